@@ -1,6 +1,9 @@
 #include "esp_log.h"
 #include "imagenet_cls.hpp"
 #include "bsp/esp-bsp.h"
+#if CONFIG_MOBILENETV2_CLS_POSTPROCESS_BENCHMARK
+#include "postprocess_benchmark.hpp"
+#endif
 
 extern const uint8_t cat_jpg_start[] asm("_binary_cat_jpg_start");
 extern const uint8_t cat_jpg_end[] asm("_binary_cat_jpg_end");
@@ -24,6 +27,10 @@ extern "C" void app_main(void)
     delete cls;
     heap_caps_free(img.data);
 
+#if CONFIG_MOBILENETV2_CLS_POSTPROCESS_BENCHMARK
+    run_postprocess_benchmark();
+#endif
+
 #if CONFIG_IMAGENET_CLS_MODEL_IN_SDCARD
     ESP_ERROR_CHECK(bsp_sdcard_unmount());
 #endif
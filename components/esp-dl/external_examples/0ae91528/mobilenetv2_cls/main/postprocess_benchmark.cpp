@@ -0,0 +1,106 @@
+#include "postprocess_benchmark.hpp"
+#include "dl_module_softmax.hpp"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "imagenet_category_name.hpp"
+#include "imagenet_cls_postprocessor.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+static const char *TAG = "postprocess_benchmark";
+
+static const int NUM_CLASS = 1000;
+static const int TOP_K = 5;
+static const float SCORE_THR = 0.f;
+static const int EXPONENT = -3;
+static const int REPEAT = 20;
+
+/**
+ * Stands in for the model, the postprocessor only reads its output.
+ */
+class LogitsModel : public dl::Model {
+public:
+    LogitsModel(dl::TensorBase *logits) : m_logits(logits) {}
+    dl::TensorBase *get_output(const std::string &name) override { return m_logits; }
+
+private:
+    dl::TensorBase *m_logits;
+};
+
+/**
+ * ClsPostprocessor::postprocess() before the top-k selection on the quantized logits.
+ */
+static void softmax_sort(dl::module::Softmax &softmax,
+                         dl::TensorBase *logits,
+                         dl::TensorBase *scores,
+                         std::vector<dl::cls::result_t> &results)
+{
+    softmax.run(logits, scores);
+    results.clear();
+    float *score = (float *)scores->data;
+    for (int i = 0; i < scores->get_size(); i++) {
+        if (score[i] > SCORE_THR) {
+            results.push_back({imagenet_cat_names[i], score[i]});
+        }
+    }
+    std::sort(results.begin(), results.end(), [](dl::cls::result_t &a, dl::cls::result_t &b) -> bool {
+        return a.score > b.score;
+    });
+    if (results.size() > TOP_K) {
+        results.resize(TOP_K);
+    }
+}
+
+void run_postprocess_benchmark()
+{
+    // Logits of a confident prediction: a few high classes over a spread of low ones.
+    dl::TensorBase logits({1, NUM_CLASS}, nullptr, EXPONENT, dl::DATA_TYPE_INT8);
+    int8_t *logit = (int8_t *)logits.data;
+    uint32_t random_state = 1;
+    for (int i = 0; i < NUM_CLASS; i++) {
+        random_state = random_state * 1664525u + 1013904223u;
+        logit[i] = (int8_t)((int)(random_state >> 24) % 96 - 64);
+    }
+    for (int i = 0; i < TOP_K; i++) {
+        logit[i * 97] = 100 - 8 * i;
+    }
+
+    LogitsModel model(&logits);
+    dl::cls::ImageNetClsPostprocessor postprocessor(&model, TOP_K, SCORE_THR, true);
+    dl::module::Softmax softmax(nullptr, -1, dl::MODULE_NON_INPLACE, dl::QUANT_TYPE_SYMM_8BIT);
+    dl::TensorBase scores({1, NUM_CLASS}, nullptr, 0, dl::DATA_TYPE_FLOAT);
+    std::vector<dl::cls::result_t> expected;
+
+    // Best of REPEAT runs, the first one of each builds its exp table.
+    int64_t softmax_us = INT64_MAX;
+    int64_t topk_us = INT64_MAX;
+    std::vector<dl::cls::result_t> *results = nullptr;
+    for (int i = 0; i < REPEAT; i++) {
+        int64_t start = esp_timer_get_time();
+        softmax_sort(softmax, &logits, &scores, expected);
+        softmax_us = std::min(softmax_us, esp_timer_get_time() - start);
+
+        start = esp_timer_get_time();
+        results = &postprocessor.postprocess();
+        topk_us = std::min(topk_us, esp_timer_get_time() - start);
+    }
+
+    bool same = results->size() == expected.size();
+    float max_diff = 0.f;
+    for (int i = 0; same && i < (int)expected.size(); i++) {
+        same = strcmp((*results)[i].cat_name, expected[i].cat_name) == 0;
+        max_diff = std::max(max_diff, fabsf((*results)[i].score - expected[i].score));
+    }
+    if (!same) {
+        ESP_LOGE(TAG, "top %d categories differ from softmax and sort", TOP_K);
+    }
+    ESP_LOGI(TAG,
+             "%d classes, top %d: softmax and sort %lld us, top-k on logits %lld us, %.1fx, max score diff %f",
+             NUM_CLASS,
+             TOP_K,
+             (long long)softmax_us,
+             (long long)topk_us,
+             (float)softmax_us / std::max(topk_us, (int64_t)1),
+             max_diff);
+}
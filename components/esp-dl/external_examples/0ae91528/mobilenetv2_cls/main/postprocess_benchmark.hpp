@@ -0,0 +1,10 @@
+#pragma once
+
+/**
+ * @brief Time the postprocessing of an int8 1000 class output as mobilenetv2 produces it.
+ *
+ * dl::cls::ImageNetClsPostprocessor selects the top 5 on the quantized logits and evaluates softmax only for them.
+ * The path it replaced, the Softmax module over all classes followed by a sort, runs on the same logits. The selected
+ * categories are compared and the times are logged.
+ */
+void run_postprocess_benchmark();
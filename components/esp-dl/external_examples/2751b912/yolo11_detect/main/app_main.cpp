@@ -1,6 +1,9 @@
 #include "coco_detect.hpp"
 #include "esp_log.h"
 #include "bsp/esp-bsp.h"
+#if CONFIG_YOLO11_DETECT_NMS_BENCHMARK
+#include "nms_benchmark.hpp"
+#endif
 
 extern const uint8_t bus_jpg_start[] asm("_binary_bus_jpg_start");
 extern const uint8_t bus_jpg_end[] asm("_binary_bus_jpg_end");
@@ -30,6 +33,10 @@ extern "C" void app_main(void)
     delete detect;
     heap_caps_free(img.data);
 
+#if CONFIG_YOLO11_DETECT_NMS_BENCHMARK
+    run_nms_benchmark();
+#endif
+
 #if CONFIG_COCO_DETECT_MODEL_IN_SDCARD
     ESP_ERROR_CHECK(bsp_sdcard_unmount());
 #endif
@@ -0,0 +1,348 @@
+#include "nms_benchmark.hpp"
+#include "dl_detect_nms.hpp"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <algorithm>
+#include <cmath>
+#include <list>
+#include <vector>
+
+static const char *TAG = "nms_benchmark";
+
+static const int IMG_W = 640;
+static const int IMG_H = 640;
+static const int NUM_CATEGORY = 80;
+static const int REPEAT = 5;
+static const float IOU_THR = 0.7;
+static const int TOP_K = 100;
+static const float SCORE_THR = 0.25;
+static const float SOFT_NMS_SIGMA = 0.5;
+
+static uint32_t s_random_state = 1;
+
+static int random_int(int n)
+{
+    s_random_state = s_random_state * 1664525u + 1013904223u;
+    return (s_random_state >> 8) % n;
+}
+
+/**
+ * About 10 candidates per object, jittered around it, as the heads of a detector produce them.
+ */
+static std::vector<dl::detect::result_t> make_candidates(int num)
+{
+    int num_object = std::max(num / 10, 1);
+    std::vector<dl::detect::result_t> objects(num_object);
+    for (auto &object : objects) {
+        int w = 16 + random_int(IMG_W / 4);
+        int h = 16 + random_int(IMG_H / 4);
+        int x = random_int(IMG_W - w);
+        int y = random_int(IMG_H - h);
+        object.category = random_int(NUM_CATEGORY);
+        object.box = {x, y, x + w - 1, y + h - 1};
+    }
+
+    std::vector<dl::detect::result_t> candidates(num);
+    for (auto &candidate : candidates) {
+        const dl::detect::result_t &object = objects[random_int(num_object)];
+        int jitter = std::max((object.box[2] - object.box[0]) / 8, 1);
+        candidate.category = object.category;
+        candidate.score = 0.25f + random_int(7500) / 10000.f;
+        candidate.box.resize(4);
+        for (int i = 0; i < 4; i++) {
+            candidate.box[i] = object.box[i] + random_int(2 * jitter + 1) - jitter;
+        }
+        candidate.box[2] = std::max(candidate.box[2], candidate.box[0]);
+        candidate.box[3] = std::max(candidate.box[3], candidate.box[1]);
+    }
+    return candidates;
+}
+
+/**
+ * IoU with the +1 pixel convention of the integer boxes, as dl::detect::candidate_iou.
+ */
+static float box_iou(const dl::detect::result_t &a, const dl::detect::result_t &b)
+{
+    int inter_w = DL_MIN(a.box[2], b.box[2]) - DL_MAX(a.box[0], b.box[0]) + 1;
+    int inter_h = DL_MIN(a.box[3], b.box[3]) - DL_MAX(a.box[1], b.box[1]) + 1;
+    if (inter_w <= 0 || inter_h <= 0) {
+        return 0.f;
+    }
+    int a_area = (a.box[2] - a.box[0] + 1) * (a.box[3] - a.box[1] + 1);
+    int b_area = (b.box[2] - b.box[0] + 1) * (b.box[3] - b.box[1] + 1);
+    int inter_area = inter_w * inter_h;
+    return (float)inter_area / (a_area + b_area - inter_area);
+}
+
+/**
+ * The NMS of DetectPostprocessor before DetectCandidates, including the sorted insertion of the postprocessors.
+ */
+static void list_nms(const std::vector<dl::detect::result_t> &candidates, std::list<dl::detect::result_t> &box_list)
+{
+    box_list.clear();
+    for (const auto &candidate : candidates) {
+        box_list.insert(std::upper_bound(box_list.begin(), box_list.end(), candidate, dl::detect::greater_box),
+                        candidate);
+    }
+
+    int kept_number = 0;
+    for (auto kept = box_list.begin(); kept != box_list.end(); kept++) {
+        kept_number++;
+        if (kept_number >= TOP_K) {
+            box_list.erase(++kept, box_list.end());
+            break;
+        }
+        int kept_area = (kept->box[2] - kept->box[0] + 1) * (kept->box[3] - kept->box[1] + 1);
+        auto other = kept;
+        other++;
+        for (; other != box_list.end();) {
+            int inter_w = DL_MIN(kept->box[2], other->box[2]) - DL_MAX(kept->box[0], other->box[0]) + 1;
+            int inter_h = DL_MIN(kept->box[3], other->box[3]) - DL_MAX(kept->box[1], other->box[1]) + 1;
+            if (inter_w > 0 && inter_h > 0) {
+                int other_area = (other->box[2] - other->box[0] + 1) * (other->box[3] - other->box[1] + 1);
+                int inter_area = inter_w * inter_h;
+                if ((float)inter_area / (kept_area + other_area - inter_area) > IOU_THR) {
+                    other = box_list.erase(other);
+                    continue;
+                }
+            }
+            other++;
+        }
+    }
+}
+
+/**
+ * Gaussian Soft-NMS as usually written: keep the highest score, decay all the others by it, repeat. Candidates decayed
+ * below SCORE_THR are removed. Scores are returned per candidate index.
+ */
+static void list_soft_nms(const std::vector<dl::detect::result_t> &candidates,
+                          std::vector<int> &keep,
+                          std::vector<float> &score)
+{
+    std::vector<int> left(candidates.size());
+    score.resize(candidates.size());
+    for (int i = 0; i < (int)candidates.size(); i++) {
+        left[i] = i;
+        score[i] = candidates[i].score;
+    }
+    keep.clear();
+    while (!left.empty() && (int)keep.size() < TOP_K) {
+        // The first of equal scores is the earlier candidate, as in the heap of dl::detect::NMS.
+        auto best = left.begin();
+        for (auto it = left.begin(); it != left.end(); it++) {
+            if (score[*it] > score[*best] || (score[*it] == score[*best] && *it < *best)) {
+                best = it;
+            }
+        }
+        int kept = *best;
+        keep.push_back(kept);
+        left.erase(best);
+        for (auto it = left.begin(); it != left.end();) {
+            float iou = box_iou(candidates[kept], candidates[*it]);
+            if (iou > 0) {
+                score[*it] *= expf(-iou * iou / SOFT_NMS_SIGMA);
+            }
+            it = score[*it] < SCORE_THR ? left.erase(it) : it + 1;
+        }
+    }
+}
+
+/**
+ * Cluster NMS by definition: hard NMS in score order, every kept box becomes the score * IoU weighted mean of itself
+ * and all the boxes it suppressed. Fused boxes are returned per kept box.
+ */
+static void list_cluster_nms(const std::vector<dl::detect::result_t> &candidates,
+                             std::vector<int> &keep,
+                             std::vector<std::vector<int>> &fused)
+{
+    std::vector<int> order(candidates.size());
+    for (int i = 0; i < (int)candidates.size(); i++) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&candidates](int a, int b) {
+        return candidates[a].score > candidates[b].score;
+    });
+
+    keep.clear();
+    std::vector<std::vector<float>> cluster;
+    for (int index : order) {
+        if ((int)keep.size() >= TOP_K) {
+            break;
+        }
+        const dl::detect::result_t &candidate = candidates[index];
+        bool suppressed = false;
+        for (int pos = 0; pos < (int)keep.size(); pos++) {
+            float iou = box_iou(candidates[keep[pos]], candidate);
+            if (iou > IOU_THR) {
+                float w = candidate.score * iou;
+                cluster[pos][0] += w;
+                for (int i = 0; i < 4; i++) {
+                    cluster[pos][i + 1] += w * candidate.box[i];
+                }
+                suppressed = true;
+            }
+        }
+        if (!suppressed) {
+            float w = candidate.score;
+            keep.push_back(index);
+            cluster.push_back(
+                {w, w * candidate.box[0], w * candidate.box[1], w * candidate.box[2], w * candidate.box[3]});
+        }
+    }
+
+    fused.resize(keep.size());
+    for (int pos = 0; pos < (int)keep.size(); pos++) {
+        fused[pos].resize(4);
+        float inv_w = 1.f / cluster[pos][0];
+        for (int i = 0; i < 4; i++) {
+            fused[pos][i] = (int)lroundf(cluster[pos][i + 1] * inv_w);
+        }
+    }
+}
+
+static void candidate_nms(const std::vector<dl::detect::result_t> &candidates,
+                          dl::detect::DetectCandidates &store,
+                          dl::detect::NMS *nms,
+                          const dl::detect::nms_config_t &config,
+                          bool dual_core,
+                          std::vector<int> &keep)
+{
+    store.clear();
+    for (const auto &candidate : candidates) {
+        store.push(candidate.category, candidate.score, candidate.box.data());
+    }
+    if (dual_core) {
+        dl::detect::nms_class_aware_dual_core(nms, store, config, keep);
+    } else {
+        nms[0].run(store, config, keep);
+    }
+}
+
+/**
+ * Best of REPEAT runs, the buffers of the candidate store and the engines are kept between frames.
+ */
+static int64_t time_candidate_nms(const std::vector<dl::detect::result_t> &candidates,
+                                  dl::detect::DetectCandidates &store,
+                                  dl::detect::NMS *nms,
+                                  const dl::detect::nms_config_t &config,
+                                  bool dual_core,
+                                  std::vector<int> &keep)
+{
+    int64_t us = INT64_MAX;
+    for (int i = 0; i < REPEAT; i++) {
+        int64_t start = esp_timer_get_time();
+        candidate_nms(candidates, store, nms, config, dual_core, keep);
+        us = std::min(us, esp_timer_get_time() - start);
+    }
+    return us;
+}
+
+static void log_mode(const char *mode, int num, int kept, int64_t reference_us, int64_t candidate_us, bool same)
+{
+    if (!same) {
+        ESP_LOGE(TAG, "%s, %d candidates: kept boxes differ from the reference", mode, num);
+    }
+    ESP_LOGI(TAG,
+             "%-20s  %10d  %4d  %14lld  %8lld  %7.1fx",
+             mode,
+             num,
+             kept,
+             (long long)reference_us,
+             (long long)candidate_us,
+             (float)reference_us / DL_MAX(candidate_us, (int64_t)1));
+}
+
+/**
+ * Soft, cluster and class aware dual core NMS, which the postprocessors select with set_nms_mode(). Soft and cluster
+ * NMS are compared with their definition above, the dual core run with the single core class aware NMS.
+ */
+static void run_nms_mode_benchmark()
+{
+    const int nums[] = {100, 500, 1000, 2000, 5000};
+    dl::detect::DetectCandidates store;
+    dl::detect::NMS nms[2];
+    std::vector<int> keep;
+    std::vector<int> reference_keep;
+    std::vector<float> reference_score;
+    std::vector<std::vector<int>> reference_fused;
+
+    ESP_LOGI(TAG, "mode                  candidates  kept  reference (us)  NMS (us)  speed-up");
+    for (int num : nums) {
+        std::vector<dl::detect::result_t> candidates = make_candidates(num);
+        store.reserve(num);
+
+        dl::detect::nms_config_t config = {dl::detect::NMS_MODE_SOFT, false, IOU_THR, TOP_K, SCORE_THR, SOFT_NMS_SIGMA};
+        int64_t start = esp_timer_get_time();
+        list_soft_nms(candidates, reference_keep, reference_score);
+        int64_t reference_us = esp_timer_get_time() - start;
+        int64_t candidate_us = time_candidate_nms(candidates, store, nms, config, false, keep);
+        // The grid applies the decays of a candidate in another order than the kept boxes, the scores agree up to the
+        // rounding of the products.
+        bool same = keep == reference_keep;
+        for (int i = 0; same && i < (int)keep.size(); i++) {
+            same = fabsf(store.score[keep[i]] - reference_score[keep[i]]) <= 1e-6f * reference_score[keep[i]];
+        }
+        log_mode("soft", num, keep.size(), reference_us, candidate_us, same);
+
+        config.mode = dl::detect::NMS_MODE_CLUSTER;
+        start = esp_timer_get_time();
+        list_cluster_nms(candidates, reference_keep, reference_fused);
+        reference_us = esp_timer_get_time() - start;
+        candidate_us = time_candidate_nms(candidates, store, nms, config, false, keep);
+        same = keep == reference_keep;
+        for (int i = 0; same && i < (int)keep.size(); i++) {
+            int k = keep[i];
+            same = store.x1[k] == reference_fused[i][0] && store.y1[k] == reference_fused[i][1] &&
+                store.x2[k] == reference_fused[i][2] && store.y2[k] == reference_fused[i][3];
+        }
+        log_mode("cluster", num, keep.size(), reference_us, candidate_us, same);
+
+        config = {dl::detect::NMS_MODE_HARD, true, IOU_THR, TOP_K, 0.f, 0.5f};
+        reference_us = time_candidate_nms(candidates, store, nms, config, false, reference_keep);
+        candidate_us = time_candidate_nms(candidates, store, nms, config, true, keep);
+        log_mode("class aware 2 cores", num, keep.size(), reference_us, candidate_us, keep == reference_keep);
+    }
+}
+
+void run_nms_benchmark()
+{
+    const int nums[] = {100, 500, 1000, 2000, 5000, 10000};
+    dl::detect::DetectCandidates store;
+    dl::detect::NMS nms[2];
+    dl::detect::nms_config_t config = {dl::detect::NMS_MODE_HARD, false, IOU_THR, TOP_K, 0.f, 0.5f};
+    std::vector<int> keep;
+    std::list<dl::detect::result_t> box_list;
+
+    ESP_LOGI(TAG, "candidates  kept  list NMS (us)  DetectCandidates NMS (us)  speed-up");
+    for (int num : nums) {
+        std::vector<dl::detect::result_t> candidates = make_candidates(num);
+        store.reserve(num);
+
+        // The list NMS is quadratic in the number of candidates and runs once. The candidate store takes the best of
+        // REPEAT runs, its buffers are kept between frames.
+        int64_t start = esp_timer_get_time();
+        list_nms(candidates, box_list);
+        int64_t list_us = esp_timer_get_time() - start;
+        int64_t candidate_us = time_candidate_nms(candidates, store, nms, config, false, keep);
+
+        bool same = keep.size() == box_list.size();
+        auto res = box_list.begin();
+        for (int i = 0; same && i < (int)keep.size(); i++, res++) {
+            int k = keep[i];
+            same = store.score[k] == res->score && store.x1[k] == res->box[0] && store.y1[k] == res->box[1] &&
+                store.x2[k] == res->box[2] && store.y2[k] == res->box[3];
+        }
+        if (!same) {
+            ESP_LOGE(TAG, "%d candidates: kept boxes differ from the list NMS", num);
+        }
+        ESP_LOGI(TAG,
+                 "%10d  %4d  %13lld  %25lld  %7.1fx",
+                 num,
+                 (int)keep.size(),
+                 (long long)list_us,
+                 (long long)candidate_us,
+                 (float)list_us / DL_MAX(candidate_us, (int64_t)1));
+    }
+
+    run_nms_mode_benchmark();
+}
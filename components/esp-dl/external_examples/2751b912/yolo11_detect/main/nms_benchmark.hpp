@@ -0,0 +1,14 @@
+#pragma once
+
+/**
+ * @brief Time the NMS of DetectPostprocessor on synthetic candidates.
+ *
+ * For 100 to 10000 candidates clustered around random objects, the candidates are pushed into
+ * dl::detect::DetectCandidates and run through dl::detect::NMS, and the same candidates are inserted into a
+ * score sorted std::list and suppressed with the list based NMS DetectPostprocessor used before. Both are given the
+ * configuration of yolo11n (iou=0.7, top_k=100), the kept boxes are compared and the times are logged.
+ *
+ * For 100 to 5000 candidates the other modes of set_nms_mode() follow: Soft-NMS and cluster NMS against a direct
+ * implementation of their definition, and class aware NMS on both cores against the same NMS on one core.
+ */
+void run_nms_benchmark();
@@ -1,5 +1,6 @@
 #include "human_face_detect.hpp"
 #include "human_face_recognition.hpp"
+#include "dl_recognition_cache.hpp"
 #include "spiflash_fatfs.hpp"
 #include "bsp/esp-bsp.h"
 
@@ -57,10 +58,32 @@ extern "C" void app_main(void)
     human_face_recognizer->enroll(bill2, human_face_detect->run(bill2));
     human_face_recognizer->enroll(musk1, human_face_detect->run(musk1));
 
-    auto res = human_face_recognizer->recognize(musk2, human_face_detect->run(musk2));
-    for (const auto &k : res) {
-        ESP_LOGI(TAG, "id: %d, sim: %f", k.id, k.similarity);
+    // musk2 stands in for the frames of a camera. The face stays in place, so it is tracked and recognized again
+    // only when the cache expires.
+    dl::recognition::RecognitionCache recognition_cache;
+    for (int frame = 0; frame < 10; frame++) {
+        auto &detect_res = human_face_detect->run(musk2);
+        recognition_cache.begin_frame(detect_res);
+        int i = 0;
+        for (const auto &det : detect_res) {
+            std::vector<dl::recognition::result_t> res;
+            if (!recognition_cache.lookup(i, res)) {
+                std::list<dl::detect::result_t> face = {det};
+                res = human_face_recognizer->recognize(musk2, face);
+                recognition_cache.update(i, res);
+            }
+            for (const auto &k : res) {
+                ESP_LOGI(TAG, "frame: %d, id: %" PRIu32 ", sim: %f", frame, k.id, k.similarity);
+            }
+            i++;
+        }
     }
+    const auto &stats = recognition_cache.get_stats();
+    ESP_LOGI(TAG,
+             "recognition cache hits: %" PRIu32 ", misses: %" PRIu32 ", hit rate: %.2f",
+             stats.num_hits,
+             stats.num_misses,
+             stats.hit_rate());
 
     human_face_recognizer->clear_all_feats();
 
@@ -0,0 +1,355 @@
+#include "dl_math.hpp"
+#include "dl_pose_yolo11_postprocessor.hpp"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "unity.h"
+#include <algorithm>
+#include <cstring>
+#include <list>
+#include <map>
+
+using namespace dl;
+using namespace dl::detect;
+
+static const int INPUT_SIZE = 160;
+static const int KPT_NUM = 17;
+static const int REG_MAX = 16;
+static const float SCORE_THR = 0.25;
+static const int SCORE_EXPONENT = -4;
+static const int BOX_EXPONENT = -2;
+static const int KPT_EXPONENT = -4;
+
+static const char *TAG = "test_pose_yolo11";
+
+/**
+ * Stands in for the model, the postprocessor only reads its outputs.
+ */
+class OutputModel : public Model {
+public:
+    std::map<std::string, TensorBase *> outputs;
+
+    ~OutputModel()
+    {
+        for (auto &output : outputs) {
+            delete output.second;
+        }
+    }
+    TensorBase *get_output(const std::string &name) override { return outputs[name]; }
+};
+
+static uint32_t s_random_state = 1;
+
+static int8_t random_int8()
+{
+    s_random_state = s_random_state * 1664525u + 1013904223u;
+    return (int8_t)(s_random_state >> 24);
+}
+
+static TensorBase *random_tensor(int size, int channel, int exponent)
+{
+    TensorBase *tensor = new TensorBase({1, size, size, channel}, nullptr, exponent, DATA_TYPE_INT8);
+    int8_t *data = (int8_t *)tensor->data;
+    for (int i = 0; i < tensor->get_size(); i++) {
+        data[i] = random_int8();
+    }
+    return tensor;
+}
+
+typedef struct {
+    int score;
+    std::vector<int> keypoint;
+} expected_t;
+
+TEST_CASE("yolo11 pose keypoints match the double precision decode", "[dl_detect]")
+{
+    // A fixed int8 frame of a 160x160 input, about half of the cells pass the score threshold and their keypoints
+    // span the whole int8 range.
+    const int strides[3] = {8, 16, 32};
+    std::vector<anchor_point_stage_t> stages;
+    OutputModel model;
+    for (int i = 0; i < 3; i++) {
+        int size = INPUT_SIZE / strides[i];
+        stages.push_back({strides[i], strides[i], strides[i] / 2, strides[i] / 2});
+        model.outputs["score" + std::to_string(i)] = random_tensor(size, 1, SCORE_EXPONENT);
+        model.outputs["box" + std::to_string(i)] = random_tensor(size, 4 * REG_MAX, BOX_EXPONENT);
+        model.outputs["kpt" + std::to_string(i)] = random_tensor(size, 3 * KPT_NUM, KPT_EXPONENT);
+    }
+
+    // An iou threshold of 1 keeps every candidate, so each one is compared.
+    yolo11posePostProcessor postprocessor(&model, SCORE_THR, 1.f, 10000, stages);
+    const int img_w = 500;
+    const int img_h = 375;
+    postprocessor.set_resize_scale_x((float)INPUT_SIZE / img_w);
+    postprocessor.set_resize_scale_y((float)INPUT_SIZE / img_h);
+    postprocessor.set_top_left_x(0);
+    postprocessor.set_top_left_y(0);
+    postprocessor.clear_result();
+    postprocessor.postprocess();
+    std::list<result_t> &results = postprocessor.get_result(img_w, img_h);
+
+    // The decode before the keypoints moved after NMS: dequantize every value and scale in double precision.
+    float inv_resize_scale_x = 1.f / ((float)INPUT_SIZE / img_w);
+    float inv_resize_scale_y = 1.f / ((float)INPUT_SIZE / img_h);
+    float kpt_exp = DL_SCALE(KPT_EXPONENT);
+    int score_thr_quant = quantize<int8_t>(dl::math::inverse_sigmoid(SCORE_THR), 1.f / DL_SCALE(SCORE_EXPONENT));
+    std::vector<expected_t> expected;
+    for (int i = 0; i < 3; i++) {
+        int size = INPUT_SIZE / strides[i];
+        const int8_t *score = (int8_t *)model.outputs["score" + std::to_string(i)]->data;
+        const int8_t *kpt = (int8_t *)model.outputs["kpt" + std::to_string(i)]->data;
+        for (int cell = 0; cell < size * size; cell++, kpt += 3 * KPT_NUM) {
+            if (score[cell] <= score_thr_quant) {
+                continue;
+            }
+            result_t res = {};
+            res.keypoint.resize(2 * KPT_NUM);
+            for (int k = 0; k < KPT_NUM; k++) {
+                float kpt_x = dequantize(kpt[3 * k], kpt_exp);
+                float kpt_y = dequantize(kpt[3 * k + 1], kpt_exp);
+                float kpt_conf = dequantize(kpt[3 * k + 2], kpt_exp);
+                if (kpt_conf >= 0.5) {
+                    res.keypoint[2 * k] =
+                        static_cast<int>((kpt_x * 2.0 * strides[i] + (cell % size) * strides[i]) * inv_resize_scale_x);
+                    res.keypoint[2 * k + 1] =
+                        static_cast<int>((kpt_y * 2.0 * strides[i] + (cell / size) * strides[i]) * inv_resize_scale_y);
+                }
+            }
+            res.limit_keypoint(img_w, img_h);
+            expected.push_back({score[cell], res.keypoint});
+        }
+    }
+    // NMS orders by score, candidates of equal score in the order they were found.
+    std::stable_sort(
+        expected.begin(), expected.end(), [](const expected_t &a, const expected_t &b) { return a.score > b.score; });
+
+    TEST_ASSERT_GREATER_THAN(100, expected.size());
+    TEST_ASSERT_EQUAL(expected.size(), results.size());
+    auto res = results.begin();
+    for (const expected_t &e : expected) {
+        TEST_ASSERT_EQUAL_INT_ARRAY(e.keypoint.data(), res->keypoint.data(), 2 * KPT_NUM);
+        res++;
+    }
+}
+
+static const int CROWD_INPUT_SIZE = 640;
+static const int CROWD_PERSON_NUM = 40;
+static const float CROWD_NMS_THR = 0.7;
+static const int CROWD_TOP_K = 100;
+static const int CROWD_REPEAT = 5;
+
+static int random_int(int n)
+{
+    s_random_state = s_random_state * 1664525u + 1013904223u;
+    return (s_random_state >> 8) % n;
+}
+
+/**
+ * Outputs of yolo11n-pose for a crowded 640x640 scene. Each person raises the score of the cells around its center
+ * at every stage, and the box distributions of those cells point at its box, so every person leaves a cluster of
+ * candidates for NMS. Keypoints are random.
+ */
+static void make_crowded_outputs(OutputModel &model, std::vector<anchor_point_stage_t> &stages)
+{
+    std::vector<std::vector<int>> persons(CROWD_PERSON_NUM);
+    for (auto &person : persons) {
+        int w = 32 + random_int(96);
+        int h = 2 * w;
+        int x = random_int(CROWD_INPUT_SIZE - w);
+        int y = random_int(CROWD_INPUT_SIZE - h);
+        person = {x, y, x + w - 1, y + h - 1};
+    }
+
+    const int strides[3] = {8, 16, 32};
+    for (int i = 0; i < 3; i++) {
+        int stride = strides[i];
+        int size = CROWD_INPUT_SIZE / stride;
+        stages.push_back({stride, stride, stride / 2, stride / 2});
+        TensorBase *score = random_tensor(size, 1, SCORE_EXPONENT);
+        TensorBase *box = random_tensor(size, 4 * REG_MAX, BOX_EXPONENT);
+        model.outputs["score" + std::to_string(i)] = score;
+        model.outputs["box" + std::to_string(i)] = box;
+        model.outputs["kpt" + std::to_string(i)] = random_tensor(size, 3 * KPT_NUM, KPT_EXPONENT);
+
+        // Background: sigmoid(-6.25), far below the score threshold.
+        memset(score->data, -100, size * size);
+        for (const auto &person : persons) {
+            int cx = (person[0] + person[2]) / 2;
+            int cy = (person[1] + person[3]) / 2;
+            int rx = (person[2] - person[0]) / 4;
+            int ry = (person[3] - person[1]) / 4;
+            for (int y = 0; y < size; y++) {
+                for (int x = 0; x < size; x++) {
+                    int center_x = x * stride + stride / 2;
+                    int center_y = y * stride + stride / 2;
+                    if (abs(center_x - cx) > rx || abs(center_y - cy) > ry) {
+                        continue;
+                    }
+                    int cell = y * size + x;
+                    // Logits 0.5 to 4.
+                    ((int8_t *)score->data)[cell] = 8 + random_int(57);
+                    int dist[4] = {
+                        center_x - person[0], center_y - person[1], person[2] - center_x, person[3] - center_y};
+                    int8_t *dfl = (int8_t *)box->data + cell * 4 * REG_MAX;
+                    for (int side = 0; side < 4; side++, dfl += REG_MAX) {
+                        memset(dfl, -64, REG_MAX);
+                        dfl[DL_CLIP((dist[side] + stride / 2) / stride, 0, REG_MAX - 1)] = 32;
+                    }
+                }
+            }
+        }
+    }
+}
+
+/**
+ * yolo11posePostProcessor before the keypoints moved after NMS: every candidate decodes its box and its 17 keypoints
+ * with scalar dequantize, is inserted into a score sorted list, and the list is suppressed greedily. Returns the number
+ * of candidates.
+ */
+static int legacy_postprocess(OutputModel &model,
+                               const std::vector<anchor_point_stage_t> &stages,
+                               float resize_scale_x,
+                               float resize_scale_y,
+                               std::list<result_t> &box_list)
+{
+    box_list.clear();
+    float inv_resize_scale_x = 1.f / resize_scale_x;
+    float inv_resize_scale_y = 1.f / resize_scale_y;
+    for (int i = 0; i < 3; i++) {
+        TensorBase *score = model.outputs["score" + std::to_string(i)];
+        TensorBase *box = model.outputs["box" + std::to_string(i)];
+        TensorBase *kpt = model.outputs["kpt" + std::to_string(i)];
+        int stride_x = stages[i].stride_x;
+        int stride_y = stages[i].stride_y;
+        int offset_x = stages[i].offset_x;
+        int offset_y = stages[i].offset_y;
+        int H = score->shape[1];
+        int W = score->shape[2];
+        int8_t *score_ptr = (int8_t *)score->data;
+        int8_t *box_ptr = (int8_t *)box->data;
+        int8_t *kpt_ptr = (int8_t *)kpt->data;
+        float score_exp = DL_SCALE(score->exponent);
+        float box_exp = DL_SCALE(box->exponent);
+        float kpt_exp = DL_SCALE(kpt->exponent);
+        int8_t score_thr_quant = quantize<int8_t>(dl::math::inverse_sigmoid(SCORE_THR), 1.f / score_exp);
+
+        for (int y = 0; y < H; y++) {
+            for (int x = 0; x < W; x++, score_ptr++, box_ptr += 4 * REG_MAX, kpt_ptr += 3 * KPT_NUM) {
+                if (*score_ptr <= score_thr_quant) {
+                    continue;
+                }
+                int center_y = y * stride_y + offset_y;
+                int center_x = x * stride_x + offset_x;
+                float box_data[REG_MAX * 4];
+                for (int j = 0; j < REG_MAX * 4; j++) {
+                    box_data[j] = dequantize(box_ptr[j], box_exp);
+                }
+                std::vector<int> keypoints_vec(2 * KPT_NUM);
+                for (int k = 0; k < KPT_NUM; k++) {
+                    float kpt_x = dequantize(kpt_ptr[3 * k], kpt_exp);
+                    float kpt_y = dequantize(kpt_ptr[3 * k + 1], kpt_exp);
+                    float kpt_conf = dequantize(kpt_ptr[3 * k + 2], kpt_exp);
+                    if (kpt_conf >= 0.5) {
+                        keypoints_vec[2 * k] =
+                            static_cast<int>((kpt_x * 2.0 * stride_x + (center_x - offset_x)) * inv_resize_scale_x);
+                        keypoints_vec[2 * k + 1] =
+                            static_cast<int>((kpt_y * 2.0 * stride_y + (center_y - offset_y)) * inv_resize_scale_y);
+                    }
+                }
+                result_t new_box = {
+                    0,
+                    dl::math::sigmoid(dequantize(*score_ptr, score_exp)),
+                    {(int)((center_x - dl::math::dfl_integral(box_data, REG_MAX - 1) * stride_x) * inv_resize_scale_x),
+                     (int)((center_y - dl::math::dfl_integral(box_data + REG_MAX, REG_MAX - 1) * stride_y) *
+                           inv_resize_scale_y),
+                     (int)((center_x + dl::math::dfl_integral(box_data + 2 * REG_MAX, REG_MAX - 1) * stride_x) *
+                           inv_resize_scale_x),
+                     (int)((center_y + dl::math::dfl_integral(box_data + 3 * REG_MAX, REG_MAX - 1) * stride_y) *
+                           inv_resize_scale_y)},
+                    keypoints_vec,
+                };
+                box_list.insert(std::upper_bound(box_list.begin(), box_list.end(), new_box, greater_box), new_box);
+            }
+        }
+    }
+
+    int num_candidates = box_list.size();
+    int kept_number = 0;
+    for (auto kept = box_list.begin(); kept != box_list.end(); kept++) {
+        kept_number++;
+        if (kept_number >= CROWD_TOP_K) {
+            box_list.erase(++kept, box_list.end());
+            break;
+        }
+        int kept_area = (kept->box[2] - kept->box[0] + 1) * (kept->box[3] - kept->box[1] + 1);
+        auto other = kept;
+        other++;
+        for (; other != box_list.end();) {
+            int inter_w = DL_MIN(kept->box[2], other->box[2]) - DL_MAX(kept->box[0], other->box[0]) + 1;
+            int inter_h = DL_MIN(kept->box[3], other->box[3]) - DL_MAX(kept->box[1], other->box[1]) + 1;
+            if (inter_w > 0 && inter_h > 0) {
+                int other_area = (other->box[2] - other->box[0] + 1) * (other->box[3] - other->box[1] + 1);
+                int inter_area = inter_w * inter_h;
+                if ((float)inter_area / (kept_area + other_area - inter_area) > CROWD_NMS_THR) {
+                    other = box_list.erase(other);
+                    continue;
+                }
+            }
+            other++;
+        }
+    }
+    return num_candidates;
+}
+
+TEST_CASE("yolo11 pose postprocess benchmark on a crowded scene", "[dl_detect][benchmark]")
+{
+    std::vector<anchor_point_stage_t> stages;
+    OutputModel model;
+    make_crowded_outputs(model, stages);
+
+    yolo11posePostProcessor postprocessor(&model, SCORE_THR, CROWD_NMS_THR, CROWD_TOP_K, stages);
+    const int img_w = 1920;
+    const int img_h = 1080;
+    float resize_scale_x = (float)CROWD_INPUT_SIZE / img_w;
+    float resize_scale_y = (float)CROWD_INPUT_SIZE / img_h;
+    postprocessor.set_resize_scale_x(resize_scale_x);
+    postprocessor.set_resize_scale_y(resize_scale_y);
+    postprocessor.set_top_left_x(0);
+    postprocessor.set_top_left_y(0);
+
+    // The legacy path runs once, the postprocessor takes the best of CROWD_REPEAT frames.
+    std::list<result_t> expected;
+    int64_t start = esp_timer_get_time();
+    int num_candidates = legacy_postprocess(model, stages, resize_scale_x, resize_scale_y, expected);
+    for (result_t &res : expected) {
+        res.limit_box(img_w, img_h);
+        res.limit_keypoint(img_w, img_h);
+    }
+    int64_t legacy_us = esp_timer_get_time() - start;
+    int64_t postprocess_us = INT64_MAX;
+    for (int i = 0; i < CROWD_REPEAT; i++) {
+        start = esp_timer_get_time();
+        postprocessor.clear_result();
+        postprocessor.postprocess();
+        postprocessor.get_result(img_w, img_h);
+        postprocess_us = std::min(postprocess_us, esp_timer_get_time() - start);
+    }
+    std::list<result_t> &results = postprocessor.get_result(img_w, img_h);
+    ESP_LOGI(TAG,
+             "%d persons, %d candidates, %d kept: decode before NMS %lld us, keypoints after NMS %lld us, %.1fx",
+             CROWD_PERSON_NUM,
+             num_candidates,
+             (int)results.size(),
+             (long long)legacy_us,
+             (long long)postprocess_us,
+             (float)legacy_us / DL_MAX(postprocess_us, (int64_t)1));
+
+    TEST_ASSERT_GREATER_THAN(CROWD_PERSON_NUM / 2, results.size());
+    TEST_ASSERT_EQUAL(expected.size(), results.size());
+    auto res = results.begin();
+    for (const result_t &e : expected) {
+        TEST_ASSERT_FLOAT_WITHIN(1e-6, e.score, res->score);
+        TEST_ASSERT_EQUAL_INT_ARRAY(e.box.data(), res->box.data(), 4);
+        TEST_ASSERT_EQUAL_INT_ARRAY(e.keypoint.data(), res->keypoint.data(), 2 * KPT_NUM);
+        res++;
+    }
+}
@@ -0,0 +1,265 @@
+#include "dl_recognition_database.hpp"
+#include "esp_vfs_fat.h"
+#include "unity.h"
+#include <algorithm>
+#include <cmath>
+#include <sys/stat.h>
+
+using namespace dl;
+using namespace dl::recognition;
+
+#define STORAGE_MOUNT_POINT "/storage"
+
+static const char *DB_PATH = STORAGE_MOUNT_POINT "/test.db";
+static const char *TMP_PATH = STORAGE_MOUNT_POINT "/test.db.tmp";
+static const char *IVF_PATH = STORAGE_MOUNT_POINT "/test.db.ivf";
+static const int FEAT_LEN = 128;
+static const size_t HEADER_SIZE = sizeof(database_header);
+static const size_t ENROLL_SIZE = sizeof(database_record) + FEAT_LEN * sizeof(float);
+static const size_t DELETE_SIZE = sizeof(database_record);
+
+static uint32_t s_random_state = 1;
+
+/**
+ * The "storage" FAT partition of partitions.csv, mounted once for all tests.
+ */
+static void mount_storage()
+{
+    static wl_handle_t s_wl_handle = WL_INVALID_HANDLE;
+    if (s_wl_handle == WL_INVALID_HANDLE) {
+        esp_vfs_fat_mount_config_t mount_config;
+        memset(&mount_config, 0, sizeof(esp_vfs_fat_mount_config_t));
+        mount_config.max_files = 5;
+        mount_config.format_if_mount_failed = true;
+        TEST_ESP_OK(esp_vfs_fat_spiflash_mount_rw_wl(STORAGE_MOUNT_POINT, "storage", &mount_config, &s_wl_handle));
+    }
+    remove(DB_PATH);
+    remove(TMP_PATH);
+    remove(IVF_PATH);
+}
+
+static long file_size(const char *path)
+{
+    struct stat st;
+    return stat(path, &st) == 0 ? st.st_size : -1;
+}
+
+/**
+ * Feature number i, the same for every test so that it can be enrolled and queried again after a reopen.
+ */
+static std::vector<float> make_feat(int i)
+{
+    s_random_state = i + 1;
+    std::vector<float> feat(FEAT_LEN);
+    float norm = 0;
+    for (int j = 0; j < FEAT_LEN; j++) {
+        s_random_state = s_random_state * 1664525u + 1013904223u;
+        feat[j] = ((s_random_state >> 8) + 0.5f) / 16777216.f - 0.5f;
+        norm += feat[j] * feat[j];
+    }
+    norm = 1.f / sqrtf(norm);
+    for (int j = 0; j < FEAT_LEN; j++) {
+        feat[j] *= norm;
+    }
+    return feat;
+}
+
+static void enroll(DataBase &db, int i)
+{
+    std::vector<float> feat = make_feat(i);
+    TensorBase tensor({FEAT_LEN}, feat.data(), 0, DATA_TYPE_FLOAT);
+    TEST_ESP_OK(db.enroll_feat(&tensor));
+}
+
+/**
+ * Result id of the best match of feature i, 0 if nothing is similar to it.
+ */
+static uint32_t query(DataBase &db, int i)
+{
+    std::vector<float> feat = make_feat(i);
+    TensorBase tensor({FEAT_LEN}, feat.data(), 0, DATA_TYPE_FLOAT);
+    std::vector<result_t> results = db.query_feat(&tensor, 0.9, 1);
+    if (results.empty()) {
+        return 0;
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1e-5, 1.f, results[0].similarity);
+    return results[0].id;
+}
+
+/**
+ * query_feat reports the 1-based position among the live features in enroll order, like the list it replaced. live
+ * holds the feature numbers in that order, every other feature below num must not be found.
+ */
+static void check_feats(DataBase &db, const std::vector<int> &live, int num)
+{
+    TEST_ASSERT_EQUAL(live.size(), db.get_num_feats());
+    for (int i = 0; i < num; i++) {
+        auto it = std::find(live.begin(), live.end(), i);
+        TEST_ASSERT_EQUAL(it == live.end() ? 0 : it - live.begin() + 1, query(db, i));
+    }
+}
+
+TEST_CASE("database enroll, delete and reopen", "[dl_recognition]")
+{
+    mount_storage();
+    DataBase *db = new DataBase(DB_PATH, FEAT_LEN);
+    for (int i = 0; i < 10; i++) {
+        enroll(*db, i);
+    }
+    // Feature i is enrolled with id i + 1.
+    TEST_ESP_OK(db->delete_feat(3));
+    TEST_ESP_OK(db->delete_last_feat());
+    TEST_ASSERT_NOT_EQUAL(ESP_OK, db->delete_feat(3));
+    std::vector<int> live = {0, 1, 3, 4, 5, 6, 7, 8};
+    check_feats(*db, live, 10);
+    TEST_ASSERT_EQUAL(HEADER_SIZE + 10 * ENROLL_SIZE + 2 * DELETE_SIZE, file_size(DB_PATH));
+    delete db;
+
+    db = new DataBase(DB_PATH, FEAT_LEN);
+    check_feats(*db, live, 10);
+    // Ids are not reused, also not the one of the deleted last feature: feature 10 gets id 11 and id 10 stays
+    // unknown.
+    enroll(*db, 10);
+    live.push_back(10);
+    TEST_ASSERT_NOT_EQUAL(ESP_OK, db->delete_feat(10));
+    TEST_ESP_OK(db->delete_feat(11));
+    live.pop_back();
+    enroll(*db, 11);
+    live.push_back(11);
+
+    // Batched records reach the file when the database is closed.
+    TEST_ESP_OK(db->set_write_batch(4));
+    enroll(*db, 12);
+    live.push_back(12);
+    TEST_ESP_OK(db->delete_feat(1));
+    live.erase(live.begin());
+    TEST_ASSERT_EQUAL(HEADER_SIZE + 12 * ENROLL_SIZE + 3 * DELETE_SIZE, file_size(DB_PATH));
+    delete db;
+    TEST_ASSERT_EQUAL(HEADER_SIZE + 13 * ENROLL_SIZE + 4 * DELETE_SIZE, file_size(DB_PATH));
+
+    db = new DataBase(DB_PATH, FEAT_LEN);
+    check_feats(*db, live, 13);
+    TEST_ESP_OK(db->delete_feat(13));
+    TEST_ESP_OK(db->clear_all_feats());
+    TEST_ASSERT_EQUAL(0, db->get_num_feats());
+    TEST_ASSERT_EQUAL(HEADER_SIZE, file_size(DB_PATH));
+    delete db;
+}
+
+TEST_CASE("database compacts once dead records outnumber live ones", "[dl_recognition]")
+{
+    mount_storage();
+    const int num = 100;
+    DataBase *db = new DataBase(DB_PATH, FEAT_LEN);
+    for (int i = 0; i < num; i++) {
+        enroll(*db, i);
+    }
+    // Each delete leaves two dead records, the enroll record and its tombstone. Compaction needs at least 64 of them
+    // and more dead than live records, so the 34th delete triggers it.
+    for (int i = 0; i < 33; i++) {
+        TEST_ESP_OK(db->delete_feat(2 * i + 1));
+    }
+    TEST_ASSERT_EQUAL(HEADER_SIZE + num * ENROLL_SIZE + 33 * DELETE_SIZE, file_size(DB_PATH));
+    TEST_ESP_OK(db->delete_feat(67));
+    TEST_ASSERT_EQUAL(HEADER_SIZE + (num - 34) * ENROLL_SIZE, file_size(DB_PATH));
+    TEST_ASSERT_EQUAL(-1, file_size(TMP_PATH));
+    TEST_ESP_OK(db->delete_feat(69));
+    TEST_ASSERT_EQUAL(HEADER_SIZE + (num - 34) * ENROLL_SIZE + DELETE_SIZE, file_size(DB_PATH));
+    std::vector<int> live;
+    for (int i = 0; i < num; i++) {
+        if (i % 2 == 1 || i > 68) {
+            live.push_back(i);
+        }
+    }
+    check_feats(*db, live, num);
+    delete db;
+
+    db = new DataBase(DB_PATH, FEAT_LEN);
+    check_feats(*db, live, num);
+    // The compacted header keeps the next id.
+    enroll(*db, num);
+    TEST_ESP_OK(db->delete_feat(num + 1));
+    TEST_ASSERT_EQUAL(num - 35, db->get_num_feats());
+    delete db;
+}
+
+TEST_CASE("database converts a legacy file", "[dl_recognition]")
+{
+    mount_storage();
+    // The previous in place format: a meta of uint16 total / valid / feat_len, then an uint16 id and the feature of
+    // every enrolled slot, with id 0 for deleted ones.
+    const int num = 5;
+    FILE *f = fopen(DB_PATH, "wb");
+    TEST_ASSERT_NOT_NULL(f);
+    uint16_t meta[3] = {num, num - 1, FEAT_LEN};
+    TEST_ASSERT_EQUAL(3, fwrite(meta, sizeof(uint16_t), 3, f));
+    for (int i = 0; i < num; i++) {
+        uint16_t id = i == 1 ? 0 : i + 1;
+        std::vector<float> feat = make_feat(i);
+        TEST_ASSERT_EQUAL(1, fwrite(&id, sizeof(uint16_t), 1, f));
+        TEST_ASSERT_EQUAL(FEAT_LEN, fwrite(feat.data(), sizeof(float), FEAT_LEN, f));
+    }
+    fclose(f);
+
+    DataBase *db = new DataBase(DB_PATH, FEAT_LEN);
+    std::vector<int> live = {0, 2, 3, 4};
+    check_feats(*db, live, num);
+    TEST_ASSERT_EQUAL(HEADER_SIZE + (num - 1) * ENROLL_SIZE, file_size(DB_PATH));
+    // The legacy ids are kept.
+    TEST_ASSERT_NOT_EQUAL(ESP_OK, db->delete_feat(2));
+    TEST_ESP_OK(db->delete_feat(3));
+    live.erase(live.begin() + 1);
+    enroll(*db, num);
+    live.push_back(num);
+    delete db;
+
+    db = new DataBase(DB_PATH, FEAT_LEN);
+    check_feats(*db, live, num + 1);
+    TEST_ESP_OK(db->delete_feat(num + 1));
+    delete db;
+}
+
+TEST_CASE("database recovers from an interrupted write", "[dl_recognition]")
+{
+    mount_storage();
+    DataBase *db = new DataBase(DB_PATH, FEAT_LEN);
+    for (int i = 0; i < 4; i++) {
+        enroll(*db, i);
+    }
+    TEST_ESP_OK(db->compact());
+    delete db;
+
+    // Power lost after a compaction removed the old file and before it renamed the new one.
+    TEST_ASSERT_EQUAL(0, rename(DB_PATH, TMP_PATH));
+    db = new DataBase(DB_PATH, FEAT_LEN);
+    std::vector<int> live = {0, 1, 2, 3};
+    check_feats(*db, live, 4);
+    TEST_ASSERT_EQUAL(-1, file_size(TMP_PATH));
+    delete db;
+
+    // Power lost while a compaction wrote the new file, the old one is complete and wins.
+    FILE *f = fopen(TMP_PATH, "wb");
+    TEST_ASSERT_NOT_NULL(f);
+    TEST_ASSERT_EQUAL(1, fwrite("DLDB", 4, 1, f));
+    fclose(f);
+    db = new DataBase(DB_PATH, FEAT_LEN);
+    check_feats(*db, live, 4);
+    TEST_ESP_OK(db->compact());
+    TEST_ASSERT_EQUAL(-1, file_size(TMP_PATH));
+    delete db;
+
+    // Power lost in the middle of an enroll record, the partial record is dropped.
+    f = fopen(DB_PATH, "ab");
+    TEST_ASSERT_NOT_NULL(f);
+    database_record record = {DATABASE_RECORD_ENROLL, 5};
+    std::vector<float> feat = make_feat(4);
+    TEST_ASSERT_EQUAL(1, fwrite(&record, sizeof(database_record), 1, f));
+    TEST_ASSERT_EQUAL(FEAT_LEN / 2, fwrite(feat.data(), sizeof(float), FEAT_LEN / 2, f));
+    fclose(f);
+    db = new DataBase(DB_PATH, FEAT_LEN);
+    check_feats(*db, live, 5);
+    TEST_ASSERT_EQUAL(HEADER_SIZE + 4 * ENROLL_SIZE, file_size(DB_PATH));
+    enroll(*db, 4);
+    TEST_ESP_OK(db->delete_feat(5));
+    delete db;
+}
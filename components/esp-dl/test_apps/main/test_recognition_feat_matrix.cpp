@@ -0,0 +1,295 @@
+#include "dl_recognition_feat_matrix.hpp"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "unity.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <list>
+
+using namespace dl;
+using namespace dl::recognition;
+
+static const char *TAG = "test_feat_matrix";
+
+static const int FEAT_LEN = 512;
+static const int NUM_FEATS = 1000;
+static const int NUM_QUERIES = 20;
+// Largest difference to the exact similarity, measured on the host at 512-d: 7e-7 float, 7e-6 int16, 2e-3 int8.
+static const float FLOAT_TOL = 1e-5;
+static const float INT16_TOL = 1e-4;
+static const float INT8_TOL = 4e-3;
+
+static uint32_t s_random_state = 1;
+
+static float random_uniform()
+{
+    s_random_state = s_random_state * 1664525u + 1013904223u;
+    return ((s_random_state >> 8) + 0.5f) / 16777216.f;
+}
+
+/**
+ * L2 normalized gaussian feature, like the output of a face recognition model.
+ */
+static void random_feat(float *feat)
+{
+    float norm = 0;
+    for (int i = 0; i < FEAT_LEN; i++) {
+        feat[i] = sqrtf(-2.f * logf(random_uniform())) * cosf(6.2831853f * random_uniform());
+        norm += feat[i] * feat[i];
+    }
+    norm = 1.f / sqrtf(norm);
+    for (int i = 0; i < FEAT_LEN; i++) {
+        feat[i] *= norm;
+    }
+}
+
+/**
+ * A new capture of an enrolled identity: the enrolled feature plus noise, normalized again.
+ */
+static void noisy_feat(const float *enrolled, float *feat)
+{
+    random_feat(feat);
+    float norm = 0;
+    for (int i = 0; i < FEAT_LEN; i++) {
+        feat[i] = enrolled[i] + 0.5f * feat[i];
+        norm += feat[i] * feat[i];
+    }
+    norm = 1.f / sqrtf(norm);
+    for (int i = 0; i < FEAT_LEN; i++) {
+        feat[i] *= norm;
+    }
+}
+
+static float exact_similarity(const float *a, const float *b)
+{
+    double sum = 0;
+    for (int i = 0; i < FEAT_LEN; i++) {
+        sum += (double)a[i] * b[i];
+    }
+    return sum;
+}
+
+static void make_feats(std::vector<float> &feats, std::vector<float> &queries)
+{
+    feats.resize(NUM_FEATS * FEAT_LEN);
+    for (int i = 0; i < NUM_FEATS; i++) {
+        random_feat(&feats[i * FEAT_LEN]);
+    }
+    // Half of the queries are enrolled identities, half are strangers.
+    queries.resize(NUM_QUERIES * FEAT_LEN);
+    for (int i = 0; i < NUM_QUERIES; i++) {
+        if (i % 2 == 0) {
+            noisy_feat(&feats[(i * 37 % NUM_FEATS) * FEAT_LEN], &queries[i * FEAT_LEN]);
+        } else {
+            random_feat(&queries[i * FEAT_LEN]);
+        }
+    }
+}
+
+TEST_CASE("feat matrix int8 and int16 similarities match float", "[dl_recognition]")
+{
+    std::vector<float> feats, queries;
+    make_feats(feats, queries);
+
+    const dtype_t dtypes[3] = {DATA_TYPE_FLOAT, DATA_TYPE_INT16, DATA_TYPE_INT8};
+    const float tols[3] = {FLOAT_TOL, INT16_TOL, INT8_TOL};
+    for (int t = 0; t < 3; t++) {
+        FeatMatrix matrix(FEAT_LEN, dtypes[t]);
+        for (int i = 0; i < NUM_FEATS; i++) {
+            matrix.push(&feats[i * FEAT_LEN]);
+        }
+        TEST_ASSERT_EQUAL(NUM_FEATS, matrix.size());
+
+        std::vector<result_t> all, top;
+        float max_diff = 0;
+        for (int q = 0; q < NUM_QUERIES; q++) {
+            const float *query = &queries[q * FEAT_LEN];
+            // Every row, in descending similarity.
+            matrix.query(query, -2.f, NUM_FEATS, all);
+            TEST_ASSERT_EQUAL(NUM_FEATS, all.size());
+            for (int i = 0; i < NUM_FEATS; i++) {
+                float exact = exact_similarity(query, &feats[(all[i].id - 1) * FEAT_LEN]);
+                max_diff = std::max(max_diff, fabsf(all[i].similarity - exact));
+                TEST_ASSERT_FLOAT_WITHIN(tols[t], exact, all[i].similarity);
+                if (i > 0) {
+                    TEST_ASSERT_TRUE(all[i - 1].similarity >= all[i].similarity);
+                }
+            }
+            // An enrolled identity stands out by far more than the quantization error.
+            if (q % 2 == 0) {
+                TEST_ASSERT_EQUAL(q * 37 % NUM_FEATS + 1, all[0].id);
+            }
+
+            // The heap keeps the same best rows as the full ranking.
+            matrix.query(query, -2.f, 5, top);
+            TEST_ASSERT_EQUAL(5, top.size());
+            for (int i = 0; i < 5; i++) {
+                TEST_ASSERT_EQUAL(all[i].id, top[i].id);
+                TEST_ASSERT_EQUAL_FLOAT(all[i].similarity, top[i].similarity);
+            }
+        }
+        ESP_LOGI(TAG, "dtype %s: max similarity difference %g", dtype_to_string(dtypes[t]), max_diff);
+    }
+}
+
+TEST_CASE("feat matrix erase, row subsets and top_k", "[dl_recognition]")
+{
+    std::vector<float> feats, queries;
+    make_feats(feats, queries);
+    FeatMatrix matrix(FEAT_LEN, DATA_TYPE_INT8);
+    FeatMatrix float_matrix(FEAT_LEN, DATA_TYPE_FLOAT);
+    for (int i = 0; i < NUM_FEATS; i++) {
+        matrix.push(&feats[i * FEAT_LEN]);
+        float_matrix.push(&feats[i * FEAT_LEN]);
+    }
+    std::vector<result_t> results;
+
+    // top_k <= 0 returns nothing.
+    matrix.query(&queries[0], -2.f, 0, results);
+    TEST_ASSERT_EQUAL(0, results.size());
+    matrix.query(&queries[0], -2.f, -1, results);
+    TEST_ASSERT_EQUAL(0, results.size());
+    int8_t query_int8[FEAT_LEN] = {1};
+    matrix.query(query_int8, 1.f / 127, -2.f, 0, results);
+    TEST_ASSERT_EQUAL(0, results.size());
+
+    // Only the given rows are searched.
+    std::vector<int> rows;
+    for (int i = 1; i < NUM_FEATS; i += 3) {
+        rows.push_back(i);
+    }
+    matrix.query(&queries[0], -2.f, NUM_FEATS, results, &rows);
+    TEST_ASSERT_EQUAL(rows.size(), results.size());
+    for (const result_t &result : results) {
+        TEST_ASSERT_EQUAL(1, (result.id - 1) % 3);
+    }
+
+    // The rows after an erased one move up, with their scales.
+    std::vector<int> erased = {0, 10, 11, 500, NUM_FEATS - 1};
+    matrix.erase(erased);
+    float_matrix.erase(erased);
+    matrix.erase(3);
+    float_matrix.erase(3);
+    std::vector<int> left;
+    for (int i = 0; i < NUM_FEATS; i++) {
+        if (std::find(erased.begin(), erased.end(), i) == erased.end()) {
+            left.push_back(i);
+        }
+    }
+    left.erase(left.begin() + 3);
+    TEST_ASSERT_EQUAL(left.size(), matrix.size());
+    TEST_ASSERT_EQUAL(left.size(), float_matrix.size());
+    std::vector<float> row(FEAT_LEN);
+    for (int i = 0; i < (int)left.size(); i++) {
+        const float *feat = &feats[left[i] * FEAT_LEN];
+        float_matrix.get(i, row.data());
+        TEST_ASSERT_EQUAL_FLOAT(1.f, exact_similarity(feat, row.data()) / exact_similarity(feat, feat));
+        matrix.get(i, row.data());
+        TEST_ASSERT_FLOAT_WITHIN(INT8_TOL, exact_similarity(feat, feat), exact_similarity(feat, row.data()));
+    }
+}
+
+/**
+ * DataBase::query_feat before FeatMatrix: one allocation per feature in a std::list, a scalar dot product per entry
+ * and a sort of all hits.
+ */
+static void legacy_query(
+    const std::list<database_feat> &feats, const float *feat, float thr, int top_k, std::vector<result_t> &results)
+{
+    results.clear();
+    uint32_t i = 1;
+    for (auto it = feats.begin(); it != feats.end(); it++, i++) {
+        float sim = 0;
+        for (int j = 0; j < FEAT_LEN; j++) {
+            sim += it->feat[j] * feat[j];
+        }
+        if (sim <= thr) {
+            continue;
+        }
+        results.push_back({i, sim});
+    }
+    std::sort(results.begin(), results.end(), [](const result_t &a, const result_t &b) -> bool {
+        return a.similarity > b.similarity;
+    });
+    if ((int)results.size() > top_k) {
+        results.resize(top_k);
+    }
+}
+
+TEST_CASE("feat matrix query benchmark", "[dl_recognition][benchmark]")
+{
+    const int nums[] = {1000, 2000, 5000, 10000, 20000, 50000};
+    const int top_k = 5;
+    const float thr = 0.f;
+    std::vector<float> feat(FEAT_LEN);
+    std::vector<float> query(FEAT_LEN);
+    std::vector<result_t> expected, results;
+
+    ESP_LOGI(TAG, "entries  list float (us)  float (us)  int16 (us)  int8 (us)  int8 max diff");
+    for (int num : nums) {
+        // The list and a float matrix growing by doubling are alive at the same time.
+        size_t need = (size_t)num * FEAT_LEN * sizeof(float) * 3;
+        if (heap_caps_get_free_size(MALLOC_CAP_SPIRAM) < need) {
+            ESP_LOGI(TAG, "%7d  skipped, needs %d MB of PSRAM", num, (int)(need >> 20));
+            continue;
+        }
+        s_random_state = num;
+        std::list<database_feat> feats;
+        FeatMatrix float_matrix(FEAT_LEN, DATA_TYPE_FLOAT);
+        FeatMatrix int16_matrix(FEAT_LEN, DATA_TYPE_INT16);
+        FeatMatrix int8_matrix(FEAT_LEN, DATA_TYPE_INT8);
+        FeatMatrix *matrices[3] = {&float_matrix, &int16_matrix, &int8_matrix};
+        for (int i = 0; i < num; i++) {
+            random_feat(feat.data());
+            float *copy = (float *)heap_caps_malloc(FEAT_LEN * sizeof(float), MALLOC_CAP_SPIRAM);
+            TEST_ASSERT_NOT_NULL(copy);
+            memcpy(copy, feat.data(), FEAT_LEN * sizeof(float));
+            feats.push_back({(uint32_t)i + 1, copy});
+            for (FeatMatrix *matrix : matrices) {
+                matrix->push(feat.data());
+            }
+        }
+        noisy_feat(feats.front().feat, query.data());
+
+        int64_t start = esp_timer_get_time();
+        legacy_query(feats, query.data(), thr, top_k, expected);
+        int64_t times[4] = {esp_timer_get_time() - start};
+        float max_diff = 0;
+        for (int t = 0; t < 3; t++) {
+            start = esp_timer_get_time();
+            matrices[t]->query(query.data(), thr, top_k, results);
+            times[t + 1] = esp_timer_get_time() - start;
+
+            TEST_ASSERT_EQUAL(expected.size(), results.size());
+            TEST_ASSERT_EQUAL(expected[0].id, results[0].id);
+            for (int i = 0; i < (int)results.size(); i++) {
+                if (t == 0) {
+                    // Same products summed in the same order.
+                    TEST_ASSERT_EQUAL(expected[i].id, results[i].id);
+                    TEST_ASSERT_EQUAL_FLOAT(expected[i].similarity, results[i].similarity);
+                } else {
+                    // Near-equal neighbours may swap ranks, the scores still agree.
+                    TEST_ASSERT_FLOAT_WITHIN(
+                        t == 1 ? INT16_TOL : INT8_TOL, expected[i].similarity, results[i].similarity);
+                    if (t == 2) {
+                        max_diff = std::max(max_diff, fabsf(expected[i].similarity - results[i].similarity));
+                    }
+                }
+            }
+        }
+        ESP_LOGI(TAG,
+                 "%7d  %15lld  %10lld  %10lld  %9lld  %13g",
+                 num,
+                 (long long)times[0],
+                 (long long)times[1],
+                 (long long)times[2],
+                 (long long)times[3],
+                 max_diff);
+
+        for (database_feat &f : feats) {
+            heap_caps_free(f.feat);
+        }
+    }
+}
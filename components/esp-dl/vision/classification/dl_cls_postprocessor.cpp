@@ -0,0 +1,123 @@
+#include "dl_cls_postprocessor.hpp"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+namespace dl {
+namespace cls {
+ClsPostprocessor::ClsPostprocessor(
+    Model *model, const int top_k, const float score_thr, bool need_softmax, const std::string &output_name) :
+    m_top_k(top_k),
+    m_score_thr(score_thr),
+    m_need_softmax(need_softmax),
+    m_softmax_module(nullptr),
+    m_exp_table_exponent(INT_MAX)
+{
+    m_model_output = model->get_output(output_name);
+    m_output = new dl::TensorBase(m_model_output->shape, nullptr, 0, dl::DATA_TYPE_FLOAT);
+    if (need_softmax) {
+        m_softmax_module = new dl::module::Softmax(nullptr, -1, dl::MODULE_NON_INPLACE, dl::QUANT_TYPE_SYMM_8BIT);
+    }
+}
+
+ClsPostprocessor::~ClsPostprocessor()
+{
+    delete m_output;
+    delete m_softmax_module;
+}
+
+template <typename T>
+void ClsPostprocessor::postprocess_topk()
+{
+    T *logits = (T *)m_model_output->data;
+    int size = m_model_output->get_size();
+    int exponent = m_model_output->exponent;
+    float scale = DL_SCALE(exponent);
+
+    // Softmax is monotonic, the top k logits are the top k scores. A negative top_k keeps every category, as the
+    // float path does.
+    int k = m_top_k < 0 ? size : DL_MIN(m_top_k, size);
+    m_cls_result.clear();
+    if (k <= 0) {
+        return;
+    }
+    m_index.resize(size);
+    for (int i = 0; i < size; i++) {
+        m_index[i] = i;
+    }
+    std::partial_sort(m_index.begin(), m_index.begin() + k, m_index.end(), [logits](int a, int b) {
+        return logits[a] > logits[b] || (logits[a] == logits[b] && a < b);
+    });
+
+    // Normalizer of softmax, sum(exp((x - max) * scale)).
+    int max_logit = *std::max_element(logits, logits + size);
+    float sum = 0.f;
+    if (m_need_softmax) {
+        if (sizeof(T) == 1) {
+            if (m_exp_table_exponent != exponent) {
+                for (int d = 0; d < 256; d++) {
+                    m_exp_table[d] = expf(-d * scale);
+                }
+                m_exp_table_exponent = exponent;
+            }
+            for (int i = 0; i < size; i++) {
+                sum += m_exp_table[max_logit - logits[i]];
+            }
+        } else {
+            for (int i = 0; i < size; i++) {
+                sum += expf((logits[i] - max_logit) * scale);
+            }
+        }
+    }
+
+    for (int i = 0; i < k; i++) {
+        int index = m_index[i];
+        float score;
+        if (!m_need_softmax) {
+            score = dequantize(logits[index], scale);
+        } else if (sizeof(T) == 1) {
+            score = m_exp_table[max_logit - logits[index]] / sum;
+        } else {
+            score = expf((logits[index] - max_logit) * scale) / sum;
+        }
+        if (score <= m_score_thr) {
+            break;
+        }
+        m_cls_result.push_back({m_cat_names[index], score});
+    }
+}
+
+std::vector<dl::cls::result_t> &ClsPostprocessor::postprocess()
+{
+    if (m_model_output->dtype == DATA_TYPE_INT8) {
+        postprocess_topk<int8_t>();
+        return m_cls_result;
+    } else if (m_model_output->dtype == DATA_TYPE_INT16) {
+        postprocess_topk<int16_t>();
+        return m_cls_result;
+    }
+
+    if (m_need_softmax) {
+        m_softmax_module->run(m_model_output, m_output);
+    } else {
+        m_output->assign(m_model_output);
+    }
+
+    m_cls_result.clear();
+    float *output_ptr = (float *)m_output->data;
+    for (int i = 0; i < m_output->get_size(); i++) {
+        if (*output_ptr > m_score_thr) {
+            m_cls_result.emplace_back(m_cat_names[i], *output_ptr);
+        }
+        output_ptr++;
+    }
+    std::sort(
+        m_cls_result.begin(), m_cls_result.end(), [](result_t &a, result_t &b) -> bool { return a.score > b.score; });
+    if (m_cls_result.size() > m_top_k) {
+        m_cls_result.resize(m_top_k);
+    }
+    return m_cls_result;
+}
+
+} // namespace cls
+} // namespace dl
@@ -18,6 +18,12 @@ protected:
     const char **m_cat_names;
 
 private:
+    /**
+     * @brief Top-k on the quantized logits, softmax is only evaluated for the selected categories.
+     */
+    template <typename T>
+    void postprocess_topk();
+
     TensorBase *m_model_output;
     int m_top_k;
     float m_score_thr;
@@ -25,6 +31,9 @@ private:
     dl::module::Softmax *m_softmax_module;
     TensorBase *m_output;
     std::vector<result_t> m_cls_result;
+    std::vector<int> m_index;   /*!< category indices, the first top_k of them are the selected ones */
+    float m_exp_table[256];     /*!< int8: exp(-d * scale) for d = max - logit in [0, 255] */
+    int m_exp_table_exponent;   /*!< exponent m_exp_table was built for */
 };
 } // namespace cls
 } // namespace dl
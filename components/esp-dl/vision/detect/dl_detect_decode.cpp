@@ -0,0 +1,101 @@
+#include "dl_detect_decode.hpp"
+#include "dl_math.hpp"
+#include "dl_tensor_base.hpp"
+#include <cmath>
+
+namespace dl {
+namespace detect {
+template <typename T>
+void filter_score_map(const T *score, int num_cells, int num_class, int score_thr, std::vector<score_hit_t> &hits)
+{
+    hits.clear();
+    if (num_class == 1) {
+        for (int i = 0; i < num_cells; i++) {
+            if (score[i] > score_thr) {
+                hits.push_back({i, 0});
+            }
+        }
+        return;
+    }
+
+    for (int i = 0; i < num_cells; i++) {
+        const T *row = score + i * num_class;
+        T max_score = row[0];
+        for (int c = 1; c < num_class; c++) {
+            max_score = DL_MAX(max_score, row[c]);
+        }
+        if (max_score <= score_thr) {
+            continue;
+        }
+        for (int c = 0; c < num_class; c++) {
+            if (row[c] > score_thr) {
+                hits.push_back({i, c});
+            }
+        }
+    }
+}
+
+template void filter_score_map<int8_t>(
+    const int8_t *score, int num_cells, int num_class, int score_thr, std::vector<score_hit_t> &hits);
+template void filter_score_map<int16_t>(
+    const int16_t *score, int num_cells, int num_class, int score_thr, std::vector<score_hit_t> &hits);
+
+void SigmoidLUT::set_exponent(int exponent)
+{
+    if (m_init && exponent == m_exponent) {
+        return;
+    }
+    m_exponent = exponent;
+    m_scale = DL_SCALE(exponent);
+    for (int i = 0; i < 256; i++) {
+        m_table[i] = dl::math::sigmoid(dequantize((int8_t)(i - 128), m_scale));
+    }
+    m_init = true;
+}
+
+float SigmoidLUT::operator()(int16_t x) const
+{
+    return dl::math::sigmoid(dequantize(x, m_scale));
+}
+
+void DFLDecoder::set_exponent(int exponent, int reg_max)
+{
+    assert(reg_max > 0 && reg_max <= MAX_REG_MAX);
+    m_reg_max = reg_max;
+    if (m_init && exponent == m_exponent) {
+        return;
+    }
+    m_exponent = exponent;
+    m_scale = DL_SCALE(exponent);
+    for (int i = 0; i < 256; i++) {
+        m_table[i] = (uint16_t)lroundf(65535.f * expf(-i * m_scale));
+    }
+    m_init = true;
+}
+
+float DFLDecoder::integral(const int8_t *x) const
+{
+    int max_x = x[0];
+    for (int i = 1; i < m_reg_max; i++) {
+        max_x = DL_MAX(max_x, x[i]);
+    }
+    uint32_t sum = 0;
+    uint32_t weighted_sum = 0;
+    for (int i = 0; i < m_reg_max; i++) {
+        uint32_t w = m_table[max_x - x[i]];
+        sum += w;
+        weighted_sum += w * i;
+    }
+    return (float)weighted_sum / sum;
+}
+
+float DFLDecoder::integral(const int16_t *x) const
+{
+    float data[MAX_REG_MAX];
+    for (int i = 0; i < m_reg_max; i++) {
+        data[i] = dequantize(x[i], m_scale);
+    }
+    return dl::math::dfl_integral(data, m_reg_max - 1);
+}
+} // namespace detect
+} // namespace dl
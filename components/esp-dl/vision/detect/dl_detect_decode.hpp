@@ -0,0 +1,87 @@
+#pragma once
+#include "dl_define.hpp"
+#include <stdint.h>
+#include <vector>
+
+namespace dl {
+namespace detect {
+/**
+ * @brief A score map element that passed the threshold.
+ */
+typedef struct {
+    int cell;     /*!< y * W + x of the feature map cell */
+    int category; /*!< category index */
+} score_hit_t;
+
+/**
+ * @brief Collect all elements of a quantized [H * W, C] score map that are greater than score_thr.
+ *
+ * The maximum over the categories of a cell is computed first with a branch-free loop that the compiler can
+ * vectorize, the categories are only visited one by one for cells whose maximum passes the threshold. Hits are
+ * appended in memory order, so the hits of one cell are adjacent.
+ *
+ * @param score      score map
+ * @param num_cells  H * W
+ * @param num_class  C
+ * @param score_thr  quantized threshold, elements equal to it are filtered
+ * @param hits       output hits, cleared first
+ */
+template <typename T>
+void filter_score_map(const T *score, int num_cells, int num_class, int score_thr, std::vector<score_hit_t> &hits);
+
+/**
+ * @brief sigmoid(dequantize(x)) for a fixed exponent. int8 input is a 256-entry table lookup.
+ */
+class SigmoidLUT {
+private:
+    float m_table[256];
+    int m_exponent;
+    float m_scale;
+    bool m_init;
+
+public:
+    SigmoidLUT() : m_exponent(0), m_scale(1.f), m_init(false) {}
+
+    /**
+     * @brief Rebuild the table if the exponent changed.
+     */
+    void set_exponent(int exponent);
+
+    float operator()(int8_t x) const { return m_table[x + 128]; }
+    float operator()(int16_t x) const;
+};
+
+/**
+ * @brief Distribution focal loss integral, sum(i * softmax(x)[i]), on quantized logits.
+ *
+ * For int8 logits softmax(x)[i] is proportional to exp((x[i] - max) * scale) with max - x[i] in [0, 255], so the
+ * weights come from a 256-entry Q16 table and accumulate in integers. Only one float division is left per side.
+ * int16 logits fall back to dl::math::dfl_integral.
+ */
+class DFLDecoder {
+public:
+    static const int MAX_REG_MAX = 32; /*!< upper bound of reg_max */
+
+private:
+    uint16_t m_table[256];
+    int m_exponent;
+    float m_scale;
+    int m_reg_max;
+    bool m_init;
+
+public:
+    DFLDecoder() : m_exponent(0), m_scale(1.f), m_reg_max(16), m_init(false) {}
+
+    /**
+     * @brief Rebuild the table if the exponent changed.
+     *
+     * @param exponent exponent of the box logits
+     * @param reg_max  number of bins of one side, at most MAX_REG_MAX
+     */
+    void set_exponent(int exponent, int reg_max);
+
+    float integral(const int8_t *x) const;
+    float integral(const int16_t *x) const;
+};
+} // namespace detect
+} // namespace dl
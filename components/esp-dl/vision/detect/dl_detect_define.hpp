@@ -20,11 +20,9 @@ typedef struct {
     }
     void limit_keypoint(int width, int height)
     {
-        for (int i = 0; i < keypoint.size(); i++) {
-            if (i % 2 == 0)
-                keypoint[i] = DL_CLIP(keypoint[i], 0, width - 1);
-            else
-                keypoint[i] = DL_CLIP(keypoint[i], 0, height - 1);
+        for (int i = 0; i + 1 < (int)keypoint.size(); i += 2) {
+            keypoint[i] = DL_CLIP(keypoint[i], 0, width - 1);
+            keypoint[i + 1] = DL_CLIP(keypoint[i + 1], 0, height - 1);
         }
     }
     int box_area() const { return (box[2] - box[0]) * (box[3] - box[1]); }
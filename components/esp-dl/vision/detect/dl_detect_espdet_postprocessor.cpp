@@ -22,38 +22,30 @@ void ESPDetPostProcessor::parse_stage(TensorBase *score, TensorBase *box, const
     T *box_ptr = (T *)box->data;
     float score_exp = DL_SCALE(score->exponent);
     float box_exp = DL_SCALE(box->exponent);
-    T score_thr_quant = quantize<T>(dl::math::inverse_sigmoid(m_score_thr), 1.f / score_exp);
+    // Boxes with score equal to the threshold are kept.
+    int score_thr_quant = quantize<T>(dl::math::inverse_sigmoid(m_score_thr), 1.f / score_exp) - 1;
     float inv_resize_scale_x = 1.f / m_resize_scale_x;
     float inv_resize_scale_y = 1.f / m_resize_scale_y;
 
-    for (size_t y = 0; y < H; y++) {
-        for (size_t x = 0; x < W; x++) {
-            for (size_t c = 0; c < C; c++) {
-                if (*score_ptr >= score_thr_quant) {
-                    int center_y = y * stride_y + offset_y;
-                    int center_x = x * stride_x + offset_x;
+    m_sigmoid.set_exponent(score->exponent);
 
-                    float box_data[4];
-                    for (int i = 0; i < 4; i++) {
-                        box_data[i] = dequantize(box_ptr[i], box_exp);
-                    }
+    // Find the survivors first, then decode the box of each surviving cell once for all of its categories.
+    filter_score_map(score_ptr, H * W, C, score_thr_quant, m_hits);
 
-                    result_t new_box = {(int)c,
-                                        dl::math::sigmoid(dequantize(*score_ptr, score_exp)),
-                                        {(int)((center_x - box_data[0] * stride_x) * inv_resize_scale_x),
-                                         (int)((center_y - box_data[1] * stride_y) * inv_resize_scale_y),
-                                         (int)((center_x + box_data[2] * stride_x) * inv_resize_scale_x),
-                                         (int)((center_y + box_data[3] * stride_y) * inv_resize_scale_y)},
-                                        {}};
-
-                    m_box_list.insert(std::upper_bound(m_box_list.begin(), m_box_list.end(), new_box, greater_box),
-                                      new_box);
-                }
-                score_ptr++;
-            }
-
-            box_ptr += 4;
+    int last_cell = -1;
+    int new_box[4];
+    for (const score_hit_t &hit : m_hits) {
+        if (hit.cell != last_cell) {
+            int center_y = (hit.cell / W) * stride_y + offset_y;
+            int center_x = (hit.cell % W) * stride_x + offset_x;
+            const T *box_data = box_ptr + hit.cell * 4;
+            new_box[0] = (int)((center_x - dequantize(box_data[0], box_exp) * stride_x) * inv_resize_scale_x);
+            new_box[1] = (int)((center_y - dequantize(box_data[1], box_exp) * stride_y) * inv_resize_scale_y);
+            new_box[2] = (int)((center_x + dequantize(box_data[2], box_exp) * stride_x) * inv_resize_scale_x);
+            new_box[3] = (int)((center_y + dequantize(box_data[3], box_exp) * stride_y) * inv_resize_scale_y);
+            last_cell = hit.cell;
         }
+        m_candidates.push(hit.category, m_sigmoid(score_ptr[hit.cell * C + hit.category]), new_box);
     }
 }
 
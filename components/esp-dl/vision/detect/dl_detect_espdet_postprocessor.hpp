@@ -1,10 +1,14 @@
 #pragma once
+#include "dl_detect_decode.hpp"
 #include "dl_detect_postprocessor.hpp"
 
 namespace dl {
 namespace detect {
 class ESPDetPostProcessor : public AnchorPointDetectPostprocessor {
 private:
+    std::vector<score_hit_t> m_hits;
+    SigmoidLUT m_sigmoid;
+
     template <typename T>
     void parse_stage(TensorBase *score, TensorBase *box, const int stage_index);
 
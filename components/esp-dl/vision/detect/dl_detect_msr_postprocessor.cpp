@@ -41,23 +41,16 @@ void MSRPostprocessor::parse_stage(TensorBase *score, TensorBase *box, const int
                         int center_x = x * stride_x + offset_x;
                         int anchor_h = anchor_shape[a][0];
                         int anchor_w = anchor_shape[a][1];
-                        result_t new_box = {
-                            (int)c,
-                            dl::math::sigmoid(dequantize(*score_ptr, score_exp)),
-                            {(int)((center_x - (anchor_w >> 1) + anchor_w * dequantize(box_ptr[0], box_exp)) *
-                                   inv_resize_scale_x),
-                             (int)((center_y - (anchor_h >> 1) + anchor_h * dequantize(box_ptr[1], box_exp)) *
-                                   inv_resize_scale_y),
-                             (int)((center_x + anchor_w - (anchor_w >> 1) +
-                                    anchor_w * dequantize(box_ptr[2], box_exp)) *
-                                   inv_resize_scale_x),
-                             (int)((center_y + anchor_h - (anchor_h >> 1) +
-                                    anchor_h * dequantize(box_ptr[3], box_exp)) *
-                                   inv_resize_scale_y)},
-                            {}};
-
-                        m_box_list.insert(std::upper_bound(m_box_list.begin(), m_box_list.end(), new_box, greater_box),
-                                          new_box);
+                        int new_box[4] = {
+                            (int)((center_x - (anchor_w >> 1) + anchor_w * dequantize(box_ptr[0], box_exp)) *
+                                  inv_resize_scale_x),
+                            (int)((center_y - (anchor_h >> 1) + anchor_h * dequantize(box_ptr[1], box_exp)) *
+                                  inv_resize_scale_y),
+                            (int)((center_x + anchor_w - (anchor_w >> 1) + anchor_w * dequantize(box_ptr[2], box_exp)) *
+                                  inv_resize_scale_x),
+                            (int)((center_y + anchor_h - (anchor_h >> 1) + anchor_h * dequantize(box_ptr[3], box_exp)) *
+                                  inv_resize_scale_y)};
+                        m_candidates.push(c, dl::math::sigmoid(dequantize(*score_ptr, score_exp)), new_box);
                     }
                     score_ptr++;
                     box_ptr += 4;
@@ -0,0 +1,382 @@
+#include "dl_detect_nms.hpp"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+namespace dl {
+namespace detect {
+void DetectCandidates::reserve(int n)
+{
+    score.reserve(n);
+    category.reserve(n);
+    x1.reserve(n);
+    y1.reserve(n);
+    x2.reserve(n);
+    y2.reserve(n);
+    area.reserve(n);
+}
+
+void DetectCandidates::clear()
+{
+    score.clear();
+    category.clear();
+    x1.clear();
+    y1.clear();
+    x2.clear();
+    y2.clear();
+    area.clear();
+    keypoint.clear();
+    keypoint_num = 0;
+}
+
+void DetectCandidates::push(int category_, float score_, const int *box, const int *keypoint_, int keypoint_num_)
+{
+    score.push_back(score_);
+    category.push_back(category_);
+    x1.push_back(box[0]);
+    y1.push_back(box[1]);
+    x2.push_back(box[2]);
+    y2.push_back(box[3]);
+    area.push_back((box[2] - box[0] + 1) * (box[3] - box[1] + 1));
+    if (keypoint_num_ > 0) {
+        keypoint_num = keypoint_num_;
+        keypoint.insert(keypoint.end(), keypoint_, keypoint_ + keypoint_num_);
+    }
+}
+
+result_t DetectCandidates::to_result(int index) const
+{
+    result_t res = {category[index], score[index], {x1[index], y1[index], x2[index], y2[index]}, {}};
+    if (keypoint_num > 0) {
+        res.keypoint.assign(keypoint.begin() + index * keypoint_num, keypoint.begin() + (index + 1) * keypoint_num);
+    }
+    return res;
+}
+
+/**
+ * @brief Heap order: higher score first, on equal score the earlier pushed candidate first. This is the same order
+ * std::upper_bound insertion used to produce.
+ */
+struct candidate_less {
+    const float *score;
+    bool operator()(int a, int b) const { return score[a] < score[b] || (score[a] == score[b] && a > b); }
+};
+
+void NMS::sort(const DetectCandidates &candidates, std::vector<int> &order)
+{
+    order.resize(candidates.size());
+    for (int i = 0; i < candidates.size(); i++) {
+        order[i] = i;
+    }
+    candidate_less less = {candidates.score.data()};
+    std::sort(order.begin(), order.end(), [&less](int a, int b) { return less(b, a); });
+}
+
+void NMS::build_grid(const DetectCandidates &candidates, const std::vector<int> &indices)
+{
+    // Only the considered candidates, the other half of a dual core run may be writing fused boxes into the rest.
+    int min_x = INT_MAX;
+    int min_y = INT_MAX;
+    int max_x = INT_MIN;
+    int max_y = INT_MIN;
+    for (int i : indices) {
+        min_x = DL_MIN(min_x, candidates.x1[i]);
+        min_y = DL_MIN(min_y, candidates.y1[i]);
+        max_x = DL_MAX(max_x, candidates.x2[i]);
+        max_y = DL_MAX(max_y, candidates.y2[i]);
+    }
+
+    m_grid_x0 = min_x;
+    m_grid_y0 = min_y;
+    m_cell_w = DL_MAX((max_x - min_x + GRID_SIZE) / GRID_SIZE, 1);
+    m_cell_h = DL_MAX((max_y - min_y + GRID_SIZE) / GRID_SIZE, 1);
+
+    m_cells.resize(GRID_SIZE * GRID_SIZE);
+    for (std::vector<int> &cell : m_cells) {
+        cell.clear();
+    }
+}
+
+void NMS::grid_range(int x1, int y1, int x2, int y2, int &cx1, int &cy1, int &cx2, int &cy2) const
+{
+    cx1 = DL_CLIP((x1 - m_grid_x0) / m_cell_w, 0, GRID_SIZE - 1);
+    cy1 = DL_CLIP((y1 - m_grid_y0) / m_cell_h, 0, GRID_SIZE - 1);
+    cx2 = DL_CLIP((x2 - m_grid_x0) / m_cell_w, 0, GRID_SIZE - 1);
+    cy2 = DL_CLIP((y2 - m_grid_y0) / m_cell_h, 0, GRID_SIZE - 1);
+}
+
+void NMS::add_kept(const DetectCandidates &candidates, int index)
+{
+    int pos = m_kept.size();
+    m_kept.push_back(index);
+    m_visited.push_back(-1);
+
+    if (m_use_grid) {
+        int cx1, cy1, cx2, cy2;
+        grid_range(
+            candidates.x1[index], candidates.y1[index], candidates.x2[index], candidates.y2[index], cx1, cy1, cx2, cy2);
+        for (int cy = cy1; cy <= cy2; cy++) {
+            for (int cx = cx1; cx <= cx2; cx++) {
+                m_cells[cy * GRID_SIZE + cx].push_back(pos);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Call f(pos) for every kept box at position >= from that may overlap the candidate, until f returns true.
+ */
+template <typename F>
+void NMS::for_each_kept(const DetectCandidates &candidates, int index, int from, F f)
+{
+    if (!m_use_grid) {
+        for (int pos = from; pos < (int)m_kept.size(); pos++) {
+            if (f(pos)) {
+                return;
+            }
+        }
+        return;
+    }
+
+    int cx1, cy1, cx2, cy2;
+    grid_range(
+        candidates.x1[index], candidates.y1[index], candidates.x2[index], candidates.y2[index], cx1, cy1, cx2, cy2);
+    for (int cy = cy1; cy <= cy2; cy++) {
+        for (int cx = cx1; cx <= cx2; cx++) {
+            for (int pos : m_cells[cy * GRID_SIZE + cx]) {
+                if (pos < from || m_visited[pos] == index) {
+                    continue;
+                }
+                m_visited[pos] = index;
+                if (f(pos)) {
+                    return;
+                }
+            }
+        }
+    }
+}
+
+void NMS::run(DetectCandidates &candidates,
+              const nms_config_t &config,
+              std::vector<int> &keep,
+              const std::vector<int> *subset)
+{
+    int max_keep = DL_MAX(config.top_k, 1);
+    keep.clear();
+    m_kept.clear();
+    m_visited.clear();
+    m_cluster.clear();
+
+    if (subset) {
+        m_heap = *subset;
+    } else {
+        m_heap.resize(candidates.size());
+        for (int i = 0; i < candidates.size(); i++) {
+            m_heap[i] = i;
+        }
+    }
+    if (m_heap.empty()) {
+        return;
+    }
+
+    candidate_less less = {candidates.score.data()};
+    std::make_heap(m_heap.begin(), m_heap.end(), less);
+
+    m_use_grid = m_heap.size() >= GRID_MIN_NUM;
+    if (m_use_grid) {
+        build_grid(candidates, m_heap);
+    }
+    if (config.mode == NMS_MODE_SOFT) {
+        m_applied.assign(candidates.size(), 0);
+    }
+
+    const int *category = candidates.category.data();
+    float *score = candidates.score.data();
+    std::vector<int>::iterator heap_end = m_heap.end();
+    while (heap_end != m_heap.begin() && (int)m_kept.size() < max_keep) {
+        std::pop_heap(m_heap.begin(), heap_end, less);
+        int index = *(heap_end - 1);
+
+        if (config.mode == NMS_MODE_SOFT) {
+            // Decay by the boxes kept since this candidate was last evaluated.
+            for_each_kept(candidates, index, m_applied[index], [&](int pos) {
+                int kept = m_kept[pos];
+                if (!config.class_aware || category[kept] == category[index]) {
+                    float iou = candidate_iou(candidates, kept, index);
+                    if (iou > 0) {
+                        score[index] *= expf(-iou * iou / config.sigma);
+                    }
+                }
+                return false;
+            });
+            m_applied[index] = m_kept.size();
+
+            if (score[index] < config.score_thr) {
+                heap_end--;
+                continue;
+            }
+            // The stored scores in the heap are upper bounds, push back if another box may be ahead now.
+            if (heap_end - 1 != m_heap.begin() && less(index, m_heap[0])) {
+                std::push_heap(m_heap.begin(), heap_end, less);
+                continue;
+            }
+            heap_end--;
+            add_kept(candidates, index);
+            continue;
+        }
+
+        heap_end--;
+        bool suppressed = false;
+        for_each_kept(candidates, index, 0, [&](int pos) {
+            int kept = m_kept[pos];
+            if (config.class_aware && category[kept] != category[index]) {
+                return false;
+            }
+            float iou = candidate_iou(candidates, kept, index);
+            if (iou <= config.iou_thr) {
+                return false;
+            }
+            suppressed = true;
+            if (config.mode != NMS_MODE_CLUSTER) {
+                return true;
+            }
+            // Every kept box of the cluster takes its share of the removed box.
+            float w = score[index] * iou;
+            float *cluster = &m_cluster[pos * 5];
+            cluster[0] += w;
+            cluster[1] += w * candidates.x1[index];
+            cluster[2] += w * candidates.y1[index];
+            cluster[3] += w * candidates.x2[index];
+            cluster[4] += w * candidates.y2[index];
+            return false;
+        });
+        if (suppressed) {
+            continue;
+        }
+
+        add_kept(candidates, index);
+        if (config.mode == NMS_MODE_CLUSTER) {
+            float w = score[index];
+            m_cluster.insert(m_cluster.end(),
+                             {w,
+                              w * candidates.x1[index],
+                              w * candidates.y1[index],
+                              w * candidates.x2[index],
+                              w * candidates.y2[index]});
+        }
+    }
+
+    if (config.mode == NMS_MODE_CLUSTER) {
+        for (int pos = 0; pos < (int)m_kept.size(); pos++) {
+            int index = m_kept[pos];
+            const float *cluster = &m_cluster[pos * 5];
+            float inv_w = 1.f / cluster[0];
+            candidates.x1[index] = (int)lroundf(cluster[1] * inv_w);
+            candidates.y1[index] = (int)lroundf(cluster[2] * inv_w);
+            candidates.x2[index] = (int)lroundf(cluster[3] * inv_w);
+            candidates.y2[index] = (int)lroundf(cluster[4] * inv_w);
+            candidates.area[index] = (candidates.x2[index] - candidates.x1[index] + 1) *
+                (candidates.y2[index] - candidates.y1[index] + 1);
+        }
+    }
+    keep = m_kept;
+}
+
+typedef struct {
+    NMS *nms;
+    DetectCandidates *candidates;
+    const nms_config_t *config;
+    std::vector<int> *keep;
+    const std::vector<int> *subset;
+    SemaphoreHandle_t semaphore;
+} nms_task_data_t;
+
+static void nms_task(void *args)
+{
+    nms_task_data_t *task = (nms_task_data_t *)args;
+    task->nms->run(*task->candidates, *task->config, *task->keep, task->subset);
+    xSemaphoreGive(task->semaphore);
+    vTaskSuspend(NULL);
+}
+
+void nms_class_aware_dual_core(NMS *nms,
+                               DetectCandidates &candidates,
+                               const nms_config_t &config,
+                               std::vector<int> &keep)
+{
+    nms_config_t class_config = config;
+    class_config.class_aware = true;
+
+#if !CONFIG_FREERTOS_UNICORE
+    int num_class = 0;
+    for (int c : candidates.category) {
+        num_class = DL_MAX(num_class, c + 1);
+    }
+
+    // Assign the categories, largest first, to the half with fewer candidates.
+    std::vector<int> count(num_class, 0);
+    for (int c : candidates.category) {
+        count[c]++;
+    }
+    std::vector<int> classes(num_class);
+    for (int c = 0; c < num_class; c++) {
+        classes[c] = c;
+    }
+    std::sort(classes.begin(), classes.end(), [&count](int a, int b) { return count[a] > count[b]; });
+    std::vector<int> half(num_class, 0);
+    int load[2] = {0, 0};
+    for (int c : classes) {
+        half[c] = load[0] <= load[1] ? 0 : 1;
+        load[half[c]] += count[c];
+    }
+
+    if (load[0] > 0 && load[1] > 0) {
+        std::vector<int> subset[2];
+        subset[0].reserve(load[0]);
+        subset[1].reserve(load[1]);
+        for (int i = 0; i < candidates.size(); i++) {
+            subset[half[candidates.category[i]]].push_back(i);
+        }
+
+        std::vector<int> keep_half[2];
+        BaseType_t current_core_id = xPortGetCoreID();
+        UBaseType_t current_priority = uxTaskPriorityGet(xTaskGetCurrentTaskHandle());
+        SemaphoreHandle_t semaphore = xSemaphoreCreateCounting(1, 0);
+        TaskHandle_t task_handle;
+        nms_task_data_t task_data = {&nms[1], &candidates, &class_config, &keep_half[1], &subset[1], semaphore};
+        bool task_created = semaphore &&
+            xTaskCreatePinnedToCore(
+                nms_task, NULL, 4096, &task_data, current_priority, &task_handle, (current_core_id + 1) % 2) == pdPASS;
+        nms[0].run(candidates, class_config, keep_half[0], &subset[0]);
+        if (task_created) {
+            xSemaphoreTake(semaphore, portMAX_DELAY);
+            vTaskDelete(task_handle);
+        } else {
+            // No heap for the task, run the other half on this core.
+            nms[1].run(candidates, class_config, keep_half[1], &subset[1]);
+        }
+        if (semaphore) {
+            vSemaphoreDelete(semaphore);
+        }
+
+        candidate_less less = {candidates.score.data()};
+        keep.resize(keep_half[0].size() + keep_half[1].size());
+        std::merge(keep_half[0].begin(),
+                   keep_half[0].end(),
+                   keep_half[1].begin(),
+                   keep_half[1].end(),
+                   keep.begin(),
+                   [&less](int a, int b) { return less(b, a); });
+        if ((int)keep.size() > DL_MAX(config.top_k, 1)) {
+            keep.resize(DL_MAX(config.top_k, 1));
+        }
+        return;
+    }
+#endif
+    nms[0].run(candidates, class_config, keep);
+}
+} // namespace detect
+} // namespace dl
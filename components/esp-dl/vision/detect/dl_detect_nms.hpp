@@ -0,0 +1,163 @@
+#pragma once
+#include "dl_detect_define.hpp"
+#include <vector>
+
+namespace dl {
+namespace detect {
+/**
+ * @brief Contiguous structure-of-arrays store of detection candidates.
+ *
+ * Postprocessors push every box that passes the score threshold here instead of keeping a sorted std::list. The
+ * ordering is only established by NMS, which touches at most top_k boxes of it.
+ */
+class DetectCandidates {
+public:
+    std::vector<float> score;  /*!< score of each candidate */
+    std::vector<int> category; /*!< category index of each candidate */
+    std::vector<int> x1;       /*!< left_up_x of each candidate */
+    std::vector<int> y1;       /*!< left_up_y of each candidate */
+    std::vector<int> x2;       /*!< right_down_x of each candidate */
+    std::vector<int> y2;       /*!< right_down_y of each candidate */
+    std::vector<int> area;     /*!< (x2 - x1 + 1) * (y2 - y1 + 1), computed once when pushed */
+    std::vector<int> keypoint; /*!< keypoint_num values per candidate, [x1, y1, x2, y2, ...] */
+    int keypoint_num;          /*!< number of keypoint values of each candidate */
+
+    DetectCandidates() : keypoint_num(0) {}
+
+    /**
+     * @brief Reserve memory for n candidates so that pushing does not reallocate.
+     */
+    void reserve(int n);
+
+    /**
+     * @brief Remove all candidates, the allocated memory is kept for the next frame.
+     */
+    void clear();
+
+    int size() const { return score.size(); }
+
+    /**
+     * @brief Append a candidate.
+     *
+     * @param category_     category index
+     * @param score_        score of box
+     * @param box           [left_up_x, left_up_y, right_down_x, right_down_y]
+     * @param keypoint_     keypoints of box, can be nullptr if keypoint_num_ is 0
+     * @param keypoint_num_ number of keypoint values, must be the same for every candidate of one frame
+     */
+    void push(int category_, float score_, const int *box, const int *keypoint_ = nullptr, int keypoint_num_ = 0);
+
+    /**
+     * @brief Convert the candidate at index into a result_t.
+     */
+    result_t to_result(int index) const;
+};
+
+typedef enum {
+    NMS_MODE_HARD,    /*!< greedy hard NMS, overlapping boxes are removed */
+    NMS_MODE_SOFT,    /*!< gaussian Soft-NMS, overlapping boxes decay their score by exp(-iou^2 / sigma) */
+    NMS_MODE_CLUSTER, /*!< hard NMS, every kept box becomes the score * IoU weighted mean of the boxes it removed */
+} nms_mode_t;
+
+typedef struct {
+    nms_mode_t mode;  /*!< NMS algorithm */
+    bool class_aware; /*!< true: only boxes of the same category interact, false: class agnostic */
+    float iou_thr;    /*!< hard / cluster: boxes with higher IoU than iou_thr to a kept box are removed */
+    int top_k;        /*!< keep at most top_k boxes */
+    float score_thr;  /*!< soft: boxes decayed below score_thr are removed */
+    float sigma;      /*!< soft: gaussian sigma */
+} nms_config_t;
+
+/**
+ * @brief NMS over DetectCandidates.
+ *
+ * - Candidates are taken in descending score order from a binary heap, so only the popped boxes pay for ordering
+ *   instead of sorting the whole candidate set. Soft-NMS re-evaluates a popped box lazily against the boxes kept since
+ *   its last evaluation and pushes it back if its decayed score is no longer the highest.
+ * - Kept boxes are registered in a uniform grid over the extent of the considered candidates. A candidate is only
+ *   compared with the kept boxes of the cells it covers, boxes that can not overlap are never visited.
+ * - The IoU follows the integer convention of the original list based implementation, areas are precomputed.
+ *
+ * Soft-NMS writes the decayed scores and cluster NMS the fused boxes back into the candidates. A run with a subset
+ * reads and writes only the candidates of the subset, so runs over disjoint subsets can share one store.
+ */
+class NMS {
+private:
+    std::vector<int> m_heap;               /*!< candidate indices, max-heap on score */
+    std::vector<int> m_kept;               /*!< indices of kept candidates */
+    std::vector<int> m_visited;            /*!< per kept box, last candidate it has been compared with */
+    std::vector<std::vector<int>> m_cells; /*!< per grid cell, positions in m_kept of the boxes covering it */
+    std::vector<int> m_applied;            /*!< soft: per candidate, number of kept boxes already applied */
+    std::vector<float> m_cluster;          /*!< cluster: per kept box, weight and weighted x1, y1, x2, y2 */
+    int m_grid_x0;
+    int m_grid_y0;
+    int m_cell_w;
+    int m_cell_h;
+    bool m_use_grid;
+
+    void build_grid(const DetectCandidates &candidates, const std::vector<int> &indices);
+    void grid_range(int x1, int y1, int x2, int y2, int &cx1, int &cy1, int &cx2, int &cy2) const;
+    void add_kept(const DetectCandidates &candidates, int index);
+    template <typename F>
+    void for_each_kept(const DetectCandidates &candidates, int index, int from, F f);
+
+public:
+    static const int GRID_SIZE = 16;     /*!< cells per axis */
+    static const int GRID_MIN_NUM = 128; /*!< below this number of candidates kept boxes are scanned linearly */
+
+    NMS() : m_grid_x0(0), m_grid_y0(0), m_cell_w(1), m_cell_h(1), m_use_grid(false) {}
+
+    /**
+     * @brief Run NMS.
+     *
+     * @param candidates candidate store
+     * @param config     NMS configuration
+     * @param keep       indices of kept candidates in descending (final) score order
+     * @param subset     only consider these candidate indices, nullptr for all of them
+     */
+    void run(DetectCandidates &candidates,
+             const nms_config_t &config,
+             std::vector<int> &keep,
+             const std::vector<int> *subset = nullptr);
+
+    /**
+     * @brief Order all candidates by descending score without suppression.
+     *
+     * @param candidates candidate store
+     * @param order      indices of all candidates in descending score order
+     */
+    static void sort(const DetectCandidates &candidates, std::vector<int> &order);
+};
+
+/**
+ * @brief Class aware NMS with the categories split between two engines.
+ *
+ * Categories are distributed so that both halves get about the same number of candidates. The half of nms[1] runs on
+ * the other core and the results are merged in score order, the output is the same as NMS::run with
+ * config.class_aware set. Falls back to a single engine on single core targets or when there is only one category.
+ *
+ * @param nms        two engines
+ * @param candidates candidate store
+ * @param config     NMS configuration, class_aware is implied
+ * @param keep       indices of kept candidates in descending score order
+ */
+void nms_class_aware_dual_core(NMS *nms,
+                               DetectCandidates &candidates,
+                               const nms_config_t &config,
+                               std::vector<int> &keep);
+
+/**
+ * @brief IoU of two candidates, with the +1 pixel convention of the integer boxes.
+ */
+inline float candidate_iou(const DetectCandidates &candidates, int a, int b)
+{
+    int inter_w = DL_MIN(candidates.x2[a], candidates.x2[b]) - DL_MAX(candidates.x1[a], candidates.x1[b]) + 1;
+    int inter_h = DL_MIN(candidates.y2[a], candidates.y2[b]) - DL_MAX(candidates.y1[a], candidates.y1[b]) + 1;
+    if (inter_w <= 0 || inter_h <= 0) {
+        return 0.f;
+    }
+    int inter_area = inter_w * inter_h;
+    return (float)inter_area / (candidates.area[a] + candidates.area[b] - inter_area);
+}
+} // namespace detect
+} // namespace dl
@@ -41,17 +41,12 @@ void PicoPostprocessor::parse_stage(TensorBase *score, TensorBase *box, const in
                         box_data[i] = dequantize(box_ptr[i], box_exp);
                     }
 
-                    result_t new_box = {
-                        (int)c,
-                        sqrtf(dequantize(*score_ptr, score_exp)),
-                        {(int)((center_x - dl::math::dfl_integral(box_data, 7) * stride_x) * inv_resize_scale_x),
-                         (int)((center_y - dl::math::dfl_integral(box_data + 8, 7) * stride_y) * inv_resize_scale_y),
-                         (int)((center_x + dl::math::dfl_integral(box_data + 16, 7) * stride_x) * inv_resize_scale_x),
-                         (int)((center_y + dl::math::dfl_integral(box_data + 24, 7) * stride_y) * inv_resize_scale_y)},
-                        {}};
-
-                    m_box_list.insert(std::upper_bound(m_box_list.begin(), m_box_list.end(), new_box, greater_box),
-                                      new_box);
+                    int new_box[4] = {
+                        (int)((center_x - dl::math::dfl_integral(box_data, 7) * stride_x) * inv_resize_scale_x),
+                        (int)((center_y - dl::math::dfl_integral(box_data + 8, 7) * stride_y) * inv_resize_scale_y),
+                        (int)((center_x + dl::math::dfl_integral(box_data + 16, 7) * stride_x) * inv_resize_scale_x),
+                        (int)((center_y + dl::math::dfl_integral(box_data + 24, 7) * stride_y) * inv_resize_scale_y)};
+                    m_candidates.push(c, sqrtf(dequantize(*score_ptr, score_exp)), new_box);
                 }
                 score_ptr++;
             }
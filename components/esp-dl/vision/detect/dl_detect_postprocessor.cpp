@@ -0,0 +1,40 @@
+#include "dl_detect_postprocessor.hpp"
+
+namespace dl {
+namespace detect {
+// With RUNTIME_MODE_AUTO class aware NMS only pays the task creation on the other core from this many candidates.
+static const int DUAL_CORE_NMS_MIN_NUM = 1000;
+
+void DetectPostprocessor::nms()
+{
+    nms_config_t config = {m_nms_mode, m_nms_class_aware, m_nms_thr, m_top_k, m_score_thr, m_soft_nms_sigma};
+    bool dual_core = m_nms_runtime == RUNTIME_MODE_MULTI_CORE ||
+        (m_nms_runtime == RUNTIME_MODE_AUTO && m_candidates.size() >= DUAL_CORE_NMS_MIN_NUM);
+    if (m_nms_class_aware && dual_core) {
+        nms_class_aware_dual_core(m_nms, m_candidates, config, m_keep);
+    } else {
+        m_nms[0].run(m_candidates, config, m_keep);
+    }
+    for (int index : m_keep) {
+        m_box_list.push_back(m_candidates.to_result(index));
+    }
+}
+
+void DetectPostprocessor::sort_result()
+{
+    NMS::sort(m_candidates, m_keep);
+    for (int index : m_keep) {
+        m_box_list.push_back(m_candidates.to_result(index));
+    }
+}
+
+std::list<result_t> &DetectPostprocessor::get_result(int width, int height)
+{
+    for (result_t &res : m_box_list) {
+        res.limit_box(width, height);
+        res.limit_keypoint(width, height);
+    }
+    return m_box_list;
+}
+} // namespace detect
+} // namespace dl
@@ -1,5 +1,6 @@
 #pragma once
 #include "dl_detect_define.hpp"
+#include "dl_detect_nms.hpp"
 #include "dl_model_base.hpp"
 #include "dl_tensor_base.hpp"
 #include <list>
@@ -17,19 +18,59 @@ protected:
     float m_resize_scale_y;
     float m_top_left_x;
     float m_top_left_y;
+    DetectCandidates m_candidates;  /*!< Boxes passing score_thr, filled by postprocess() */
+    NMS m_nms[2];                   /*!< NMS engines, keep their buffers between frames */
+    nms_mode_t m_nms_mode;          /*!< NMS algorithm */
+    bool m_nms_class_aware;         /*!< Only boxes of the same category suppress each other */
+    runtime_mode_t m_nms_runtime;   /*!< Class aware NMS may split the categories across both cores */
+    float m_soft_nms_sigma;         /*!< Gaussian sigma of Soft-NMS */
+    std::vector<int> m_keep;        /*!< Indices of m_candidates kept by nms() */
     std::list<result_t> m_box_list; /*!< Detected box list */
 
 public:
     DetectPostprocessor(Model *model, const float score_thr, const float nms_thr, const int top_k) :
-        m_model(model), m_score_thr(score_thr), m_nms_thr(nms_thr), m_top_k(top_k) {};
+        m_model(model),
+        m_score_thr(score_thr),
+        m_nms_thr(nms_thr),
+        m_top_k(top_k),
+        m_nms_mode(NMS_MODE_HARD),
+        m_nms_class_aware(false),
+        m_nms_runtime(RUNTIME_MODE_SINGLE_CORE),
+        m_soft_nms_sigma(0.5f) {};
     virtual ~DetectPostprocessor() {};
     virtual void postprocess() = 0;
+    /**
+     * @brief Run NMS over m_candidates and put the kept boxes into m_box_list in descending score order.
+     */
     void nms();
+    /**
+     * @brief Put all of m_candidates into m_box_list in descending score order, without NMS.
+     */
+    void sort_result();
+    /**
+     * @brief Select the NMS algorithm used by nms().
+     *
+     * @param mode         NMS_MODE_HARD (default), NMS_MODE_SOFT or NMS_MODE_CLUSTER
+     * @param class_aware  true: only boxes of the same category suppress each other
+     * @param runtime_mode RUNTIME_MODE_MULTI_CORE: class aware NMS runs half of the categories on the other core,
+     *                     RUNTIME_MODE_AUTO: only when there are many candidates
+     */
+    void set_nms_mode(nms_mode_t mode, bool class_aware = false, runtime_mode_t runtime_mode = RUNTIME_MODE_SINGLE_CORE)
+    {
+        m_nms_mode = mode;
+        m_nms_class_aware = class_aware;
+        m_nms_runtime = runtime_mode;
+    };
+    void set_soft_nms_sigma(float sigma) { m_soft_nms_sigma = sigma; };
     void set_resize_scale_x(float resize_scale_x) { m_resize_scale_x = resize_scale_x; };
     void set_resize_scale_y(float resize_scale_y) { m_resize_scale_y = resize_scale_y; };
     void set_top_left_x(float top_left_x) { m_top_left_x = top_left_x; };
     void set_top_left_y(float top_left_y) { m_top_left_y = top_left_y; };
-    void clear_result() { m_box_list.clear(); };
+    void clear_result()
+    {
+        m_candidates.clear();
+        m_box_list.clear();
+    };
     std::list<result_t> &get_result(int width, int height);
 };
 
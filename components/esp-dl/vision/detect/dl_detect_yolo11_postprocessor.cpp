@@ -21,46 +21,31 @@ void yolo11PostProcessor::parse_stage(TensorBase *score, TensorBase *box, const
     T *score_ptr = (T *)score->data;
     T *box_ptr = (T *)box->data;
     float score_exp = DL_SCALE(score->exponent);
-    float box_exp = DL_SCALE(box->exponent);
-    T score_thr_quant = quantize<T>(dl::math::inverse_sigmoid(m_score_thr), 1.f / score_exp);
+    int score_thr_quant = quantize<T>(dl::math::inverse_sigmoid(m_score_thr), 1.f / score_exp);
     float inv_resize_scale_x = 1.f / m_resize_scale_x;
     float inv_resize_scale_y = 1.f / m_resize_scale_y;
 
     int reg_max = 16;
+    m_sigmoid.set_exponent(score->exponent);
+    m_dfl.set_exponent(box->exponent, reg_max);
 
-    for (size_t y = 0; y < H; y++) {
-        for (size_t x = 0; x < W; x++) {
-            for (size_t c = 0; c < C; c++) {
-                if (*score_ptr > score_thr_quant) {
-                    int center_y = y * stride_y + offset_y;
-                    int center_x = x * stride_x + offset_x;
+    // Find the survivors first, then decode the box of each surviving cell once for all of its categories.
+    filter_score_map(score_ptr, H * W, C, score_thr_quant, m_hits);
 
-                    float box_data[reg_max * 4];
-                    for (int i = 0; i < reg_max * 4; i++) {
-                        box_data[i] = dequantize(box_ptr[i], box_exp);
-                    }
-
-                    result_t new_box = {
-                        (int)c,
-                        dl::math::sigmoid(dequantize(*score_ptr, score_exp)),
-                        {(int)((center_x - dl::math::dfl_integral(box_data, reg_max - 1) * stride_x) *
-                               inv_resize_scale_x),
-                         (int)((center_y - dl::math::dfl_integral(box_data + reg_max, reg_max - 1) * stride_y) *
-                               inv_resize_scale_y),
-                         (int)((center_x + dl::math::dfl_integral(box_data + 2 * reg_max, reg_max - 1) * stride_x) *
-                               inv_resize_scale_x),
-                         (int)((center_y + dl::math::dfl_integral(box_data + 3 * reg_max, reg_max - 1) * stride_y) *
-                               inv_resize_scale_y)},
-                        {}};
-
-                    m_box_list.insert(std::upper_bound(m_box_list.begin(), m_box_list.end(), new_box, greater_box),
-                                      new_box);
-                }
-                score_ptr++;
-            }
-
-            box_ptr += 4 * reg_max;
+    int last_cell = -1;
+    int new_box[4];
+    for (const score_hit_t &hit : m_hits) {
+        if (hit.cell != last_cell) {
+            int center_y = (hit.cell / W) * stride_y + offset_y;
+            int center_x = (hit.cell % W) * stride_x + offset_x;
+            const T *box_data = box_ptr + hit.cell * 4 * reg_max;
+            new_box[0] = (int)((center_x - m_dfl.integral(box_data) * stride_x) * inv_resize_scale_x);
+            new_box[1] = (int)((center_y - m_dfl.integral(box_data + reg_max) * stride_y) * inv_resize_scale_y);
+            new_box[2] = (int)((center_x + m_dfl.integral(box_data + 2 * reg_max) * stride_x) * inv_resize_scale_x);
+            new_box[3] = (int)((center_y + m_dfl.integral(box_data + 3 * reg_max) * stride_y) * inv_resize_scale_y);
+            last_cell = hit.cell;
         }
+        m_candidates.push(hit.category, m_sigmoid(score_ptr[hit.cell * C + hit.category]), new_box);
     }
 }
 
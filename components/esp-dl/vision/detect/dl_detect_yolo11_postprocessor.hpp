@@ -1,10 +1,15 @@
 #pragma once
+#include "dl_detect_decode.hpp"
 #include "dl_detect_postprocessor.hpp"
 
 namespace dl {
 namespace detect {
 class yolo11PostProcessor : public AnchorPointDetectPostprocessor {
 private:
+    std::vector<score_hit_t> m_hits;
+    SigmoidLUT m_sigmoid;
+    DFLDecoder m_dfl;
+
     template <typename T>
     void parse_stage(TensorBase *score, TensorBase *box, const int stage_index);
 
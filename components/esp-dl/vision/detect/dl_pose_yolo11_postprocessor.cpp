@@ -0,0 +1,123 @@
+#include "dl_pose_yolo11_postprocessor.hpp"
+#include "dl_math.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace dl {
+namespace detect {
+static const int coco_kpt_num = 17;
+static const int coco_kpt_ch = 3;                    //(x, y, visibility)
+static const int coco_kpt_total = coco_kpt_num * coco_kpt_ch;
+static const int coco_kpt_res_total = coco_kpt_num * 2; //(x, y)
+static const float coco_kpt_conf_th = 0.5;
+
+template <typename T>
+void yolo11posePostProcessor::parse_stage(TensorBase *score, TensorBase *box, const int stage_index)
+{
+    int stride_y = m_stages[stage_index].stride_y;
+    int stride_x = m_stages[stage_index].stride_x;
+
+    int offset_y = m_stages[stage_index].offset_y;
+    int offset_x = m_stages[stage_index].offset_x;
+
+    int H = score->shape[1];
+    int W = score->shape[2];
+    int C = score->shape[3];
+
+    T *score_ptr = (T *)score->data;
+    T *box_ptr = (T *)box->data;
+    float score_exp = DL_SCALE(score->exponent);
+    int score_thr_quant = quantize<T>(dl::math::inverse_sigmoid(m_score_thr), 1.f / score_exp);
+    float inv_resize_scale_x = 1.f / m_resize_scale_x;
+    float inv_resize_scale_y = 1.f / m_resize_scale_y;
+
+    int reg_max = 16;
+    m_sigmoid.set_exponent(score->exponent);
+    m_dfl.set_exponent(box->exponent, reg_max);
+
+    filter_score_map(score_ptr, H * W, C, score_thr_quant, m_hits);
+
+    int last_cell = -1;
+    int new_box[4];
+    for (const score_hit_t &hit : m_hits) {
+        if (hit.cell != last_cell) {
+            int center_y = (hit.cell / W) * stride_y + offset_y;
+            int center_x = (hit.cell % W) * stride_x + offset_x;
+            const T *box_data = box_ptr + hit.cell * 4 * reg_max;
+            new_box[0] = (int)((center_x - m_dfl.integral(box_data) * stride_x) * inv_resize_scale_x);
+            new_box[1] = (int)((center_y - m_dfl.integral(box_data + reg_max) * stride_y) * inv_resize_scale_y);
+            new_box[2] = (int)((center_x + m_dfl.integral(box_data + 2 * reg_max) * stride_x) * inv_resize_scale_x);
+            new_box[3] = (int)((center_y + m_dfl.integral(box_data + 3 * reg_max) * stride_y) * inv_resize_scale_y);
+            last_cell = hit.cell;
+        }
+        // Keypoints are only decoded for the boxes kept by NMS, remember where they are.
+        m_candidates.push(hit.category, m_sigmoid(score_ptr[hit.cell * C + hit.category]), new_box);
+        m_kpt_sources.push_back({stage_index, hit.cell});
+    }
+}
+
+template void yolo11posePostProcessor::parse_stage<int8_t>(TensorBase *score, TensorBase *box, const int stage_index);
+template void yolo11posePostProcessor::parse_stage<int16_t>(TensorBase *score, TensorBase *box, const int stage_index);
+
+template <typename T>
+void yolo11posePostProcessor::decode_keypoints(TensorBase **kpt)
+{
+    float inv_resize_scale_x = 1.f / m_resize_scale_x;
+    float inv_resize_scale_y = 1.f / m_resize_scale_y;
+    auto res = m_box_list.begin();
+    for (int index : m_keep) {
+        const kpt_source_t &source = m_kpt_sources[index];
+        const anchor_point_stage_t &stage = m_stages[source.stage];
+        int W = kpt[source.stage]->shape[2];
+        const T *kpt_ptr = (T *)kpt[source.stage]->data + source.cell * coco_kpt_total;
+        float kpt_exp = DL_SCALE(kpt[source.stage]->exponent);
+
+        // x = (q * kpt_exp * 2 * stride + cell * stride) / resize_scale, folded into one multiply-add per coordinate.
+        // kpt_exp is a power of two, so the confidence threshold is exact in the quantized domain.
+        float scale_x = kpt_exp * 2.f * stage.stride_x * inv_resize_scale_x;
+        float scale_y = kpt_exp * 2.f * stage.stride_y * inv_resize_scale_y;
+        float bias_x = (source.cell % W) * stage.stride_x * inv_resize_scale_x;
+        float bias_y = (source.cell / W) * stage.stride_y * inv_resize_scale_y;
+        int conf_thr_quant = (int)ceilf(coco_kpt_conf_th / kpt_exp);
+
+        res->keypoint.resize(coco_kpt_res_total);
+        int *keypoint = res->keypoint.data();
+        for (int k = 0; k < coco_kpt_num; k++, kpt_ptr += coco_kpt_ch) {
+            bool visible = kpt_ptr[2] >= conf_thr_quant;
+            keypoint[2 * k] = visible ? (int)(kpt_ptr[0] * scale_x + bias_x) : 0;
+            keypoint[2 * k + 1] = visible ? (int)(kpt_ptr[1] * scale_y + bias_y) : 0;
+        }
+        res++;
+    }
+}
+
+void yolo11posePostProcessor::postprocess()
+{
+    TensorBase *bbox0 = m_model->get_output("box0");
+    TensorBase *score0 = m_model->get_output("score0");
+
+    TensorBase *bbox1 = m_model->get_output("box1");
+    TensorBase *score1 = m_model->get_output("score1");
+
+    TensorBase *bbox2 = m_model->get_output("box2");
+    TensorBase *score2 = m_model->get_output("score2");
+
+    TensorBase *kpt[3] = {m_model->get_output("kpt0"), m_model->get_output("kpt1"), m_model->get_output("kpt2")};
+
+    m_kpt_sources.clear();
+    if (bbox0->dtype == DATA_TYPE_INT8) {
+        parse_stage<int8_t>(score0, bbox0, 0);
+        parse_stage<int8_t>(score1, bbox1, 1);
+        parse_stage<int8_t>(score2, bbox2, 2);
+        nms();
+        decode_keypoints<int8_t>(kpt);
+    } else {
+        parse_stage<int16_t>(score0, bbox0, 0);
+        parse_stage<int16_t>(score1, bbox1, 1);
+        parse_stage<int16_t>(score2, bbox2, 2);
+        nms();
+        decode_keypoints<int16_t>(kpt);
+    }
+}
+} // namespace detect
+} // namespace dl
@@ -0,0 +1,29 @@
+#pragma once
+#include "dl_detect_decode.hpp"
+#include "dl_detect_postprocessor.hpp"
+
+namespace dl {
+namespace detect {
+class yolo11posePostProcessor : public AnchorPointDetectPostprocessor {
+private:
+    typedef struct {
+        int stage; /*!< stage index */
+        int cell;  /*!< y * W + x of the feature map cell */
+    } kpt_source_t;
+
+    std::vector<score_hit_t> m_hits;
+    SigmoidLUT m_sigmoid;
+    DFLDecoder m_dfl;
+    std::vector<kpt_source_t> m_kpt_sources; /*!< Keypoint source of each candidate, decoded after NMS */
+
+    template <typename T>
+    void parse_stage(TensorBase *score, TensorBase *box, const int stage_index);
+    template <typename T>
+    void decode_keypoints(TensorBase **kpt);
+
+public:
+    void postprocess() override;
+    using AnchorPointDetectPostprocessor::AnchorPointDetectPostprocessor;
+};
+} // namespace detect
+} // namespace dl
@@ -0,0 +1,64 @@
+#include "dl_feat_postprocessor.hpp"
+#include <type_traits>
+
+namespace dl {
+namespace feat {
+
+FeatPostprocessor::FeatPostprocessor(Model *model, const std::string &output_name, dtype_t feat_dtype)
+{
+    assert(feat_dtype == DATA_TYPE_FLOAT || feat_dtype == DATA_TYPE_INT8);
+    m_model_output = model->get_output(output_name);
+    m_feat = new TensorBase(m_model_output->shape, nullptr, 0, feat_dtype);
+}
+
+TensorBase *FeatPostprocessor::postprocess()
+{
+    if (m_model_output->dtype == DATA_TYPE_INT8) {
+        l2_norm<int8_t>();
+    } else if (m_model_output->dtype == DATA_TYPE_INT16) {
+        l2_norm<int16_t>();
+    } else {
+        l2_norm<float>();
+    }
+    return m_feat;
+}
+
+template <typename T>
+void FeatPostprocessor::l2_norm()
+{
+    // x / |x| does not depend on the quantization scale, so the norm is accumulated on the raw output and the
+    // dequantize, normalize (and quantize) steps are fused into one write pass.
+    using acc_t = std::conditional_t<std::is_same_v<T, float>,
+                                     float,
+                                     std::conditional_t<std::is_same_v<T, int8_t>, int32_t, int64_t>>;
+    const T *input = (T *)m_model_output->data;
+    int size = m_model_output->get_size();
+    acc_t norm = 0;
+    acc_t max_abs = 0;
+    for (int i = 0; i < size; i++) {
+        acc_t x = input[i];
+        norm += x * x;
+        max_abs = DL_MAX(max_abs, x < 0 ? -x : x);
+    }
+    float inv_norm = norm > 0 ? 1.f / dl::math::sqrt_newton((float)norm) : 0.f;
+
+    if (m_feat->dtype == DATA_TYPE_FLOAT) {
+        float *output = (float *)m_feat->data;
+        for (int i = 0; i < size; i++) {
+            output[i] = input[i] * inv_norm;
+        }
+    } else {
+        // Largest exponent keeping the maximum within int8, a maximum of exactly 128 is clipped.
+        float max_value = max_abs * inv_norm;
+        int exponent = max_value > 0 ? (int)ceilf(log2f(max_value / 128.f)) : 0;
+        m_feat->exponent = exponent;
+        float scale = inv_norm * DL_RESCALE(exponent);
+        int8_t *output = (int8_t *)m_feat->data;
+        for (int i = 0; i < size; i++) {
+            int value = tool::round(input[i] * scale);
+            output[i] = DL_CLIP(value, DL_QUANT8_MIN, DL_QUANT8_MAX);
+        }
+    }
+}
+} // namespace feat
+} // namespace dl
@@ -0,0 +1,30 @@
+#pragma once
+#include "dl_math.hpp"
+#include "dl_model_base.hpp"
+#include "dl_tensor_base.hpp"
+#include <map>
+
+namespace dl {
+namespace feat {
+class FeatPostprocessor {
+private:
+    TensorBase *m_model_output;
+    TensorBase *m_feat;
+    template <typename T>
+    void l2_norm();
+
+public:
+    /**
+     * @brief Construct a new FeatPostprocessor object.
+     *
+     * @param model       feature model
+     * @param output_name name of the feature output
+     * @param feat_dtype  DATA_TYPE_FLOAT for a float feature, DATA_TYPE_INT8 for a feature quantized with a power of
+     *                    two exponent, which DataBase searches without dequantizing when it stores int8 features
+     */
+    FeatPostprocessor(Model *model, const std::string &output_name = "", dtype_t feat_dtype = DATA_TYPE_FLOAT);
+    TensorBase *postprocess();
+    ~FeatPostprocessor() { delete m_feat; }
+};
+} // namespace feat
+} // namespace dl
@@ -0,0 +1,110 @@
+#include "dl_recognition_cache.hpp"
+#include <algorithm>
+
+namespace dl {
+namespace recognition {
+static float box_iou(const std::vector<int> &a, const std::vector<int> &b)
+{
+    int inter_w = DL_MIN(a[2], b[2]) - DL_MAX(a[0], b[0]) + 1;
+    int inter_h = DL_MIN(a[3], b[3]) - DL_MAX(a[1], b[1]) + 1;
+    if (inter_w <= 0 || inter_h <= 0) {
+        return 0.f;
+    }
+    int inter_area = inter_w * inter_h;
+    int area_a = (a[2] - a[0] + 1) * (a[3] - a[1] + 1);
+    int area_b = (b[2] - b[0] + 1) * (b[3] - b[1] + 1);
+    return (float)inter_area / (area_a + area_b - inter_area);
+}
+
+void RecognitionCache::begin_frame(const std::list<dl::detect::result_t> &detect_res)
+{
+    int num_det = detect_res.size();
+    int num_track = m_tracks.size();
+    m_match.assign(num_det, -1);
+
+    // Greedy association, best IoU pairs first. There are only a few faces per frame.
+    typedef struct {
+        float iou;
+        int det;
+        int track;
+    } pair_t;
+    std::vector<pair_t> pairs;
+    int d = 0;
+    for (auto &det : detect_res) {
+        for (int t = 0; t < num_track; t++) {
+            float iou = box_iou(det.box, m_tracks[t].box);
+            if (iou >= m_iou_thr) {
+                pairs.push_back({iou, d, t});
+            }
+        }
+        d++;
+    }
+    std::sort(pairs.begin(), pairs.end(), [](const pair_t &a, const pair_t &b) { return a.iou > b.iou; });
+    std::vector<bool> track_matched(num_track, false);
+    for (const pair_t &p : pairs) {
+        if (m_match[p.det] < 0 && !track_matched[p.track]) {
+            m_match[p.det] = p.track;
+            track_matched[p.track] = true;
+        }
+    }
+
+    for (int t = 0; t < num_track; t++) {
+        track_t &track = m_tracks[t];
+        track.lost = track_matched[t] ? 0 : track.lost + 1;
+        track.age++;
+        track.confidence *= m_decay;
+    }
+    d = 0;
+    for (auto &det : detect_res) {
+        if (m_match[d] < 0) {
+            m_match[d] = m_tracks.size();
+            m_tracks.push_back({det.box, {}, 0.f, 0, 0, false});
+        } else {
+            m_tracks[m_match[d]].box = det.box;
+        }
+        d++;
+    }
+
+    // Drop lost tracks and renumber the matches.
+    std::vector<int> remap(m_tracks.size(), -1);
+    int num_kept = 0;
+    for (int t = 0; t < (int)m_tracks.size(); t++) {
+        if (m_tracks[t].lost <= m_max_lost) {
+            remap[t] = num_kept;
+            if (num_kept != t) {
+                m_tracks[num_kept] = std::move(m_tracks[t]);
+            }
+            num_kept++;
+        }
+    }
+    m_tracks.resize(num_kept);
+    for (int &m : m_match) {
+        m = remap[m];
+    }
+}
+
+bool RecognitionCache::lookup(int index, std::vector<result_t> &res)
+{
+    const track_t &track = m_tracks[m_match[index]];
+    bool valid = track.recognized &&
+        (track.results.empty() ? track.age < m_unknown_refresh_interval
+                               : track.age < m_refresh_interval && track.confidence >= m_min_confidence);
+    if (valid) {
+        res = track.results;
+        m_stats.num_hits++;
+    } else {
+        m_stats.num_misses++;
+    }
+    return valid;
+}
+
+void RecognitionCache::update(int index, const std::vector<result_t> &res)
+{
+    track_t &track = m_tracks[m_match[index]];
+    track.results = res;
+    track.confidence = res.empty() ? 0.f : res[0].similarity;
+    track.age = 0;
+    track.recognized = true;
+}
+} // namespace recognition
+} // namespace dl
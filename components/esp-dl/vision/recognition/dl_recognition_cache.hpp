@@ -0,0 +1,115 @@
+#pragma once
+#include "dl_detect_define.hpp"
+#include "dl_recognition_define.hpp"
+#include <list>
+#include <vector>
+
+namespace dl {
+namespace recognition {
+typedef struct {
+    uint32_t num_hits;   /*!< detections answered from the cache */
+    uint32_t num_misses; /*!< detections that had to be recognized */
+    float hit_rate() const { return num_hits + num_misses ? (float)num_hits / (num_hits + num_misses) : 0.f; }
+} recognition_cache_stats_t;
+
+/**
+ * @brief Reuse recognition results of a face while it is tracked across frames.
+ *
+ * Detections are associated with the tracks of the previous frame by greedy box IoU. A track keeps the result of its
+ * last recognition, which is reused until
+ * - the track is lost for more than max_lost frames,
+ * - refresh_interval frames passed since the last recognition, unknown_refresh_interval frames if the face was not
+ *   found in the database, or
+ * - the top similarity, decayed by decay per frame, drops below min_confidence.
+ *
+ * Usage per frame:
+ * @code
+ * cache.begin_frame(detect_res);
+ * int i = 0;
+ * for (auto &det : detect_res) {
+ *     std::vector<dl::recognition::result_t> res;
+ *     if (!cache.lookup(i, res)) {
+ *         res = db.query_feat(feat_model->run(img, det.keypoint), thr, top_k);
+ *         cache.update(i, res);
+ *     }
+ *     i++;
+ * }
+ * @endcode
+ */
+class RecognitionCache {
+private:
+    typedef struct {
+        std::vector<int> box;
+        std::vector<result_t> results;
+        float confidence; /*!< decayed top similarity */
+        int age;          /*!< frames since the last recognition */
+        int lost;         /*!< frames without a matching detection */
+        bool recognized;  /*!< results are valid */
+    } track_t;
+
+    std::vector<track_t> m_tracks;
+    std::vector<int> m_match; /*!< track of each detection of the current frame */
+    float m_iou_thr;
+    int m_refresh_interval;
+    int m_unknown_refresh_interval;
+    int m_max_lost;
+    float m_decay;
+    float m_min_confidence;
+    recognition_cache_stats_t m_stats;
+
+public:
+    /**
+     * @brief Construct a new RecognitionCache object.
+     *
+     * @param iou_thr          minimum IoU between a detection and the box of a track in the previous frame
+     * @param refresh_interval recognize a track again after this number of frames
+     * @param max_lost         drop a track after this number of frames without a detection
+     * @param decay            per frame decay of the cached top similarity
+     * @param min_confidence   recognize a track again once its decayed top similarity is lower
+     * @param unknown_refresh_interval recognize a track that was not found in the database again after this number of
+     *                                 frames, so a face enrolled meanwhile or seen better in a later frame is picked up
+     *                                 soon. 0 does not cache empty results.
+     */
+    RecognitionCache(float iou_thr = 0.5,
+                     int refresh_interval = 30,
+                     int max_lost = 3,
+                     float decay = 0.98,
+                     float min_confidence = 0.4,
+                     int unknown_refresh_interval = 5) :
+        m_iou_thr(iou_thr),
+        m_refresh_interval(refresh_interval),
+        m_unknown_refresh_interval(unknown_refresh_interval),
+        m_max_lost(max_lost),
+        m_decay(decay),
+        m_min_confidence(min_confidence),
+        m_stats({0, 0})
+    {
+    }
+
+    /**
+     * @brief Associate the detections of a new frame with the tracks.
+     */
+    void begin_frame(const std::list<dl::detect::result_t> &detect_res);
+
+    /**
+     * @brief Get the cached results of the index-th detection of the current frame.
+     *
+     * @return true if res is valid, false if the detection has to be recognized and passed to update
+     */
+    bool lookup(int index, std::vector<result_t> &res);
+
+    /**
+     * @brief Store the recognition results of the index-th detection of the current frame.
+     */
+    void update(int index, const std::vector<result_t> &res);
+
+    /**
+     * @brief Drop all tracks, e.g. after the database changed.
+     */
+    void clear() { m_tracks.clear(); }
+
+    const recognition_cache_stats_t &get_stats() const { return m_stats; }
+    void reset_stats() { m_stats = {0, 0}; }
+};
+} // namespace recognition
+} // namespace dl
@@ -0,0 +1,555 @@
+#include "dl_recognition_database.hpp"
+#include <sys/stat.h>
+
+static const char *TAG = "dl::recognition::DataBase";
+
+namespace dl {
+namespace recognition {
+static const uint32_t DATABASE_MAGIC = 0x42444c44; // "DLDB"
+static const uint16_t DATABASE_VERSION = 2;
+static const int DATABASE_COMPACT_MIN_DEAD = 64; /*!< small logs are not worth compacting */
+static const size_t DATABASE_STREAM_BUF_SIZE = 16384;
+
+/**
+ * FNV-1a over the id and the float feature, one word at a time.
+ */
+static uint32_t row_hash(uint32_t id, const float *feat, int feat_len)
+{
+    uint32_t hash = (2166136261u ^ id) * 16777619u;
+    const uint32_t *words = (const uint32_t *)feat;
+    for (int i = 0; i < feat_len; i++) {
+        hash = (hash ^ words[i]) * 16777619u;
+    }
+    return hash;
+}
+
+typedef struct {
+    uint16_t num_feats_total;
+    uint16_t num_feats_valid;
+    uint16_t feat_len;
+} database_legacy_meta;
+
+DataBase::DataBase(const char *db_path, int feat_len, dtype_t dtype) :
+    m_content_hash(0),
+    m_feats(feat_len, dtype),
+    m_feat_buf(feat_len),
+    m_index(nullptr),
+    m_has_index_file(false),
+    m_num_pending(0),
+    m_write_batch(1),
+    m_num_dead(0)
+{
+    assert(db_path);
+    int length = strlen(db_path) + 1;
+    m_db_path = (char *)malloc(sizeof(char) * length);
+    memcpy(m_db_path, db_path, length);
+    m_index_path = std::string(db_path) + ".ivf";
+    struct stat st;
+    m_has_index_file = stat(m_index_path.c_str(), &st) == 0;
+    std::string tmp_path = std::string(db_path) + ".tmp";
+    if (stat(db_path, &st) != 0 && stat(tmp_path.c_str(), &st) == 0) {
+        // Power lost between removing the old file and renaming the compacted one.
+        rename(tmp_path.c_str(), db_path);
+    }
+    if (stat(db_path, &st) == 0) {
+        load_database_from_storage(feat_len);
+    } else {
+        create_empty_database_in_storage(feat_len);
+    }
+}
+
+DataBase::~DataBase()
+{
+    flush();
+    clear_all_feats_in_memory();
+    free(m_db_path);
+    delete m_index;
+}
+
+esp_err_t DataBase::create_empty_database_in_storage(int feat_len)
+{
+    FILE *f = fopen(m_db_path, "wb");
+    size_t size = 0;
+    if (!f) {
+        ESP_LOGE(TAG, "Failed to open db.");
+        return ESP_FAIL;
+    }
+    m_meta.num_feats_total = 0;
+    m_meta.num_feats_valid = 0;
+    m_meta.feat_len = feat_len;
+    m_num_dead = 0;
+    database_header header = {DATABASE_MAGIC, DATABASE_VERSION, (uint16_t)feat_len, 1};
+    size = fwrite(&header, sizeof(database_header), 1, f);
+    if (size != 1) {
+        ESP_LOGE(TAG, "Failed to write db header.");
+        fclose(f);
+        return ESP_FAIL;
+    }
+    fclose(f);
+    return ESP_OK;
+}
+
+esp_err_t DataBase::clear_all_feats()
+{
+    m_pending.clear();
+    m_num_pending = 0;
+    if (remove(m_db_path) == -1) {
+        ESP_LOGE(TAG, "Failed to remove db.");
+        return ESP_FAIL;
+    }
+    ESP_RETURN_ON_ERROR(
+        create_empty_database_in_storage(m_meta.feat_len), TAG, "Failed to create empty db in storage.");
+    clear_all_feats_in_memory();
+    remove_index_file();
+    return ESP_OK;
+}
+
+void DataBase::clear_all_feats_in_memory()
+{
+    m_ids.clear();
+    m_row_hashes.clear();
+    m_content_hash = 0;
+    m_feats.clear();
+    if (m_index) {
+        m_index->reset();
+    }
+    m_meta.num_feats_total = 0;
+    m_meta.num_feats_valid = 0;
+}
+
+void DataBase::push_row(uint32_t id, const float *feat)
+{
+    uint32_t hash = row_hash(id, feat, m_meta.feat_len);
+    m_ids.push_back(id);
+    m_row_hashes.push_back(hash);
+    m_content_hash += hash;
+    m_feats.push(feat);
+}
+
+void DataBase::erase_row(int row)
+{
+    m_content_hash -= m_row_hashes[row];
+    m_row_hashes.erase(m_row_hashes.begin() + row);
+    m_ids.erase(m_ids.begin() + row);
+    m_feats.erase(row);
+}
+
+esp_err_t DataBase::save_index(bool last)
+{
+    if (!m_index || !m_index->is_trained()) {
+        // Nothing keeps the file in step with the rows any more.
+        remove_index_file();
+        return ESP_OK;
+    }
+    m_has_index_file = true;
+    return last ? m_index->save_last(m_index_path.c_str(), m_content_hash)
+                : m_index->save(m_index_path.c_str(), m_content_hash);
+}
+
+void DataBase::remove_index_file()
+{
+    if (m_has_index_file) {
+        remove(m_index_path.c_str());
+        m_has_index_file = false;
+    }
+}
+
+esp_err_t DataBase::replace_database(const char *tmp_path)
+{
+    // rename does not overwrite on FAT, the constructor recovers tmp_path if power is lost in between.
+    if (remove(m_db_path) == -1 || rename(tmp_path, m_db_path) != 0) {
+        ESP_LOGE(TAG, "Failed to replace db.");
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+esp_err_t DataBase::convert_legacy_database(int feat_len)
+{
+    std::string tmp_path = std::string(m_db_path) + ".tmp";
+    FILE *f = fopen(m_db_path, "rb");
+    if (!f) {
+        ESP_LOGE(TAG, "Failed to open db.");
+        return ESP_FAIL;
+    }
+    setvbuf(f, nullptr, _IOFBF, DATABASE_STREAM_BUF_SIZE);
+    database_legacy_meta meta;
+    if (fread(&meta, sizeof(database_legacy_meta), 1, f) != 1) {
+        ESP_LOGE(TAG, "Failed to read database meta.");
+        fclose(f);
+        return ESP_FAIL;
+    }
+    if (feat_len != meta.feat_len) {
+        ESP_LOGE(TAG, "Feature len in storage does not match feature len in db.");
+        fclose(f);
+        return ESP_FAIL;
+    }
+    FILE *out = fopen(tmp_path.c_str(), "wb");
+    if (!out) {
+        ESP_LOGE(TAG, "Failed to open tmp db.");
+        fclose(f);
+        return ESP_FAIL;
+    }
+    setvbuf(out, nullptr, _IOFBF, DATABASE_STREAM_BUF_SIZE);
+    database_header header = {DATABASE_MAGIC, DATABASE_VERSION, meta.feat_len, (uint32_t)meta.num_feats_total + 1};
+    bool ok = fwrite(&header, sizeof(database_header), 1, out) == 1;
+    for (int i = 0; ok && i < meta.num_feats_total; i++) {
+        uint16_t id;
+        ok = fread(&id, sizeof(uint16_t), 1, f) == 1 &&
+            fread(m_feat_buf.data(), sizeof(float), feat_len, f) == (size_t)feat_len;
+        if (ok && id != 0) {
+            database_record record = {DATABASE_RECORD_ENROLL, id};
+            ok = fwrite(&record, sizeof(database_record), 1, out) == 1 &&
+                fwrite(m_feat_buf.data(), sizeof(float), feat_len, out) == (size_t)feat_len;
+        }
+    }
+    fclose(f);
+    fclose(out);
+    if (!ok) {
+        ESP_LOGE(TAG, "Failed to convert legacy db.");
+        remove(tmp_path.c_str());
+        return ESP_FAIL;
+    }
+    ESP_LOGI(TAG, "Converted legacy db.");
+    return replace_database(tmp_path.c_str());
+}
+
+esp_err_t DataBase::load_database_from_storage(int feat_len)
+{
+    clear_all_feats_in_memory();
+    FILE *f = fopen(m_db_path, "rb");
+    size_t size = 0;
+    if (!f) {
+        ESP_LOGE(TAG, "Failed to open db.");
+        return ESP_FAIL;
+    }
+    // The log is streamed through a large stdio buffer instead of one flash read per record.
+    setvbuf(f, nullptr, _IOFBF, DATABASE_STREAM_BUF_SIZE);
+    database_header header;
+    size = fread(&header, sizeof(database_header), 1, f);
+    if (size != 1 || header.magic != DATABASE_MAGIC) {
+        fclose(f);
+        ESP_RETURN_ON_ERROR(convert_legacy_database(feat_len), TAG, "Failed to read database header.");
+        return load_database_from_storage(feat_len);
+    }
+    if (header.version != DATABASE_VERSION) {
+        ESP_LOGE(TAG, "Unsupported db version.");
+        fclose(f);
+        return ESP_FAIL;
+    }
+    if (feat_len != header.feat_len) {
+        ESP_LOGE(TAG, "Feature len in storage does not match feature len in db.");
+        fclose(f);
+        return ESP_FAIL;
+    }
+    m_meta.num_feats_total = header.next_id - 1;
+    m_num_dead = 0;
+
+    m_meta.feat_len = feat_len;
+    std::vector<uint32_t> deleted_ids;
+    bool truncated = false;
+    database_record record;
+    while (fread(&record, sizeof(database_record), 1, f) == 1) {
+        if (record.type == DATABASE_RECORD_ENROLL) {
+            size = fread(m_feat_buf.data(), sizeof(float), feat_len, f);
+            if (size != (size_t)feat_len) {
+                truncated = true;
+                break;
+            }
+            if (!m_ids.empty() && record.id <= m_ids.back()) {
+                ESP_LOGE(TAG, "Feature ids are not ascending.");
+                fclose(f);
+                return ESP_FAIL;
+            }
+            push_row(record.id, m_feat_buf.data());
+            m_meta.num_feats_total = DL_MAX(m_meta.num_feats_total, record.id);
+        } else if (record.type == DATABASE_RECORD_DELETE) {
+            deleted_ids.push_back(record.id);
+        } else {
+            truncated = true;
+            break;
+        }
+    }
+    if (!truncated && !feof(f)) {
+        truncated = true;
+    }
+    fclose(f);
+
+    // Apply the tombstones in one pass.
+    std::vector<int> rows;
+    for (uint32_t id : deleted_ids) {
+        auto it = std::lower_bound(m_ids.begin(), m_ids.end(), id);
+        if (it != m_ids.end() && *it == id) {
+            rows.push_back(it - m_ids.begin());
+        }
+    }
+    std::sort(rows.begin(), rows.end());
+    rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+    m_feats.erase(rows);
+    for (int i = rows.size() - 1; i >= 0; i--) {
+        m_content_hash -= m_row_hashes[rows[i]];
+        m_row_hashes.erase(m_row_hashes.begin() + rows[i]);
+        m_ids.erase(m_ids.begin() + rows[i]);
+    }
+    m_meta.num_feats_valid = m_ids.size();
+    m_num_dead = rows.size() + deleted_ids.size();
+
+    if (truncated) {
+        // Drop the partially written tail, otherwise new records would be appended after it.
+        ESP_LOGW(TAG, "Truncated record at the end of db, compacting.");
+        return compact();
+    }
+    return ESP_OK;
+}
+
+esp_err_t DataBase::append_record(const database_record &record, const float *feat)
+{
+    size_t pending_size = m_pending.size();
+    const uint8_t *bytes = (const uint8_t *)&record;
+    m_pending.insert(m_pending.end(), bytes, bytes + sizeof(database_record));
+    if (feat) {
+        bytes = (const uint8_t *)feat;
+        m_pending.insert(m_pending.end(), bytes, bytes + sizeof(float) * m_meta.feat_len);
+    }
+    m_num_pending++;
+    if (m_num_pending >= m_write_batch && flush() != ESP_OK) {
+        // Drop the record again, the caller does not apply it. Records batched before stay pending.
+        m_pending.resize(pending_size);
+        m_num_pending--;
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+esp_err_t DataBase::flush()
+{
+    if (m_num_pending == 0) {
+        return ESP_OK;
+    }
+    FILE *f = fopen(m_db_path, "ab");
+    if (!f) {
+        ESP_LOGE(TAG, "Failed to open db.");
+        return ESP_FAIL;
+    }
+    size_t size = fwrite(m_pending.data(), 1, m_pending.size(), f);
+    fclose(f);
+    if (size != m_pending.size()) {
+        ESP_LOGE(TAG, "Failed to write records.");
+        return ESP_FAIL;
+    }
+    m_pending.clear();
+    m_num_pending = 0;
+    return ESP_OK;
+}
+
+esp_err_t DataBase::set_write_batch(int num)
+{
+    if (num < 1) {
+        ESP_LOGE(TAG, "Write batch should be greater than 0.");
+        return ESP_FAIL;
+    }
+    m_write_batch = num;
+    if (m_num_pending >= m_write_batch) {
+        return flush();
+    }
+    return ESP_OK;
+}
+
+esp_err_t DataBase::compact()
+{
+    ESP_RETURN_ON_ERROR(flush(), TAG, "Failed to flush db.");
+    std::string tmp_path = std::string(m_db_path) + ".tmp";
+    FILE *f = fopen(m_db_path, "rb");
+    if (!f) {
+        ESP_LOGE(TAG, "Failed to open db.");
+        return ESP_FAIL;
+    }
+    FILE *out = fopen(tmp_path.c_str(), "wb");
+    if (!out) {
+        ESP_LOGE(TAG, "Failed to open tmp db.");
+        fclose(f);
+        return ESP_FAIL;
+    }
+    setvbuf(f, nullptr, _IOFBF, DATABASE_STREAM_BUF_SIZE);
+    setvbuf(out, nullptr, _IOFBF, DATABASE_STREAM_BUF_SIZE);
+
+    // The features are copied from the old file, the ones in memory may be quantized.
+    database_header header;
+    bool ok = fread(&header, sizeof(database_header), 1, f) == 1;
+    header.next_id = m_meta.num_feats_total + 1;
+    ok = ok && fwrite(&header, sizeof(database_header), 1, out) == 1;
+    int num_live = 0;
+    database_record record;
+    while (ok && num_live < (int)m_ids.size() && fread(&record, sizeof(database_record), 1, f) == 1) {
+        if (record.type != DATABASE_RECORD_ENROLL) {
+            continue;
+        }
+        if (fread(m_feat_buf.data(), sizeof(float), m_meta.feat_len, f) != m_meta.feat_len) {
+            break;
+        }
+        if (std::binary_search(m_ids.begin(), m_ids.end(), record.id)) {
+            ok = fwrite(&record, sizeof(database_record), 1, out) == 1 &&
+                fwrite(m_feat_buf.data(), sizeof(float), m_meta.feat_len, out) == m_meta.feat_len;
+            num_live++;
+        }
+    }
+    fclose(f);
+    fclose(out);
+    if (!ok || num_live != (int)m_ids.size()) {
+        ESP_LOGE(TAG, "Failed to compact db.");
+        remove(tmp_path.c_str());
+        return ESP_FAIL;
+    }
+    ESP_RETURN_ON_ERROR(replace_database(tmp_path.c_str()), TAG, "Failed to replace db.");
+    m_num_dead = 0;
+    if (!m_index || !m_index->is_trained()) {
+        // The rows are unchanged, only a file without a trained index behind it goes.
+        remove_index_file();
+    }
+    return ESP_OK;
+}
+
+const float *DataBase::get_float_feat(TensorBase *feat)
+{
+    if (feat->dtype == DATA_TYPE_FLOAT) {
+        return (float *)feat->data;
+    }
+    const int8_t *data = (int8_t *)feat->data;
+    float scale = DL_SCALE(feat->exponent);
+    for (int i = 0; i < m_meta.feat_len; i++) {
+        m_feat_buf[i] = dequantize(data[i], scale);
+    }
+    return m_feat_buf.data();
+}
+
+esp_err_t DataBase::enroll_feat(TensorBase *feat)
+{
+    if (feat->dtype != DATA_TYPE_FLOAT && feat->dtype != DATA_TYPE_INT8) {
+        ESP_LOGE(TAG, "Only support float and int8 feature.");
+        return ESP_FAIL;
+    }
+    if (feat->size != m_meta.feat_len) {
+        ESP_LOGE(TAG, "Feature len to enroll does not match feature len in db.");
+        return ESP_FAIL;
+    }
+    const float *feat_data = get_float_feat(feat);
+    // The record is logged first, memory and index only change once it is accepted.
+    database_record record = {DATABASE_RECORD_ENROLL, m_meta.num_feats_total + 1};
+    ESP_RETURN_ON_ERROR(append_record(record, feat_data), TAG, "Failed to write feature.");
+    m_meta.num_feats_total++;
+    m_meta.num_feats_valid++;
+    push_row(m_meta.num_feats_total, feat_data);
+    if (m_index) {
+        if (m_index->is_trained()) {
+            m_index->add(feat_data);
+            return save_index(true);
+        } else if (m_index->can_train(m_feats)) {
+            m_index->train(m_feats);
+        }
+    }
+    return save_index(false);
+}
+
+esp_err_t DataBase::delete_feat(uint32_t id)
+{
+    auto it = std::lower_bound(m_ids.begin(), m_ids.end(), id);
+    if (it == m_ids.end() || *it != id) {
+        ESP_LOGW(TAG, "Invalid id to delete.");
+        return ESP_FAIL;
+    }
+    database_record record = {DATABASE_RECORD_DELETE, id};
+    ESP_RETURN_ON_ERROR(append_record(record, nullptr), TAG, "Failed to write tombstone.");
+    int row = it - m_ids.begin();
+    erase_row(row);
+    m_meta.num_feats_valid--;
+    // The enroll record and its tombstone.
+    m_num_dead += 2;
+
+    if (m_index && m_index->is_trained()) {
+        m_index->erase(row);
+    }
+    esp_err_t ret = save_index(false);
+    if (m_num_dead >= DATABASE_COMPACT_MIN_DEAD && m_num_dead > (int)m_ids.size()) {
+        // The delete is already logged, a failed compaction leaves a longer but valid log.
+        ESP_RETURN_ON_ERROR(compact(), TAG, "Failed to compact db.");
+    }
+    return ret;
+}
+
+esp_err_t DataBase::delete_last_feat()
+{
+    if (m_ids.empty()) {
+        ESP_LOGW(TAG, "Empty db, nothing to delete");
+        return ESP_FAIL;
+    }
+    uint32_t id = m_ids.back();
+    return delete_feat(id);
+}
+
+std::vector<result_t> DataBase::query_feat(TensorBase *feat, float thr, int top_k)
+{
+    if (top_k < 1) {
+        ESP_LOGW(TAG, "Top_k should be greater than 0.");
+        return {};
+    }
+    if (feat->dtype != DATA_TYPE_FLOAT && feat->dtype != DATA_TYPE_INT8) {
+        ESP_LOGE(TAG, "Only support float and int8 feature.");
+        return {};
+    }
+    std::vector<result_t> results;
+    if (m_index && m_index->is_trained()) {
+        m_index->query(m_feats, get_float_feat(feat), thr, top_k, results);
+    } else if (feat->dtype == DATA_TYPE_INT8 && m_feats.get_dtype() == DATA_TYPE_INT8) {
+        // An int8 feature from FeatPostprocessor is searched as is.
+        m_feats.query((int8_t *)feat->data, DL_SCALE(feat->exponent), thr, top_k, results);
+    } else {
+        m_feats.query(get_float_feat(feat), thr, top_k, results);
+    }
+    return results;
+}
+
+esp_err_t DataBase::enable_ivf_index(int nlist, int nprobe)
+{
+    if (nlist < 1 || nlist > UINT16_MAX) {
+        ESP_LOGE(TAG, "Invalid nlist.");
+        return ESP_FAIL;
+    }
+    delete m_index;
+    m_index = new IVFIndex(m_meta.feat_len, nlist, nprobe);
+    if (m_index->load(m_index_path.c_str(), m_feats.size(), m_content_hash) == ESP_OK) {
+        return ESP_OK;
+    }
+    if (m_index->can_train(m_feats)) {
+        m_index->train(m_feats);
+    }
+    return save_index(false);
+}
+
+void DataBase::set_nprobe(int nprobe)
+{
+    if (m_index) {
+        m_index->set_nprobe(nprobe);
+    }
+}
+
+void DataBase::print()
+{
+    printf("\n");
+    printf("[db meta]\nnum_feats_total: %lu, num_feats_valid: %lu, feat_len: %d\n",
+           (unsigned long)m_meta.num_feats_total,
+           (unsigned long)m_meta.num_feats_valid,
+           m_meta.feat_len);
+    printf("[feats]\n");
+    for (int i = 0; i < m_feats.size(); i++) {
+        m_feats.get(i, m_feat_buf.data());
+        printf("id: %lu feat: ", (unsigned long)m_ids[i]);
+        for (int j = 0; j < m_meta.feat_len; j++) {
+            printf("%f, ", m_feat_buf[j]);
+        }
+        printf("\n");
+    }
+    printf("\n");
+}
+
+} // namespace recognition
+} // namespace dl
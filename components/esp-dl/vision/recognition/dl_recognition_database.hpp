@@ -0,0 +1,105 @@
+#pragma once
+#include "dl_recognition_define.hpp"
+#include "dl_recognition_feat_matrix.hpp"
+#include "dl_recognition_ivf_index.hpp"
+#include "dl_tensor_base.hpp"
+#include "esp_check.h"
+#include "esp_system.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace dl {
+namespace recognition {
+/**
+ * @brief Feature database persisted as an append-only log.
+ *
+ * The file is a database_header followed by enroll records (id + feature) and delete records (tombstones). Enroll
+ * and delete only append a record, optionally batched in memory, and never rewrite the header or seek. The log is
+ * compacted into a new file, keeping only the live enroll records, once the dead records outnumber the live ones.
+ * Files of the previous in place format are converted on load.
+ */
+class DataBase {
+public:
+    /**
+     * @brief Construct a new DataBase object.
+     *
+     * @param db_path  path of the database file, features are always stored as float in it
+     * @param feat_len length of a feature
+     * @param dtype    in memory type of the features, DATA_TYPE_INT8 / DATA_TYPE_INT16 quantize them symmetrically
+     *                 per feature to speed up query_feat and save memory
+     */
+    DataBase(const char *db_path, int feat_len, dtype_t dtype = DATA_TYPE_FLOAT);
+    virtual ~DataBase();
+    esp_err_t clear_all_feats();
+    esp_err_t enroll_feat(TensorBase *feat);
+    esp_err_t delete_feat(uint32_t id);
+    esp_err_t delete_last_feat();
+    std::vector<result_t> query_feat(TensorBase *feat, float thr, int top_k);
+    /**
+     * @brief Enable an approximate IVF index for query_feat, see IVFIndex.
+     *
+     * The index is stored in "<db_path>.ivf" and loaded from there if it was saved for the same features. Otherwise it
+     * is trained as soon as the database holds IVFIndex::TRAIN_MIN_PER_LIST * nlist features, until then queries scan
+     * all features. Features enrolled later are added to it incrementally. Without a trained index the file is removed
+     * on every change of the database.
+     *
+     * @param nlist  number of lists, about sqrt(number of features) is a good start
+     * @param nprobe number of lists scanned per query, higher is slower with better recall
+     * @return esp_err_t
+     */
+    esp_err_t enable_ivf_index(int nlist, int nprobe);
+    void set_nprobe(int nprobe);
+    /**
+     * @brief Keep up to num enroll / delete records in memory before appending them to the file with one write.
+     *
+     * Batching reduces flash wear and enroll latency, records not flushed yet are lost on power failure.
+     *
+     * @param num number of records per write, 1 (default) writes through
+     * @return esp_err_t
+     */
+    esp_err_t set_write_batch(int num);
+    /**
+     * @brief Append all batched records to the file.
+     */
+    esp_err_t flush();
+    /**
+     * @brief Rewrite the file with only the live enroll records.
+     *
+     * Called automatically by delete_feat when more than half of the records are dead. It streams the file once, so it
+     * can also be called from a low priority task when the device is idle.
+     */
+    esp_err_t compact();
+    void print();
+    int get_num_feats() { return m_meta.num_feats_valid; }
+
+private:
+    char *m_db_path;
+    std::vector<uint32_t> m_ids;        /*!< id of each row of m_feats, ascending */
+    std::vector<uint32_t> m_row_hashes; /*!< hash of the id and feature of each row */
+    uint32_t m_content_hash;            /*!< sum of m_row_hashes, ties the index file to the rows */
+    FeatMatrix m_feats;
+    database_meta m_meta;
+    std::vector<float> m_feat_buf;
+    IVFIndex *m_index;
+    std::string m_index_path;
+    bool m_has_index_file;
+    std::vector<uint8_t> m_pending; /*!< records not written yet */
+    int m_num_pending;
+    int m_write_batch;
+    int m_num_dead; /*!< deleted enroll records and tombstones in the file */
+
+    esp_err_t create_empty_database_in_storage(int feat_len);
+    esp_err_t load_database_from_storage(int feat_len);
+    esp_err_t convert_legacy_database(int feat_len);
+    esp_err_t replace_database(const char *tmp_path);
+    esp_err_t append_record(const database_record &record, const float *feat);
+    void push_row(uint32_t id, const float *feat);
+    void erase_row(int row);
+    esp_err_t save_index(bool last);
+    void remove_index_file();
+    const float *get_float_feat(TensorBase *feat);
+    void clear_all_feats_in_memory();
+};
+} // namespace recognition
+} // namespace dl
@@ -0,0 +1,43 @@
+#pragma once
+#include <cstdint>
+
+namespace dl {
+namespace recognition {
+typedef struct {
+    uint32_t num_feats_total; /*!< last id handed out, ids are never reused */
+    uint32_t num_feats_valid;
+    uint16_t feat_len;
+} database_meta;
+
+/**
+ * @brief Header of the database file, followed by an append-only log of database_record.
+ */
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t feat_len;
+    uint32_t next_id; /*!< first id not handed out when the file was created / compacted */
+} database_header;
+
+typedef enum {
+    DATABASE_RECORD_ENROLL = 1, /*!< followed by feat_len floats */
+    DATABASE_RECORD_DELETE = 2, /*!< tombstone of an enrolled id */
+} database_record_type_t;
+
+typedef struct {
+    uint32_t type; /*!< database_record_type_t */
+    uint32_t id;
+} database_record;
+
+typedef struct {
+    uint32_t id;
+    float *feat;
+} database_feat;
+
+typedef struct {
+    uint32_t id;
+    float similarity;
+} result_t;
+
+} // namespace recognition
+} // namespace dl
@@ -0,0 +1,291 @@
+#include "dl_recognition_feat_matrix.hpp"
+#include "esp_heap_caps.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace dl {
+namespace recognition {
+/**
+ * @brief Result order, higher similarity first, lower row first on ties.
+ */
+static inline bool result_greater(const result_t &a, const result_t &b)
+{
+    return a.similarity > b.similarity || (a.similarity == b.similarity && a.id < b.id);
+}
+
+/**
+ * @brief Keep the best top_k results in a heap whose front is the worst of them.
+ */
+static inline void push_result(std::vector<result_t> &heap, int top_k, uint32_t id, float similarity)
+{
+    result_t result = {id, similarity};
+    if (heap.size() < (size_t)top_k) {
+        heap.push_back(result);
+        std::push_heap(heap.begin(), heap.end(), result_greater);
+    } else if (result_greater(result, heap.front())) {
+        std::pop_heap(heap.begin(), heap.end(), result_greater);
+        heap.back() = result;
+        std::push_heap(heap.begin(), heap.end(), result_greater);
+    }
+}
+
+FeatMatrix::FeatMatrix(int feat_len, dtype_t dtype) :
+    m_dtype(dtype), m_feat_len(feat_len), m_num(0), m_capacity(0), m_data(nullptr)
+{
+    assert(dtype == DATA_TYPE_FLOAT || dtype == DATA_TYPE_INT16 || dtype == DATA_TYPE_INT8);
+    if (m_dtype != DATA_TYPE_FLOAT) {
+        m_query.resize(m_feat_len * dtype_sizeof(m_dtype));
+    }
+}
+
+FeatMatrix::~FeatMatrix()
+{
+    heap_caps_free(m_data);
+}
+
+void FeatMatrix::reserve(int capacity)
+{
+    if (capacity <= m_capacity) {
+        return;
+    }
+    size_t row_bytes = m_feat_len * dtype_sizeof(m_dtype);
+    void *data = heap_caps_aligned_alloc(16, capacity * row_bytes, MALLOC_CAP_SPIRAM);
+    assert(data);
+    if (m_data) {
+        memcpy(data, m_data, m_num * row_bytes);
+        heap_caps_free(m_data);
+    }
+    m_data = data;
+    m_capacity = capacity;
+}
+
+template <typename T>
+void FeatMatrix::quantize_row(const float *feat, T *row, float &scale)
+{
+    const float qmax = (float)std::numeric_limits<T>::max();
+    float max_abs = 0;
+    for (int i = 0; i < m_feat_len; i++) {
+        max_abs = DL_MAX(max_abs, fabsf(feat[i]));
+    }
+    scale = max_abs > 0 ? max_abs / qmax : 1.f;
+    float inv_scale = 1.f / scale;
+    for (int i = 0; i < m_feat_len; i++) {
+        row[i] = (T)DL_CLIP(lroundf(feat[i] * inv_scale), -qmax, qmax);
+    }
+}
+
+void FeatMatrix::push(const float *feat)
+{
+    if (m_num == m_capacity) {
+        reserve(DL_MAX(16, m_capacity * 2));
+    }
+    if (m_dtype == DATA_TYPE_FLOAT) {
+        memcpy((float *)m_data + m_num * m_feat_len, feat, m_feat_len * sizeof(float));
+    } else {
+        float scale;
+        if (m_dtype == DATA_TYPE_INT8) {
+            quantize_row(feat, (int8_t *)m_data + m_num * m_feat_len, scale);
+        } else {
+            quantize_row(feat, (int16_t *)m_data + m_num * m_feat_len, scale);
+        }
+        m_scales.push_back(scale);
+    }
+    m_num++;
+}
+
+void FeatMatrix::erase(int index)
+{
+    assert(index >= 0 && index < m_num);
+    size_t row_bytes = m_feat_len * dtype_sizeof(m_dtype);
+    uint8_t *row = (uint8_t *)m_data + index * row_bytes;
+    memmove(row, row + row_bytes, (m_num - index - 1) * row_bytes);
+    if (m_dtype != DATA_TYPE_FLOAT) {
+        m_scales.erase(m_scales.begin() + index);
+    }
+    m_num--;
+}
+
+void FeatMatrix::erase(const std::vector<int> &rows)
+{
+    if (rows.empty()) {
+        return;
+    }
+    size_t row_bytes = m_feat_len * dtype_sizeof(m_dtype);
+    uint8_t *data = (uint8_t *)m_data;
+    int dst = rows[0];
+    for (int i = 0; i < (int)rows.size(); i++) {
+        assert(rows[i] >= 0 && rows[i] < m_num && (i == 0 || rows[i] > rows[i - 1]));
+        int src = rows[i] + 1;
+        int end = i + 1 < (int)rows.size() ? rows[i + 1] : m_num;
+        memmove(data + dst * row_bytes, data + src * row_bytes, (end - src) * row_bytes);
+        if (m_dtype != DATA_TYPE_FLOAT) {
+            std::copy(m_scales.begin() + src, m_scales.begin() + end, m_scales.begin() + dst);
+        }
+        dst += end - src;
+    }
+    m_num = dst;
+    if (m_dtype != DATA_TYPE_FLOAT) {
+        m_scales.resize(m_num);
+    }
+}
+
+void FeatMatrix::clear()
+{
+    m_num = 0;
+    m_scales.clear();
+}
+
+void FeatMatrix::get(int index, float *feat) const
+{
+    assert(index >= 0 && index < m_num);
+    if (m_dtype == DATA_TYPE_FLOAT) {
+        memcpy(feat, (float *)m_data + index * m_feat_len, m_feat_len * sizeof(float));
+    } else if (m_dtype == DATA_TYPE_INT8) {
+        const int8_t *row = (int8_t *)m_data + index * m_feat_len;
+        for (int i = 0; i < m_feat_len; i++) {
+            feat[i] = row[i] * m_scales[index];
+        }
+    } else {
+        const int16_t *row = (int16_t *)m_data + index * m_feat_len;
+        for (int i = 0; i < m_feat_len; i++) {
+            feat[i] = row[i] * m_scales[index];
+        }
+    }
+}
+
+template <typename T, typename AccT>
+void FeatMatrix::query_quant(
+    const T *q, float q_scale, float thr, int top_k, const int *rows, int num, std::vector<result_t> &results)
+{
+    const T *data = (const T *)m_data;
+    int n = m_feat_len;
+    int i = 0;
+    for (; i + 4 <= num; i += 4) {
+        int index[4];
+        for (int k = 0; k < 4; k++) {
+            index[k] = rows ? rows[i + k] : i + k;
+        }
+        const T *r0 = data + index[0] * n;
+        const T *r1 = data + index[1] * n;
+        const T *r2 = data + index[2] * n;
+        const T *r3 = data + index[3] * n;
+        AccT acc0 = 0, acc1 = 0, acc2 = 0, acc3 = 0;
+        for (int j = 0; j < n; j++) {
+            AccT qj = q[j];
+            acc0 += r0[j] * qj;
+            acc1 += r1[j] * qj;
+            acc2 += r2[j] * qj;
+            acc3 += r3[j] * qj;
+        }
+        AccT acc[4] = {acc0, acc1, acc2, acc3};
+        for (int k = 0; k < 4; k++) {
+            float sim = acc[k] * m_scales[index[k]] * q_scale;
+            if (sim > thr) {
+                push_result(results, top_k, index[k] + 1, sim);
+            }
+        }
+    }
+    for (; i < num; i++) {
+        int index = rows ? rows[i] : i;
+        const T *r = data + index * n;
+        AccT acc = 0;
+        for (int j = 0; j < n; j++) {
+            acc += r[j] * (AccT)q[j];
+        }
+        float sim = acc * m_scales[index] * q_scale;
+        if (sim > thr) {
+            push_result(results, top_k, index + 1, sim);
+        }
+    }
+}
+
+void FeatMatrix::query_float(
+    const float *feat, float thr, int top_k, const int *rows, int num, std::vector<result_t> &results)
+{
+    const float *data = (const float *)m_data;
+    int n = m_feat_len;
+    int i = 0;
+    for (; i + 4 <= num; i += 4) {
+        int index[4];
+        for (int k = 0; k < 4; k++) {
+            index[k] = rows ? rows[i + k] : i + k;
+        }
+        const float *r0 = data + index[0] * n;
+        const float *r1 = data + index[1] * n;
+        const float *r2 = data + index[2] * n;
+        const float *r3 = data + index[3] * n;
+        float acc[4] = {0, 0, 0, 0};
+        for (int j = 0; j < n; j++) {
+            float qj = feat[j];
+            acc[0] += r0[j] * qj;
+            acc[1] += r1[j] * qj;
+            acc[2] += r2[j] * qj;
+            acc[3] += r3[j] * qj;
+        }
+        for (int k = 0; k < 4; k++) {
+            if (acc[k] > thr) {
+                push_result(results, top_k, index[k] + 1, acc[k]);
+            }
+        }
+    }
+    for (; i < num; i++) {
+        int index = rows ? rows[i] : i;
+        const float *r = data + index * n;
+        float acc = 0;
+        for (int j = 0; j < n; j++) {
+            acc += r[j] * feat[j];
+        }
+        if (acc > thr) {
+            push_result(results, top_k, index + 1, acc);
+        }
+    }
+}
+
+void FeatMatrix::query(
+    const float *feat, float thr, int top_k, std::vector<result_t> &results, const std::vector<int> *rows)
+{
+    results.clear();
+    if (top_k <= 0) {
+        return;
+    }
+    results.reserve(top_k);
+    const int *rows_ptr = rows ? rows->data() : nullptr;
+    int num = rows ? rows->size() : m_num;
+    float q_scale;
+    if (m_dtype == DATA_TYPE_INT8) {
+        int8_t *q = (int8_t *)m_query.data();
+        quantize_row(feat, q, q_scale);
+        // |int8 * int8| <= 2^14, int32 accumulation is safe up to 2^17 elements.
+        query_quant<int8_t, int32_t>(q, q_scale, thr, top_k, rows_ptr, num, results);
+    } else if (m_dtype == DATA_TYPE_INT16) {
+        int16_t *q = (int16_t *)m_query.data();
+        quantize_row(feat, q, q_scale);
+        query_quant<int16_t, int64_t>(q, q_scale, thr, top_k, rows_ptr, num, results);
+    } else {
+        query_float(feat, thr, top_k, rows_ptr, num, results);
+    }
+    std::sort_heap(results.begin(), results.end(), result_greater);
+}
+
+void FeatMatrix::query(const int8_t *feat,
+                       float scale,
+                       float thr,
+                       int top_k,
+                       std::vector<result_t> &results,
+                       const std::vector<int> *rows)
+{
+    assert(m_dtype == DATA_TYPE_INT8);
+    results.clear();
+    if (top_k <= 0) {
+        return;
+    }
+    results.reserve(top_k);
+    const int *rows_ptr = rows ? rows->data() : nullptr;
+    int num = rows ? rows->size() : m_num;
+    query_quant<int8_t, int32_t>(feat, scale, thr, top_k, rows_ptr, num, results);
+    std::sort_heap(results.begin(), results.end(), result_greater);
+}
+} // namespace recognition
+} // namespace dl
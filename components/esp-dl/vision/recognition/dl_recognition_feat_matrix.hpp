@@ -0,0 +1,106 @@
+#pragma once
+#include "dl_recognition_define.hpp"
+#include "dl_tensor_base.hpp"
+#include <vector>
+
+namespace dl {
+namespace recognition {
+/**
+ * @brief Enrolled features packed row by row into one contiguous buffer.
+ *
+ * Rows are stored as float or symmetrically quantized to int8 / int16 with one scale per row. L2 normalized features
+ * have a small dynamic range, int8 keeps the cosine similarity within about 1e-3 while reading 4x less memory per
+ * query. A query is quantized the same way and the similarity of four rows is accumulated at once in integers, so
+ * the query stays in registers / cache while the gallery is streamed. The best top_k rows are kept in a heap.
+ */
+class FeatMatrix {
+private:
+    dtype_t m_dtype;
+    int m_feat_len;
+    int m_num;
+    int m_capacity;
+    void *m_data;                /*!< m_capacity rows of m_feat_len elements */
+    std::vector<float> m_scales; /*!< per row dequantize scale, quantized types only */
+    std::vector<int8_t> m_query; /*!< quantized query buffer */
+
+    void reserve(int capacity);
+    template <typename T>
+    void quantize_row(const float *feat, T *row, float &scale);
+    template <typename T, typename AccT>
+    void query_quant(const T *q,
+                     float q_scale,
+                     float thr,
+                     int top_k,
+                     const int *rows,
+                     int num,
+                     std::vector<result_t> &results);
+    void query_float(const float *feat, float thr, int top_k, const int *rows, int num, std::vector<result_t> &results);
+
+public:
+    /**
+     * @brief Construct a new FeatMatrix object.
+     *
+     * @param feat_len length of a feature
+     * @param dtype    storage type, DATA_TYPE_FLOAT, DATA_TYPE_INT16 or DATA_TYPE_INT8
+     */
+    FeatMatrix(int feat_len, dtype_t dtype = DATA_TYPE_FLOAT);
+    ~FeatMatrix();
+
+    int size() const { return m_num; }
+    dtype_t get_dtype() const { return m_dtype; }
+
+    /**
+     * @brief Append a float feature as the last row.
+     */
+    void push(const float *feat);
+
+    /**
+     * @brief Remove a row, the following rows move up by one.
+     */
+    void erase(int index);
+
+    /**
+     * @brief Remove several rows in one pass, rows must be ascending.
+     */
+    void erase(const std::vector<int> &rows);
+
+    /**
+     * @brief Remove all rows, the buffer is kept.
+     */
+    void clear();
+
+    /**
+     * @brief Dequantize a row into feat.
+     */
+    void get(int index, float *feat) const;
+
+    /**
+     * @brief Find the rows most similar (dot product) to a float feature.
+     *
+     * @param feat    query feature of feat_len floats
+     * @param thr     only rows with similarity greater than thr are returned
+     * @param top_k   maximum number of results, no results if it is not positive
+     * @param results results in descending similarity, id is the 1-based row index
+     * @param rows    only search these rows, nullptr for all of them
+     */
+    void query(const float *feat,
+               float thr,
+               int top_k,
+               std::vector<result_t> &results,
+               const std::vector<int> *rows = nullptr);
+
+    /**
+     * @brief Same as query with an int8 feature, only for DATA_TYPE_INT8 storage. The query is used as is.
+     *
+     * @param feat  query feature of feat_len int8 values
+     * @param scale dequantize scale of feat
+     */
+    void query(const int8_t *feat,
+               float scale,
+               float thr,
+               int top_k,
+               std::vector<result_t> &results,
+               const std::vector<int> *rows = nullptr);
+};
+} // namespace recognition
+} // namespace dl
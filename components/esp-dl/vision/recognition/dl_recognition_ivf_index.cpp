@@ -0,0 +1,242 @@
+#include "dl_recognition_ivf_index.hpp"
+#include "dl_math.hpp"
+#include "esp_log.h"
+#include <algorithm>
+#include <cstdio>
+
+static const char *TAG = "dl::recognition::IVFIndex";
+
+namespace dl {
+namespace recognition {
+typedef struct {
+    uint32_t magic;
+    uint16_t nlist;
+    uint16_t feat_len;
+    uint32_t num_rows;
+    uint32_t db_hash; /*!< content hash of the database the index was built for */
+} ivf_meta;
+
+static const uint32_t IVF_MAGIC = 0x32465649; // "IVF2"
+
+static inline float dot(const float *a, const float *b, int n)
+{
+    float sum = 0;
+    for (int i = 0; i < n; i++) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+static inline void normalize(float *feat, int n)
+{
+    float norm = dl::math::sqrt_newton(dot(feat, feat, n));
+    if (norm > 0) {
+        float inv_norm = 1.f / norm;
+        for (int i = 0; i < n; i++) {
+            feat[i] *= inv_norm;
+        }
+    }
+}
+
+IVFIndex::IVFIndex(int feat_len, int nlist, int nprobe) : m_feat_len(feat_len), m_nlist(nlist)
+{
+    assert(nlist > 0 && nlist <= UINT16_MAX);
+    set_nprobe(nprobe);
+}
+
+int IVFIndex::nearest_centroid(const float *feat) const
+{
+    int best = 0;
+    float best_sim = dot(feat, m_centroids.data(), m_feat_len);
+    for (int c = 1; c < m_nlist; c++) {
+        float sim = dot(feat, m_centroids.data() + c * m_feat_len, m_feat_len);
+        if (sim > best_sim) {
+            best_sim = sim;
+            best = c;
+        }
+    }
+    return best;
+}
+
+void IVFIndex::build_lists()
+{
+    m_lists.assign(m_nlist, {});
+    for (int i = 0; i < (int)m_assign.size(); i++) {
+        m_lists[m_assign[i]].push_back(i);
+    }
+}
+
+void IVFIndex::train(const FeatMatrix &feats)
+{
+    int num = feats.size();
+    assert(num >= m_nlist);
+    int num_sample = DL_MIN(num, TRAIN_MAX_PER_LIST * m_nlist);
+    std::vector<float> feat(m_feat_len);
+    std::vector<float> sums(m_nlist * m_feat_len);
+    std::vector<int> counts(m_nlist);
+    auto sample_row = [num, num_sample](int s) { return (int)((int64_t)s * num / num_sample); };
+
+    // Spherical k-means on an evenly strided sample, initialized with evenly strided sample rows.
+    m_centroids.resize(m_nlist * m_feat_len);
+    for (int c = 0; c < m_nlist; c++) {
+        feats.get(sample_row(c * num_sample / m_nlist), m_centroids.data() + c * m_feat_len);
+        normalize(m_centroids.data() + c * m_feat_len, m_feat_len);
+    }
+    for (int iter = 0; iter < TRAIN_ITERATIONS; iter++) {
+        std::fill(sums.begin(), sums.end(), 0.f);
+        std::fill(counts.begin(), counts.end(), 0);
+        for (int s = 0; s < num_sample; s++) {
+            feats.get(sample_row(s), feat.data());
+            int c = nearest_centroid(feat.data());
+            float *sum = sums.data() + c * m_feat_len;
+            for (int i = 0; i < m_feat_len; i++) {
+                sum[i] += feat[i];
+            }
+            counts[c]++;
+        }
+        for (int c = 0; c < m_nlist; c++) {
+            // An empty list keeps its centroid.
+            if (counts[c] > 0) {
+                float *centroid = m_centroids.data() + c * m_feat_len;
+                std::copy(sums.begin() + c * m_feat_len, sums.begin() + (c + 1) * m_feat_len, centroid);
+                normalize(centroid, m_feat_len);
+            }
+        }
+    }
+
+    m_assign.resize(num);
+    for (int i = 0; i < num; i++) {
+        feats.get(i, feat.data());
+        m_assign[i] = nearest_centroid(feat.data());
+    }
+    build_lists();
+}
+
+void IVFIndex::reset()
+{
+    m_centroids.clear();
+    m_assign.clear();
+    m_lists.clear();
+}
+
+void IVFIndex::add(const float *feat)
+{
+    assert(is_trained());
+    int c = nearest_centroid(feat);
+    m_lists[c].push_back(m_assign.size());
+    m_assign.push_back(c);
+}
+
+void IVFIndex::erase(int row)
+{
+    m_assign.erase(m_assign.begin() + row);
+    build_lists();
+}
+
+void IVFIndex::query(FeatMatrix &feats, const float *feat, float thr, int top_k, std::vector<result_t> &results)
+{
+    if (m_nprobe == m_nlist) {
+        feats.query(feat, thr, top_k, results);
+        return;
+    }
+    m_probes.resize(m_nlist);
+    for (int c = 0; c < m_nlist; c++) {
+        m_probes[c] = {(uint32_t)c, dot(feat, m_centroids.data() + c * m_feat_len, m_feat_len)};
+    }
+    std::partial_sort(m_probes.begin(),
+                      m_probes.begin() + m_nprobe,
+                      m_probes.end(),
+                      [](const result_t &a, const result_t &b) { return a.similarity > b.similarity; });
+
+    m_rows.clear();
+    for (int p = 0; p < m_nprobe; p++) {
+        const std::vector<int> &list = m_lists[m_probes[p].id];
+        m_rows.insert(m_rows.end(), list.begin(), list.end());
+    }
+    // Scan in memory order.
+    std::sort(m_rows.begin(), m_rows.end());
+    feats.query(feat, thr, top_k, results, &m_rows);
+}
+
+esp_err_t IVFIndex::save(const char *path, uint32_t db_hash) const
+{
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        ESP_LOGE(TAG, "Failed to open index.");
+        return ESP_FAIL;
+    }
+    ivf_meta meta = {IVF_MAGIC, (uint16_t)m_nlist, (uint16_t)m_feat_len, (uint32_t)m_assign.size(), db_hash};
+    if (fwrite(&meta, sizeof(ivf_meta), 1, f) != 1 ||
+        fwrite(m_centroids.data(), sizeof(float), m_centroids.size(), f) != m_centroids.size() ||
+        fwrite(m_assign.data(), sizeof(uint16_t), m_assign.size(), f) != m_assign.size()) {
+        ESP_LOGE(TAG, "Failed to write index.");
+        fclose(f);
+        return ESP_FAIL;
+    }
+    fclose(f);
+    return ESP_OK;
+}
+
+esp_err_t IVFIndex::save_last(const char *path, uint32_t db_hash) const
+{
+    FILE *f = fopen(path, "rb+");
+    if (!f) {
+        ESP_LOGE(TAG, "Failed to open index.");
+        return ESP_FAIL;
+    }
+    ivf_meta meta = {IVF_MAGIC, (uint16_t)m_nlist, (uint16_t)m_feat_len, (uint32_t)m_assign.size(), db_hash};
+    if (fwrite(&meta, sizeof(ivf_meta), 1, f) != 1) {
+        ESP_LOGE(TAG, "Failed to write index meta.");
+        fclose(f);
+        return ESP_FAIL;
+    }
+    if (fseek(f, 0, SEEK_END) != 0) {
+        ESP_LOGE(TAG, "Failed to seek index file.");
+        fclose(f);
+        return ESP_FAIL;
+    }
+    if (fwrite(&m_assign.back(), sizeof(uint16_t), 1, f) != 1) {
+        ESP_LOGE(TAG, "Failed to write assignment.");
+        fclose(f);
+        return ESP_FAIL;
+    }
+    fclose(f);
+    return ESP_OK;
+}
+
+esp_err_t IVFIndex::load(const char *path, int num_rows, uint32_t db_hash)
+{
+    reset();
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        return ESP_FAIL;
+    }
+    ivf_meta meta;
+    if (fread(&meta, sizeof(ivf_meta), 1, f) != 1 || meta.magic != IVF_MAGIC || meta.nlist != m_nlist ||
+        meta.feat_len != m_feat_len || meta.num_rows != (uint32_t)num_rows || meta.db_hash != db_hash) {
+        ESP_LOGW(TAG, "Index does not match the database, it will be trained again.");
+        fclose(f);
+        return ESP_FAIL;
+    }
+    m_centroids.resize(m_nlist * m_feat_len);
+    m_assign.resize(num_rows);
+    if (fread(m_centroids.data(), sizeof(float), m_centroids.size(), f) != m_centroids.size() ||
+        fread(m_assign.data(), sizeof(uint16_t), m_assign.size(), f) != m_assign.size()) {
+        ESP_LOGE(TAG, "Failed to read index.");
+        fclose(f);
+        reset();
+        return ESP_FAIL;
+    }
+    fclose(f);
+    for (uint16_t c : m_assign) {
+        if (c >= m_nlist) {
+            ESP_LOGE(TAG, "Invalid assignment in index.");
+            reset();
+            return ESP_FAIL;
+        }
+    }
+    build_lists();
+    return ESP_OK;
+}
+} // namespace recognition
+} // namespace dl
@@ -0,0 +1,101 @@
+#pragma once
+#include "dl_recognition_feat_matrix.hpp"
+#include "esp_err.h"
+#include <vector>
+
+namespace dl {
+namespace recognition {
+/**
+ * @brief Inverted file (IVF) index over the rows of a FeatMatrix.
+ *
+ * The gallery is partitioned by nlist centroids trained with spherical k-means, each row is listed under its most
+ * similar centroid. A query ranks the centroids and only scans the rows of the best nprobe lists, so the query cost
+ * drops to about nprobe / nlist of a full scan. nprobe trades recall for latency, nprobe = nlist is exact.
+ *
+ * The index is trained once the gallery has TRAIN_MIN_PER_LIST * nlist rows, rows enrolled after that are assigned to
+ * the existing centroids. The centroids and the assignment of every row are persisted in a separate file, so the
+ * index does not need to be trained again at boot. The file carries a content hash of the database it was built for
+ * and is only loaded back for the same content.
+ */
+class IVFIndex {
+private:
+    int m_feat_len;
+    int m_nlist;
+    int m_nprobe;
+    std::vector<float> m_centroids;        /*!< nlist * feat_len L2 normalized centroids, empty until trained */
+    std::vector<uint16_t> m_assign;        /*!< list of each row */
+    std::vector<std::vector<int>> m_lists; /*!< rows of each list */
+    std::vector<int> m_rows;               /*!< rows to scan of the current query */
+    std::vector<result_t> m_probes;        /*!< centroids to probe of the current query */
+
+    int nearest_centroid(const float *feat) const;
+    void build_lists();
+
+public:
+    static const int TRAIN_MIN_PER_LIST = 16; /*!< rows per list needed to train */
+    static const int TRAIN_MAX_PER_LIST = 64; /*!< rows per list sampled for training */
+    static const int TRAIN_ITERATIONS = 8;    /*!< k-means iterations */
+
+    /**
+     * @brief Construct a new IVFIndex object.
+     *
+     * @param feat_len length of a feature
+     * @param nlist    number of lists, at most 65535
+     * @param nprobe   number of lists scanned per query
+     */
+    IVFIndex(int feat_len, int nlist, int nprobe);
+
+    bool is_trained() const { return !m_centroids.empty(); }
+    bool can_train(const FeatMatrix &feats) const { return feats.size() >= TRAIN_MIN_PER_LIST * m_nlist; }
+    void set_nprobe(int nprobe) { m_nprobe = DL_CLIP(nprobe, 1, m_nlist); }
+    int get_nprobe() const { return m_nprobe; }
+
+    /**
+     * @brief Train the centroids on (a sample of) the rows and assign every row.
+     */
+    void train(const FeatMatrix &feats);
+
+    /**
+     * @brief Forget the centroids and all rows.
+     */
+    void reset();
+
+    /**
+     * @brief Assign a row appended to the FeatMatrix. Only valid once trained.
+     */
+    void add(const float *feat);
+
+    /**
+     * @brief Remove a row, following rows move up by one as in FeatMatrix::erase.
+     */
+    void erase(int row);
+
+    /**
+     * @brief Query the rows of the nprobe lists most similar to feat, same output as FeatMatrix::query.
+     */
+    void query(FeatMatrix &feats, const float *feat, float thr, int top_k, std::vector<result_t> &results);
+
+    /**
+     * @brief Write the centroids and all assignments.
+     *
+     * @param path    index file
+     * @param db_hash content hash of the rows, checked by load
+     */
+    esp_err_t save(const char *path, uint32_t db_hash) const;
+
+    /**
+     * @brief Append the assignment of the last row and update the row number and hash in the header.
+     */
+    esp_err_t save_last(const char *path, uint32_t db_hash) const;
+
+    /**
+     * @brief Load an index written by save.
+     *
+     * @param path     index file
+     * @param num_rows number of rows of the gallery, the index is rejected if it does not cover exactly these rows
+     * @param db_hash  content hash of the rows, the index is rejected if it was saved for other content
+     */
+    esp_err_t load(const char *path, int num_rows, uint32_t db_hash);
+};
+} // namespace recognition
+} // namespace dl
@@ -0,0 +1,932 @@
+// Copyright 2020-2021 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+/**
+ * @file        Header definitions to include for esp_nn reference functions
+ */
+
+#include "esp_nn_defs.h"
+/************************** Basic math functions ****************************/
+
+/**
+ * @brief       elementwise addition
+ *
+ * @note        inputs type: int8_t, output: int8_t
+ *              input offsets: although int32_t, they are contained in 8 bits [-128, 127]
+ *
+ *              shift values are expected to be <= 0
+ */
+void esp_nn_add_elementwise_s8_ansi(const int8_t *input1_data,
+                                    const int8_t *input2_data,
+                                    const int32_t input1_offset,
+                                    const int32_t input2_offset,
+                                    const int32_t input1_mult,
+                                    const int32_t input2_mult,
+                                    const int32_t input1_shift,
+                                    const int32_t input2_shift,
+                                    const int32_t left_shift,
+                                    int8_t *output,
+                                    const int32_t out_offset,
+                                    const int32_t out_mult,
+                                    const int32_t out_shift,
+                                    const int32_t activation_min,
+                                    const int32_t activation_max,
+                                    const int32_t size);
+/**
+ * @brief       elementwise multiplication
+ *
+ * @note        inputs type: int8_t, output: int8_t
+ *              input offsets: although int32_t, they are contained in 8 bits [-128, 127]
+ *
+ *              output shift is expected to be <= 0
+ */
+void esp_nn_mul_elementwise_s8_ansi(const int8_t *input1_data,
+                                    const int8_t *input2_data,
+                                    const int32_t input1_offset,
+                                    const int32_t input2_offset,
+                                    int8_t *output,
+                                    const int32_t out_offset,
+                                    const int32_t out_mult,
+                                    const int32_t out_shift,
+                                    const int32_t activation_min,
+                                    const int32_t activation_max,
+                                    const int32_t size);
+
+/**
+ * @brief       elementwise addition
+ *
+ * @note        inputs type: int16_t, output: int16_t
+ *              same arithmetic as s8 version, left_shift is 15 for 16 bit data
+ */
+void esp_nn_add_elementwise_s16_ansi(const int16_t *input1_data,
+                                     const int16_t *input2_data,
+                                     const int32_t input1_offset,
+                                     const int32_t input2_offset,
+                                     const int32_t input1_mult,
+                                     const int32_t input2_mult,
+                                     const int32_t input1_shift,
+                                     const int32_t input2_shift,
+                                     const int32_t left_shift,
+                                     int16_t *output,
+                                     const int32_t out_offset,
+                                     const int32_t out_mult,
+                                     const int32_t out_shift,
+                                     const int32_t activation_min,
+                                     const int32_t activation_max,
+                                     const int32_t size);
+
+/**
+ * @brief       elementwise multiplication
+ *
+ * @note        inputs type: int16_t, output: int16_t
+ */
+void esp_nn_mul_elementwise_s16_ansi(const int16_t *input1_data,
+                                     const int16_t *input2_data,
+                                     const int32_t input1_offset,
+                                     const int32_t input2_offset,
+                                     int16_t *output,
+                                     const int32_t out_offset,
+                                     const int32_t out_mult,
+                                     const int32_t out_shift,
+                                     const int32_t activation_min,
+                                     const int32_t activation_max,
+                                     const int32_t size);
+
+/**
+ * @brief       elementwise addition
+ *
+ * @note        inputs type: float, output: float
+ */
+void esp_nn_add_elementwise_f32_ansi(const float *input1_data,
+                                     const float *input2_data,
+                                     float *output,
+                                     const float activation_min,
+                                     const float activation_max,
+                                     const int32_t size);
+
+/**
+ * @brief       elementwise multiplication
+ *
+ * @note        inputs type: float, output: float
+ */
+void esp_nn_mul_elementwise_f32_ansi(const float *input1_data,
+                                     const float *input2_data,
+                                     float *output,
+                                     const float activation_min,
+                                     const float activation_max,
+                                     const int32_t size);
+
+
+/************************** Convolution functions *****************************/
+
+/**
+ * @brief       depthwise convolution per channel
+ *
+ * @note        inputs type: int8_t, output: int8_t
+ *              Version used in tflite is per channel.
+ *              This version follows the same footsprints.
+ *              Meaning, it has per out_channel shift and multiplier for
+ *              requantization
+ *
+ *              optimization notes: Though input_offset is int32 type,
+ *              offset values are contained in 8 bits [-128, 127]
+ */
+void esp_nn_depthwise_conv_s8_ansi(const data_dims_t *input_dims,
+                                   const int8_t *input_data,
+                                   const data_dims_t *filter_dims,
+                                   const int8_t *filter_data,
+                                   const int32_t *bias,
+                                   const data_dims_t *output_dims,
+                                   int8_t *out_data,
+                                   const dw_conv_params_t *conv_params,
+                                   const quant_data_t *quant_data);
+
+/**
+ * @brief       2d-convolution channelwise
+ *
+ * @note        operation: result += (input + offset) * filter
+ *
+ *              inputs type: int8_t, output: int8_t
+ *              input offsets: although int32_t, they are contained in 8 bits [-128, 127]
+ */
+void esp_nn_conv_s8_ansi(const data_dims_t *input_dims,
+                         const int8_t *input_data,
+                         const data_dims_t *filter_dims,
+                         const int8_t *filter_data,
+                         const int32_t *bias,
+                         const data_dims_t *output_dims,
+                         int8_t *out_data,
+                         const conv_params_t *conv_params,
+                         const quant_data_t *quant_data);
+
+/**
+ * @brief       scratch buffer size and setter for conv and depthwise conv
+ *
+ * @note        the buffer set is kept per task: set it from the task that
+ *              calls the kernel. Two tasks may run a kernel at the same time,
+ *              each with its own buffer.
+ */
+int esp_nn_get_conv_scratch_size_ansi(const data_dims_t *input_dims,
+                                      const data_dims_t *filter_dims,
+                                      const data_dims_t *output_dims,
+                                      const conv_params_t *conv_params);
+void esp_nn_set_conv_scratch_buf_ansi(const void *buf);
+
+int esp_nn_get_depthwise_conv_scratch_size_ansi(const data_dims_t *input_dims,
+                                                const data_dims_t *filter_dims,
+                                                const data_dims_t *output_dims,
+                                                const dw_conv_params_t *conv_params);
+void esp_nn_set_depthwise_conv_scratch_buf_ansi(const void *buf);
+
+/**
+ * @brief       transpose convolution (deconvolution) channelwise
+ *
+ * @note        operation: output[out_pixel] += (input + offset) * filter for
+ *              every input pixel and filter tap landing on out_pixel
+ *
+ *              inputs type: int8_t, output: int8_t
+ *              filter layout: [out_ch, filter_ht, filter_wd, in_ch]
+ *              dilation is not supported
+ */
+void esp_nn_transpose_conv_s8_ansi(const data_dims_t *input_dims,
+                                   const int8_t *input_data,
+                                   const data_dims_t *filter_dims,
+                                   const int8_t *filter_data,
+                                   const int32_t *bias,
+                                   const data_dims_t *output_dims,
+                                   int8_t *out_data,
+                                   const conv_params_t *conv_params,
+                                   const quant_data_t *quant_data);
+
+/**
+ * @brief       scratch buffer size and setter for transpose conv
+ *
+ * @note        the buffer must be 4 byte aligned and is kept per task,
+ *              same as the conv scratch buffer.
+ */
+int esp_nn_get_transpose_conv_scratch_size_ansi(const data_dims_t *input_dims,
+                                                const data_dims_t *filter_dims,
+                                                const data_dims_t *output_dims,
+                                                const conv_params_t *conv_params);
+void esp_nn_set_transpose_conv_scratch_buf_ansi(const void *buf);
+
+/**
+ * @brief       depthwise convolution per channel, 16x8 quantization
+ *
+ * @note        inputs type: int16_t, filter: int8_t, bias: int64_t, output: int16_t
+ *              in_offset and out_offset are ignored, 16 bit data is symmetric.
+ *              Accumulation and requantization follow tflite int64 path.
+ */
+void esp_nn_depthwise_conv_s16_ansi(const data_dims_t *input_dims,
+                                    const int16_t *input_data,
+                                    const data_dims_t *filter_dims,
+                                    const int8_t *filter_data,
+                                    const int64_t *bias,
+                                    const data_dims_t *output_dims,
+                                    int16_t *out_data,
+                                    const dw_conv_params_t *conv_params,
+                                    const quant_data_t *quant_data);
+
+/**
+ * @brief       2d-convolution channelwise, 16x8 quantization
+ *
+ * @note        operation: result += input * filter
+ *
+ *              inputs type: int16_t, filter: int8_t, bias: int64_t, output: int16_t
+ *              in_offset and out_offset are ignored, 16 bit data is symmetric.
+ */
+void esp_nn_conv_s16_ansi(const data_dims_t *input_dims,
+                          const int16_t *input_data,
+                          const data_dims_t *filter_dims,
+                          const int8_t *filter_data,
+                          const int64_t *bias,
+                          const data_dims_t *output_dims,
+                          int16_t *out_data,
+                          const conv_params_t *conv_params,
+                          const quant_data_t *quant_data);
+
+/**
+ * @brief       depthwise convolution, float32
+ */
+void esp_nn_depthwise_conv_f32_ansi(const data_dims_t *input_dims,
+                                    const float *input_data,
+                                    const data_dims_t *filter_dims,
+                                    const float *filter_data,
+                                    const float *bias,
+                                    const data_dims_t *output_dims,
+                                    float *out_data,
+                                    const dw_conv_params_f32_t *conv_params);
+
+/**
+ * @brief       2d-convolution, float32
+ */
+void esp_nn_conv_f32_ansi(const data_dims_t *input_dims,
+                          const float *input_data,
+                          const data_dims_t *filter_dims,
+                          const float *filter_data,
+                          const float *bias,
+                          const data_dims_t *output_dims,
+                          float *out_data,
+                          const conv_params_f32_t *conv_params);
+
+/************************** Activation functions *****************************/
+
+/**
+ * @brief       relu6
+ *
+ * @note        inout: int8_t
+ */
+void esp_nn_relu6_s8_ansi(int8_t *data, uint16_t size);
+
+/**
+ * @brief       elementwise lookup table
+ *
+ * @note        inputs type: int8_t, output: int8_t
+ *              lut holds 256 entries, lut[0] being the output for input -128.
+ *              Any int8 -> int8 activation (logistic, tanh, hard_swish, elu)
+ *              with fixed quantization can be tabulated this way.
+ *              input_data and output_data may be the same buffer.
+ */
+void esp_nn_lut_s8_ansi(const int8_t *input_data,
+                        int8_t *output_data,
+                        const int8_t *lut,
+                        const int32_t size);
+
+/************************** Pooling functions *****************************/
+
+
+/**
+ * @brief       max_pool
+ *
+ * @note        inputs type: int8_t, output: int8_t
+ *              input offsets: although int32_t, they are contained in 8 bits [-128, 127]
+ */
+void esp_nn_max_pool_s8_ansi(const int8_t *input,
+                             const uint16_t input_wd,
+                             const uint16_t input_ht,
+                             int8_t *output,
+                             const uint16_t output_wd,
+                             const uint16_t output_ht,
+                             const uint16_t stride_wd,
+                             const uint16_t stride_ht,
+                             const uint16_t filter_wd,
+                             const uint16_t filter_ht,
+                             const uint16_t pad_wd,
+                             const uint16_t pad_ht,
+                             const int32_t activation_min,
+                             const int32_t activation_max,
+                             const uint16_t channels);
+
+/**
+ * @brief       avg_pool
+ *
+ * @note        inputs type: int8_t, output: int8_t
+ *              input offsets: although int32_t, they are contained in 8 bits [-128, 127]
+ */
+void esp_nn_avg_pool_s8_ansi(const int8_t *input,
+                             const uint16_t input_wd,
+                             const uint16_t input_ht,
+                             int8_t *output,
+                             const uint16_t output_wd,
+                             const uint16_t output_ht,
+                             const uint16_t stride_wd,
+                             const uint16_t stride_ht,
+                             const uint16_t filter_wd,
+                             const uint16_t filter_ht,
+                             const uint16_t pad_wd,
+                             const uint16_t pad_ht,
+                             const int32_t activation_min,
+                             const int32_t activation_max,
+                             const uint16_t channels);
+
+
+/**
+ * @brief       max_pool, float32
+ */
+void esp_nn_max_pool_f32_ansi(const float *input,
+                              const uint16_t input_wd,
+                              const uint16_t input_ht,
+                              float *output,
+                              const uint16_t output_wd,
+                              const uint16_t output_ht,
+                              const uint16_t stride_wd,
+                              const uint16_t stride_ht,
+                              const uint16_t filter_wd,
+                              const uint16_t filter_ht,
+                              const uint16_t pad_wd,
+                              const uint16_t pad_ht,
+                              const float activation_min,
+                              const float activation_max,
+                              const uint16_t channels);
+
+/**
+ * @brief       avg_pool, float32
+ */
+void esp_nn_avg_pool_f32_ansi(const float *input,
+                              const uint16_t input_wd,
+                              const uint16_t input_ht,
+                              float *output,
+                              const uint16_t output_wd,
+                              const uint16_t output_ht,
+                              const uint16_t stride_wd,
+                              const uint16_t stride_ht,
+                              const uint16_t filter_wd,
+                              const uint16_t filter_ht,
+                              const uint16_t pad_wd,
+                              const uint16_t pad_ht,
+                              const float activation_min,
+                              const float activation_max,
+                              const uint16_t channels);
+
+/************************** Fully connected functions ***********************/
+
+/**
+ * @brief       fully connected
+ *
+ * @note        inputs type: int8_t, output: int8_t
+ *              input offsets: although int32_t, they are contained in 8 bits [-128, 127]
+ */
+void esp_nn_fully_connected_s8_ansi(const int8_t *input_data,
+                                    const int32_t input_offset,
+                                    const uint16_t row_len,
+                                    const int8_t *filter_data,
+                                    const int32_t filter_offset,
+                                    const int32_t *bias,
+                                    int8_t *out_data,
+                                    const uint16_t out_channels,
+                                    const int32_t out_offset,
+                                    const int32_t out_shift,
+                                    const int32_t out_mult,
+                                    const int32_t activation_min,
+                                    const int32_t activation_max);
+
+/**
+ * @brief       fully connected
+ *
+ * @note        inputs type: int8_t, output: int8_t
+ *              input offsets: although int32_t, they are contained in 8 bits [-128, 127]
+ *              out_mult, out_shift: int32_t* containing per-channel data
+ */
+void esp_nn_fully_connected_per_ch_s8_ansi(const int8_t *input_data,
+                                    const int32_t input_offset,
+                                    const uint16_t row_len,
+                                    const int8_t *filter_data,
+                                    const int32_t filter_offset,
+                                    const int32_t *bias,
+                                    int8_t *out_data,
+                                    const uint16_t out_channels,
+                                    const int32_t out_offset,
+                                    const int32_t* out_shift,
+                                    const int32_t* out_mult,
+                                    const int32_t activation_min,
+                                    const int32_t activation_max);
+
+/**
+ * @brief       fully connected, int8 input and filter, int16 output
+ *
+ * @note        input and filter offsets are not applied: fold
+ *              input_offset * sum(filter row) into bias, filter offset is 0
+ *              bias may be NULL
+ */
+void esp_nn_fully_connected_s8_s16_ansi(const int8_t *input_data,
+                                        const uint16_t row_len,
+                                        const int8_t *filter_data,
+                                        const int32_t *bias,
+                                        int16_t *out_data,
+                                        const uint16_t out_channels,
+                                        const int32_t out_shift,
+                                        const int32_t out_mult,
+                                        const int32_t activation_min,
+                                        const int32_t activation_max);
+
+/**
+ * @brief       fully connected, 16x8 quantization
+ *
+ * @note        inputs type: int16_t, filter: int8_t, bias: int64_t, output: int16_t
+ *              input, filter and output zero points are 0 hence no offsets
+ */
+void esp_nn_fully_connected_s16_ansi(const int16_t *input_data,
+                                     const uint16_t row_len,
+                                     const int8_t *filter_data,
+                                     const int64_t *bias,
+                                     int16_t *out_data,
+                                     const uint16_t out_channels,
+                                     const int32_t out_shift,
+                                     const int32_t out_mult,
+                                     const int32_t activation_min,
+                                     const int32_t activation_max);
+
+/**
+ * @brief       fully connected, float32
+ */
+void esp_nn_fully_connected_f32_ansi(const float *input_data,
+                                     const uint16_t row_len,
+                                     const float *filter_data,
+                                     const float *bias,
+                                     float *out_data,
+                                     const uint16_t out_channels,
+                                     const float activation_min,
+                                     const float activation_max);
+
+/**
+ * @brief       batch matmul, one matrix product of the batch
+ *
+ * @note        out[row][col] = sum_k (lhs[row][k] + lhs_offset) * (rhs[col][k] + rhs_offset)
+ *              lhs: [rows, depth], rhs: [cols, depth] (i.e. transposed), out: [rows, cols]
+ *
+ *              inputs type: int8_t, output: int8_t
+ *              offsets: although int32_t, they are contained in 8 bits [-128, 127]
+ */
+void esp_nn_batch_matmul_s8_ansi(const int8_t *lhs_data,
+                                 const int32_t lhs_offset,
+                                 const int8_t *rhs_data,
+                                 const int32_t rhs_offset,
+                                 int8_t *out_data,
+                                 const int32_t rows,
+                                 const int32_t cols,
+                                 const int32_t depth,
+                                 const int32_t out_offset,
+                                 const int32_t out_mult,
+                                 const int32_t out_shift,
+                                 const int32_t activation_min,
+                                 const int32_t activation_max);
+
+/**
+ * @brief       scratch buffer size and setter for batch matmul
+ *
+ * @note        the buffer must be 4 byte aligned and is kept per task.
+ */
+int32_t esp_nn_get_batch_matmul_scratch_size_ansi(const int32_t cols, const int32_t depth);
+void esp_nn_set_batch_matmul_scratch_buf_ansi(void *buffer);
+
+/**
+ * @brief       LSTM gate pre-activations, input and recurrent fully connected
+ *              of all gates in one pass
+ *
+ * @note        filter: [gates * cells, input_len + hidden_len], every row is the
+ *              input weights followed by the recurrent weights of one cell
+ *              out[row] = sat16(fc(input) + fc(hidden)), both fc results
+ *              requantized with the per gate input_quant/recurrent_quant
+ *              (gates elements each) and saturated to int16 first.
+ *              Offsets are not applied: fold input_offset * sum(input weights)
+ *              into input_bias and hidden_offset * sum(recurrent weights) into
+ *              recurrent_bias. Biases may be NULL.
+ */
+void esp_nn_lstm_gates_s8_ansi(const int8_t *input_data,
+                               const uint16_t input_len,
+                               const int8_t *hidden_data,
+                               const uint16_t hidden_len,
+                               const int8_t *filter_data,
+                               const int32_t *input_bias,
+                               const int32_t *recurrent_bias,
+                               int16_t *out_data,
+                               const uint16_t gates,
+                               const uint16_t cells,
+                               const quant_data_t *input_quant,
+                               const quant_data_t *recurrent_quant);
+
+/**
+ * @brief       sum over the middle axis of [outer_size, reduce_size, inner_size] data
+ *
+ * @note        out[outer][inner] = sum_r (in[outer][r][inner] + input_offset), requantized
+ *              MEAN is the same with 1 / reduce_size folded into out_mult and out_shift
+ *
+ *              inputs type: int8_t, output: int8_t
+ *              input_offset: although int32_t, it is contained in 8 bits [-128, 127]
+ */
+void esp_nn_reduce_sum_s8_ansi(const int8_t *input_data,
+                               const int32_t outer_size,
+                               const int32_t reduce_size,
+                               const int32_t inner_size,
+                               const int32_t input_offset,
+                               int8_t *out_data,
+                               const int32_t out_offset,
+                               const int32_t out_mult,
+                               const int32_t out_shift,
+                               const int32_t activation_min,
+                               const int32_t activation_max);
+
+/**
+ * @brief       max over the middle axis of [outer_size, reduce_size, inner_size] data
+ *
+ * @note        input and output share scale and zero point, reduce_size > 0
+ */
+void esp_nn_reduce_max_s8_ansi(const int8_t *input_data,
+                               const int32_t outer_size,
+                               const int32_t reduce_size,
+                               const int32_t inner_size,
+                               int8_t *out_data);
+
+/**
+ * @brief       scratch buffer size and setter for reduce sum
+ *
+ * @note        the buffer must be 4 byte aligned and is kept per task.
+ */
+int32_t esp_nn_get_reduce_scratch_size_ansi(const int32_t inner_size);
+void esp_nn_set_reduce_scratch_buf_ansi(void *buffer);
+
+/**
+ * @brief       bilinear resize, integer only
+ *
+ * @note        source positions and weights in Q10, as tflite's
+ *              ResizeBilinearInteger, rounding half away from zero
+ *              input_dims->extra and output_dims->extra are the batch count
+ *
+ *              inputs type: int8_t, output: int8_t, same quantization
+ */
+void esp_nn_resize_bilinear_s8_ansi(const data_dims_t *input_dims,
+                                    const int8_t *input_data,
+                                    const data_dims_t *output_dims,
+                                    int8_t *out_data,
+                                    const resize_params_t *resize_params);
+
+/**
+ * @brief       scratch buffer size and setter for bilinear resize
+ *
+ * @note        the buffer must be 4 byte aligned and is kept per task.
+ */
+int32_t esp_nn_get_resize_bilinear_scratch_size_ansi(const data_dims_t *output_dims);
+void esp_nn_set_resize_bilinear_scratch_buf_ansi(void *buffer);
+
+/**
+ * @brief   Get scratch buffer size needed by softmax function
+ *
+ * @param   width
+ * @param   height
+ * @return  size in bytes
+ *
+ * @note    buffer must be 4 byte aligned
+ */
+int32_t esp_nn_get_softmax_scratch_size_ansi(const int32_t width, const int32_t height);
+
+/* ANSI C function to be hooked up when optimised version needed */
+int32_t esp_nn_get_softmax_scratch_size_opt(const int32_t width, const int32_t height);
+
+/**
+ * @brief   Set scratch buffer to be used by softmax function
+ *
+ * @param   buffer  this can be NULL if one needs to unset it
+ *                  must be aligned to 4 bytes
+ */
+void esp_nn_set_softmax_scratch_buf_ansi(void *buffer);
+
+/**
+ * @brief       reference softmax function
+ *
+ * @note        inputs type: int8_t, output: int8_t
+ */
+void esp_nn_softmax_s8_ansi(const int8_t *input_data,
+                            const int32_t height,
+                            const int32_t width,
+                            const int32_t mult,
+                            const int32_t shift,
+                            const int32_t diff_min,
+                            int8_t *output_data);
+
+
+//////////////////////////// Generic optimisations /////////////////////////////
+
+/************************** Convolution functions *****************************/
+
+/**
+ * @brief       2d-convolution channelwise optimized version
+ *
+ * @note        operation: result += (input + offset) * filter
+ *
+ *              inputs type: int8_t, output: int8_t
+ *              input offsets: although int32_t, they are contained in 8 bits [-128, 127]
+ */
+void esp_nn_conv_s8_opt(const data_dims_t *input_dims,
+                        const int8_t *input_data,
+                        const data_dims_t *filter_dims,
+                        const int8_t *filter_data,
+                        const int32_t *bias,
+                        const data_dims_t *output_dims,
+                        int8_t *out_data,
+                        const conv_params_t *conv_params,
+                        const quant_data_t *quant_data);
+
+/**
+ * @brief       depthwise convolution per channel optimized version
+ *
+ * @note        inputs type: int8_t, output: int8_t
+ *              Version used in tflite is per channel.
+ *              This version follows the same footsprints.
+ *              Meaning, it has per out_channel shift and multiplier for
+ *              requantization
+ *
+ *              optimization notes: Though input_offset is int32 type,
+ *              offset values are contained in 8 bits [-128, 127]
+ */
+void esp_nn_depthwise_conv_s8_opt(const data_dims_t *input_dims,
+                                  const int8_t *input_data,
+                                  const data_dims_t *filter_dims,
+                                  const int8_t *filter_data,
+                                  const int32_t *bias,
+                                  const data_dims_t *output_dims,
+                                  int8_t *out_data,
+                                  const dw_conv_params_t *conv_params,
+                                  const quant_data_t *quant_data);
+
+int esp_nn_get_conv_scratch_size_opt(const data_dims_t *input_dims,
+                                     const data_dims_t *filter_dims,
+                                     const data_dims_t *output_dims,
+                                     const conv_params_t *conv_params);
+void esp_nn_set_conv_scratch_buf_opt(const void *buf);
+
+int esp_nn_get_depthwise_conv_scratch_size_opt(const data_dims_t *input_dims,
+                                               const data_dims_t *filter_dims,
+                                               const data_dims_t *output_dims,
+                                               const dw_conv_params_t *conv_params);
+void esp_nn_set_depthwise_conv_scratch_buf_opt(const void *buf);
+
+/**
+ * @brief       transpose convolution optimized version
+ *
+ * @note        gathers per output pixel, 4 output channels at a time.
+ *              bit-exact with esp_nn_transpose_conv_s8_ansi
+ */
+void esp_nn_transpose_conv_s8_opt(const data_dims_t *input_dims,
+                                  const int8_t *input_data,
+                                  const data_dims_t *filter_dims,
+                                  const int8_t *filter_data,
+                                  const int32_t *bias,
+                                  const data_dims_t *output_dims,
+                                  int8_t *out_data,
+                                  const conv_params_t *conv_params,
+                                  const quant_data_t *quant_data);
+
+int esp_nn_get_transpose_conv_scratch_size_opt(const data_dims_t *input_dims,
+                                               const data_dims_t *filter_dims,
+                                               const data_dims_t *output_dims,
+                                               const conv_params_t *conv_params);
+void esp_nn_set_transpose_conv_scratch_buf_opt(const void *buf);
+
+/**
+ * @brief       2d-convolution channelwise 16x8 optimized version
+ *
+ * @note        inputs type: int16_t, filter: int8_t, bias: int64_t, output: int16_t
+ *              bit-exact with esp_nn_conv_s16_ansi
+ */
+void esp_nn_conv_s16_opt(const data_dims_t *input_dims,
+                         const int16_t *input_data,
+                         const data_dims_t *filter_dims,
+                         const int8_t *filter_data,
+                         const int64_t *bias,
+                         const data_dims_t *output_dims,
+                         int16_t *out_data,
+                         const conv_params_t *conv_params,
+                         const quant_data_t *quant_data);
+
+/**
+ * @brief       depthwise convolution per channel 16x8 optimized version
+ *
+ * @note        inputs type: int16_t, filter: int8_t, bias: int64_t, output: int16_t
+ *              bit-exact with esp_nn_depthwise_conv_s16_ansi
+ */
+void esp_nn_depthwise_conv_s16_opt(const data_dims_t *input_dims,
+                                   const int16_t *input_data,
+                                   const data_dims_t *filter_dims,
+                                   const int8_t *filter_data,
+                                   const int64_t *bias,
+                                   const data_dims_t *output_dims,
+                                   int16_t *out_data,
+                                   const dw_conv_params_t *conv_params,
+                                   const quant_data_t *quant_data);
+
+/**
+ * @brief       2d-convolution float32 optimized version
+ *
+ * @note        register tiled over 4 output channels
+ */
+void esp_nn_conv_f32_opt(const data_dims_t *input_dims,
+                         const float *input_data,
+                         const data_dims_t *filter_dims,
+                         const float *filter_data,
+                         const float *bias,
+                         const data_dims_t *output_dims,
+                         float *out_data,
+                         const conv_params_f32_t *conv_params);
+
+/**
+ * @brief       depthwise convolution float32 optimized version
+ */
+void esp_nn_depthwise_conv_f32_opt(const data_dims_t *input_dims,
+                                   const float *input_data,
+                                   const data_dims_t *filter_dims,
+                                   const float *filter_data,
+                                   const float *bias,
+                                   const data_dims_t *output_dims,
+                                   float *out_data,
+                                   const dw_conv_params_f32_t *conv_params);
+
+/************************** Fully connected functions ***********************/
+
+/**
+ * @brief       fully connected int8 to int16 optimized version
+ *
+ * @note        bit-exact with esp_nn_fully_connected_s8_s16_ansi
+ */
+void esp_nn_fully_connected_s8_s16_opt(const int8_t *input_data,
+                                       const uint16_t row_len,
+                                       const int8_t *filter_data,
+                                       const int32_t *bias,
+                                       int16_t *out_data,
+                                       const uint16_t out_channels,
+                                       const int32_t out_shift,
+                                       const int32_t out_mult,
+                                       const int32_t activation_min,
+                                       const int32_t activation_max);
+
+/**
+ * @brief       fully connected 16x8 optimized version
+ *
+ * @note        bit-exact with esp_nn_fully_connected_s16_ansi
+ */
+void esp_nn_fully_connected_s16_opt(const int16_t *input_data,
+                                    const uint16_t row_len,
+                                    const int8_t *filter_data,
+                                    const int64_t *bias,
+                                    int16_t *out_data,
+                                    const uint16_t out_channels,
+                                    const int32_t out_shift,
+                                    const int32_t out_mult,
+                                    const int32_t activation_min,
+                                    const int32_t activation_max);
+
+/**
+ * @brief       fully connected float32 optimized version (blocked GEMV)
+ */
+void esp_nn_fully_connected_f32_opt(const float *input_data,
+                                    const uint16_t row_len,
+                                    const float *filter_data,
+                                    const float *bias,
+                                    float *out_data,
+                                    const uint16_t out_channels,
+                                    const float activation_min,
+                                    const float activation_max);
+
+/**
+ * @brief       batch matmul optimized version
+ *
+ * @note        offsets folded out with row sums, 4 rhs rows at a time.
+ *              bit-exact with esp_nn_batch_matmul_s8_ansi
+ */
+void esp_nn_batch_matmul_s8_opt(const int8_t *lhs_data,
+                                const int32_t lhs_offset,
+                                const int8_t *rhs_data,
+                                const int32_t rhs_offset,
+                                int8_t *out_data,
+                                const int32_t rows,
+                                const int32_t cols,
+                                const int32_t depth,
+                                const int32_t out_offset,
+                                const int32_t out_mult,
+                                const int32_t out_shift,
+                                const int32_t activation_min,
+                                const int32_t activation_max);
+
+int32_t esp_nn_get_batch_matmul_scratch_size_opt(const int32_t cols, const int32_t depth);
+void esp_nn_set_batch_matmul_scratch_buf_opt(void *buffer);
+
+/**
+ * @brief       LSTM gates optimized version
+ *
+ * @note        4 rows of a gate at a time.
+ *              bit-exact with esp_nn_lstm_gates_s8_ansi
+ */
+void esp_nn_lstm_gates_s8_opt(const int8_t *input_data,
+                              const uint16_t input_len,
+                              const int8_t *hidden_data,
+                              const uint16_t hidden_len,
+                              const int8_t *filter_data,
+                              const int32_t *input_bias,
+                              const int32_t *recurrent_bias,
+                              int16_t *out_data,
+                              const uint16_t gates,
+                              const uint16_t cells,
+                              const quant_data_t *input_quant,
+                              const quant_data_t *recurrent_quant);
+
+/**
+ * @brief       reduce sum optimized version
+ *
+ * @note        contiguous rows added into the scratch accumulators.
+ *              bit-exact with esp_nn_reduce_sum_s8_ansi
+ */
+void esp_nn_reduce_sum_s8_opt(const int8_t *input_data,
+                              const int32_t outer_size,
+                              const int32_t reduce_size,
+                              const int32_t inner_size,
+                              const int32_t input_offset,
+                              int8_t *out_data,
+                              const int32_t out_offset,
+                              const int32_t out_mult,
+                              const int32_t out_shift,
+                              const int32_t activation_min,
+                              const int32_t activation_max);
+
+void esp_nn_reduce_max_s8_opt(const int8_t *input_data,
+                              const int32_t outer_size,
+                              const int32_t reduce_size,
+                              const int32_t inner_size,
+                              int8_t *out_data);
+
+int32_t esp_nn_get_reduce_scratch_size_opt(const int32_t inner_size);
+void esp_nn_set_reduce_scratch_buf_opt(void *buffer);
+
+/**
+ * @brief       bilinear resize optimized version
+ *
+ * @note        separable: input rows interpolated along x once, then blended
+ *              along y. bit-exact with esp_nn_resize_bilinear_s8_ansi
+ */
+void esp_nn_resize_bilinear_s8_opt(const data_dims_t *input_dims,
+                                   const int8_t *input_data,
+                                   const data_dims_t *output_dims,
+                                   int8_t *out_data,
+                                   const resize_params_t *resize_params);
+
+int32_t esp_nn_get_resize_bilinear_scratch_size_opt(const data_dims_t *output_dims);
+void esp_nn_set_resize_bilinear_scratch_buf_opt(void *buffer);
+
+/**
+ * @brief       elementwise lookup table optimized version
+ *
+ * @note        four lookups per 32 bit load/store when both buffers are
+ *              4 byte aligned
+ */
+void esp_nn_lut_s8_opt(const int8_t *input_data,
+                       int8_t *output_data,
+                       const int8_t *lut,
+                       const int32_t size);
+
+/* ANSI C function to be hooked up when optimised version needed */
+void esp_nn_set_softmax_scratch_buf_opt(void *buffer);
+
+/**
+ * @brief       optimised version of softmax function
+ *
+ * @note        the function uses extra buffer (4 * width bytes)
+ *              hence, scratch buffers must be set before calling this.
+ */
+void esp_nn_softmax_s8_opt(const int8_t *input_data,
+                           const int32_t height,
+                           const int32_t width,
+                           const int32_t mult,
+                           const int32_t shift,
+                           const int32_t diff_min,
+                           int8_t *output_data);
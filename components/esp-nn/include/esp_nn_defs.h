@@ -81,3 +81,43 @@ typedef struct dw_conv_params {
     data_2d_t dilation;
     act_params_t activation;
 } dw_conv_params_t;
+
+/**
+ * @brief min/max activation for float kernels
+ */
+typedef struct act_params_f32 {
+    float min;
+    float max;
+} act_params_f32_t;
+
+/**
+ * @brief params specific to float convolution 2d
+ *
+ */
+typedef struct conv_params_f32 {
+    data_2d_t stride;
+    data_2d_t padding;
+    data_2d_t dilation;
+    act_params_f32_t activation;
+} conv_params_f32_t;
+
+/**
+ * @brief params specific to float depthwise convolution 2d
+ *
+ */
+typedef struct dw_conv_params_f32 {
+    int32_t ch_mult; // channel multiplier. (in_ch * ch_mult = out_ch)
+    data_2d_t stride;
+    data_2d_t padding;
+    data_2d_t dilation;
+    act_params_f32_t activation;
+} dw_conv_params_f32_t;
+
+/**
+ * @brief params specific to bilinear resize
+ *
+ */
+typedef struct resize_params {
+    int32_t align_corners;
+    int32_t half_pixel_centers; // must be 0 when align_corners is set
+} resize_params_t;
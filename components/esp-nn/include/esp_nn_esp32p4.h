@@ -44,10 +44,18 @@ void esp_nn_set_conv_scratch_buf_esp32p4(const void *buf);
 
 #define esp_nn_add_elementwise_s8 esp_nn_add_elementwise_s8_ansi
 #define esp_nn_mul_elementwise_s8 esp_nn_mul_elementwise_s8_ansi
+#define esp_nn_add_elementwise_s16 esp_nn_add_elementwise_s16_ansi
+#define esp_nn_mul_elementwise_s16 esp_nn_mul_elementwise_s16_ansi
+#define esp_nn_add_elementwise_f32 esp_nn_add_elementwise_f32_ansi
+#define esp_nn_mul_elementwise_f32 esp_nn_mul_elementwise_f32_ansi
 
 #define esp_nn_depthwise_conv_s8 esp_nn_depthwise_conv_s8_opt
+#define esp_nn_depthwise_conv_s16 esp_nn_depthwise_conv_s16_opt
+#define esp_nn_depthwise_conv_f32 esp_nn_depthwise_conv_f32_opt
 
 #define esp_nn_conv_s8 esp_nn_conv_s8_esp32p4
+#define esp_nn_conv_s16 esp_nn_conv_s16_opt
+#define esp_nn_conv_f32 esp_nn_conv_f32_opt
 
 #define esp_nn_get_conv_scratch_size esp_nn_get_conv_scratch_size_esp32p4
 #define esp_nn_set_conv_scratch_buf esp_nn_set_conv_scratch_buf_esp32p4
@@ -55,13 +63,38 @@ void esp_nn_set_conv_scratch_buf_esp32p4(const void *buf);
 #define esp_nn_get_depthwise_conv_scratch_size esp_nn_get_depthwise_conv_scratch_size_opt
 #define esp_nn_set_depthwise_conv_scratch_buf esp_nn_set_depthwise_conv_scratch_buf_opt
 
+#define esp_nn_transpose_conv_s8 esp_nn_transpose_conv_s8_opt
+#define esp_nn_get_transpose_conv_scratch_size esp_nn_get_transpose_conv_scratch_size_opt
+#define esp_nn_set_transpose_conv_scratch_buf esp_nn_set_transpose_conv_scratch_buf_opt
+
 #define esp_nn_relu6_s8 esp_nn_relu6_s8_ansi
+#define esp_nn_lut_s8 esp_nn_lut_s8_opt
 
 #define esp_nn_avg_pool_s8 esp_nn_avg_pool_s8_ansi
 #define esp_nn_max_pool_s8 esp_nn_max_pool_s8_ansi
+#define esp_nn_avg_pool_f32 esp_nn_avg_pool_f32_ansi
+#define esp_nn_max_pool_f32 esp_nn_max_pool_f32_ansi
 
 #define esp_nn_fully_connected_s8 esp_nn_fully_connected_s8_ansi
 #define esp_nn_fully_connected_per_ch_s8 esp_nn_fully_connected_per_ch_s8_ansi
+#define esp_nn_fully_connected_s8_s16 esp_nn_fully_connected_s8_s16_opt
+#define esp_nn_fully_connected_s16 esp_nn_fully_connected_s16_opt
+#define esp_nn_fully_connected_f32 esp_nn_fully_connected_f32_opt
+
+#define esp_nn_batch_matmul_s8 esp_nn_batch_matmul_s8_opt
+#define esp_nn_get_batch_matmul_scratch_size esp_nn_get_batch_matmul_scratch_size_opt
+#define esp_nn_set_batch_matmul_scratch_buf esp_nn_set_batch_matmul_scratch_buf_opt
+
+#define esp_nn_lstm_gates_s8 esp_nn_lstm_gates_s8_opt
+
+#define esp_nn_reduce_sum_s8 esp_nn_reduce_sum_s8_opt
+#define esp_nn_reduce_max_s8 esp_nn_reduce_max_s8_opt
+#define esp_nn_get_reduce_scratch_size esp_nn_get_reduce_scratch_size_opt
+#define esp_nn_set_reduce_scratch_buf esp_nn_set_reduce_scratch_buf_opt
+
+#define esp_nn_resize_bilinear_s8 esp_nn_resize_bilinear_s8_opt
+#define esp_nn_get_resize_bilinear_scratch_size esp_nn_get_resize_bilinear_scratch_size_opt
+#define esp_nn_set_resize_bilinear_scratch_buf esp_nn_set_resize_bilinear_scratch_buf_opt
 
 #define esp_nn_get_softmax_scratch_size esp_nn_get_softmax_scratch_size_opt
 #define esp_nn_set_softmax_scratch_buf esp_nn_set_softmax_scratch_buf_opt
@@ -0,0 +1,27 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdint.h>
+
+#include <common_functions.h>
+
+void esp_nn_lut_s8_ansi(const int8_t *input_data,
+                        int8_t *output_data,
+                        const int8_t *lut,
+                        const int32_t size)
+{
+    for (int32_t i = 0; i < size; i++) {
+        output_data[i] = lut[input_data[i] + 128];
+    }
+}
@@ -0,0 +1,62 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdint.h>
+
+#include <common_functions.h>
+
+/**
+ * Lookups are done on the table re-based at its middle entry, so the signed
+ * input is the index. Aligned runs go one 32 bit word in and out per four
+ * lookups instead of byte loads and stores.
+ */
+void esp_nn_lut_s8_opt(const int8_t *input_data,
+                       int8_t *output_data,
+                       const int8_t *lut,
+                       const int32_t size)
+{
+    const int8_t *table = lut + 128;
+    int32_t i = 0;
+
+    if ((((uintptr_t) input_data | (uintptr_t) output_data) & 3) == 0) {
+        const uint32_t *in_word = (const uint32_t *) input_data;
+        uint32_t *out_word = (uint32_t *) output_data;
+        for (; i < size - 7; i += 8) {
+            const uint32_t in0 = *in_word++;
+            const uint32_t in1 = *in_word++;
+            *out_word++ = (uint8_t) table[(int8_t) in0] |
+                          ((uint32_t) (uint8_t) table[(int8_t) (in0 >> 8)] << 8) |
+                          ((uint32_t) (uint8_t) table[(int8_t) (in0 >> 16)] << 16) |
+                          ((uint32_t) (uint8_t) table[(int8_t) (in0 >> 24)] << 24);
+            *out_word++ = (uint8_t) table[(int8_t) in1] |
+                          ((uint32_t) (uint8_t) table[(int8_t) (in1 >> 8)] << 8) |
+                          ((uint32_t) (uint8_t) table[(int8_t) (in1 >> 16)] << 16) |
+                          ((uint32_t) (uint8_t) table[(int8_t) (in1 >> 24)] << 24);
+        }
+    } else {
+        for (; i < size - 3; i += 4) {
+            const int8_t in0 = input_data[i];
+            const int8_t in1 = input_data[i + 1];
+            const int8_t in2 = input_data[i + 2];
+            const int8_t in3 = input_data[i + 3];
+            output_data[i] = table[in0];
+            output_data[i + 1] = table[in1];
+            output_data[i + 2] = table[in2];
+            output_data[i + 3] = table[in3];
+        }
+    }
+    for (; i < size; i++) {
+        output_data[i] = table[input_data[i]];
+    }
+}
@@ -40,3 +40,42 @@ void esp_nn_mul_elementwise_s8_ansi(const int8_t *input1_data,
         output[i] = (int8_t) out;
     }
 }
+
+void esp_nn_mul_elementwise_s16_ansi(const int16_t *input1_data,
+                                     const int16_t *input2_data,
+                                     const int32_t input1_offset,
+                                     const int32_t input2_offset,
+                                     int16_t *output,
+                                     const int32_t out_offset,
+                                     const int32_t out_mult,
+                                     const int32_t out_shift,
+                                     const int32_t activation_min,
+                                     const int32_t activation_max,
+                                     const int32_t size)
+{
+    for (int i = 0; i < size; i++) {
+        int32_t tmp1 = input1_data[i] + input1_offset;
+        int32_t tmp2 = input2_data[i] + input2_offset;
+
+        int32_t out = tmp1 * tmp2;
+        out = esp_nn_multiply_by_quantized_mult(out, out_mult, out_shift);
+        out = out + out_offset;
+
+        out = max(activation_min, min(out, activation_max));
+        output[i] = (int16_t) out;
+    }
+}
+
+void esp_nn_mul_elementwise_f32_ansi(const float *input1_data,
+                                     const float *input2_data,
+                                     float *output,
+                                     const float activation_min,
+                                     const float activation_max,
+                                     const int32_t size)
+{
+    for (int i = 0; i < size; i++) {
+        float out = input1_data[i] * input2_data[i];
+        out = max(activation_min, min(out, activation_max));
+        output[i] = out;
+    }
+}
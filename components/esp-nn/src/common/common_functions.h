@@ -24,6 +24,13 @@
  */
 #define __NN_FORCE_INLINE__ __attribute((always_inline)) static inline
 
+/**
+ * Scratch buffers set with esp_nn_set_*_scratch_buf are kept per task, so
+ * that two tasks (one per core) can run the same kernel at the same time,
+ * each with its own buffer.
+ */
+#define __NN_SCRATCH_TLS__ __thread
+
 /* min/max macros */
 #ifndef max
 #define max(a, b) ({            \
@@ -153,6 +160,140 @@ __NN_FORCE_INLINE__ int32_t esp_nn_multiply_by_quantized_mult(int32_t x, int32_t
     return esp_nn_div_by_power_of_two(result, right_shift);
 }
 
+/**
+ * 64 bit accumulator version used by 16x8 kernels.
+ * Follows tflite: multiplier is reduced to 16 bits and rounding is done once.
+ * x is expected to be in range [-(1 << 47), (1 << 47)).
+ */
+__NN_FORCE_INLINE__ int32_t esp_nn_multiply_by_quantized_mult_s64(int64_t x, int32_t mult, int32_t shift)
+{
+    const int32_t reduced_mult = (mult < 0x7FFF0000) ? ((mult + (1 << 15)) >> 16) : 0x7FFF;
+    const int32_t total_shift = 15 - shift;
+    x = x * reduced_mult + ((int64_t) 1 << (total_shift - 1));
+    return (int32_t) (x >> total_shift);
+}
+
+/**
+ * int16 x int8 products are at most 2^22, so up to 256 of them are summed
+ * in 32 bit registers and only the block sums are widened to 64 bits.
+ */
+#define ESP_NN_S16_ACC_BLOCK    256
+
+/**
+ * @brief       dot product of int16_t data with int8_t filter
+ *
+ * @return      64 bit accumulation, bit-exact with a 64 bit running sum
+ */
+__NN_FORCE_INLINE__ int64_t esp_nn_dot_s16_s8(const int16_t *input, const int8_t *filter, int32_t len)
+{
+    int64_t acc = 0;
+    while (len > 0) {
+        const int32_t blk_len = min(len, ESP_NN_S16_ACC_BLOCK);
+        int32_t acc0 = 0, acc1 = 0;
+        int32_t i = 0;
+        for (; i < blk_len - 3; i += 4) {
+            acc0 += input[i + 0] * filter[i + 0];
+            acc1 += input[i + 1] * filter[i + 1];
+            acc0 += input[i + 2] * filter[i + 2];
+            acc1 += input[i + 3] * filter[i + 3];
+        }
+        for (; i < blk_len; i++) {
+            acc0 += input[i] * filter[i];
+        }
+        acc += acc0 + acc1;
+        input += blk_len;
+        filter += blk_len;
+        len -= blk_len;
+    }
+    return acc;
+}
+
+/**
+ * @brief       dot product of one float input row with 4 filter rows placed
+ *              `filter_stride` apart, accumulated into acc[0..3]
+ *
+ * @note        each accumulator adds its products in input order, so results
+ *              match a plain loop. Input is loaded once per 4 multiply-adds.
+ */
+__NN_FORCE_INLINE__ void esp_nn_dot4_f32(const float *input, const float *filter,
+                                         const int32_t filter_stride, const int32_t len,
+                                         float *acc)
+{
+    const float *filter0 = filter;
+    const float *filter1 = filter0 + filter_stride;
+    const float *filter2 = filter1 + filter_stride;
+    const float *filter3 = filter2 + filter_stride;
+    float acc0 = acc[0], acc1 = acc[1], acc2 = acc[2], acc3 = acc[3];
+    for (int32_t i = 0; i < len; i++) {
+        const float in = input[i];
+        acc0 += in * filter0[i];
+        acc1 += in * filter1[i];
+        acc2 += in * filter2[i];
+        acc3 += in * filter3[i];
+    }
+    acc[0] = acc0;
+    acc[1] = acc1;
+    acc[2] = acc2;
+    acc[3] = acc3;
+}
+
+/**
+ * @brief       dot product of one int8_t input row with 4 int8_t filter rows
+ *              placed `filter_stride` apart, accumulated into acc[0..3]
+ *
+ * @note        no offsets are applied, callers fold them in with row sums.
+ */
+__NN_FORCE_INLINE__ void esp_nn_dot4_s8(const int8_t *input, const int8_t *filter,
+                                        const int32_t filter_stride, const int32_t len,
+                                        int32_t *acc)
+{
+    const int8_t *filter0 = filter;
+    const int8_t *filter1 = filter0 + filter_stride;
+    const int8_t *filter2 = filter1 + filter_stride;
+    const int8_t *filter3 = filter2 + filter_stride;
+    int32_t acc0 = acc[0], acc1 = acc[1], acc2 = acc[2], acc3 = acc[3];
+    for (int32_t i = 0; i < len; i++) {
+        const int32_t in = input[i];
+        acc0 += in * filter0[i];
+        acc1 += in * filter1[i];
+        acc2 += in * filter2[i];
+        acc3 += in * filter3[i];
+    }
+    acc[0] = acc0;
+    acc[1] = acc1;
+    acc[2] = acc2;
+    acc[3] = acc3;
+}
+
+/**
+ * @brief       dot product of int8_t data, without offsets
+ */
+__NN_FORCE_INLINE__ int32_t esp_nn_dot_s8(const int8_t *input, const int8_t *filter, int32_t len)
+{
+    int32_t acc0 = 0, acc1 = 0;
+    int32_t i = 0;
+    for (; i < len - 1; i += 2) {
+        acc0 += input[i + 0] * filter[i + 0];
+        acc1 += input[i + 1] * filter[i + 1];
+    }
+    if (i < len) {
+        acc0 += input[i] * filter[i];
+    }
+    return acc0 + acc1;
+}
+
+/**
+ * @brief       sum of int8_t data, used to fold offsets out of dot products
+ */
+__NN_FORCE_INLINE__ int32_t esp_nn_sum_s8(const int8_t *data, int32_t len)
+{
+    int32_t sum = 0;
+    for (int32_t i = 0; i < len; i++) {
+        sum += data[i];
+    }
+    return sum;
+}
+
 __NN_FORCE_INLINE__ int32_t esp_nn_multiply_by_quantized_mult_fast(int32_t x, int32_t mult, int32_t shift)
 {
     int32_t left_shift = max(shift, 0);
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <esp_nn_defs.h>
+#include <esp_nn_ansi_headers.h>
 #include <common_functions.h>
 
 int esp_nn_get_depthwise_conv_scratch_size_opt(const data_dims_t *input_dims,
@@ -289,3 +290,226 @@ void esp_nn_depthwise_conv_s8_opt(const data_dims_t *input_dims,
         }
     }
 }
+
+/**
+ * 16 bit activations, 8 bit filter (16x8 quantization)
+ *
+ * A depthwise output sums one product per filter tap, so for filters of up to
+ * ESP_NN_S16_ACC_BLOCK taps the whole sum fits a 32 bit accumulator and only
+ * the bias add is done in 64 bits. Bigger filters use the ansi version.
+ */
+void esp_nn_depthwise_conv_s16_opt(const data_dims_t *input_dims,
+                                   const int16_t *input_data,
+                                   const data_dims_t *filter_dims,
+                                   const int8_t *filter_data,
+                                   const int64_t *bias,
+                                   const data_dims_t *output_dims,
+                                   int16_t *out_data,
+                                   const dw_conv_params_t *conv_params,
+                                   const quant_data_t *quant_data)
+{
+    const uint16_t filter_wd = filter_dims->width;
+    const uint16_t filter_ht = filter_dims->height;
+    if (filter_wd * filter_ht > ESP_NN_S16_ACC_BLOCK) {
+        esp_nn_depthwise_conv_s16_ansi(input_dims, input_data, filter_dims, filter_data,
+                                       bias, output_dims, out_data, conv_params, quant_data);
+        return;
+    }
+    const uint16_t input_wd = input_dims->width;
+    const uint16_t input_ht = input_dims->height;
+    const uint16_t channels = input_dims->channels;
+    const uint16_t pad_wd = conv_params->padding.width;
+    const uint16_t pad_ht = conv_params->padding.height;
+    const uint16_t stride_wd = conv_params->stride.width;
+    const uint16_t stride_ht = conv_params->stride.height;
+    const uint16_t out_wd = output_dims->width;
+    const uint16_t out_ht = output_dims->height;
+    const int32_t activation_min = conv_params->activation.min;
+    const int32_t activation_max = conv_params->activation.max;
+    const uint16_t ch_mult = conv_params->ch_mult;
+    const int32_t out_channels = channels * ch_mult;
+
+    int out_idx = 0;
+    for (int out_y = 0; out_y < out_ht; out_y++) { //height loop
+        const int16_t base_y = (out_y * stride_ht) - pad_ht;
+        for (int out_x = 0; out_x < out_wd; out_x++) { //width_loop
+            const int16_t base_x = (out_x * stride_wd) - pad_wd;
+
+            const int32_t *out_shift = quant_data->shift;
+            const int32_t *out_mult = quant_data->mult;
+
+            /* Select filter so as the point doesn't lie outside block */
+            int filter_y_start = max(0, -base_y);
+            int filter_x_start = max(0, -base_x);
+            int filter_y_end = min(filter_ht, input_ht - base_y);
+            int filter_x_end = min(filter_wd, input_wd - base_x);
+
+            int out_ch_idx = 0;
+            for (; out_ch_idx < out_channels - 3; out_ch_idx += 4) {
+                int32_t acc0 = 0;
+                int32_t acc1 = 0;
+                int32_t acc2 = 0;
+                int32_t acc3 = 0;
+                const int32_t in_ch0 = (out_ch_idx + 0) / ch_mult;
+                const int32_t in_ch1 = (out_ch_idx + 1) / ch_mult;
+                const int32_t in_ch2 = (out_ch_idx + 2) / ch_mult;
+                const int32_t in_ch3 = (out_ch_idx + 3) / ch_mult;
+
+                for (int filter_y_idx = filter_y_start; filter_y_idx < filter_y_end; filter_y_idx++) {
+                    const int32_t idx_y = base_y + filter_y_idx;
+                    for (int filter_x_idx = filter_x_start; filter_x_idx < filter_x_end; filter_x_idx++) {
+                        const int32_t idx_x = base_x + filter_x_idx;
+                        const int16_t *input_ptr = input_data + (idx_y * input_wd + idx_x) * channels;
+                        const int8_t *filter_ptr = filter_data +
+                                        (filter_y_idx * filter_wd + filter_x_idx) * out_channels + out_ch_idx;
+                        acc0 += input_ptr[in_ch0] * filter_ptr[0];
+                        acc1 += input_ptr[in_ch1] * filter_ptr[1];
+                        acc2 += input_ptr[in_ch2] * filter_ptr[2];
+                        acc3 += input_ptr[in_ch3] * filter_ptr[3];
+                    }
+                }
+                int64_t result0 = acc0;
+                int64_t result1 = acc1;
+                int64_t result2 = acc2;
+                int64_t result3 = acc3;
+                if (bias) {
+                    result0 += bias[out_ch_idx + 0];
+                    result1 += bias[out_ch_idx + 1];
+                    result2 += bias[out_ch_idx + 2];
+                    result3 += bias[out_ch_idx + 3];
+                }
+                int32_t out0 = esp_nn_multiply_by_quantized_mult_s64(result0, *out_mult++, *out_shift++);
+                int32_t out1 = esp_nn_multiply_by_quantized_mult_s64(result1, *out_mult++, *out_shift++);
+                int32_t out2 = esp_nn_multiply_by_quantized_mult_s64(result2, *out_mult++, *out_shift++);
+                int32_t out3 = esp_nn_multiply_by_quantized_mult_s64(result3, *out_mult++, *out_shift++);
+
+                out_data[out_idx++] = min(max(out0, activation_min), activation_max);
+                out_data[out_idx++] = min(max(out1, activation_min), activation_max);
+                out_data[out_idx++] = min(max(out2, activation_min), activation_max);
+                out_data[out_idx++] = min(max(out3, activation_min), activation_max);
+            }
+            for (; out_ch_idx < out_channels; out_ch_idx++) {
+                int32_t acc = 0;
+                const int32_t in_ch = out_ch_idx / ch_mult;
+
+                for (int filter_y_idx = filter_y_start; filter_y_idx < filter_y_end; filter_y_idx++) {
+                    const int32_t idx_y = base_y + filter_y_idx;
+                    for (int filter_x_idx = filter_x_start; filter_x_idx < filter_x_end; filter_x_idx++) {
+                        const int32_t idx_x = base_x + filter_x_idx;
+                        int32_t input_index = (idx_y * input_wd + idx_x) * channels + in_ch;
+                        int32_t filter_index = (filter_y_idx * filter_wd + filter_x_idx) * out_channels + out_ch_idx;
+                        acc += input_data[input_index] * filter_data[filter_index];
+                    }
+                }
+                int64_t result = acc;
+                if (bias) {
+                    result += bias[out_ch_idx];
+                }
+                int32_t out = esp_nn_multiply_by_quantized_mult_s64(result, *out_mult++, *out_shift++);
+                out_data[out_idx++] = min(max(out, activation_min), activation_max);
+            }
+        }
+    }
+}
+
+/**
+ * float32 version
+ *
+ * 4 output channels are computed together, so the filter taps for them are
+ * read as one contiguous group and the accumulators stay in registers for the
+ * whole receptive field. Per output the products are summed in tap order,
+ * same as the ansi version.
+ */
+void esp_nn_depthwise_conv_f32_opt(const data_dims_t *input_dims,
+                                   const float *input_data,
+                                   const data_dims_t *filter_dims,
+                                   const float *filter_data,
+                                   const float *bias,
+                                   const data_dims_t *output_dims,
+                                   float *out_data,
+                                   const dw_conv_params_f32_t *conv_params)
+{
+    const uint16_t input_wd = input_dims->width;
+    const uint16_t input_ht = input_dims->height;
+    const uint16_t channels = input_dims->channels;
+    const uint16_t pad_wd = conv_params->padding.width;
+    const uint16_t pad_ht = conv_params->padding.height;
+    const uint16_t stride_wd = conv_params->stride.width;
+    const uint16_t stride_ht = conv_params->stride.height;
+    const uint16_t filter_wd = filter_dims->width;
+    const uint16_t filter_ht = filter_dims->height;
+    const uint16_t out_wd = output_dims->width;
+    const uint16_t out_ht = output_dims->height;
+    const float activation_min = conv_params->activation.min;
+    const float activation_max = conv_params->activation.max;
+    const uint16_t ch_mult = conv_params->ch_mult;
+    const int32_t out_channels = channels * ch_mult;
+
+    int out_idx = 0;
+    for (int out_y = 0; out_y < out_ht; out_y++) { //height loop
+        const int16_t base_y = (out_y * stride_ht) - pad_ht;
+        for (int out_x = 0; out_x < out_wd; out_x++) { //width_loop
+            const int16_t base_x = (out_x * stride_wd) - pad_wd;
+
+            /* Select filter so as the point doesn't lie outside block */
+            int filter_y_start = max(0, -base_y);
+            int filter_x_start = max(0, -base_x);
+            int filter_y_end = min(filter_ht, input_ht - base_y);
+            int filter_x_end = min(filter_wd, input_wd - base_x);
+
+            int out_ch_idx = 0;
+            for (; out_ch_idx < out_channels - 3; out_ch_idx += 4) {
+                float acc0 = 0;
+                float acc1 = 0;
+                float acc2 = 0;
+                float acc3 = 0;
+                const int32_t in_ch0 = (out_ch_idx + 0) / ch_mult;
+                const int32_t in_ch1 = (out_ch_idx + 1) / ch_mult;
+                const int32_t in_ch2 = (out_ch_idx + 2) / ch_mult;
+                const int32_t in_ch3 = (out_ch_idx + 3) / ch_mult;
+
+                for (int filter_y_idx = filter_y_start; filter_y_idx < filter_y_end; filter_y_idx++) {
+                    const int32_t idx_y = base_y + filter_y_idx;
+                    for (int filter_x_idx = filter_x_start; filter_x_idx < filter_x_end; filter_x_idx++) {
+                        const int32_t idx_x = base_x + filter_x_idx;
+                        const float *input_ptr = input_data + (idx_y * input_wd + idx_x) * channels;
+                        const float *filter_ptr = filter_data +
+                                        (filter_y_idx * filter_wd + filter_x_idx) * out_channels + out_ch_idx;
+                        acc0 += input_ptr[in_ch0] * filter_ptr[0];
+                        acc1 += input_ptr[in_ch1] * filter_ptr[1];
+                        acc2 += input_ptr[in_ch2] * filter_ptr[2];
+                        acc3 += input_ptr[in_ch3] * filter_ptr[3];
+                    }
+                }
+                if (bias) {
+                    acc0 += bias[out_ch_idx + 0];
+                    acc1 += bias[out_ch_idx + 1];
+                    acc2 += bias[out_ch_idx + 2];
+                    acc3 += bias[out_ch_idx + 3];
+                }
+                out_data[out_idx++] = min(max(acc0, activation_min), activation_max);
+                out_data[out_idx++] = min(max(acc1, activation_min), activation_max);
+                out_data[out_idx++] = min(max(acc2, activation_min), activation_max);
+                out_data[out_idx++] = min(max(acc3, activation_min), activation_max);
+            }
+            for (; out_ch_idx < out_channels; out_ch_idx++) {
+                float acc = 0;
+                const int32_t in_ch = out_ch_idx / ch_mult;
+
+                for (int filter_y_idx = filter_y_start; filter_y_idx < filter_y_end; filter_y_idx++) {
+                    const int32_t idx_y = base_y + filter_y_idx;
+                    for (int filter_x_idx = filter_x_start; filter_x_idx < filter_x_end; filter_x_idx++) {
+                        const int32_t idx_x = base_x + filter_x_idx;
+                        int32_t input_index = (idx_y * input_wd + idx_x) * channels + in_ch;
+                        int32_t filter_index = (filter_y_idx * filter_wd + filter_x_idx) * out_channels + out_ch_idx;
+                        acc += input_data[input_index] * filter_data[filter_index];
+                    }
+                }
+                if (bias) {
+                    acc += bias[out_ch_idx];
+                }
+                out_data[out_idx++] = min(max(acc, activation_min), activation_max);
+            }
+        }
+    }
+}
@@ -0,0 +1,120 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdio.h>
+
+#include <esp_nn_defs.h>
+
+#include <common_functions.h>
+
+static __NN_SCRATCH_TLS__ int32_t *scratch_buf = NULL;
+
+/* one int32_t accumulator per output element */
+int esp_nn_get_transpose_conv_scratch_size_ansi(const data_dims_t *input_dims,
+                                                const data_dims_t *filter_dims,
+                                                const data_dims_t *output_dims,
+                                                const conv_params_t *conv_params)
+{
+    return output_dims->width * output_dims->height * output_dims->channels * sizeof(int32_t);
+}
+
+void esp_nn_set_transpose_conv_scratch_buf_ansi(const void *buf)
+{
+    scratch_buf = (int32_t *) buf;
+}
+
+/**
+ * Every input element is scattered into the output elements it touches,
+ * the same way as the tflite reference kernel.
+ */
+void esp_nn_transpose_conv_s8_ansi(const data_dims_t *input_dims,
+                                   const int8_t *input_data,
+                                   const data_dims_t *filter_dims,
+                                   const int8_t *filter_data,
+                                   const int32_t *bias,
+                                   const data_dims_t *output_dims,
+                                   int8_t *out_data,
+                                   const conv_params_t *conv_params,
+                                   const quant_data_t *quant_data)
+{
+    const uint16_t input_wd = input_dims->width;
+    const uint16_t input_ht = input_dims->height;
+    const uint16_t in_channels = input_dims->channels;
+    const int32_t input_offset = conv_params->in_offset;
+    const int32_t out_offset = conv_params->out_offset;
+    const uint16_t pad_wd = conv_params->padding.width;
+    const uint16_t pad_ht = conv_params->padding.height;
+    const uint16_t stride_wd = conv_params->stride.width;
+    const uint16_t stride_ht = conv_params->stride.height;
+    const uint16_t filter_wd = filter_dims->width;
+    const uint16_t filter_ht = filter_dims->height;
+    const uint16_t out_wd = output_dims->width;
+    const uint16_t out_ht = output_dims->height;
+    const uint16_t out_channels = output_dims->channels;
+    const int32_t *out_shift = quant_data->shift;
+    const int32_t *out_mult = quant_data->mult;
+    const int32_t activation_min = conv_params->activation.min;
+    const int32_t activation_max = conv_params->activation.max;
+
+    if (scratch_buf == NULL) {
+        printf("%s error! scratch buffer not set\n", __FUNCTION__);
+        return;
+    }
+    int32_t *acc_buf = scratch_buf;
+    memset(acc_buf, 0, out_wd * out_ht * out_channels * sizeof(int32_t));
+
+    for (int in_y = 0; in_y < input_ht; in_y++) {
+        for (int in_x = 0; in_x < input_wd; in_x++) {
+            const int8_t *input_ptr = input_data + (in_y * input_wd + in_x) * in_channels;
+            const int32_t out_x_origin = in_x * stride_wd - pad_wd;
+            const int32_t out_y_origin = in_y * stride_ht - pad_ht;
+            for (int filter_y = 0; filter_y < filter_ht; filter_y++) {
+                const int32_t out_y = out_y_origin + filter_y;
+                if (out_y < 0 || out_y >= out_ht) {
+                    continue;
+                }
+                for (int filter_x = 0; filter_x < filter_wd; filter_x++) {
+                    const int32_t out_x = out_x_origin + filter_x;
+                    if (out_x < 0 || out_x >= out_wd) {
+                        continue;
+                    }
+                    int32_t *acc_ptr = acc_buf + (out_y * out_wd + out_x) * out_channels;
+                    for (int out_ch_idx = 0; out_ch_idx < out_channels; out_ch_idx++) {
+                        const int8_t *filter_ptr = filter_data +
+                            ((out_ch_idx * filter_ht + filter_y) * filter_wd + filter_x) * in_channels;
+                        int32_t result = 0;
+                        for (int in_ch_idx = 0; in_ch_idx < in_channels; in_ch_idx++) {
+                            result += (input_ptr[in_ch_idx] + input_offset) * filter_ptr[in_ch_idx];
+                        }
+                        acc_ptr[out_ch_idx] += result;
+                    }
+                }
+            }
+        }
+    }
+
+    for (int i = 0; i < out_wd * out_ht; i++) {
+        for (int out_ch_idx = 0; out_ch_idx < out_channels; out_ch_idx++) {
+            int32_t result = acc_buf[i * out_channels + out_ch_idx];
+            if (bias) {
+                result += bias[out_ch_idx];
+            }
+            result = esp_nn_multiply_by_quantized_mult(result, out_mult[out_ch_idx], out_shift[out_ch_idx]);
+            result += out_offset;
+            result = max(result, activation_min);
+            result = min(result, activation_max);
+            out_data[i * out_channels + out_ch_idx] = (int8_t) result;
+        }
+    }
+}
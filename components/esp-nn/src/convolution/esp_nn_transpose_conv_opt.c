@@ -0,0 +1,159 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdio.h>
+
+#include <esp_nn_defs.h>
+
+#include <common_functions.h>
+
+static __NN_SCRATCH_TLS__ int32_t *scratch_buf = NULL;
+
+/* one int32_t filter sum per output channel and filter tap */
+int esp_nn_get_transpose_conv_scratch_size_opt(const data_dims_t *input_dims,
+                                               const data_dims_t *filter_dims,
+                                               const data_dims_t *output_dims,
+                                               const conv_params_t *conv_params)
+{
+    return output_dims->channels * filter_dims->width * filter_dims->height * sizeof(int32_t);
+}
+
+void esp_nn_set_transpose_conv_scratch_buf_opt(const void *buf)
+{
+    scratch_buf = (int32_t *) buf;
+}
+
+/* first and last input index that reaches output index `out_idx` */
+__NN_FORCE_INLINE__ void esp_nn_transpose_conv_in_range(const int32_t out_idx, const int32_t pad,
+                                                        const int32_t stride, const int32_t filter_len,
+                                                        const int32_t in_len,
+                                                        int32_t *in_start, int32_t *in_end)
+{
+    const int32_t base = out_idx + pad;
+    const int32_t lowest = base - filter_len + 1;
+    *in_start = lowest > 0 ? (lowest + stride - 1) / stride : 0;
+    *in_end = min(in_len - 1, base / stride);
+}
+
+/**
+ * Each output pixel gathers the input pixels that reach it instead of the
+ * reference scatter, so the accumulators stay in registers and no output
+ * sized buffer is needed. Output channels are taken 4 at a time to share
+ * input loads; the input offset is applied once per tap through the filter
+ * sums kept in the scratch buffer.
+ */
+void esp_nn_transpose_conv_s8_opt(const data_dims_t *input_dims,
+                                  const int8_t *input_data,
+                                  const data_dims_t *filter_dims,
+                                  const int8_t *filter_data,
+                                  const int32_t *bias,
+                                  const data_dims_t *output_dims,
+                                  int8_t *out_data,
+                                  const conv_params_t *conv_params,
+                                  const quant_data_t *quant_data)
+{
+    const uint16_t input_wd = input_dims->width;
+    const uint16_t input_ht = input_dims->height;
+    const uint16_t in_channels = input_dims->channels;
+    const int32_t input_offset = conv_params->in_offset;
+    const int32_t out_offset = conv_params->out_offset;
+    const uint16_t pad_wd = conv_params->padding.width;
+    const uint16_t pad_ht = conv_params->padding.height;
+    const uint16_t stride_wd = conv_params->stride.width;
+    const uint16_t stride_ht = conv_params->stride.height;
+    const uint16_t filter_wd = filter_dims->width;
+    const uint16_t filter_ht = filter_dims->height;
+    const uint16_t out_wd = output_dims->width;
+    const uint16_t out_ht = output_dims->height;
+    const uint16_t out_channels = output_dims->channels;
+    const int32_t *out_shift = quant_data->shift;
+    const int32_t *out_mult = quant_data->mult;
+    const int32_t activation_min = conv_params->activation.min;
+    const int32_t activation_max = conv_params->activation.max;
+
+    if (scratch_buf == NULL) {
+        printf("%s error! scratch buffer not set\n", __FUNCTION__);
+        return;
+    }
+    const int32_t filter_taps = filter_wd * filter_ht;
+    const int32_t filter_ch_size = filter_taps * in_channels;
+    int32_t *filter_sums = scratch_buf;
+    for (int32_t i = 0; i < out_channels * filter_taps; i++) {
+        filter_sums[i] = input_offset * esp_nn_sum_s8(filter_data + i * in_channels, in_channels);
+    }
+
+    for (int32_t out_y = 0; out_y < out_ht; out_y++) {
+        int32_t in_y_start, in_y_end;
+        esp_nn_transpose_conv_in_range(out_y, pad_ht, stride_ht, filter_ht, input_ht,
+                                       &in_y_start, &in_y_end);
+        for (int32_t out_x = 0; out_x < out_wd; out_x++) {
+            int32_t in_x_start, in_x_end;
+            esp_nn_transpose_conv_in_range(out_x, pad_wd, stride_wd, filter_wd, input_wd,
+                                           &in_x_start, &in_x_end);
+            int8_t *out_ptr = out_data + (out_y * out_wd + out_x) * out_channels;
+            int32_t out_ch_idx = 0;
+            for (; out_ch_idx < out_channels - 3; out_ch_idx += 4) {
+                int32_t acc[4] = {0, 0, 0, 0};
+                for (int32_t in_y = in_y_start; in_y <= in_y_end; in_y++) {
+                    const int32_t filter_y = out_y + pad_ht - in_y * stride_ht;
+                    for (int32_t in_x = in_x_start; in_x <= in_x_end; in_x++) {
+                        const int32_t filter_x = out_x + pad_wd - in_x * stride_wd;
+                        const int32_t tap = out_ch_idx * filter_taps + filter_y * filter_wd + filter_x;
+                        esp_nn_dot4_s8(input_data + (in_y * input_wd + in_x) * in_channels,
+                                       filter_data + tap * in_channels, filter_ch_size,
+                                       in_channels, acc);
+                        acc[0] += filter_sums[tap];
+                        acc[1] += filter_sums[tap + filter_taps];
+                        acc[2] += filter_sums[tap + 2 * filter_taps];
+                        acc[3] += filter_sums[tap + 3 * filter_taps];
+                    }
+                }
+                for (int32_t i = 0; i < 4; i++) {
+                    int32_t result = acc[i];
+                    if (bias) {
+                        result += bias[out_ch_idx + i];
+                    }
+                    result = esp_nn_multiply_by_quantized_mult(result, out_mult[out_ch_idx + i],
+                                                               out_shift[out_ch_idx + i]);
+                    result += out_offset;
+                    result = max(result, activation_min);
+                    result = min(result, activation_max);
+                    out_ptr[out_ch_idx + i] = (int8_t) result;
+                }
+            }
+            for (; out_ch_idx < out_channels; out_ch_idx++) {
+                int32_t result = 0;
+                for (int32_t in_y = in_y_start; in_y <= in_y_end; in_y++) {
+                    const int32_t filter_y = out_y + pad_ht - in_y * stride_ht;
+                    for (int32_t in_x = in_x_start; in_x <= in_x_end; in_x++) {
+                        const int32_t filter_x = out_x + pad_wd - in_x * stride_wd;
+                        const int32_t tap = out_ch_idx * filter_taps + filter_y * filter_wd + filter_x;
+                        result += esp_nn_dot_s8(input_data + (in_y * input_wd + in_x) * in_channels,
+                                                filter_data + tap * in_channels, in_channels);
+                        result += filter_sums[tap];
+                    }
+                }
+                if (bias) {
+                    result += bias[out_ch_idx];
+                }
+                result = esp_nn_multiply_by_quantized_mult(result, out_mult[out_ch_idx],
+                                                           out_shift[out_ch_idx]);
+                result += out_offset;
+                result = max(result, activation_min);
+                result = min(result, activation_max);
+                out_ptr[out_ch_idx] = (int8_t) result;
+            }
+        }
+    }
+}
@@ -0,0 +1,60 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdint.h>
+
+#include <common_functions.h>
+
+int32_t esp_nn_get_batch_matmul_scratch_size_ansi(const int32_t cols, const int32_t depth)
+{
+    (void) cols;
+    (void) depth;
+    return 0;
+}
+
+void esp_nn_set_batch_matmul_scratch_buf_ansi(void *buffer)
+{
+    (void) buffer;
+}
+
+void esp_nn_batch_matmul_s8_ansi(const int8_t *lhs_data,
+                                 const int32_t lhs_offset,
+                                 const int8_t *rhs_data,
+                                 const int32_t rhs_offset,
+                                 int8_t *out_data,
+                                 const int32_t rows,
+                                 const int32_t cols,
+                                 const int32_t depth,
+                                 const int32_t out_offset,
+                                 const int32_t out_mult,
+                                 const int32_t out_shift,
+                                 const int32_t activation_min,
+                                 const int32_t activation_max)
+{
+    for (int32_t row = 0; row < rows; row++) {
+        const int8_t *lhs_row = lhs_data + row * depth;
+        for (int32_t col = 0; col < cols; col++) {
+            const int8_t *rhs_row = rhs_data + col * depth;
+            int32_t result = 0;
+            for (int32_t k = 0; k < depth; k++) {
+                result += (lhs_row[k] + lhs_offset) * (rhs_row[k] + rhs_offset);
+            }
+            result = esp_nn_multiply_by_quantized_mult(result, out_mult, out_shift);
+            result += out_offset;
+            result = max(result, activation_min);
+            result = min(result, activation_max);
+            out_data[row * cols + col] = (int8_t) result;
+        }
+    }
+}
@@ -0,0 +1,103 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <common_functions.h>
+
+static __NN_SCRATCH_TLS__ int32_t *scratch_buf = NULL;
+
+/**
+ * @brief   Get scratch buffer size needed by batch matmul function
+ *
+ * @return  size in bytes, one int32_t sum per rhs row
+ */
+int32_t esp_nn_get_batch_matmul_scratch_size_opt(const int32_t cols, const int32_t depth)
+{
+    (void) depth;
+    return cols * sizeof(int32_t);
+}
+
+void esp_nn_set_batch_matmul_scratch_buf_opt(void *buffer)
+{
+    scratch_buf = (int32_t *) buffer;
+}
+
+__NN_FORCE_INLINE__ int8_t esp_nn_batch_matmul_requant(int32_t acc,
+                                                       const int32_t out_offset,
+                                                       const int32_t out_mult,
+                                                       const int32_t out_shift,
+                                                       const int32_t activation_min,
+                                                       const int32_t activation_max)
+{
+    acc = esp_nn_multiply_by_quantized_mult(acc, out_mult, out_shift);
+    acc += out_offset;
+    acc = max(acc, activation_min);
+    acc = min(acc, activation_max);
+    return (int8_t) acc;
+}
+
+/**
+ * sum((l + lhs_offset) * (r + rhs_offset)) is computed as
+ * sum(l * r) + rhs_offset * sum(l) + lhs_offset * sum(r) + depth * lhs_offset * rhs_offset
+ * with the rhs row sums kept in the scratch buffer. Rows of rhs are then
+ * taken 4 at a time so that every lhs load feeds 4 multiply-adds.
+ */
+void esp_nn_batch_matmul_s8_opt(const int8_t *lhs_data,
+                                const int32_t lhs_offset,
+                                const int8_t *rhs_data,
+                                const int32_t rhs_offset,
+                                int8_t *out_data,
+                                const int32_t rows,
+                                const int32_t cols,
+                                const int32_t depth,
+                                const int32_t out_offset,
+                                const int32_t out_mult,
+                                const int32_t out_shift,
+                                const int32_t activation_min,
+                                const int32_t activation_max)
+{
+    if (scratch_buf == NULL) {
+        printf("%s error! scratch buffer not set\n", __FUNCTION__);
+        return;
+    }
+    int32_t *rhs_sums = scratch_buf;
+    const int32_t offset_prod = depth * lhs_offset * rhs_offset;
+    for (int32_t col = 0; col < cols; col++) {
+        rhs_sums[col] = lhs_offset * esp_nn_sum_s8(rhs_data + col * depth, depth) + offset_prod;
+    }
+
+    for (int32_t row = 0; row < rows; row++) {
+        const int8_t *lhs_row = lhs_data + row * depth;
+        const int32_t lhs_sum = rhs_offset * esp_nn_sum_s8(lhs_row, depth);
+        int8_t *out_row = out_data + row * cols;
+        int32_t col = 0;
+        for (; col < cols - 3; col += 4) {
+            int32_t acc[4] = {0, 0, 0, 0};
+            esp_nn_dot4_s8(lhs_row, rhs_data + col * depth, depth, depth, acc);
+            for (int32_t i = 0; i < 4; i++) {
+                out_row[col + i] = esp_nn_batch_matmul_requant(acc[i] + lhs_sum + rhs_sums[col + i],
+                                                               out_offset, out_mult, out_shift,
+                                                               activation_min, activation_max);
+            }
+        }
+        for (; col < cols; col++) {
+            int32_t acc = esp_nn_dot_s8(lhs_row, rhs_data + col * depth, depth);
+            out_row[col] = esp_nn_batch_matmul_requant(acc + lhs_sum + rhs_sums[col],
+                                                       out_offset, out_mult, out_shift,
+                                                       activation_min, activation_max);
+        }
+    }
+}
@@ -0,0 +1,129 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdint.h>
+
+#include <common_functions.h>
+
+/**
+ * Blocked GEMV: 4 filter rows share every input load.
+ */
+void esp_nn_fully_connected_s8_s16_opt(const int8_t *input_data,
+                                       const uint16_t row_len,
+                                       const int8_t *filter_data,
+                                       const int32_t *bias,
+                                       int16_t *out_data,
+                                       const uint16_t out_channels,
+                                       const int32_t out_shift,
+                                       const int32_t out_mult,
+                                       const int32_t activation_min,
+                                       const int32_t activation_max)
+{
+    const int8_t *filter_ptr = filter_data;
+    int32_t out_c = 0;
+    for (; out_c < out_channels - 3; out_c += 4) {
+        int32_t acc[4] = {0, 0, 0, 0};
+        esp_nn_dot4_s8(input_data, filter_ptr, row_len, row_len, acc);
+        for (int32_t i = 0; i < 4; i++) {
+            int32_t result = acc[i];
+            if (bias) {
+                result += bias[out_c + i];
+            }
+            result = esp_nn_multiply_by_quantized_mult(result, out_mult, out_shift);
+            result = max(result, activation_min);
+            result = min(result, activation_max);
+            out_data[out_c + i] = (int16_t) result;
+        }
+        filter_ptr += 4 * row_len;
+    }
+    for (; out_c < out_channels; ++out_c) {
+        int32_t result = esp_nn_dot_s8(input_data, filter_ptr, row_len);
+        if (bias) {
+            result += bias[out_c];
+        }
+        result = esp_nn_multiply_by_quantized_mult(result, out_mult, out_shift);
+        result = max(result, activation_min);
+        result = min(result, activation_max);
+        out_data[out_c] = (int16_t) result;
+        filter_ptr += row_len;
+    }
+}
+
+void esp_nn_fully_connected_s16_opt(const int16_t *input_data,
+                                    const uint16_t row_len,
+                                    const int8_t *filter_data,
+                                    const int64_t *bias,
+                                    int16_t *out_data,
+                                    const uint16_t out_channels,
+                                    const int32_t out_shift,
+                                    const int32_t out_mult,
+                                    const int32_t activation_min,
+                                    const int32_t activation_max)
+{
+    const int8_t *filter_ptr = filter_data;
+    for (int32_t out_c = 0; out_c < out_channels; ++out_c) {
+        int64_t acc = esp_nn_dot_s16_s8(input_data, filter_ptr, row_len);
+        if (bias) {
+            acc += bias[out_c];
+        }
+        int32_t result = esp_nn_multiply_by_quantized_mult_s64(acc, out_mult, out_shift);
+        result = max(result, activation_min);
+        result = min(result, activation_max);
+        out_data[out_c] = (int16_t) result;
+        filter_ptr += row_len;
+    }
+}
+
+/**
+ * Blocked GEMV: 4 filter rows share every input load.
+ */
+void esp_nn_fully_connected_f32_opt(const float *input_data,
+                                    const uint16_t row_len,
+                                    const float *filter_data,
+                                    const float *bias,
+                                    float *out_data,
+                                    const uint16_t out_channels,
+                                    const float activation_min,
+                                    const float activation_max)
+{
+    const float *filter_ptr = filter_data;
+    int32_t out_c = 0;
+    for (; out_c < out_channels - 3; out_c += 4) {
+        float acc[4] = {0, 0, 0, 0};
+        esp_nn_dot4_f32(input_data, filter_ptr, row_len, row_len, acc);
+        for (int32_t i = 0; i < 4; i++) {
+            float result = acc[i];
+            if (bias) {
+                result += bias[out_c + i];
+            }
+            result = max(result, activation_min);
+            result = min(result, activation_max);
+            out_data[out_c + i] = result;
+        }
+        filter_ptr += 4 * row_len;
+    }
+    for (; out_c < out_channels; ++out_c) {
+        float result = 0;
+        for (int32_t i = 0; i < row_len; i++) {
+            result += input_data[i] * filter_ptr[i];
+        }
+        if (bias) {
+            result += bias[out_c];
+        }
+        result = max(result, activation_min);
+        result = min(result, activation_max);
+        out_data[out_c] = result;
+        filter_ptr += row_len;
+    }
+}
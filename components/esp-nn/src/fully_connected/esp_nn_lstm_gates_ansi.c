@@ -0,0 +1,70 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdint.h>
+
+#include <esp_nn_defs.h>
+
+#include <common_functions.h>
+
+void esp_nn_lstm_gates_s8_ansi(const int8_t *input_data,
+                               const uint16_t input_len,
+                               const int8_t *hidden_data,
+                               const uint16_t hidden_len,
+                               const int8_t *filter_data,
+                               const int32_t *input_bias,
+                               const int32_t *recurrent_bias,
+                               int16_t *out_data,
+                               const uint16_t gates,
+                               const uint16_t cells,
+                               const quant_data_t *input_quant,
+                               const quant_data_t *recurrent_quant)
+{
+    const int32_t row_len = input_len + hidden_len;
+    for (int32_t gate = 0; gate < gates; gate++) {
+        for (int32_t cell = 0; cell < cells; cell++) {
+            const int32_t row = gate * cells + cell;
+            const int8_t *filter_ptr = filter_data + row * row_len;
+
+            int32_t input_acc = 0;
+            for (int32_t i = 0; i < input_len; i++) {
+                input_acc += input_data[i] * filter_ptr[i];
+            }
+            if (input_bias) {
+                input_acc += input_bias[row];
+            }
+            input_acc = esp_nn_multiply_by_quantized_mult(input_acc, input_quant->mult[gate],
+                                                          input_quant->shift[gate]);
+            input_acc = max(input_acc, INT16_MIN);
+            input_acc = min(input_acc, INT16_MAX);
+
+            int32_t recurrent_acc = 0;
+            for (int32_t i = 0; i < hidden_len; i++) {
+                recurrent_acc += hidden_data[i] * filter_ptr[input_len + i];
+            }
+            if (recurrent_bias) {
+                recurrent_acc += recurrent_bias[row];
+            }
+            recurrent_acc = esp_nn_multiply_by_quantized_mult(recurrent_acc, recurrent_quant->mult[gate],
+                                                              recurrent_quant->shift[gate]);
+            recurrent_acc = max(recurrent_acc, INT16_MIN);
+            recurrent_acc = min(recurrent_acc, INT16_MAX);
+
+            int32_t result = input_acc + recurrent_acc;
+            result = max(result, INT16_MIN);
+            result = min(result, INT16_MAX);
+            out_data[row] = (int16_t) result;
+        }
+    }
+}
@@ -0,0 +1,96 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdint.h>
+
+#include <esp_nn_defs.h>
+
+#include <common_functions.h>
+
+__NN_FORCE_INLINE__ int32_t esp_nn_lstm_gate_requant(int32_t acc, const int32_t *bias,
+                                                     const int32_t mult, const int32_t shift)
+{
+    if (bias) {
+        acc += *bias;
+    }
+    acc = esp_nn_multiply_by_quantized_mult(acc, mult, shift);
+    acc = max(acc, INT16_MIN);
+    return min(acc, INT16_MAX);
+}
+
+__NN_FORCE_INLINE__ int16_t esp_nn_lstm_gate_sum(const int32_t input_acc, const int32_t recurrent_acc)
+{
+    int32_t result = input_acc + recurrent_acc;
+    result = max(result, INT16_MIN);
+    result = min(result, INT16_MAX);
+    return (int16_t) result;
+}
+
+/**
+ * The input and recurrent halves of every packed row are accumulated in the
+ * same pass, 4 rows at a time so that each input and hidden load feeds 4
+ * multiply-adds. Blocks never straddle two gates, as every gate has its own
+ * requantization.
+ */
+void esp_nn_lstm_gates_s8_opt(const int8_t *input_data,
+                              const uint16_t input_len,
+                              const int8_t *hidden_data,
+                              const uint16_t hidden_len,
+                              const int8_t *filter_data,
+                              const int32_t *input_bias,
+                              const int32_t *recurrent_bias,
+                              int16_t *out_data,
+                              const uint16_t gates,
+                              const uint16_t cells,
+                              const quant_data_t *input_quant,
+                              const quant_data_t *recurrent_quant)
+{
+    const int32_t row_len = input_len + hidden_len;
+    for (int32_t gate = 0; gate < gates; gate++) {
+        const int32_t input_mult = input_quant->mult[gate];
+        const int32_t input_shift = input_quant->shift[gate];
+        const int32_t recurrent_mult = recurrent_quant->mult[gate];
+        const int32_t recurrent_shift = recurrent_quant->shift[gate];
+        int32_t row = gate * cells;
+        const int32_t gate_end = row + cells;
+
+        for (; row < gate_end - 3; row += 4) {
+            const int8_t *filter_ptr = filter_data + row * row_len;
+            int32_t input_acc[4] = {0, 0, 0, 0};
+            int32_t recurrent_acc[4] = {0, 0, 0, 0};
+            esp_nn_dot4_s8(input_data, filter_ptr, row_len, input_len, input_acc);
+            esp_nn_dot4_s8(hidden_data, filter_ptr + input_len, row_len, hidden_len, recurrent_acc);
+            for (int32_t i = 0; i < 4; i++) {
+                const int32_t in = esp_nn_lstm_gate_requant(input_acc[i],
+                                                            input_bias ? input_bias + row + i : NULL,
+                                                            input_mult, input_shift);
+                const int32_t rec = esp_nn_lstm_gate_requant(recurrent_acc[i],
+                                                             recurrent_bias ? recurrent_bias + row + i : NULL,
+                                                             recurrent_mult, recurrent_shift);
+                out_data[row + i] = esp_nn_lstm_gate_sum(in, rec);
+            }
+        }
+        for (; row < gate_end; row++) {
+            const int8_t *filter_ptr = filter_data + row * row_len;
+            const int32_t in = esp_nn_lstm_gate_requant(esp_nn_dot_s8(input_data, filter_ptr, input_len),
+                                                        input_bias ? input_bias + row : NULL,
+                                                        input_mult, input_shift);
+            const int32_t rec = esp_nn_lstm_gate_requant(esp_nn_dot_s8(hidden_data, filter_ptr + input_len,
+                                                                       hidden_len),
+                                                         recurrent_bias ? recurrent_bias + row : NULL,
+                                                         recurrent_mult, recurrent_shift);
+            out_data[row] = esp_nn_lstm_gate_sum(in, rec);
+        }
+    }
+}
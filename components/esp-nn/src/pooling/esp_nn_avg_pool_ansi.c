@@ -70,3 +70,61 @@ void esp_nn_avg_pool_s8_ansi(const int8_t *input,
         }
     }
 }
+
+/**
+ * float32 version
+ *
+ * Sums are built directly in the output pixel with channels innermost, so
+ * every tap is one contiguous pass over the channels.
+ */
+void esp_nn_avg_pool_f32_ansi(const float *input,
+                              const uint16_t input_wd,
+                              const uint16_t input_ht,
+                              float *output,
+                              const uint16_t output_wd,
+                              const uint16_t output_ht,
+                              const uint16_t stride_wd,
+                              const uint16_t stride_ht,
+                              const uint16_t filter_wd,
+                              const uint16_t filter_ht,
+                              const uint16_t pad_wd,
+                              const uint16_t pad_ht,
+                              const float activation_min,
+                              const float activation_max,
+                              const uint16_t channels)
+{
+    int32_t base_y = -pad_ht;
+    for (int32_t out_y = 0; out_y < output_ht; out_y++, base_y += stride_ht) {
+        int32_t base_x = -pad_wd;
+        for (int32_t out_x = 0; out_x < output_wd; out_x++, base_x += stride_wd) {
+            /* Make sure filter does not cross the input box */
+            int32_t filter_y_start = max(0, -base_y);
+            int32_t filter_x_start = max(0, -base_x);
+            int32_t filter_y_end = min(filter_ht, input_ht - base_y);
+            int32_t filter_x_end = min(filter_wd, input_wd - base_x);
+            int32_t filter_cnt = (filter_y_end - filter_y_start) * (filter_x_end - filter_x_start);
+
+            float *out_ptr = output + (out_y * output_wd + out_x) * channels;
+            for (int32_t ch_idx = 0; ch_idx < channels; ch_idx++) {
+                out_ptr[ch_idx] = 0;
+            }
+            for (int32_t filter_y = filter_y_start; filter_y < filter_y_end; filter_y++) {
+                for (int32_t filter_x = filter_x_start; filter_x < filter_x_end; filter_x++) {
+                    int32_t in_x_idx = base_x + filter_x;
+                    int32_t in_y_idx = base_y + filter_y;
+                    const float *in_ptr = input + (in_y_idx * input_wd + in_x_idx) * channels;
+                    for (int32_t ch_idx = 0; ch_idx < channels; ch_idx++) {
+                        out_ptr[ch_idx] += in_ptr[ch_idx];
+                    }
+                }
+            }
+            for (int32_t ch_idx = 0; ch_idx < channels; ch_idx++) {
+                float result = out_ptr[ch_idx] / filter_cnt;
+                /* Activation function */
+                result = max(result, activation_min);
+                result = min(result, activation_max);
+                out_ptr[ch_idx] = result;
+            }
+        }
+    }
+}
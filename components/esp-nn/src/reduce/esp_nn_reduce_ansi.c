@@ -0,0 +1,75 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdint.h>
+
+#include <common_functions.h>
+
+int32_t esp_nn_get_reduce_scratch_size_ansi(const int32_t inner_size)
+{
+    (void) inner_size;
+    return 0;
+}
+
+void esp_nn_set_reduce_scratch_buf_ansi(void *buffer)
+{
+    (void) buffer;
+}
+
+void esp_nn_reduce_sum_s8_ansi(const int8_t *input_data,
+                               const int32_t outer_size,
+                               const int32_t reduce_size,
+                               const int32_t inner_size,
+                               const int32_t input_offset,
+                               int8_t *out_data,
+                               const int32_t out_offset,
+                               const int32_t out_mult,
+                               const int32_t out_shift,
+                               const int32_t activation_min,
+                               const int32_t activation_max)
+{
+    for (int32_t outer = 0; outer < outer_size; outer++) {
+        const int8_t *in_ptr = input_data + outer * reduce_size * inner_size;
+        for (int32_t inner = 0; inner < inner_size; inner++) {
+            int32_t result = 0;
+            for (int32_t r = 0; r < reduce_size; r++) {
+                result += in_ptr[r * inner_size + inner];
+            }
+            result += input_offset * reduce_size;
+            result = esp_nn_multiply_by_quantized_mult(result, out_mult, out_shift);
+            result += out_offset;
+            result = max(result, activation_min);
+            result = min(result, activation_max);
+            out_data[outer * inner_size + inner] = (int8_t) result;
+        }
+    }
+}
+
+void esp_nn_reduce_max_s8_ansi(const int8_t *input_data,
+                               const int32_t outer_size,
+                               const int32_t reduce_size,
+                               const int32_t inner_size,
+                               int8_t *out_data)
+{
+    for (int32_t outer = 0; outer < outer_size; outer++) {
+        const int8_t *in_ptr = input_data + outer * reduce_size * inner_size;
+        for (int32_t inner = 0; inner < inner_size; inner++) {
+            int8_t result = INT8_MIN;
+            for (int32_t r = 0; r < reduce_size; r++) {
+                result = max(result, in_ptr[r * inner_size + inner]);
+            }
+            out_data[outer * inner_size + inner] = result;
+        }
+    }
+}
@@ -0,0 +1,141 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdint.h>
+#include <string.h>
+
+#include <common_functions.h>
+
+static __NN_SCRATCH_TLS__ int32_t *scratch_buf = NULL;
+
+/**
+ * @brief   Get scratch buffer size needed by reduce sum function
+ *
+ * @return  size in bytes, one int32_t accumulator per inner element
+ */
+int32_t esp_nn_get_reduce_scratch_size_opt(const int32_t inner_size)
+{
+    return inner_size * sizeof(int32_t);
+}
+
+void esp_nn_set_reduce_scratch_buf_opt(void *buffer)
+{
+    scratch_buf = (int32_t *) buffer;
+}
+
+__NN_FORCE_INLINE__ int8_t esp_nn_reduce_requant(int32_t acc,
+                                                 const int32_t out_offset,
+                                                 const int32_t out_mult,
+                                                 const int32_t out_shift,
+                                                 const int32_t activation_min,
+                                                 const int32_t activation_max)
+{
+    acc = esp_nn_multiply_by_quantized_mult(acc, out_mult, out_shift);
+    acc += out_offset;
+    acc = max(acc, activation_min);
+    acc = min(acc, activation_max);
+    return (int8_t) acc;
+}
+
+/**
+ * The reduced rows are contiguous runs of inner_size elements, so they are
+ * added row by row into the scratch accumulators instead of the strided
+ * gather of the ansi version. Rows are taken 4 at a time; 4 int8 values are
+ * summed before every accumulator update.
+ */
+void esp_nn_reduce_sum_s8_opt(const int8_t *input_data,
+                              const int32_t outer_size,
+                              const int32_t reduce_size,
+                              const int32_t inner_size,
+                              const int32_t input_offset,
+                              int8_t *out_data,
+                              const int32_t out_offset,
+                              const int32_t out_mult,
+                              const int32_t out_shift,
+                              const int32_t activation_min,
+                              const int32_t activation_max)
+{
+    const int32_t offset = input_offset * reduce_size;
+
+    if (inner_size == 1) {
+        for (int32_t outer = 0; outer < outer_size; outer++) {
+            const int32_t acc = esp_nn_sum_s8(input_data + outer * reduce_size, reduce_size);
+            out_data[outer] = esp_nn_reduce_requant(acc + offset, out_offset, out_mult, out_shift,
+                                                    activation_min, activation_max);
+        }
+        return;
+    }
+
+    int32_t *acc = scratch_buf;
+    for (int32_t outer = 0; outer < outer_size; outer++) {
+        const int8_t *in_ptr = input_data + outer * reduce_size * inner_size;
+        memset(acc, 0, inner_size * sizeof(int32_t));
+
+        int32_t r = 0;
+        for (; r < reduce_size - 3; r += 4) {
+            const int8_t *row0 = in_ptr;
+            const int8_t *row1 = row0 + inner_size;
+            const int8_t *row2 = row1 + inner_size;
+            const int8_t *row3 = row2 + inner_size;
+            for (int32_t i = 0; i < inner_size; i++) {
+                acc[i] += (int16_t) (row0[i] + row1[i]) + (int16_t) (row2[i] + row3[i]);
+            }
+            in_ptr += 4 * inner_size;
+        }
+        for (; r < reduce_size; r++) {
+            for (int32_t i = 0; i < inner_size; i++) {
+                acc[i] += in_ptr[i];
+            }
+            in_ptr += inner_size;
+        }
+
+        int8_t *out_ptr = out_data + outer * inner_size;
+        for (int32_t i = 0; i < inner_size; i++) {
+            out_ptr[i] = esp_nn_reduce_requant(acc[i] + offset, out_offset, out_mult, out_shift,
+                                               activation_min, activation_max);
+        }
+    }
+}
+
+/**
+ * Running maximum kept in the output row itself, one contiguous input row at
+ * a time.
+ */
+void esp_nn_reduce_max_s8_opt(const int8_t *input_data,
+                              const int32_t outer_size,
+                              const int32_t reduce_size,
+                              const int32_t inner_size,
+                              int8_t *out_data)
+{
+    for (int32_t outer = 0; outer < outer_size; outer++) {
+        const int8_t *in_ptr = input_data + outer * reduce_size * inner_size;
+        int8_t *out_ptr = out_data + outer * inner_size;
+        if (inner_size == 1) {
+            int8_t result = INT8_MIN;
+            for (int32_t r = 0; r < reduce_size; r++) {
+                result = max(result, in_ptr[r]);
+            }
+            *out_ptr = result;
+            continue;
+        }
+        memcpy(out_ptr, in_ptr, inner_size);
+        in_ptr += inner_size;
+        for (int32_t r = 1; r < reduce_size; r++) {
+            for (int32_t i = 0; i < inner_size; i++) {
+                out_ptr[i] = max(out_ptr[i], in_ptr[i]);
+            }
+            in_ptr += inner_size;
+        }
+    }
+}
@@ -0,0 +1,98 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdint.h>
+
+#include <esp_nn_defs.h>
+
+#include <common_functions.h>
+
+int32_t esp_nn_get_resize_bilinear_scratch_size_ansi(const data_dims_t *output_dims)
+{
+    (void) output_dims;
+    return 0;
+}
+
+void esp_nn_set_resize_bilinear_scratch_buf_ansi(void *buffer)
+{
+    (void) buffer;
+}
+
+/* input to output size ratio in Q10 */
+static int32_t esp_nn_resize_scale_10(const int32_t in_size, const int32_t out_size,
+                                      const int32_t align_corners)
+{
+    if (align_corners && out_size > 1) {
+        return ((1 << 10) * (in_size - 1) + (out_size - 1) / 2) / (out_size - 1);
+    }
+    return ((1 << 10) * in_size + out_size / 2) / out_size;
+}
+
+/* Q10 source position of output index `out_idx` and the two pixels around it */
+static void esp_nn_resize_src_pos(const int32_t out_idx, const int32_t scale_10,
+                                  const int32_t half_pixel_centers, const int32_t in_size,
+                                  int32_t *pos, int32_t *lower, int32_t *upper)
+{
+    *pos = out_idx * scale_10;
+    if (half_pixel_centers) {
+        *pos += scale_10 / 2 - (1 << 9);
+    }
+    *lower = max(*pos / (1 << 10), 0);
+    *upper = min((*pos + (1 << 10) - 1) / (1 << 10), in_size - 1);
+}
+
+void esp_nn_resize_bilinear_s8_ansi(const data_dims_t *input_dims,
+                                    const int8_t *input_data,
+                                    const data_dims_t *output_dims,
+                                    int8_t *out_data,
+                                    const resize_params_t *resize_params)
+{
+    const int32_t batches = input_dims->extra;
+    const int32_t in_ht = input_dims->height;
+    const int32_t in_wd = input_dims->width;
+    const int32_t channels = input_dims->channels;
+    const int32_t out_ht = output_dims->height;
+    const int32_t out_wd = output_dims->width;
+    const int32_t scale_y = esp_nn_resize_scale_10(in_ht, out_ht, resize_params->align_corners);
+    const int32_t scale_x = esp_nn_resize_scale_10(in_wd, out_wd, resize_params->align_corners);
+
+    for (int32_t b = 0; b < batches; b++) {
+        const int8_t *in_batch = input_data + b * in_ht * in_wd * channels;
+        for (int32_t y = 0; y < out_ht; y++) {
+            int32_t pos_y, y0, y1;
+            esp_nn_resize_src_pos(y, scale_y, resize_params->half_pixel_centers, in_ht,
+                                  &pos_y, &y0, &y1);
+            const int32_t dy = pos_y - (1 << 10) * y0;
+            for (int32_t x = 0; x < out_wd; x++) {
+                int32_t pos_x, x0, x1;
+                esp_nn_resize_src_pos(x, scale_x, resize_params->half_pixel_centers, in_wd,
+                                      &pos_x, &x0, &x1);
+                const int32_t dx = pos_x - (1 << 10) * x0;
+                for (int32_t c = 0; c < channels; c++) {
+                    const int32_t in_00 = in_batch[(y0 * in_wd + x0) * channels + c];
+                    const int32_t in_10 = in_batch[(y1 * in_wd + x0) * channels + c];
+                    const int32_t in_01 = in_batch[(y0 * in_wd + x1) * channels + c];
+                    const int32_t in_11 = in_batch[(y1 * in_wd + x1) * channels + c];
+                    /* the four weights add up to 1 << 20, result fits 32 bits */
+                    const int32_t result = in_00 * ((1 << 10) - dy) * ((1 << 10) - dx) +
+                                           in_10 * dy * ((1 << 10) - dx) +
+                                           in_01 * ((1 << 10) - dy) * dx +
+                                           in_11 * dy * dx;
+                    const int32_t round = result > 0 ? (1 << 19) : -(1 << 19);
+                    *out_data++ = (int8_t) ((result + round) / (1 << 20));
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,150 @@
+// Copyright 2024 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdint.h>
+
+#include <esp_nn_defs.h>
+
+#include <common_functions.h>
+
+static __NN_SCRATCH_TLS__ int32_t *scratch_buf = NULL;
+
+/**
+ * @brief   Get scratch buffer size needed by bilinear resize function
+ *
+ * @return  size in bytes: x0, x1 and weight per output column, plus two
+ *          horizontally interpolated output rows
+ */
+int32_t esp_nn_get_resize_bilinear_scratch_size_opt(const data_dims_t *output_dims)
+{
+    return (3 * output_dims->width + 2 * output_dims->width * output_dims->channels) * sizeof(int32_t);
+}
+
+void esp_nn_set_resize_bilinear_scratch_buf_opt(void *buffer)
+{
+    scratch_buf = (int32_t *) buffer;
+}
+
+__NN_FORCE_INLINE__ int32_t esp_nn_resize_scale_10(const int32_t in_size, const int32_t out_size,
+                                                   const int32_t align_corners)
+{
+    if (align_corners && out_size > 1) {
+        return ((1 << 10) * (in_size - 1) + (out_size - 1) / 2) / (out_size - 1);
+    }
+    return ((1 << 10) * in_size + out_size / 2) / out_size;
+}
+
+__NN_FORCE_INLINE__ void esp_nn_resize_src_pos(const int32_t out_idx, const int32_t scale_10,
+                                               const int32_t half_pixel_centers, const int32_t in_size,
+                                               int32_t *pos, int32_t *lower, int32_t *upper)
+{
+    *pos = out_idx * scale_10;
+    if (half_pixel_centers) {
+        *pos += scale_10 / 2 - (1 << 9);
+    }
+    *lower = max(*pos / (1 << 10), 0);
+    *upper = min((*pos + (1 << 10) - 1) / (1 << 10), in_size - 1);
+}
+
+/* interpolate input row `in_row` along x, Q10 result kept in 32 bits */
+static void esp_nn_resize_row_s8(const int8_t *in_row, const int32_t *x_table,
+                                 const int32_t out_wd, const int32_t channels,
+                                 int32_t *out_row)
+{
+    for (int32_t x = 0; x < out_wd; x++) {
+        const int8_t *in_0 = in_row + x_table[3 * x];
+        const int8_t *in_1 = in_row + x_table[3 * x + 1];
+        const int32_t dx = x_table[3 * x + 2];
+        const int32_t dx_0 = (1 << 10) - dx;
+        for (int32_t c = 0; c < channels; c++) {
+            out_row[c] = in_0[c] * dx_0 + in_1[c] * dx;
+        }
+        out_row += channels;
+    }
+}
+
+/**
+ * Separable version: every input row is interpolated along x once into a
+ * 32 bit scratch row, and output rows blend two of those along y. The
+ * intermediate is not rounded, so the result is bit-exact with the four tap
+ * ansi version. A row pair is kept across output rows, which is what makes
+ * upsampling cheap: with factor 2 every interpolated row is used 2-4 times.
+ */
+void esp_nn_resize_bilinear_s8_opt(const data_dims_t *input_dims,
+                                   const int8_t *input_data,
+                                   const data_dims_t *output_dims,
+                                   int8_t *out_data,
+                                   const resize_params_t *resize_params)
+{
+    const int32_t batches = input_dims->extra;
+    const int32_t in_ht = input_dims->height;
+    const int32_t in_wd = input_dims->width;
+    const int32_t channels = input_dims->channels;
+    const int32_t out_ht = output_dims->height;
+    const int32_t out_wd = output_dims->width;
+    const int32_t half_pixel_centers = resize_params->half_pixel_centers;
+    const int32_t scale_y = esp_nn_resize_scale_10(in_ht, out_ht, resize_params->align_corners);
+    const int32_t scale_x = esp_nn_resize_scale_10(in_wd, out_wd, resize_params->align_corners);
+    const int32_t row_len = out_wd * channels;
+
+    int32_t *x_table = scratch_buf;
+    int32_t *row_0 = x_table + 3 * out_wd;
+    int32_t *row_1 = row_0 + row_len;
+
+    for (int32_t x = 0; x < out_wd; x++) {
+        int32_t pos_x, x0, x1;
+        esp_nn_resize_src_pos(x, scale_x, half_pixel_centers, in_wd, &pos_x, &x0, &x1);
+        x_table[3 * x] = x0 * channels;
+        x_table[3 * x + 1] = x1 * channels;
+        x_table[3 * x + 2] = pos_x - (1 << 10) * x0;
+    }
+
+    for (int32_t b = 0; b < batches; b++) {
+        const int8_t *in_batch = input_data + b * in_ht * in_wd * channels;
+        int32_t row_0_y = -1, row_1_y = -1;
+        for (int32_t y = 0; y < out_ht; y++) {
+            int32_t pos_y, y0, y1;
+            esp_nn_resize_src_pos(y, scale_y, half_pixel_centers, in_ht, &pos_y, &y0, &y1);
+            const int32_t dy = pos_y - (1 << 10) * y0;
+            const int32_t dy_0 = (1 << 10) - dy;
+
+            if (row_0_y != y0) {
+                if (row_1_y == y0) {
+                    /* moving down by one input row, reuse the lower one */
+                    int32_t *tmp = row_0;
+                    row_0 = row_1;
+                    row_1 = tmp;
+                    row_1_y = -1;
+                } else {
+                    esp_nn_resize_row_s8(in_batch + y0 * in_wd * channels, x_table,
+                                         out_wd, channels, row_0);
+                }
+                row_0_y = y0;
+            }
+            if (y1 != y0 && row_1_y != y1) {
+                esp_nn_resize_row_s8(in_batch + y1 * in_wd * channels, x_table,
+                                     out_wd, channels, row_1);
+                row_1_y = y1;
+            }
+            const int32_t *bottom = y1 == y0 ? row_0 : row_1;
+
+            for (int32_t i = 0; i < row_len; i++) {
+                const int32_t result = row_0[i] * dy_0 + bottom[i] * dy;
+                const int32_t round = result > 0 ? (1 << 19) : -(1 << 19);
+                out_data[i] = (int8_t) ((result + round) / (1 << 20));
+            }
+            out_data += row_len;
+        }
+    }
+}
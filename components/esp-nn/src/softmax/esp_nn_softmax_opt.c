@@ -15,7 +15,7 @@
 #include "softmax_common.h"
 #include <stdio.h>
 
-static int32_t *scratch_buf = NULL;
+static __NN_SCRATCH_TLS__ int32_t *scratch_buf = NULL;
 
 /**
  * @brief   Get scratch buffer size needed by softmax function
@@ -63,19 +63,44 @@ void app_main()
     printf("mul, c %"PRIu32" opt %"PRIu32"\n", total_c, total_opt);
     esp_nn_depthwise_conv_s8_test();
     esp_nn_conv_s8_test();
+    esp_nn_transpose_conv_s8_test();
 
     esp_nn_relu6_s8_test();
     printf("relu, c %"PRIu32" opt %"PRIu32"\n", total_c, total_opt);
+    esp_nn_lut_s8_test();
+    printf("lut, c %"PRIu32" opt %"PRIu32"\n", total_c, total_opt);
     esp_nn_avg_pool_s8_test();
     printf("avg_pool, c %"PRIu32" opt %"PRIu32"\n", total_c, total_opt);
     esp_nn_max_pool_s8_test();
     printf("max_pool, c %"PRIu32" opt %"PRIu32"\n", total_c, total_opt);
     esp_nn_fully_connected_s8_test();
     esp_nn_fully_connected_per_ch_s8_test();
+    esp_nn_batch_matmul_s8_test();
+    esp_nn_lstm_gates_s8_test();
     esp_nn_softmax_s8_test();
     printf("softmax, c %"PRIu32" opt %"PRIu32"\n", total_c, total_opt);
+    esp_nn_reduce_sum_s8_test();
+    esp_nn_reduce_max_s8_test();
+    esp_nn_resize_bilinear_s8_test();
     ESP_LOGI(TAG, "s8 tests done!\n");
 
+    /* s16 tests */
+    ESP_LOGI(TAG, "Running s16 tests...");
+    esp_nn_elementwise_s16_test();
+    printf("add s16 %"PRIu32", mul s16 %"PRIu32"\n", total_c, total_opt);
+    esp_nn_depthwise_conv_s16_test();
+    esp_nn_conv_s16_test();
+    esp_nn_fully_connected_s8_s16_test();
+    esp_nn_fully_connected_s16_test();
+    ESP_LOGI(TAG, "s16 tests done!\n");
+
+    /* f32 tests */
+    ESP_LOGI(TAG, "Running f32 tests...");
+    esp_nn_depthwise_conv_f32_test();
+    esp_nn_conv_f32_test();
+    esp_nn_fully_connected_f32_test();
+    ESP_LOGI(TAG, "f32 tests done!\n");
+
     /* u8 tests */
     //ESP_LOGI(TAG, "Running u8 tests...");
     //esp_nn_add_elementwise_u8_test();
@@ -19,17 +19,41 @@ void esp_nn_mul_elementwise_s8_test();
 
 void esp_nn_depthwise_conv_s8_test();
 void esp_nn_conv_s8_test();
+void esp_nn_transpose_conv_s8_test();
 
 void esp_nn_avg_pool_s8_test();
 void esp_nn_max_pool_s8_test();
 
 void esp_nn_fully_connected_s8_test();
 void esp_nn_fully_connected_per_ch_s8_test();
+void esp_nn_batch_matmul_s8_test();
+void esp_nn_lstm_gates_s8_test();
 
 void esp_nn_relu6_s8_test();
+void esp_nn_lut_s8_test();
 
 void esp_nn_softmax_s8_test();
 
+void esp_nn_reduce_sum_s8_test();
+void esp_nn_reduce_max_s8_test();
+
+void esp_nn_resize_bilinear_s8_test();
+
+/* int16_t activation, int8_t filter (16x8) ops tests */
+void esp_nn_elementwise_s16_test();
+
+void esp_nn_depthwise_conv_s16_test();
+void esp_nn_conv_s16_test();
+
+void esp_nn_fully_connected_s8_s16_test();
+void esp_nn_fully_connected_s16_test();
+
+/* float32 ops tests */
+void esp_nn_depthwise_conv_f32_test();
+void esp_nn_conv_f32_test();
+
+void esp_nn_fully_connected_f32_test();
+
 /* uint8_t ops tests */
 void esp_nn_add_elementwise_u8_test();
 
@@ -60,6 +60,21 @@ uint32_t profile_opt_end();
     res;                                        \
 })
 
+/* float compare, `tol` is relative to the magnitude of ARRAY1 */
+#define CHECK_NEAR(ARRAY1, ARRAY2, size, tol) ({                \
+    bool res = true;                                            \
+    for (int _i = 0; _i < size; _i++) {                         \
+        float _ref = ARRAY1[_i] < 0 ? -ARRAY1[_i] : ARRAY1[_i]; \
+        float _diff = ARRAY1[_i] - ARRAY2[_i];                  \
+        _diff = _diff < 0 ? -_diff : _diff;                     \
+        if (_diff > (tol) * (1.0f + _ref)) {                    \
+            res = false;                                        \
+            break;                                              \
+        }                                                       \
+    }                                                           \
+    res;                                                        \
+})
+
 #define PRINT_ARRAY_INT(ARRAY, width, height) ({        \
     int *_array = (int *) ARRAY;                        \
     for (int _j = 0; _j < height; _j++) {               \
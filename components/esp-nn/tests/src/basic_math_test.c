@@ -377,3 +377,64 @@ elementwise_mult_test_cleanup:
         }
     }
 }
+
+/**
+ * s16 add and mul do the same arithmetic as the s8 ones, hence inputs in 8 bit
+ * range with 8 bit activation limits must give the same outputs.
+ */
+void esp_nn_elementwise_s16_test()
+{
+    const int size = 256 + 7;
+    int8_t in1_s8[size], in2_s8[size], out_s8[size];
+    int16_t in1_s16[size], in2_s16[size], out_s16[size];
+
+    printf("\n######## Running %s ##########\n", __FUNCTION__);
+    for (int itr = 0; itr < 5; itr++) {
+        const int32_t input1_offset = rand() % 256 - 127;
+        const int32_t input2_offset = rand() % 256 - 127;
+        const int32_t output_offset = rand() % 256 - 128;
+        const int32_t input1_mult = MULT_MAX / 2 + rand() % INT16_MAX;
+        const int32_t input2_mult = MULT_MAX / 2 + rand() % INT16_MAX;
+        const int32_t output_mult = MULT_MAX / 2 + rand() % INT16_MAX;
+        const int32_t input1_shift = -8 + rand() % 4;
+        const int32_t input2_shift = -8 + rand() % 4;
+        const int32_t output_shift = -8 + rand() % 4;
+        const int32_t left_shift = rand() % 15;
+
+        for (int i = 0; i < size; ++i) {
+            in1_s8[i] = rand() % 256 - 128;
+            in2_s8[i] = rand() % 256 - 128;
+            in1_s16[i] = in1_s8[i];
+            in2_s16[i] = in2_s8[i];
+        }
+
+        esp_nn_add_elementwise_s8_ansi(in1_s8, in2_s8, input1_offset, input2_offset,
+                                       input1_mult, input2_mult, input1_shift, input2_shift,
+                                       left_shift, out_s8, output_offset, output_mult,
+                                       output_shift, -128, 127, size);
+        profile_c_start();
+        esp_nn_add_elementwise_s16(in1_s16, in2_s16, input1_offset, input2_offset,
+                                   input1_mult, input2_mult, input1_shift, input2_shift,
+                                   left_shift, out_s16, output_offset, output_mult,
+                                   output_shift, -128, 127, size);
+        profile_c_end();
+        if (CHECK_EQUAL(out_s8, out_s16, size) == false) {
+            printf(ANSI_COLOR_RED"%s[%d] add failed\n"ANSI_COLOR_RESET, __FUNCTION__, itr);
+            return;
+        }
+
+        esp_nn_mul_elementwise_s8_ansi(in1_s8, in2_s8, input1_offset, input2_offset,
+                                       out_s8, output_offset, output_mult, output_shift,
+                                       -128, 127, size);
+        profile_opt_start();
+        esp_nn_mul_elementwise_s16(in1_s16, in2_s16, input1_offset, input2_offset,
+                                   out_s16, output_offset, output_mult, output_shift,
+                                   -128, 127, size);
+        profile_opt_end();
+        if (CHECK_EQUAL(out_s8, out_s16, size) == false) {
+            printf(ANSI_COLOR_RED"%s[%d] mul failed\n"ANSI_COLOR_RESET, __FUNCTION__, itr);
+            return;
+        }
+        printf(ANSI_COLOR_GREEN"%s[%d] passed\n"ANSI_COLOR_RESET, __FUNCTION__, itr);
+    }
+}
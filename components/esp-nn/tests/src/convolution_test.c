@@ -650,3 +650,402 @@ void esp_nn_conv_s8_test()
         }
     }
 }
+
+/* 16x8 cases: {in_wd, in_ht, in_ch, out_ch (ch_mult for depthwise), filter_wd, filter_ht, pad, stride} */
+static const uint16_t conv_s16_test_cases[][8] = {
+    {10, 10, 64, 64, 1, 1, 0, 1},
+    {10, 10,  3, 64, 3, 3, 0, 1},
+    {10, 10, 12, 64, 3, 3, 1, 1},
+    {16, 16, 16, 16, 1, 1, 0, 2},
+    { 3,  3, 32,  1, 3, 3, 1, 1},
+    { 4,  8,  3,  4, 3, 3, 0, 2},
+    {40, 49,  1,  8, 10, 8, 1, 2},
+    { 8,  8,  5, 16, 6, 6, 0, 2},
+    { 6,  6, 300, 4, 3, 3, 1, 1},
+};
+
+static const uint16_t depthwise_conv_s16_test_cases[][8] = {
+    {10, 10, 16, 1, 3, 3, 1, 1},
+    {10, 10, 15, 1, 3, 3, 0, 1},
+    {18, 18, 16, 1, 3, 3, 1, 2},
+    {10, 10,  8, 4, 5, 5, 1, 1},
+    {10, 10,  3, 3, 3, 3, 0, 2},
+    {25, 20, 64, 1, 3, 3, 1, 1},
+    {20, 20,  2, 1, 17, 17, 0, 1},
+};
+
+#define CONV_S16_TEST_COUNT \
+    (int) (sizeof(conv_s16_test_cases) / sizeof(conv_s16_test_cases[0]))
+#define DEPTHWISE_CONV_S16_TEST_COUNT \
+    (int) (sizeof(depthwise_conv_s16_test_cases) / sizeof(depthwise_conv_s16_test_cases[0]))
+
+static void esp_nn_conv_s16_test_common(bool depthwise)
+{
+    uint32_t total_c = 0, total_opt = 0;
+    const int32_t activation_min = -32768 + 100;
+    const int32_t activation_max = 32767 - 100;
+    const int test_count = depthwise ? DEPTHWISE_CONV_S16_TEST_COUNT : CONV_S16_TEST_COUNT;
+
+    for (int itr = 0; itr < test_count; itr++) {
+        const uint16_t *tc = depthwise ? depthwise_conv_s16_test_cases[itr] : conv_s16_test_cases[itr];
+        const uint16_t in_wd = tc[0], in_ht = tc[1], in_channels = tc[2];
+        const uint16_t filter_wd = tc[4], filter_ht = tc[5];
+        const uint16_t pad = tc[6], stride = tc[7];
+        const uint16_t ch_mult = depthwise ? tc[3] : 1;
+        const uint16_t out_channels = depthwise ? in_channels * ch_mult : tc[3];
+        uint16_t out_wd, out_ht;
+
+        if (pad) {
+            out_wd = (in_wd + stride - 1) / stride;
+            out_ht = (in_ht + stride - 1) / stride;
+        } else {
+            out_wd = (in_wd + stride - filter_wd) / stride;
+            out_ht = (in_ht + stride - filter_ht) / stride;
+        }
+        const uint16_t pad_wd = pad ? max(0, ((out_wd - 1) * stride + filter_wd - in_wd) / 2) : 0;
+        const uint16_t pad_ht = pad ? max(0, ((out_ht - 1) * stride + filter_ht - in_ht) / 2) : 0;
+
+        const int in_size = in_wd * in_ht * in_channels;
+        const int filter_size = filter_wd * filter_ht * (depthwise ? out_channels : in_channels * out_channels);
+        const int out_size = out_wd * out_ht * out_channels;
+
+        int16_t *input = ESP_NN_TEST_ALLOC(in_size * sizeof(int16_t));
+        int16_t *out_data_c = ESP_NN_TEST_ALLOC(out_size * sizeof(int16_t));
+        int16_t *out_data_opt = ESP_NN_TEST_ALLOC(out_size * sizeof(int16_t));
+        int8_t *filter_data = ESP_NN_TEST_ALLOC(filter_size);
+        int64_t *bias = ESP_NN_TEST_ALLOC(out_channels * sizeof(int64_t));
+        int32_t *out_shift = ESP_NN_TEST_ALLOC(out_channels * sizeof(int32_t));
+        int32_t *out_mult = ESP_NN_TEST_ALLOC(out_channels * sizeof(int32_t));
+
+        if (input == NULL || out_data_c == NULL || out_data_opt == NULL || filter_data == NULL ||
+                bias == NULL || out_shift == NULL || out_mult == NULL) {
+            printf(ANSI_COLOR_RED"%s allocations failed\n"ANSI_COLOR_RESET, __FUNCTION__);
+            goto conv_s16_cleanup;
+        }
+
+        /* full 16 bit range, including both extremes */
+        for (int i = 0; i < in_size; ++i) {
+            input[i] = (int16_t) (rand() % 65536 - 32768);
+        }
+        input[0] = INT16_MIN;
+        input[in_size - 1] = INT16_MAX;
+        for (int i = 0; i < filter_size; ++i) {
+            filter_data[i] = rand() % 255 - 127;
+        }
+        for (int i = 0; i < out_channels; ++i) {
+            bias[i] = (int64_t) (rand() % (1 << 24)) - (1 << 23);
+            out_shift[i] = -14 + rand() % 4;
+            out_mult[i] = 0x40000000 + rand() % 0x3fffffff;
+        }
+
+        data_dims_t input_dims = {.width = in_wd, .height = in_ht, .channels = in_channels, 1};
+        data_dims_t output_dims = {.width = out_wd, .height = out_ht, .channels = out_channels, 1};
+        data_dims_t filter_dims = {.width = filter_wd, .height = filter_ht, 0, 0};
+        quant_data_t quant_data = {.shift = out_shift, .mult = out_mult};
+
+        if (depthwise) {
+            dw_conv_params_t conv_params = {.in_offset = 0, .out_offset = 0, .ch_mult = ch_mult,
+                                            .stride = {stride, stride}, .padding = {pad_wd, pad_ht},
+                                            .dilation = {0, 0}, .activation = {activation_min, activation_max}};
+            profile_c_start();
+            esp_nn_depthwise_conv_s16_ansi(&input_dims, input, &filter_dims, filter_data, bias,
+                                           &output_dims, out_data_c, &conv_params, &quant_data);
+            total_c = profile_c_end();
+            profile_opt_start();
+            esp_nn_depthwise_conv_s16(&input_dims, input, &filter_dims, filter_data, bias,
+                                      &output_dims, out_data_opt, &conv_params, &quant_data);
+            total_opt = profile_opt_end();
+        } else {
+            conv_params_t conv_params = {.in_offset = 0, .out_offset = 0,
+                                         .stride = {stride, stride}, .padding = {pad_wd, pad_ht},
+                                         .dilation = {0, 0}, .activation = {activation_min, activation_max}};
+            profile_c_start();
+            esp_nn_conv_s16_ansi(&input_dims, input, &filter_dims, filter_data, bias,
+                                 &output_dims, out_data_c, &conv_params, &quant_data);
+            total_c = profile_c_end();
+            profile_opt_start();
+            esp_nn_conv_s16(&input_dims, input, &filter_dims, filter_data, bias,
+                            &output_dims, out_data_opt, &conv_params, &quant_data);
+            total_opt = profile_opt_end();
+        }
+
+        bool ret = CHECK_EQUAL(out_data_c, out_data_opt, out_size);
+        if (ret == false) {
+            printf(ANSI_COLOR_RED"[%3d] failed [pad: (%d, %d), stride: %d"
+                   " out: (%3d,%3d,%3d), filter: (%d, %d,%3d)]\n"ANSI_COLOR_RESET,
+                   itr, pad_wd, pad_ht, stride, out_wd, out_ht,
+                   out_channels, filter_wd, filter_ht, in_channels);
+            goto conv_s16_cleanup;
+        }
+        printf(ANSI_COLOR_GREEN"[%3d] passed [pad: (%d, %d), stride: %d"
+               " out: (%3d,%3d,%3d), filter: (%d, %d,%3d)]"ANSI_COLOR_RESET,
+               itr, pad_wd, pad_ht, stride, out_wd, out_ht,
+               out_channels, filter_wd, filter_ht, in_channels);
+        printf("\tcycles: c %8"PRIu32", opt %8"PRIu32"\n", total_c, total_opt);
+
+    conv_s16_cleanup:
+        free(input);
+        free(out_data_c);
+        free(out_data_opt);
+        free(filter_data);
+        free(bias);
+        free(out_shift);
+        free(out_mult);
+    }
+}
+
+void esp_nn_conv_s16_test()
+{
+    printf("\n######## Running %s ##########\n", __FUNCTION__);
+    esp_nn_conv_s16_test_common(false);
+}
+
+void esp_nn_depthwise_conv_s16_test()
+{
+    printf("\n######## Running %s ##########\n", __FUNCTION__);
+    esp_nn_conv_s16_test_common(true);
+}
+
+/* float32 tests run the same shapes as the 16x8 ones */
+static void esp_nn_conv_f32_test_common(bool depthwise)
+{
+    uint32_t total_c = 0, total_opt = 0;
+    const float activation_min = -6.0f;
+    const float activation_max = 6.0f;
+    const int test_count = depthwise ? DEPTHWISE_CONV_S16_TEST_COUNT : CONV_S16_TEST_COUNT;
+
+    for (int itr = 0; itr < test_count; itr++) {
+        const uint16_t *tc = depthwise ? depthwise_conv_s16_test_cases[itr] : conv_s16_test_cases[itr];
+        const uint16_t in_wd = tc[0], in_ht = tc[1], in_channels = tc[2];
+        const uint16_t filter_wd = tc[4], filter_ht = tc[5];
+        const uint16_t pad = tc[6], stride = tc[7];
+        const uint16_t ch_mult = depthwise ? tc[3] : 1;
+        const uint16_t out_channels = depthwise ? in_channels * ch_mult : tc[3];
+        uint16_t out_wd, out_ht;
+
+        if (pad) {
+            out_wd = (in_wd + stride - 1) / stride;
+            out_ht = (in_ht + stride - 1) / stride;
+        } else {
+            out_wd = (in_wd + stride - filter_wd) / stride;
+            out_ht = (in_ht + stride - filter_ht) / stride;
+        }
+        const uint16_t pad_wd = pad ? max(0, ((out_wd - 1) * stride + filter_wd - in_wd) / 2) : 0;
+        const uint16_t pad_ht = pad ? max(0, ((out_ht - 1) * stride + filter_ht - in_ht) / 2) : 0;
+
+        const int in_size = in_wd * in_ht * in_channels;
+        const int filter_size = filter_wd * filter_ht * (depthwise ? out_channels : in_channels * out_channels);
+        const int out_size = out_wd * out_ht * out_channels;
+
+        float *input = ESP_NN_TEST_ALLOC(in_size * sizeof(float));
+        float *out_data_c = ESP_NN_TEST_ALLOC(out_size * sizeof(float));
+        float *out_data_opt = ESP_NN_TEST_ALLOC(out_size * sizeof(float));
+        float *filter_data = ESP_NN_TEST_ALLOC(filter_size * sizeof(float));
+        float *bias = ESP_NN_TEST_ALLOC(out_channels * sizeof(float));
+
+        if (input == NULL || out_data_c == NULL || out_data_opt == NULL || filter_data == NULL ||
+                bias == NULL) {
+            printf(ANSI_COLOR_RED"%s allocations failed\n"ANSI_COLOR_RESET, __FUNCTION__);
+            goto conv_f32_cleanup;
+        }
+
+        for (int i = 0; i < in_size; ++i) {
+            input[i] = (rand() % 2001 - 1000) / 1000.0f;
+        }
+        for (int i = 0; i < filter_size; ++i) {
+            filter_data[i] = (rand() % 2001 - 1000) / 4000.0f;
+        }
+        for (int i = 0; i < out_channels; ++i) {
+            bias[i] = (rand() % 2001 - 1000) / 1000.0f;
+        }
+
+        data_dims_t input_dims = {.width = in_wd, .height = in_ht, .channels = in_channels, 1};
+        data_dims_t output_dims = {.width = out_wd, .height = out_ht, .channels = out_channels, 1};
+        data_dims_t filter_dims = {.width = filter_wd, .height = filter_ht, 0, 0};
+
+        if (depthwise) {
+            dw_conv_params_f32_t conv_params = {.ch_mult = ch_mult,
+                                                .stride = {stride, stride}, .padding = {pad_wd, pad_ht},
+                                                .dilation = {0, 0}, .activation = {activation_min, activation_max}};
+            profile_c_start();
+            esp_nn_depthwise_conv_f32_ansi(&input_dims, input, &filter_dims, filter_data, bias,
+                                           &output_dims, out_data_c, &conv_params);
+            total_c = profile_c_end();
+            profile_opt_start();
+            esp_nn_depthwise_conv_f32(&input_dims, input, &filter_dims, filter_data, bias,
+                                      &output_dims, out_data_opt, &conv_params);
+            total_opt = profile_opt_end();
+        } else {
+            conv_params_f32_t conv_params = {.stride = {stride, stride}, .padding = {pad_wd, pad_ht},
+                                             .dilation = {0, 0}, .activation = {activation_min, activation_max}};
+            profile_c_start();
+            esp_nn_conv_f32_ansi(&input_dims, input, &filter_dims, filter_data, bias,
+                                 &output_dims, out_data_c, &conv_params);
+            total_c = profile_c_end();
+            profile_opt_start();
+            esp_nn_conv_f32(&input_dims, input, &filter_dims, filter_data, bias,
+                            &output_dims, out_data_opt, &conv_params);
+            total_opt = profile_opt_end();
+        }
+
+        bool ret = CHECK_NEAR(out_data_c, out_data_opt, out_size, 1e-5f);
+        if (ret == false) {
+            printf(ANSI_COLOR_RED"[%3d] failed [pad: (%d, %d), stride: %d"
+                   " out: (%3d,%3d,%3d), filter: (%d, %d,%3d)]\n"ANSI_COLOR_RESET,
+                   itr, pad_wd, pad_ht, stride, out_wd, out_ht,
+                   out_channels, filter_wd, filter_ht, in_channels);
+            goto conv_f32_cleanup;
+        }
+        printf(ANSI_COLOR_GREEN"[%3d] passed [pad: (%d, %d), stride: %d"
+               " out: (%3d,%3d,%3d), filter: (%d, %d,%3d)]"ANSI_COLOR_RESET,
+               itr, pad_wd, pad_ht, stride, out_wd, out_ht,
+               out_channels, filter_wd, filter_ht, in_channels);
+        printf("\tcycles: c %8"PRIu32", opt %8"PRIu32"\n", total_c, total_opt);
+
+    conv_f32_cleanup:
+        free(input);
+        free(out_data_c);
+        free(out_data_opt);
+        free(filter_data);
+        free(bias);
+    }
+}
+
+void esp_nn_conv_f32_test()
+{
+    printf("\n######## Running %s ##########\n", __FUNCTION__);
+    esp_nn_conv_f32_test_common(false);
+}
+
+void esp_nn_depthwise_conv_f32_test()
+{
+    printf("\n######## Running %s ##########\n", __FUNCTION__);
+    esp_nn_conv_f32_test_common(true);
+}
+
+/* in_wd, in_ht, in_ch, out_ch, filter_wd, filter_ht, pad (same), stride */
+static const uint16_t transpose_conv_s8_test_cases[][8] = {
+    { 8,  8, 16, 16, 3, 3, 1, 2},
+    { 8,  8, 16, 16, 3, 3, 0, 2},
+    { 5,  5,  3,  8, 4, 4, 1, 2},
+    { 6,  4,  8,  3, 2, 2, 0, 2},
+    { 7,  7, 12,  7, 3, 3, 1, 1},
+    { 4,  4, 33,  5, 5, 5, 1, 3},
+    {10,  1, 16, 32, 1, 1, 0, 1},
+    { 2,  2,  1,  1, 3, 3, 0, 1},
+};
+
+#define TRANSPOSE_CONV_S8_TEST_COUNT \
+    (int) (sizeof(transpose_conv_s8_test_cases) / sizeof(transpose_conv_s8_test_cases[0]))
+
+void esp_nn_transpose_conv_s8_test()
+{
+    uint32_t total_c = 0, total_opt = 0;
+    const int32_t input_offset = 7; /* some number in [-128, 127] */
+    const int32_t activation_min = -125;
+    const int32_t activation_max = 122;
+    const int32_t out_offset = -3;
+
+    printf("\n######## Running %s ##########\n", __FUNCTION__);
+    for (int itr = 0; itr < TRANSPOSE_CONV_S8_TEST_COUNT; itr++) {
+        const uint16_t *tc = transpose_conv_s8_test_cases[itr];
+        const uint16_t in_wd = tc[0], in_ht = tc[1], in_channels = tc[2];
+        const uint16_t out_channels = tc[3];
+        const uint16_t filter_wd = tc[4], filter_ht = tc[5];
+        const uint16_t pad = tc[6], stride = tc[7];
+        uint16_t out_wd, out_ht;
+
+        if (pad) {
+            out_wd = in_wd * stride;
+            out_ht = in_ht * stride;
+        } else {
+            out_wd = (in_wd - 1) * stride + filter_wd;
+            out_ht = (in_ht - 1) * stride + filter_ht;
+        }
+        const uint16_t pad_wd = pad ? max(0, ((in_wd - 1) * stride + filter_wd - out_wd) / 2) : 0;
+        const uint16_t pad_ht = pad ? max(0, ((in_ht - 1) * stride + filter_ht - out_ht) / 2) : 0;
+
+        const int in_size = in_wd * in_ht * in_channels;
+        const int filter_size = filter_wd * filter_ht * in_channels * out_channels;
+        const int out_size = out_wd * out_ht * out_channels;
+
+        data_dims_t input_dims = {.width = in_wd, .height = in_ht, .channels = in_channels, 1};
+        data_dims_t output_dims = {.width = out_wd, .height = out_ht, .channels = out_channels, 1};
+        data_dims_t filter_dims = {.width = filter_wd, .height = filter_ht, 0, 0};
+        conv_params_t conv_params = {.in_offset = input_offset, .out_offset = out_offset,
+                                     .stride = {stride, stride}, .padding = {pad_wd, pad_ht},
+                                     .dilation = {0, 0}, .activation = {activation_min, activation_max}};
+
+        const int scratch_c_size = esp_nn_get_transpose_conv_scratch_size_ansi(&input_dims, &filter_dims,
+                                                                               &output_dims, &conv_params);
+        const int scratch_opt_size = esp_nn_get_transpose_conv_scratch_size(&input_dims, &filter_dims,
+                                                                            &output_dims, &conv_params);
+
+        int8_t *input = ESP_NN_TEST_ALLOC(in_size);
+        int8_t *out_data_c = ESP_NN_TEST_ALLOC(out_size);
+        int8_t *out_data_opt = ESP_NN_TEST_ALLOC(out_size);
+        int8_t *filter_data = ESP_NN_TEST_ALLOC(filter_size);
+        int32_t *bias = ESP_NN_TEST_ALLOC(out_channels * sizeof(int32_t));
+        int32_t *out_shift = ESP_NN_TEST_ALLOC(out_channels * sizeof(int32_t));
+        int32_t *out_mult = ESP_NN_TEST_ALLOC(out_channels * sizeof(int32_t));
+        int32_t *scratch_c = ESP_NN_TEST_ALLOC(scratch_c_size);
+        int32_t *scratch_opt = ESP_NN_TEST_ALLOC(scratch_opt_size);
+
+        if (input == NULL || out_data_c == NULL || out_data_opt == NULL || filter_data == NULL ||
+                bias == NULL || out_shift == NULL || out_mult == NULL ||
+                scratch_c == NULL || scratch_opt == NULL) {
+            printf(ANSI_COLOR_RED"%s allocations failed\n"ANSI_COLOR_RESET, __FUNCTION__);
+            goto transpose_conv_s8_cleanup;
+        }
+
+        for (int i = 0; i < in_size; ++i) {
+            input[i] = rand() % 256 - 128;
+        }
+        for (int i = 0; i < filter_size; ++i) {
+            filter_data[i] = rand() % 255 - 127;
+        }
+        for (int i = 0; i < out_channels; ++i) {
+            bias[i] = (int32_t) (rand() % UINT16_MAX) + UINT8_MAX;
+            out_shift[i] = -15 + rand() % 3;
+            out_mult[i] = 0x7eb0e200 + rand() % 50;
+        }
+        quant_data_t quant_data = {.shift = out_shift, .mult = out_mult};
+
+        profile_c_start();
+        esp_nn_set_transpose_conv_scratch_buf_ansi(scratch_c);
+        esp_nn_transpose_conv_s8_ansi(&input_dims, input, &filter_dims, filter_data, itr % 2 ? bias : NULL,
+                                      &output_dims, out_data_c, &conv_params, &quant_data);
+        total_c = profile_c_end();
+
+        profile_opt_start();
+        esp_nn_set_transpose_conv_scratch_buf(scratch_opt);
+        esp_nn_transpose_conv_s8(&input_dims, input, &filter_dims, filter_data, itr % 2 ? bias : NULL,
+                                 &output_dims, out_data_opt, &conv_params, &quant_data);
+        total_opt = profile_opt_end();
+
+        bool ret = CHECK_EQUAL(out_data_c, out_data_opt, out_size);
+        if (ret == false) {
+            printf(ANSI_COLOR_RED"[%3d] failed [pad: (%d, %d), stride: %d"
+                   " out: (%3d,%3d,%3d), filter: (%d, %d,%3d)]\n"ANSI_COLOR_RESET,
+                   itr, pad_wd, pad_ht, stride, out_wd, out_ht,
+                   out_channels, filter_wd, filter_ht, in_channels);
+            goto transpose_conv_s8_cleanup;
+        }
+        printf(ANSI_COLOR_GREEN"[%3d] passed [pad: (%d, %d), stride: %d"
+               " out: (%3d,%3d,%3d), filter: (%d, %d,%3d)]"ANSI_COLOR_RESET,
+               itr, pad_wd, pad_ht, stride, out_wd, out_ht,
+               out_channels, filter_wd, filter_ht, in_channels);
+        printf("\tcycles: c %8"PRIu32", opt %8"PRIu32"\n", total_c, total_opt);
+
+    transpose_conv_s8_cleanup:
+        free(input);
+        free(out_data_c);
+        free(out_data_opt);
+        free(filter_data);
+        free(bias);
+        free(out_shift);
+        free(out_mult);
+        free(scratch_c);
+        free(scratch_opt);
+    }
+}
@@ -0,0 +1,756 @@
+/*
+ * SPDX-FileCopyrightText: 2020-2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
+
+#include <esp_nn.h>
+#include "test_utils.h"
+
+
+void esp_nn_fully_connected_s8_test()
+{
+    uint32_t total_c = 0, total_opt = 0;
+    /* prepare data */
+    uint16_t row_len = 256 + 8 + 7; /* odd len to test unaligned+left-over */
+    uint16_t out_channels = 3;
+    int8_t input[row_len];
+    int8_t filter_data[row_len * out_channels];
+    int8_t output_c[out_channels], output_opt[out_channels];
+    int32_t activation_min = -128;
+    int32_t activation_max = 127;
+    int32_t input_offset = 0;
+    int32_t filter_offset = 0;
+    int32_t out_shift = -10;
+    int32_t out_offset = 5;
+    int32_t out_mult = 0x59e492c4;
+    printf("\n######## Running %s ##########\n", __FUNCTION__);
+    for (int itr = 0; itr < 15; itr++) {
+        out_mult = INT32_MAX / row_len + rand() % INT16_MAX;
+        switch (itr) {
+        case 0:
+            out_shift = -10;
+            break;
+        case 1:
+            out_shift = SHIFT_MIN;
+            break;
+        case 2:
+            out_shift = SHIFT_MAX;
+            break;
+        case 3:
+            out_shift = 0;
+            break;
+        case 4:
+            row_len = 1;
+            out_channels = 16;
+            out_shift = -10 + rand() % 5;
+            break;
+        case 5:
+            row_len = 16;
+            out_channels = 8;
+            out_shift = -10 + rand() % 5;
+            break;
+        case 6:
+            row_len = 8;
+            out_channels = 8;
+            out_shift = -10 + rand() % 5;
+            break;
+        case 7:
+            row_len = 8;
+            out_channels = 15;
+            out_shift = -10 + rand() % 5;
+            break;
+        case 8:
+            row_len = 8;
+            out_channels = 1;
+            out_shift = -10 + rand() % 5;
+            break;
+        default:
+            row_len = rand() % 7 + 1;
+            out_channels = 8;
+            out_shift = -10 + rand() % 5;
+            break;
+        }
+        if (itr == 0) {
+            out_shift = SHIFT_MAX;
+        }
+        /* Generate input and filter data */
+        for (int i = 0; i < row_len; ++i) {
+            input[i] = rand() % 256 - 128;
+        }
+        for (int i = 0; i < row_len * out_channels; ++i) {
+            filter_data[i] = rand() % 256 - 128;
+        }
+
+        /* enable profiler */
+        profile_c_start();
+
+        /* C function */
+        esp_nn_fully_connected_s8_ansi(input, input_offset, row_len, filter_data, filter_offset,
+                                    NULL, output_c, out_channels, out_offset, out_shift, out_mult,
+                                    activation_min, activation_max);
+
+        total_c = profile_c_end();
+        profile_opt_start();
+
+        /* Optimized function */
+        esp_nn_fully_connected_s8(input, input_offset, row_len, filter_data, filter_offset,
+                                NULL, output_opt, out_channels, out_offset, out_shift, out_mult,
+                                activation_min, activation_max);
+
+        /* disable profiler */
+        total_opt = profile_opt_end();
+
+        bool ret = CHECK_EQUAL(output_c, output_opt, out_channels);
+        if (ret == false) {
+            printf(ANSI_COLOR_RED"[%3d] failed\n"ANSI_COLOR_RESET, itr);
+#if 0
+            printf("Output: \n");
+            PRINT_ARRAY_HEX(output_opt, out_channels, 1);
+            printf("Expected: \n");
+            PRINT_ARRAY_HEX(output_c, out_channels, 1);
+            printf("Input:\n");
+            PRINT_ARRAY_HEX(input, row_len, 1);
+            printf("Filter data:\n");
+            PRINT_ARRAY_HEX(filter_data, row_len, out_channels);
+            printf("Out shift: %d\n", out_shift);
+            printf("Out mult: %x\n", out_mult);
+#endif
+            return;
+        }
+        printf(ANSI_COLOR_GREEN"[%3d] passed [row_len %"PRIu16", out_ch %"PRIu16"]"ANSI_COLOR_RESET,
+               itr, row_len, out_channels);
+        printf("\tcycles: c %8"PRIu32", opt %8"PRIu32"\n", total_c, total_opt);
+    }
+}
+
+void esp_nn_fully_connected_per_ch_s8_test()
+{
+    uint32_t total_c = 0, total_opt = 0;
+    /* prepare data */
+    uint16_t row_len = 256 + 8 + 7; /* odd len to test unaligned+left-over */
+    const int32_t max_out_ch = 16;
+    uint16_t out_channels = 3;
+    int8_t input[row_len];
+    int8_t filter_data[row_len * max_out_ch];
+    int8_t output_c[max_out_ch], output_opt[max_out_ch];
+    int32_t activation_min = -128;
+    int32_t activation_max = 127;
+    int32_t input_offset = 0;
+    int32_t filter_offset = 0;
+    int32_t out_offset = 7;
+
+    int32_t* out_mult = NULL;
+    int32_t* out_shift = NULL;
+
+    printf("\n######## Running %s ##########\n", __FUNCTION__);
+    for (int itr = 0;  itr < 15; itr++) {
+        int32_t out_shift_val = 0;
+        switch (itr) {
+        case 0:
+            out_shift_val = -10;
+            break;
+        case 1:
+            out_shift_val = SHIFT_MIN;
+            break;
+        case 2:
+            out_shift_val = SHIFT_MAX;
+            break;
+        case 3:
+            out_shift_val = 0;
+            break;
+        case 4:
+            row_len = 1;
+            out_channels = 16;
+            break;
+        case 5:
+            row_len = 16;
+            out_channels = 8;
+            break;
+        case 6:
+            row_len = 8;
+            out_channels = 8;
+            break;
+        case 7:
+            row_len = 8;
+            out_channels = 15;
+            break;
+        case 8:
+            row_len = 8;
+            out_channels = 1;
+            break;
+        default:
+            row_len = rand() % 7 + 1;
+            out_channels = 8;
+            break;
+        }
+
+        out_mult = ESP_NN_TEST_ALLOC(out_channels * sizeof(int32_t));
+        out_shift = ESP_NN_TEST_ALLOC(out_channels * sizeof(int32_t));
+
+        if (out_shift == NULL || out_mult == NULL) {
+            printf(ANSI_COLOR_RED"out_shift/out_mult allocations failed\n"ANSI_COLOR_RESET);
+            goto fully_connected_per_ch_cleanup;
+        }
+
+        for (int i = 0; i < out_channels; i++) {
+            out_mult[i] = INT32_MAX / row_len + rand() % INT16_MAX;
+            if (i < 4) {
+                out_shift[i] = out_shift_val;
+            } else {
+                out_shift[i] = -10 + rand() % 5;
+            }
+        }
+
+        /* Generate input and filter data */
+        for (int i = 0; i < row_len; ++i) {
+            input[i] = rand() % 256 - 128;
+        }
+        for (int i = 0; i < row_len * out_channels; ++i) {
+            filter_data[i] = rand() % 256 - 128;
+        }
+        
+        /* enable profiler */
+        profile_c_start();
+
+        /* C function */
+        esp_nn_fully_connected_per_ch_s8_ansi(input, input_offset, row_len, filter_data, filter_offset,
+                                    NULL, output_c, out_channels, out_offset, out_shift, out_mult,
+                                    activation_min, activation_max);
+
+        total_c = profile_c_end();
+        profile_opt_start();
+
+        /* Optimized function */
+        esp_nn_fully_connected_per_ch_s8(input, input_offset, row_len, filter_data, filter_offset,
+                                NULL, output_opt, out_channels, out_offset, out_shift, out_mult,
+                                activation_min, activation_max);
+
+        /* disable profiler */
+        total_opt = profile_opt_end();
+
+        bool ret = CHECK_EQUAL(output_c, output_opt, out_channels);
+        if (ret == false) {
+            printf(ANSI_COLOR_RED"[%3d] failed\n"ANSI_COLOR_RESET, itr);
+#if 0
+            printf("Output: \n");
+            PRINT_ARRAY_HEX(output_opt, out_channels, 1);
+            printf("Expected: \n");
+            PRINT_ARRAY_HEX(output_c, out_channels, 1);
+            printf("Input:\n");
+            PRINT_ARRAY_HEX(input, row_len, 1);
+            printf("Filter data:\n");
+            PRINT_ARRAY_HEX(filter_data, row_len, out_channels);
+
+            printf("Out shift: ");
+            for (int i = 0; i < out_channels; i++) {
+                printf("%d, ", out_shift[i]);
+            }
+
+            printf("\nOut mult: ");
+            for (int i = 0; i < out_channels; i++) {
+                printf("%d, ", out_mult[i]);
+            }
+            printf("\n");
+#endif
+            goto fully_connected_per_ch_cleanup;
+        }
+        printf(ANSI_COLOR_GREEN"[%3d] passed [row_len %"PRIu16", out_ch %"PRIu16"]"ANSI_COLOR_RESET,
+               itr, row_len, out_channels);
+        printf("\tcycles: c %8"PRIu32", opt %8"PRIu32"\n", total_c, total_opt);
+    
+    fully_connected_per_ch_cleanup:
+        if (out_shift) {
+            free(out_shift);
+        }
+        if (out_mult) {
+            free(out_mult);
+        }
+    }
+}
+
+void esp_nn_fully_connected_s16_test()
+{
+    uint32_t total_c = 0, total_opt = 0;
+    /* prepare data */
+    uint16_t row_len = 256 + 8 + 7; /* odd len to test unaligned+left-over */
+    const uint16_t max_row_len = 640;
+    uint16_t out_channels = 3;
+    const int32_t max_out_ch = 16;
+    int16_t input[max_row_len];
+    int8_t filter_data[max_row_len * max_out_ch];
+    int64_t bias[max_out_ch];
+    int16_t output_c[max_out_ch], output_opt[max_out_ch];
+    int32_t activation_min = INT16_MIN;
+    int32_t activation_max = INT16_MAX;
+    int32_t out_shift = -10;
+    int32_t out_mult = 0x59e492c4;
+    printf("\n######## Running %s ##########\n", __FUNCTION__);
+    for (int itr = 0; itr < 12; itr++) {
+        out_mult = INT32_MAX / 2 + rand() % INT16_MAX;
+        switch (itr) {
+        case 0:
+            out_shift = -10;
+            break;
+        case 1:
+            out_shift = -20;
+            break;
+        case 2: /* more than one 32 bit accumulation block */
+            row_len = max_row_len;
+            out_channels = 16;
+            out_shift = -20;
+            break;
+        case 3:
+            row_len = 1;
+            out_channels = 16;
+            out_shift = 0;
+            break;
+        case 4:
+            row_len = 16;
+            out_channels = 8;
+            out_shift = -10 + rand() % 5;
+            break;
+        case 5:
+            row_len = 8;
+            out_channels = 15;
+            out_shift = -10 + rand() % 5;
+            break;
+        default:
+            row_len = rand() % 7 + 1;
+            out_channels = 8;
+            out_shift = -10 + rand() % 5;
+            break;
+        }
+        /* Generate input, filter and bias data */
+        for (int i = 0; i < row_len; ++i) {
+            input[i] = rand() % 65536 - 32768;
+        }
+        for (int i = 0; i < row_len * out_channels; ++i) {
+            filter_data[i] = rand() % 255 - 127;
+        }
+        for (int i = 0; i < out_channels; ++i) {
+            bias[i] = (int64_t) (rand() % (1 << 24)) - (1 << 23);
+        }
+
+        /* enable profiler */
+        profile_c_start();
+
+        /* C function */
+        esp_nn_fully_connected_s16_ansi(input, row_len, filter_data, itr % 2 ? bias : NULL,
+                                        output_c, out_channels, out_shift, out_mult,
+                                        activation_min, activation_max);
+
+        total_c = profile_c_end();
+        profile_opt_start();
+
+        /* Optimized function */
+        esp_nn_fully_connected_s16(input, row_len, filter_data, itr % 2 ? bias : NULL,
+                                   output_opt, out_channels, out_shift, out_mult,
+                                   activation_min, activation_max);
+
+        /* disable profiler */
+        total_opt = profile_opt_end();
+
+        bool ret = CHECK_EQUAL(output_c, output_opt, out_channels);
+        if (ret == false) {
+            printf(ANSI_COLOR_RED"[%3d] failed\n"ANSI_COLOR_RESET, itr);
+            return;
+        }
+        printf(ANSI_COLOR_GREEN"[%3d] passed [row_len %"PRIu16", out_ch %"PRIu16"]"ANSI_COLOR_RESET,
+               itr, row_len, out_channels);
+        printf("\tcycles: c %8"PRIu32", opt %8"PRIu32"\n", total_c, total_opt);
+    }
+}
+
+void esp_nn_fully_connected_f32_test()
+{
+    uint32_t total_c = 0, total_opt = 0;
+    /* prepare data */
+    uint16_t row_len = 256 + 8 + 7; /* odd len to test unaligned+left-over */
+    const uint16_t max_row_len = 640;
+    uint16_t out_channels = 3;
+    const int32_t max_out_ch = 16;
+    const float activation_min = -6.0f;
+    const float activation_max = 6.0f;
+    float *input = ESP_NN_TEST_ALLOC(max_row_len * sizeof(float));
+    float *filter_data = ESP_NN_TEST_ALLOC(max_row_len * max_out_ch * sizeof(float));
+    float bias[max_out_ch];
+    float output_c[max_out_ch], output_opt[max_out_ch];
+    printf("\n######## Running %s ##########\n", __FUNCTION__);
+    if (input == NULL || filter_data == NULL) {
+        printf(ANSI_COLOR_RED"%s allocations failed\n"ANSI_COLOR_RESET, __FUNCTION__);
+        goto fc_f32_cleanup;
+    }
+    for (int itr = 0; itr < 10; itr++) {
+        switch (itr) {
+        case 0:
+            break;
+        case 1:
+            row_len = max_row_len;
+            out_channels = 16;
+            break;
+        case 2:
+            row_len = 1;
+            out_channels = 16;
+            break;
+        case 3:
+            row_len = 16;
+            out_channels = 8;
+            break;
+        case 4:
+            row_len = 8;
+            out_channels = 15;
+            break;
+        default:
+            row_len = rand() % 7 + 1;
+            out_channels = rand() % max_out_ch + 1;
+            break;
+        }
+        /* Generate input, filter and bias data */
+        for (int i = 0; i < row_len; ++i) {
+            input[i] = (rand() % 2001 - 1000) / 1000.0f;
+        }
+        for (int i = 0; i < row_len * out_channels; ++i) {
+            filter_data[i] = (rand() % 2001 - 1000) / 4000.0f;
+        }
+        for (int i = 0; i < out_channels; ++i) {
+            bias[i] = (rand() % 2001 - 1000) / 1000.0f;
+        }
+
+        /* enable profiler */
+        profile_c_start();
+
+        /* C function */
+        esp_nn_fully_connected_f32_ansi(input, row_len, filter_data, itr % 2 ? bias : NULL,
+                                        output_c, out_channels, activation_min, activation_max);
+
+        total_c = profile_c_end();
+        profile_opt_start();
+
+        /* Optimized function */
+        esp_nn_fully_connected_f32(input, row_len, filter_data, itr % 2 ? bias : NULL,
+                                   output_opt, out_channels, activation_min, activation_max);
+
+        /* disable profiler */
+        total_opt = profile_opt_end();
+
+        bool ret = CHECK_NEAR(output_c, output_opt, out_channels, 1e-5f);
+        if (ret == false) {
+            printf(ANSI_COLOR_RED"[%3d] failed\n"ANSI_COLOR_RESET, itr);
+            goto fc_f32_cleanup;
+        }
+        printf(ANSI_COLOR_GREEN"[%3d] passed [row_len %"PRIu16", out_ch %"PRIu16"]"ANSI_COLOR_RESET,
+               itr, row_len, out_channels);
+        printf("\tcycles: c %8"PRIu32", opt %8"PRIu32"\n", total_c, total_opt);
+    }
+
+fc_f32_cleanup:
+    free(input);
+    free(filter_data);
+}
+
+void esp_nn_batch_matmul_s8_test()
+{
+    uint32_t total_c = 0, total_opt = 0;
+    const int32_t max_rows = 16, max_cols = 24, max_depth = 128;
+    const int32_t activation_min = -128;
+    const int32_t activation_max = 127;
+    int32_t rows = 8, cols = 16, depth = 64;
+    int8_t *lhs = ESP_NN_TEST_ALLOC(max_rows * max_depth);
+    int8_t *rhs = ESP_NN_TEST_ALLOC(max_cols * max_depth);
+    int8_t *output_c = ESP_NN_TEST_ALLOC(max_rows * max_cols);
+    int8_t *output_opt = ESP_NN_TEST_ALLOC(max_rows * max_cols);
+    int32_t *scratch_c = NULL, *scratch_opt = NULL;
+    printf("\n######## Running %s ##########\n", __FUNCTION__);
+    if (lhs == NULL || rhs == NULL || output_c == NULL || output_opt == NULL) {
+        printf(ANSI_COLOR_RED"%s allocations failed\n"ANSI_COLOR_RESET, __FUNCTION__);
+        goto batch_matmul_s8_cleanup;
+    }
+    scratch_c = ESP_NN_TEST_ALLOC(esp_nn_get_batch_matmul_scratch_size_ansi(max_cols, max_depth) + 4);
+    scratch_opt = ESP_NN_TEST_ALLOC(esp_nn_get_batch_matmul_scratch_size(max_cols, max_depth) + 4);
+    if (scratch_c == NULL || scratch_opt == NULL) {
+        printf(ANSI_COLOR_RED"%s scratch allocations failed\n"ANSI_COLOR_RESET, __FUNCTION__);
+        goto batch_matmul_s8_cleanup;
+    }
+    for (int itr = 0; itr < 10; itr++) {
+        int32_t lhs_offset = rand() % 256 - 128;
+        int32_t rhs_offset = rand() % 256 - 128;
+        int32_t out_offset = rand() % 256 - 128;
+        int32_t out_shift = -14 + rand() % 3;
+        int32_t out_mult = INT32_MAX / 2 + rand() % INT16_MAX;
+        switch (itr) {
+        case 0:
+            break;
+        case 1: /* symmetric rhs */
+            rows = max_rows;
+            cols = max_cols;
+            depth = max_depth;
+            rhs_offset = 0;
+            out_shift = -13;
+            break;
+        case 2:
+            rows = 1;
+            cols = 7;
+            depth = 33;
+            break;
+        case 3:
+            rows = 5;
+            cols = 3;
+            depth = 1;
+            out_shift = 0;
+            break;
+        default:
+            rows = rand() % max_rows + 1;
+            cols = rand() % max_cols + 1;
+            depth = rand() % max_depth + 1;
+            break;
+        }
+        for (int i = 0; i < rows * depth; ++i) {
+            lhs[i] = rand() % 256 - 128;
+        }
+        for (int i = 0; i < cols * depth; ++i) {
+            rhs[i] = rand() % 256 - 128;
+        }
+
+        /* enable profiler */
+        profile_c_start();
+
+        /* C function */
+        esp_nn_set_batch_matmul_scratch_buf_ansi(scratch_c);
+        esp_nn_batch_matmul_s8_ansi(lhs, lhs_offset, rhs, rhs_offset, output_c, rows, cols, depth,
+                                    out_offset, out_mult, out_shift, activation_min, activation_max);
+
+        total_c = profile_c_end();
+        profile_opt_start();
+
+        /* Optimized function */
+        esp_nn_set_batch_matmul_scratch_buf(scratch_opt);
+        esp_nn_batch_matmul_s8(lhs, lhs_offset, rhs, rhs_offset, output_opt, rows, cols, depth,
+                               out_offset, out_mult, out_shift, activation_min, activation_max);
+
+        /* disable profiler */
+        total_opt = profile_opt_end();
+
+        bool ret = CHECK_EQUAL(output_c, output_opt, rows * cols);
+        if (ret == false) {
+            printf(ANSI_COLOR_RED"[%3d] failed\n"ANSI_COLOR_RESET, itr);
+            goto batch_matmul_s8_cleanup;
+        }
+        printf(ANSI_COLOR_GREEN"[%3d] passed [rows %"PRIi32", cols %"PRIi32", depth %"PRIi32"]"ANSI_COLOR_RESET,
+               itr, rows, cols, depth);
+        printf("\tcycles: c %8"PRIu32", opt %8"PRIu32"\n", total_c, total_opt);
+    }
+
+batch_matmul_s8_cleanup:
+    free(lhs);
+    free(rhs);
+    free(output_c);
+    free(output_opt);
+    free(scratch_c);
+    free(scratch_opt);
+}
+
+void esp_nn_fully_connected_s8_s16_test()
+{
+    uint32_t total_c = 0, total_opt = 0;
+    /* prepare data */
+    uint16_t row_len = 256 + 8 + 7; /* odd len to test unaligned+left-over */
+    const uint16_t max_row_len = 320;
+    uint16_t out_channels = 3;
+    const int32_t max_out_ch = 16;
+    int8_t input[max_row_len];
+    int8_t filter_data[max_row_len * max_out_ch];
+    int32_t bias[max_out_ch];
+    int16_t output_c[max_out_ch], output_opt[max_out_ch];
+    int32_t activation_min = INT16_MIN;
+    int32_t activation_max = INT16_MAX;
+    int32_t out_shift = -10;
+    int32_t out_mult = 0x59e492c4;
+    printf("\n######## Running %s ##########\n", __FUNCTION__);
+    for (int itr = 0; itr < 12; itr++) {
+        out_mult = INT32_MAX / 2 + rand() % INT16_MAX;
+        switch (itr) {
+        case 0:
+            out_shift = -2;
+            break;
+        case 1: /* saturating */
+            out_shift = 4;
+            break;
+        case 2:
+            row_len = max_row_len;
+            out_channels = 16;
+            out_shift = -4;
+            break;
+        case 3:
+            row_len = 1;
+            out_channels = 16;
+            out_shift = 0;
+            break;
+        case 4:
+            row_len = 16;
+            out_channels = 8;
+            out_shift = -2 + rand() % 5;
+            activation_min = -1024;
+            activation_max = 1023;
+            break;
+        case 5:
+            row_len = 8;
+            out_channels = 15;
+            out_shift = -2 + rand() % 5;
+            activation_min = INT16_MIN;
+            activation_max = INT16_MAX;
+            break;
+        default:
+            row_len = rand() % max_row_len + 1;
+            out_channels = rand() % max_out_ch + 1;
+            out_shift = -4 + rand() % 5;
+            break;
+        }
+        /* Generate input, filter and bias data */
+        for (int i = 0; i < row_len; ++i) {
+            input[i] = rand() % 256 - 128;
+        }
+        for (int i = 0; i < row_len * out_channels; ++i) {
+            filter_data[i] = rand() % 255 - 127;
+        }
+        for (int i = 0; i < out_channels; ++i) {
+            bias[i] = rand() % (1 << 16) - (1 << 15);
+        }
+
+        /* enable profiler */
+        profile_c_start();
+
+        /* C function */
+        esp_nn_fully_connected_s8_s16_ansi(input, row_len, filter_data, itr % 2 ? bias : NULL,
+                                           output_c, out_channels, out_shift, out_mult,
+                                           activation_min, activation_max);
+
+        total_c = profile_c_end();
+        profile_opt_start();
+
+        /* Optimized function */
+        esp_nn_fully_connected_s8_s16(input, row_len, filter_data, itr % 2 ? bias : NULL,
+                                      output_opt, out_channels, out_shift, out_mult,
+                                      activation_min, activation_max);
+
+        /* disable profiler */
+        total_opt = profile_opt_end();
+
+        bool ret = CHECK_EQUAL(output_c, output_opt, out_channels);
+        if (ret == false) {
+            printf(ANSI_COLOR_RED"[%3d] failed\n"ANSI_COLOR_RESET, itr);
+            return;
+        }
+        printf(ANSI_COLOR_GREEN"[%3d] passed [row_len %"PRIu16", out_ch %"PRIu16"]"ANSI_COLOR_RESET,
+               itr, row_len, out_channels);
+        printf("\tcycles: c %8"PRIu32", opt %8"PRIu32"\n", total_c, total_opt);
+    }
+}
+
+void esp_nn_lstm_gates_s8_test()
+{
+    uint32_t total_c = 0, total_opt = 0;
+    const int32_t gates = 4, max_input_len = 80, max_cells = 64;
+    int32_t input_len = 40, cells = 32;
+    int32_t input_mult[4], input_shift[4], recurrent_mult[4], recurrent_shift[4];
+    quant_data_t input_quant = {input_shift, input_mult};
+    quant_data_t recurrent_quant = {recurrent_shift, recurrent_mult};
+    int8_t *input = ESP_NN_TEST_ALLOC(max_input_len);
+    int8_t *hidden = ESP_NN_TEST_ALLOC(max_cells);
+    int8_t *filter_data = ESP_NN_TEST_ALLOC(gates * max_cells * (max_input_len + max_cells));
+    int32_t *input_bias = ESP_NN_TEST_ALLOC(gates * max_cells * sizeof(int32_t));
+    int32_t *recurrent_bias = ESP_NN_TEST_ALLOC(gates * max_cells * sizeof(int32_t));
+    int16_t *output_c = ESP_NN_TEST_ALLOC(gates * max_cells * sizeof(int16_t));
+    int16_t *output_opt = ESP_NN_TEST_ALLOC(gates * max_cells * sizeof(int16_t));
+    printf("\n######## Running %s ##########\n", __FUNCTION__);
+    if (input == NULL || hidden == NULL || filter_data == NULL || input_bias == NULL ||
+            recurrent_bias == NULL || output_c == NULL || output_opt == NULL) {
+        printf(ANSI_COLOR_RED"%s allocations failed\n"ANSI_COLOR_RESET, __FUNCTION__);
+        goto lstm_gates_s8_cleanup;
+    }
+    for (int itr = 0; itr < 10; itr++) {
+        switch (itr) {
+        case 0:
+            break;
+        case 1:
+            input_len = max_input_len;
+            cells = max_cells;
+            break;
+        case 2: /* cells not a multiple of 4 */
+            input_len = 13;
+            cells = 7;
+            break;
+        case 3:
+            input_len = 1;
+            cells = 1;
+            break;
+        default:
+            input_len = rand() % max_input_len + 1;
+            cells = rand() % max_cells + 1;
+            break;
+        }
+        const int32_t row_len = input_len + cells;
+        for (int g = 0; g < gates; g++) {
+            input_mult[g] = INT32_MAX / 2 + rand() % INT16_MAX;
+            recurrent_mult[g] = INT32_MAX / 2 + rand() % INT16_MAX;
+            input_shift[g] = -4 + rand() % 6;
+            recurrent_shift[g] = -4 + rand() % 6;
+        }
+        for (int i = 0; i < input_len; ++i) {
+            input[i] = rand() % 256 - 128;
+        }
+        for (int i = 0; i < cells; ++i) {
+            hidden[i] = rand() % 256 - 128;
+        }
+        for (int i = 0; i < gates * cells * row_len; ++i) {
+            filter_data[i] = rand() % 255 - 127;
+        }
+        for (int i = 0; i < gates * cells; ++i) {
+            input_bias[i] = rand() % (1 << 16) - (1 << 15);
+            recurrent_bias[i] = rand() % (1 << 16) - (1 << 15);
+        }
+
+        /* enable profiler */
+        profile_c_start();
+
+        /* C function */
+        esp_nn_lstm_gates_s8_ansi(input, input_len, hidden, cells, filter_data, input_bias,
+                                  itr % 2 ? recurrent_bias : NULL, output_c, gates, cells,
+                                  &input_quant, &recurrent_quant);
+
+        total_c = profile_c_end();
+        profile_opt_start();
+
+        /* Optimized function */
+        esp_nn_lstm_gates_s8(input, input_len, hidden, cells, filter_data, input_bias,
+                             itr % 2 ? recurrent_bias : NULL, output_opt, gates, cells,
+                             &input_quant, &recurrent_quant);
+
+        /* disable profiler */
+        total_opt = profile_opt_end();
+
+        bool ret = CHECK_EQUAL(output_c, output_opt, gates * cells);
+        if (ret == false) {
+            printf(ANSI_COLOR_RED"[%3d] failed\n"ANSI_COLOR_RESET, itr);
+            goto lstm_gates_s8_cleanup;
+        }
+        printf(ANSI_COLOR_GREEN"[%3d] passed [input_len %"PRIi32", cells %"PRIi32"]"ANSI_COLOR_RESET,
+               itr, input_len, cells);
+        printf("\tcycles: c %8"PRIu32", opt %8"PRIu32"\n", total_c, total_opt);
+    }
+
+lstm_gates_s8_cleanup:
+    free(input);
+    free(hidden);
+    free(filter_data);
+    free(input_bias);
+    free(recurrent_bias);
+    free(output_c);
+    free(output_opt);
+}
@@ -0,0 +1,182 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
+
+#include <esp_nn.h>
+#include "test_utils.h"
+
+void esp_nn_reduce_sum_s8_test()
+{
+    uint32_t total_c = 0, total_opt = 0;
+    const int32_t max_outer = 4, max_reduce = 196, max_inner = 96;
+    const int32_t activation_min = -128;
+    const int32_t activation_max = 127;
+    /* global average pool of a squeeze-excite block: 14x14x96 -> 96 */
+    int32_t outer_size = 1, reduce_size = 196, inner_size = 96;
+    int8_t *input = ESP_NN_TEST_ALLOC(max_outer * max_reduce * max_inner);
+    int8_t *output_c = ESP_NN_TEST_ALLOC(max_outer * max_inner);
+    int8_t *output_opt = ESP_NN_TEST_ALLOC(max_outer * max_inner);
+    int32_t *scratch_c = NULL, *scratch_opt = NULL;
+    printf("\n######## Running %s ##########\n", __FUNCTION__);
+    if (input == NULL || output_c == NULL || output_opt == NULL) {
+        printf(ANSI_COLOR_RED"%s allocations failed\n"ANSI_COLOR_RESET, __FUNCTION__);
+        goto reduce_sum_s8_cleanup;
+    }
+    scratch_c = ESP_NN_TEST_ALLOC(esp_nn_get_reduce_scratch_size_ansi(max_inner) + 4);
+    scratch_opt = ESP_NN_TEST_ALLOC(esp_nn_get_reduce_scratch_size(max_inner) + 4);
+    if (scratch_c == NULL || scratch_opt == NULL) {
+        printf(ANSI_COLOR_RED"%s scratch allocations failed\n"ANSI_COLOR_RESET, __FUNCTION__);
+        goto reduce_sum_s8_cleanup;
+    }
+    for (int itr = 0; itr < 10; itr++) {
+        int32_t input_offset = rand() % 256 - 128;
+        int32_t out_offset = rand() % 256 - 128;
+        /* mean: 1 / reduce_size folded in */
+        int32_t out_mult = INT32_MAX / 2 + rand() % INT16_MAX;
+        int32_t out_shift = -7 + rand() % 3;
+        switch (itr) {
+        case 0:
+            break;
+        case 1: /* reduce over the last axis */
+            outer_size = max_outer;
+            reduce_size = max_reduce;
+            inner_size = 1;
+            break;
+        case 2: /* sum, no rescale */
+            outer_size = 2;
+            reduce_size = 3;
+            inner_size = 5;
+            out_shift = 1;
+            break;
+        case 3:
+            outer_size = 1;
+            reduce_size = 1;
+            inner_size = 1;
+            break;
+        default:
+            outer_size = rand() % max_outer + 1;
+            reduce_size = rand() % max_reduce + 1;
+            inner_size = rand() % max_inner + 1;
+            break;
+        }
+        const int32_t size = outer_size * reduce_size * inner_size;
+        for (int i = 0; i < size; ++i) {
+            input[i] = rand() % 256 - 128;
+        }
+
+        esp_nn_set_reduce_scratch_buf_ansi(scratch_c);
+        esp_nn_set_reduce_scratch_buf(scratch_opt);
+
+        /* enable profiler */
+        profile_c_start();
+
+        /* C function */
+        esp_nn_reduce_sum_s8_ansi(input, outer_size, reduce_size, inner_size, input_offset,
+                                  output_c, out_offset, out_mult, out_shift,
+                                  activation_min, activation_max);
+
+        total_c = profile_c_end();
+        profile_opt_start();
+
+        /* Optimized function */
+        esp_nn_reduce_sum_s8(input, outer_size, reduce_size, inner_size, input_offset,
+                             output_opt, out_offset, out_mult, out_shift,
+                             activation_min, activation_max);
+
+        /* disable profiler */
+        total_opt = profile_opt_end();
+
+        bool ret = CHECK_EQUAL(output_c, output_opt, outer_size * inner_size);
+        if (ret == false) {
+            printf(ANSI_COLOR_RED"[%3d] failed\n"ANSI_COLOR_RESET, itr);
+            goto reduce_sum_s8_cleanup;
+        }
+        printf(ANSI_COLOR_GREEN"[%3d] passed [outer %"PRIi32", reduce %"PRIi32", inner %"PRIi32"]"ANSI_COLOR_RESET,
+               itr, outer_size, reduce_size, inner_size);
+        printf("\tcycles: c %8"PRIu32", opt %8"PRIu32"\n", total_c, total_opt);
+    }
+
+reduce_sum_s8_cleanup:
+    free(input);
+    free(output_c);
+    free(output_opt);
+    free(scratch_c);
+    free(scratch_opt);
+}
+
+void esp_nn_reduce_max_s8_test()
+{
+    uint32_t total_c = 0, total_opt = 0;
+    const int32_t max_outer = 4, max_reduce = 196, max_inner = 96;
+    int32_t outer_size = 1, reduce_size = 196, inner_size = 96;
+    int8_t *input = ESP_NN_TEST_ALLOC(max_outer * max_reduce * max_inner);
+    int8_t *output_c = ESP_NN_TEST_ALLOC(max_outer * max_inner);
+    int8_t *output_opt = ESP_NN_TEST_ALLOC(max_outer * max_inner);
+    printf("\n######## Running %s ##########\n", __FUNCTION__);
+    if (input == NULL || output_c == NULL || output_opt == NULL) {
+        printf(ANSI_COLOR_RED"%s allocations failed\n"ANSI_COLOR_RESET, __FUNCTION__);
+        goto reduce_max_s8_cleanup;
+    }
+    for (int itr = 0; itr < 10; itr++) {
+        switch (itr) {
+        case 0:
+            break;
+        case 1: /* reduce over the last axis */
+            outer_size = max_outer;
+            reduce_size = max_reduce;
+            inner_size = 1;
+            break;
+        case 2:
+            outer_size = 1;
+            reduce_size = 1;
+            inner_size = 1;
+            break;
+        default:
+            outer_size = rand() % max_outer + 1;
+            reduce_size = rand() % max_reduce + 1;
+            inner_size = rand() % max_inner + 1;
+            break;
+        }
+        const int32_t size = outer_size * reduce_size * inner_size;
+        for (int i = 0; i < size; ++i) {
+            input[i] = rand() % 256 - 128;
+        }
+
+        /* enable profiler */
+        profile_c_start();
+
+        /* C function */
+        esp_nn_reduce_max_s8_ansi(input, outer_size, reduce_size, inner_size, output_c);
+
+        total_c = profile_c_end();
+        profile_opt_start();
+
+        /* Optimized function */
+        esp_nn_reduce_max_s8(input, outer_size, reduce_size, inner_size, output_opt);
+
+        /* disable profiler */
+        total_opt = profile_opt_end();
+
+        bool ret = CHECK_EQUAL(output_c, output_opt, outer_size * inner_size);
+        if (ret == false) {
+            printf(ANSI_COLOR_RED"[%3d] failed\n"ANSI_COLOR_RESET, itr);
+            goto reduce_max_s8_cleanup;
+        }
+        printf(ANSI_COLOR_GREEN"[%3d] passed [outer %"PRIi32", reduce %"PRIi32", inner %"PRIi32"]"ANSI_COLOR_RESET,
+               itr, outer_size, reduce_size, inner_size);
+        printf("\tcycles: c %8"PRIu32", opt %8"PRIu32"\n", total_c, total_opt);
+    }
+
+reduce_max_s8_cleanup:
+    free(input);
+    free(output_c);
+    free(output_opt);
+}
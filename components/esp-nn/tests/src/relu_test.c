@@ -0,0 +1,150 @@
+/*
+ * SPDX-FileCopyrightText: 2020-2023 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <malloc.h>
+
+#include <esp_nn.h>
+#include "test_utils.h"
+
+void esp_nn_relu6_s8_test()
+{
+    const int size = 1600 + 8 + 7;
+    int8_t *input = NULL, *inout_ansi = NULL, *inout_opt = NULL;
+
+    int8_t *input_orig = malloc(size + 16);
+    int8_t *inout_c_orig = malloc(size + 16);
+    int8_t *inout_opt_orig = malloc(size + 16);
+
+    if (input_orig == NULL || inout_c_orig == NULL || inout_opt_orig == NULL) {
+        printf(ANSI_COLOR_RED"%s allocations failed\n"ANSI_COLOR_RESET, __FUNCTION__);
+        goto relu6_s8_cleanup;
+    }
+    input = (int8_t *) (((uint32_t) input_orig + 15) & ~15);
+    inout_ansi = (int8_t *) (((uint32_t) inout_c_orig + 15) & ~15);
+    inout_opt = (int8_t *) (((uint32_t) inout_opt_orig + 15) & ~15);
+
+    /* Generate filter data between -128 -> +127 */
+    for (int i = 0; i < size; ++i) {
+        input[i] = rand() % 255 - 128;
+        inout_ansi[i] = input[i];
+        inout_opt[i] = input[i];
+    }
+
+    /* enable profiler */
+    profile_c_start();
+
+    /* C function */
+    esp_nn_relu6_s8_ansi(inout_ansi, size);
+
+    profile_c_end();
+    profile_opt_start();
+
+    /* Optimized function */
+    esp_nn_relu6_s8(inout_opt, size);
+
+    /* disable profiler */
+    profile_opt_end();
+
+    bool ret = CHECK_EQUAL(inout_ansi, inout_opt, size);
+    if (ret == false) {
+        printf(ANSI_COLOR_RED"%s failed\n"ANSI_COLOR_RESET, __FUNCTION__);
+        printf("Output: \n");
+        PRINT_ARRAY_HEX(inout_opt, size, 1);
+        printf("Expected: \n");
+        PRINT_ARRAY_HEX(inout_ansi, size, 1);
+        printf("Input:\n");
+        PRINT_ARRAY_HEX(input, size, 1);
+        goto relu6_s8_cleanup;
+    }
+    printf(ANSI_COLOR_GREEN"%s passed\n"ANSI_COLOR_RESET, __FUNCTION__);
+
+relu6_s8_cleanup:
+    if (input_orig) {
+        free (input_orig);
+    }
+    if (inout_c_orig) {
+        free (inout_c_orig);
+    }
+    if (inout_opt_orig) {
+        free (inout_opt_orig);
+    }
+}
+
+void esp_nn_lut_s8_test()
+{
+    /* odd size and offset, so both aligned and unaligned paths run */
+    const int size = 1600 + 8 + 7;
+    int8_t *input = NULL, *out_ansi = NULL, *out_opt = NULL;
+    int8_t lut[256];
+
+    int8_t *input_orig = malloc(size + 16);
+    int8_t *out_c_orig = malloc(size + 16);
+    int8_t *out_opt_orig = malloc(size + 16);
+
+    if (input_orig == NULL || out_c_orig == NULL || out_opt_orig == NULL) {
+        printf(ANSI_COLOR_RED"%s allocations failed\n"ANSI_COLOR_RESET, __FUNCTION__);
+        goto lut_s8_cleanup;
+    }
+
+    for (int i = 0; i < 256; ++i) {
+        lut[i] = rand() % 256 - 128;
+    }
+
+    for (int itr = 0; itr < 2; itr++) {
+        const int offset = itr;
+        input = (int8_t *) ((((uint32_t) input_orig + 15) & ~15) + offset);
+        out_ansi = (int8_t *) ((((uint32_t) out_c_orig + 15) & ~15) + offset);
+        out_opt = (int8_t *) ((((uint32_t) out_opt_orig + 15) & ~15) + offset);
+        const int len = size - offset;
+
+        for (int i = 0; i < len; ++i) {
+            input[i] = rand() % 256 - 128;
+        }
+
+        /* enable profiler */
+        profile_c_start();
+
+        /* C function */
+        esp_nn_lut_s8_ansi(input, out_ansi, lut, len);
+
+        profile_c_end();
+        profile_opt_start();
+
+        /* Optimized function */
+        esp_nn_lut_s8(input, out_opt, lut, len);
+
+        /* disable profiler */
+        profile_opt_end();
+
+        bool ret = CHECK_EQUAL(out_ansi, out_opt, len);
+        if (ret == false) {
+            printf(ANSI_COLOR_RED"%s[%d] failed\n"ANSI_COLOR_RESET, __FUNCTION__, itr);
+            printf("Output: \n");
+            PRINT_ARRAY_HEX(out_opt, len, 1);
+            printf("Expected: \n");
+            PRINT_ARRAY_HEX(out_ansi, len, 1);
+            printf("Input:\n");
+            PRINT_ARRAY_HEX(input, len, 1);
+            goto lut_s8_cleanup;
+        }
+        printf(ANSI_COLOR_GREEN"%s[%d] passed\n"ANSI_COLOR_RESET, __FUNCTION__, itr);
+    }
+
+lut_s8_cleanup:
+    if (input_orig) {
+        free (input_orig);
+    }
+    if (out_c_orig) {
+        free (out_c_orig);
+    }
+    if (out_opt_orig) {
+        free (out_opt_orig);
+    }
+}
@@ -0,0 +1,127 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
+
+#include <esp_nn.h>
+#include "test_utils.h"
+
+void esp_nn_resize_bilinear_s8_test()
+{
+    uint32_t total_c = 0, total_opt = 0;
+    const int32_t max_in_size = 16, max_out_size = 40, max_channels = 24;
+    data_dims_t input_dims = {.width = 10, .height = 10, .channels = 16, .extra = 1};
+    data_dims_t output_dims = {.width = 20, .height = 20, .channels = 16, .extra = 1};
+    resize_params_t resize_params = {.align_corners = 0, .half_pixel_centers = 1};
+    int8_t *input = ESP_NN_TEST_ALLOC(2 * max_in_size * max_in_size * max_channels);
+    int8_t *output_c = ESP_NN_TEST_ALLOC(2 * max_out_size * max_out_size * max_channels);
+    int8_t *output_opt = ESP_NN_TEST_ALLOC(2 * max_out_size * max_out_size * max_channels);
+    int32_t *scratch_c = NULL, *scratch_opt = NULL;
+    data_dims_t max_dims = {.width = max_out_size, .height = max_out_size,
+                            .channels = max_channels, .extra = 2};
+    printf("\n######## Running %s ##########\n", __FUNCTION__);
+    if (input == NULL || output_c == NULL || output_opt == NULL) {
+        printf(ANSI_COLOR_RED"%s allocations failed\n"ANSI_COLOR_RESET, __FUNCTION__);
+        goto resize_bilinear_s8_cleanup;
+    }
+    scratch_c = ESP_NN_TEST_ALLOC(esp_nn_get_resize_bilinear_scratch_size_ansi(&max_dims) + 4);
+    scratch_opt = ESP_NN_TEST_ALLOC(esp_nn_get_resize_bilinear_scratch_size(&max_dims) + 4);
+    if (scratch_c == NULL || scratch_opt == NULL) {
+        printf(ANSI_COLOR_RED"%s scratch allocations failed\n"ANSI_COLOR_RESET, __FUNCTION__);
+        goto resize_bilinear_s8_cleanup;
+    }
+    for (int itr = 0; itr < 12; itr++) {
+        switch (itr) {
+        case 0: /* 2x upsampling of a segmentation head */
+            break;
+        case 1:
+            resize_params.half_pixel_centers = 0;
+            break;
+        case 2:
+            resize_params.align_corners = 1;
+            resize_params.half_pixel_centers = 0;
+            break;
+        case 3: /* downsampling */
+            input_dims.width = max_in_size;
+            input_dims.height = max_in_size;
+            output_dims.width = 5;
+            output_dims.height = 7;
+            resize_params.align_corners = 0;
+            resize_params.half_pixel_centers = 1;
+            break;
+        case 4: /* batches, odd channels */
+            input_dims.width = 3;
+            input_dims.height = 4;
+            input_dims.channels = 3;
+            input_dims.extra = 2;
+            output_dims.width = max_out_size;
+            output_dims.height = 9;
+            break;
+        case 5:
+            input_dims.width = 1;
+            input_dims.height = 1;
+            output_dims.width = 1;
+            output_dims.height = 1;
+            break;
+        default:
+            input_dims.width = rand() % max_in_size + 1;
+            input_dims.height = rand() % max_in_size + 1;
+            input_dims.channels = rand() % max_channels + 1;
+            input_dims.extra = rand() % 2 + 1;
+            output_dims.width = rand() % max_out_size + 1;
+            output_dims.height = rand() % max_out_size + 1;
+            resize_params.align_corners = rand() % 2;
+            resize_params.half_pixel_centers = resize_params.align_corners ? 0 : rand() % 2;
+            break;
+        }
+        output_dims.channels = input_dims.channels;
+        output_dims.extra = input_dims.extra;
+        const int32_t in_size = input_dims.extra * input_dims.height * input_dims.width * input_dims.channels;
+        const int32_t out_size = output_dims.extra * output_dims.height * output_dims.width * output_dims.channels;
+        for (int i = 0; i < in_size; ++i) {
+            input[i] = rand() % 256 - 128;
+        }
+
+        esp_nn_set_resize_bilinear_scratch_buf_ansi(scratch_c);
+        esp_nn_set_resize_bilinear_scratch_buf(scratch_opt);
+
+        /* enable profiler */
+        profile_c_start();
+
+        /* C function */
+        esp_nn_resize_bilinear_s8_ansi(&input_dims, input, &output_dims, output_c, &resize_params);
+
+        total_c = profile_c_end();
+        profile_opt_start();
+
+        /* Optimized function */
+        esp_nn_resize_bilinear_s8(&input_dims, input, &output_dims, output_opt, &resize_params);
+
+        /* disable profiler */
+        total_opt = profile_opt_end();
+
+        bool ret = CHECK_EQUAL(output_c, output_opt, out_size);
+        if (ret == false) {
+            printf(ANSI_COLOR_RED"[%3d] failed\n"ANSI_COLOR_RESET, itr);
+            goto resize_bilinear_s8_cleanup;
+        }
+        printf(ANSI_COLOR_GREEN"[%3d] passed [%"PRIi32"x%"PRIi32" -> %"PRIi32"x%"PRIi32", ch %"PRIi32"]"ANSI_COLOR_RESET,
+               itr, input_dims.height, input_dims.width, output_dims.height, output_dims.width,
+               input_dims.channels);
+        printf("\tcycles: c %8"PRIu32", opt %8"PRIu32"\n", total_c, total_opt);
+    }
+
+resize_bilinear_s8_cleanup:
+    free(input);
+    free(output_c);
+    free(output_opt);
+    free(scratch_c);
+    free(scratch_opt);
+}
@@ -18,6 +18,7 @@ limitations under the License.
 
 #include <esp_log.h>
 
+#include <algorithm>
 #include <cstring>
 #include "feature_provider.h"
 
@@ -39,6 +40,7 @@ const char *TAG = "feature_provider";
 FeatureProvider::FeatureProvider(int feature_size, int8_t* feature_data)
     : feature_size_(feature_size),
       feature_data_(feature_data),
+      oldest_slice_(0),
       is_first_run_(true) {
   // Initialize the feature data to default values.
   for (int n = 0; n < feature_size_; ++n) {
@@ -79,31 +81,19 @@ TfLiteStatus FeatureProvider::PopulateFeatureData(
   *how_many_new_slices = slices_needed;
 
   const int slices_to_keep = kFeatureCount - slices_needed;
-  const int slices_to_drop = kFeatureCount - slices_to_keep;
-  // If we can avoid recalculating some slices, just move the existing data
-  // up in the spectrogram, to perform something like this:
+  // The spectrogram is a ring of slices, so the slices we can avoid
+  // recalculating stay where they are, and each new slice replaces the oldest
+  // one, to perform something like this:
   // last time = 80ms          current time = 120ms
   // +-----------+             +-----------+
-  // | data@20ms |         --> | data@60ms |
-  // +-----------+       --    +-----------+
-  // | data@40ms |     --  --> | data@80ms |
-  // +-----------+   --  --    +-----------+
-  // | data@60ms | --  --      |  <empty>  |
-  // +-----------+   --        +-----------+
-  // | data@80ms | --          |  <empty>  |
+  // | data@20ms | <- oldest   | data@100ms|
+  // +-----------+             +-----------+
+  // | data@40ms |             | data@120ms|
+  // +-----------+             +-----------+
+  // | data@60ms |             | data@60ms | <- oldest
+  // +-----------+             +-----------+
+  // | data@80ms |             | data@80ms |
   // +-----------+             +-----------+
-  if (slices_to_keep > 0) {
-    for (int dest_slice = 0; dest_slice < slices_to_keep; ++dest_slice) {
-      int8_t* dest_slice_data =
-          feature_data_ + (dest_slice * kFeatureSize);
-      const int src_slice = dest_slice + slices_to_drop;
-      const int8_t* src_slice_data =
-          feature_data_ + (src_slice * kFeatureSize);
-      for (int i = 0; i < kFeatureSize; ++i) {
-        dest_slice_data[i] = src_slice_data[i];
-      }
-    }
-  }
   // Any slices that need to be filled in with feature data have their
   // appropriate audio data pulled, and features calculated for that slice.
   if (slices_needed > 0) {
@@ -122,7 +112,8 @@ TfLiteStatus FeatureProvider::PopulateFeatureData(
                     audio_samples_size, kMaxAudioSampleSize);
         return kTfLiteError;
       }
-      int8_t* new_slice_data = feature_data_ + (new_slice * kFeatureSize);
+      int8_t* new_slice_data = feature_data_ + (oldest_slice_ * kFeatureSize);
+      oldest_slice_ = (oldest_slice_ + 1) % kFeatureCount;
       // size_t num_samples_read;
       // TfLiteStatus generate_status = GenerateMicroFeatures(
       //     audio_samples, audio_samples_size, kFeatureSize,
@@ -134,9 +125,7 @@ TfLiteStatus FeatureProvider::PopulateFeatureData(
       }
 
       // copy features
-      for (int j = 0; j < kFeatureSize; ++j) {
-        new_slice_data[j] = g_features[0][j];
-      }
+      memcpy(new_slice_data, g_features[0], kFeatureSize);
     }
   }
 #elif 1
@@ -202,3 +191,13 @@ TfLiteStatus FeatureProvider::PopulateFeatureData(
 #endif
   return kTfLiteOk;
 }
+
+void FeatureProvider::CopySlices(int age, int count, int8_t* dest) const {
+  // The newest slice is the one before the oldest in the ring.
+  int first = (oldest_slice_ + kFeatureCount - 1 - age) % kFeatureCount;
+  const int before_wrap = std::min(count, kFeatureCount - first);
+  memcpy(dest, feature_data_ + first * kFeatureSize,
+         before_wrap * kFeatureSize);
+  memcpy(dest + before_wrap * kFeatureSize, feature_data_,
+         (count - before_wrap) * kFeatureSize);
+}
@@ -39,9 +39,18 @@ class FeatureProvider {
   TfLiteStatus PopulateFeatureData(int32_t last_time_in_ms, int32_t time_in_ms,
                                    int* how_many_new_slices);
 
+  // The feature data is a ring of slices: new slices replace the oldest ones
+  // instead of moving the others. Copies `count` slices in time order into
+  // `dest`, starting with the slice `age` slices older than the newest one.
+  // The whole spectrogram is CopySlices(kFeatureCount - 1, kFeatureCount, ...)
+  // and the newest slice is CopySlices(0, 1, ...).
+  void CopySlices(int age, int count, int8_t* dest) const;
+
  private:
   int feature_size_;
   int8_t* feature_data_;
+  // Index of the oldest slice in feature_data_, the next one to be replaced.
+  int oldest_slice_;
   // Make sure we don't try to use cached information if this is the first call
   // into the provider.
   bool is_first_run_;
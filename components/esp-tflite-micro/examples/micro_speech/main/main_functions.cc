@@ -17,11 +17,14 @@ limitations under the License.
 #include <cstdint>
 #include <iterator>
 
+#include <esp_timer.h>
+
 #include "main_functions.h"
 
 #include "audio_provider.h"
 #include "command_responder.h"
 #include "feature_provider.h"
+#include "kws_model_op_resolver.h"
 #include "micro_model_settings.h"
 #include "model.h"
 #include "recognize_commands.h"
@@ -30,7 +33,7 @@ limitations under the License.
 #include "tensorflow/lite/core/c/common.h"
 #include "tensorflow/lite/micro/micro_interpreter.h"
 #include "tensorflow/lite/micro/micro_log.h"
-#include "tensorflow/lite/micro/micro_mutable_op_resolver.h"
+#include "tensorflow/lite/micro/micro_resource_variable.h"
 
 // Globals, used for compatibility with Arduino-style sketches.
 namespace {
@@ -41,15 +44,47 @@ FeatureProvider* feature_provider = nullptr;
 RecognizeCommands* recognizer = nullptr;
 int32_t previous_time = 0;
 
-// Create an area of memory to use for input, output, and intermediate arrays.
-// The size of this will depend on the model you're using, and may need to be
-// determined by experimentation.
-constexpr int kTensorArenaSize = 30 * 1024;
-uint8_t tensor_arena[kTensorArenaSize];
+// Create an area of memory to use for the persistent data of the model. The
+// input, output, and intermediate arrays are in g_non_persistent_arena, which
+// is shared with the feature generator. The sizes of both will depend on the
+// models you're using, and may need to be determined by experimentation.
+constexpr int kPersistentArenaSize = 4 * 1024;
+alignas(16) uint8_t persistent_arena[kPersistentArenaSize];
 int8_t feature_buffer[kFeatureElementCount];
 int8_t* model_input_buffer = nullptr;
+
+// A model whose input holds fewer than kFeatureCount slices is a streaming
+// model: it keeps what it needs of the older slices in resource variables
+// (VAR_HANDLE, READ_VARIABLE, ASSIGN_VARIABLE) and each Invoke() only gets
+// the next model_slice_count slices. Such a model can have up to
+// kMaxResourceVariables variables.
+constexpr int kMaxResourceVariables = 8;
+int model_slice_count = 0;
+// Slices that the model has not seen yet.
+int pending_slices = 0;
+
+// Time spent on features and inference since report_start_time, to report
+// the latency per stride and the CPU load about once a second.
+constexpr int32_t kReportIntervalMs = 1000;
+int32_t report_start_time = 0;
+int64_t feature_time_us = 0;
+int64_t inference_time_us = 0;
+int stride_count = 0;
+
+// Returns the number of slices in the model's input [1, slices * kFeatureSize].
+int ModelSliceCount(const tflite::Model* model) {
+  const tflite::SubGraph* subgraph = model->subgraphs()->Get(0);
+  const tflite::Tensor* input =
+      subgraph->tensors()->Get(subgraph->inputs()->Get(0));
+  if (input->shape() == nullptr || input->shape()->size() != 2) {
+    return 0;
+  }
+  return input->shape()->Get(1) / kFeatureSize;
+}
 }  // namespace
 
+alignas(16) uint8_t g_non_persistent_arena[kNonPersistentArenaSize];
+
 // The name of this function is important for Arduino compatibility.
 void setup() {
   // Map the model into a usable data structure. This doesn't involve any
@@ -61,45 +96,50 @@ void setup() {
     return;
   }
 
-  // Pull in only the operation implementations we need.
-  // This relies on a complete list of all the ops needed by this graph.
-  // An easier approach is to just use the AllOpsResolver, but this will
-  // incur some penalty in code space for op implementations that are not
-  // needed by this graph.
-  //
-  // tflite::AllOpsResolver resolver;
+  // Pull in only the operation implementations we need. The resolver is
+  // generated from model.cc at build time, so it has exactly the ops of the
+  // model, including the variable ops of a streaming model.
   // NOLINTNEXTLINE(runtime-global-variables)
-  static tflite::MicroMutableOpResolver<4> micro_op_resolver;
-  if (micro_op_resolver.AddDepthwiseConv2D() != kTfLiteOk) {
-    return;
-  }
-  if (micro_op_resolver.AddFullyConnected() != kTfLiteOk) {
-    return;
-  }
-  if (micro_op_resolver.AddSoftmax() != kTfLiteOk) {
+  static kws_model::OpResolver micro_op_resolver;
+  if (kws_model::RegisterOps(micro_op_resolver) != kTfLiteOk) {
     return;
   }
-  if (micro_op_resolver.AddReshape() != kTfLiteOk) {
+
+  model_slice_count = ModelSliceCount(model);
+  if (model_slice_count < 1 || model_slice_count > kFeatureCount) {
+    MicroPrintf("Bad input tensor parameters in model");
     return;
   }
 
   // Build an interpreter to run the model with.
+  tflite::MicroAllocator* allocator = tflite::MicroAllocator::Create(
+      persistent_arena, kPersistentArenaSize, g_non_persistent_arena,
+      kNonPersistentArenaSize);
+  tflite::MicroResourceVariables* resource_variables = nullptr;
+  if (model_slice_count < kFeatureCount) {
+    resource_variables =
+        tflite::MicroResourceVariables::Create(allocator, kMaxResourceVariables);
+    MicroPrintf("Streaming model, %d slices per inference", model_slice_count);
+  }
   static tflite::MicroInterpreter static_interpreter(
-      model, micro_op_resolver, tensor_arena, kTensorArenaSize);
+      model, micro_op_resolver, allocator, resource_variables);
   interpreter = &static_interpreter;
 
-  // Allocate memory from the tensor_arena for the model's tensors.
+  // Allocate memory from the arenas for the model's tensors.
   TfLiteStatus allocate_status = interpreter->AllocateTensors();
   if (allocate_status != kTfLiteOk) {
     MicroPrintf("AllocateTensors() failed");
     return;
   }
+  MicroPrintf("Model arena size = %u (persistent %u)",
+              interpreter->arena_used_bytes(),
+              allocator->persistent_used_bytes());
 
   // Get information about the memory area to use for the model's input.
   model_input = interpreter->input(0);
   if ((model_input->dims->size != 2) || (model_input->dims->data[0] != 1) ||
       (model_input->dims->data[1] !=
-       (kFeatureCount * kFeatureSize)) ||
+       (model_slice_count * kFeatureSize)) ||
       (model_input->type != kTfLiteInt8)) {
     MicroPrintf("Bad input tensor parameters in model");
     return;
@@ -117,6 +157,8 @@ void setup() {
   recognizer = &static_recognizer;
 
   previous_time = 0;
+  pending_slices = 0;
+  report_start_time = 0;
 }
 
 // The name of this function is important for Arduino compatibility.
@@ -124,12 +166,14 @@ void loop() {
   // Fetch the spectrogram for the current time.
   const int32_t current_time = LatestAudioTimestamp();
   int how_many_new_slices = 0;
+  const int64_t feature_start = esp_timer_get_time();
   TfLiteStatus feature_status = feature_provider->PopulateFeatureData(
       previous_time, current_time, &how_many_new_slices);
   if (feature_status != kTfLiteOk) {
     MicroPrintf( "Feature generation failed");
     return;
   }
+  feature_time_us += esp_timer_get_time() - feature_start;
   previous_time = current_time;
   // If no new audio samples have been received since last time, don't bother
   // running the network model.
@@ -137,17 +181,48 @@ void loop() {
     return;
   }
 
-  // Copy feature buffer to input tensor
-  for (int i = 0; i < kFeatureElementCount; i++) {
-    model_input_buffer[i] = feature_buffer[i];
+  // A streaming model runs once for every model_slice_count new slices, the
+  // other model once on the whole spectrogram.
+  pending_slices = std::min(pending_slices + how_many_new_slices, kFeatureCount);
+  if (model_slice_count == kFeatureCount) {
+    pending_slices = kFeatureCount;
   }
-
-  // Run the model on the spectrogram input and make sure it succeeds.
-  TfLiteStatus invoke_status = interpreter->Invoke();
-  if (invoke_status != kTfLiteOk) {
-    MicroPrintf( "Invoke failed");
+  if (pending_slices < model_slice_count) {
     return;
   }
+  const int64_t inference_start = esp_timer_get_time();
+  while (pending_slices >= model_slice_count) {
+    // Copy the slices to the input tensor. The feature generator has just run
+    // in the shared arena, so this has to happen right before Invoke().
+    feature_provider->CopySlices(pending_slices - 1, model_slice_count,
+                                 model_input_buffer);
+    pending_slices -= model_slice_count;
+
+    // Run the model on the spectrogram input and make sure it succeeds.
+    TfLiteStatus invoke_status = interpreter->Invoke();
+    if (invoke_status != kTfLiteOk) {
+      MicroPrintf( "Invoke failed");
+      return;
+    }
+  }
+  inference_time_us += esp_timer_get_time() - inference_start;
+  stride_count++;
+
+  // The audio arrives in real time, so the CPU load is the processing time
+  // over the audio time it covers.
+  if (current_time - report_start_time >= kReportIntervalMs) {
+    const int64_t audio_time_us =
+        static_cast<int64_t>(current_time - report_start_time) * 1000;
+    MicroPrintf("Per stride: features %d us, inference %d us, CPU load %d%%",
+                static_cast<int>(feature_time_us / stride_count),
+                static_cast<int>(inference_time_us / stride_count),
+                static_cast<int>((feature_time_us + inference_time_us) * 100 /
+                                 audio_time_us));
+    report_start_time = current_time;
+    feature_time_us = 0;
+    inference_time_us = 0;
+    stride_count = 0;
+  }
 
   // Obtain a pointer to the output tensor
   TfLiteTensor* output = interpreter->output(0);
@@ -34,8 +34,8 @@ bool g_is_first_time = true;
 const tflite::Model* model = nullptr;
 tflite::MicroInterpreter* interpreter = nullptr;
 
-constexpr size_t kArenaSize = 16 * 1024;
-alignas(16) uint8_t g_arena[kArenaSize];
+constexpr size_t kPersistentArenaSize = 8 * 1024;
+alignas(16) uint8_t g_persistent_arena[kPersistentArenaSize];
 
 constexpr int kAudioSampleDurationCount =
     kFeatureDurationMs * kAudioSampleFrequency / 1000;
@@ -81,7 +81,12 @@ TfLiteStatus InitializeMicroFeatures() {
   static AudioPreprocessorOpResolver op_resolver;
   RegisterOps(op_resolver);
 
-  static tflite::MicroInterpreter static_interpreter(model, op_resolver, g_arena, kArenaSize);
+  // Only the persistent data of the model is private, the activations use the
+  // arena shared with the keyword model.
+  tflite::MicroAllocator* allocator = tflite::MicroAllocator::Create(
+      g_persistent_arena, kPersistentArenaSize, g_non_persistent_arena,
+      kNonPersistentArenaSize);
+  static tflite::MicroInterpreter static_interpreter(model, op_resolver, allocator);
   interpreter = &static_interpreter;
 
   if (interpreter->AllocateTensors() != kTfLiteOk) {
@@ -89,8 +94,9 @@ TfLiteStatus InitializeMicroFeatures() {
     return kTfLiteError;
   }
 
-  // MicroPrintf("AudioPreprocessor model arena size = %u",
-  //             interpreter.arena_used_bytes());
+  MicroPrintf("AudioPreprocessor model arena size = %u (persistent %u)",
+              interpreter->arena_used_bytes(),
+              allocator->persistent_used_bytes());
 
   return kTfLiteOk;
 }
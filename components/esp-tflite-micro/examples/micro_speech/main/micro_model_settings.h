@@ -16,6 +16,8 @@ limitations under the License.
 #ifndef TENSORFLOW_LITE_MICRO_EXAMPLES_MICRO_SPEECH_MICRO_MODEL_SETTINGS_H_
 #define TENSORFLOW_LITE_MICRO_EXAMPLES_MICRO_SPEECH_MICRO_MODEL_SETTINGS_H_
 
+#include <cstdint>
+
 // The following values are derived from values used during model training.
 // If you change the way you preprocess the input, update all these constants.
 constexpr int kMaxAudioSampleSize = 512;
@@ -35,4 +37,11 @@ constexpr const char* kCategoryLabels[kCategoryCount] = {
     "no",
 };
 
+// The feature generator and the keyword model never run at the same time, so
+// their activation tensors and scratch buffers share one arena, defined in
+// main_functions.cc. Each interpreter keeps its persistent data in an arena of
+// its own.
+constexpr int kNonPersistentArenaSize = 16 * 1024;
+extern uint8_t g_non_persistent_arena[kNonPersistentArenaSize];
+
 #endif  // TENSORFLOW_LITE_MICRO_EXAMPLES_MICRO_SPEECH_MICRO_MODEL_SETTINGS_H_
@@ -54,6 +54,11 @@ constexpr int scratchBufSize = 0;
 // Keeping allocation on bit larger size to accomodate future needs.
 constexpr int kTensorArenaSize = 100 * 1024 + scratchBufSize;
 static uint8_t *tensor_arena;//[kTensorArenaSize]; // Maybe we should move this to external
+#if CONFIG_TFLITE_ARENA_IN_PSRAM
+// The most frequently accessed buffers stay in internal RAM.
+constexpr int kFastArenaSize = CONFIG_TFLITE_FAST_ARENA_SIZE;
+static uint8_t *fast_arena;
+#endif
 }  // namespace
 
 // The name of this function is important for Arduino compatibility.
@@ -67,6 +72,18 @@ void setup() {
     return;
   }
 
+#if CONFIG_TFLITE_ARENA_IN_PSRAM
+  if (tensor_arena == NULL) {
+    tensor_arena = (uint8_t *) heap_caps_malloc(kTensorArenaSize, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  }
+  if (fast_arena == NULL) {
+    fast_arena = (uint8_t *) heap_caps_malloc(kFastArenaSize, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+  }
+  if (tensor_arena == NULL || fast_arena == NULL) {
+    printf("Couldn't allocate memory of %d + %d bytes\n", kTensorArenaSize, kFastArenaSize);
+    return;
+  }
+#else
   if (tensor_arena == NULL) {
     tensor_arena = (uint8_t *) heap_caps_malloc(kTensorArenaSize, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
   }
@@ -74,6 +91,7 @@ void setup() {
     printf("Couldn't allocate memory of %d bytes\n", kTensorArenaSize);
     return;
   }
+#endif
 
   // Pull in only the operation implementations we need.
   // This relies on a complete list of all the ops needed by this graph.
@@ -92,8 +110,15 @@ void setup() {
 
   // Build an interpreter to run the model with.
   // NOLINTNEXTLINE(runtime-global-variables)
+#if CONFIG_TFLITE_ARENA_IN_PSRAM
+  static tflite::MicroInterpreter static_interpreter(
+      model, micro_op_resolver,
+      tflite::MicroAllocator::CreateTiered(tensor_arena, kTensorArenaSize,
+                                           fast_arena, kFastArenaSize));
+#else
   static tflite::MicroInterpreter static_interpreter(
       model, micro_op_resolver, tensor_arena, kTensorArenaSize);
+#endif
   interpreter = &static_interpreter;
 
   // Allocate memory from the tensor_arena for the model's tensors.
@@ -0,0 +1,90 @@
+set(TFLITE_MICRO_GEN_OP_RESOLVER "${CMAKE_CURRENT_LIST_DIR}/tools/gen_op_resolver.py")
+set(TFLITE_MICRO_GEN_AOT_MODEL "${CMAKE_CURRENT_LIST_DIR}/tools/gen_aot_model.py")
+
+# tflite_micro_generate_op_resolver(<target>
+#                                   MODEL <model>
+#                                   HEADER <header>
+#                                   [NAMESPACE <namespace>])
+#
+# Generates <header> in the component's build directory with a
+# MicroMutableOpResolver holding exactly the ops of <model>, a .tflite file or
+# a C/C++ source with the model as a byte array, and makes it includable from
+# <target>. The resolver is declared in <namespace>, by default the name of
+# the model file without extension. The header is regenerated when the model
+# changes.
+#
+# Registering only the used ops keeps the kernels of all other ops out of the
+# image: the linker only pulls the kernel objects referenced by a resolver
+# out of the component library.
+function(tflite_micro_generate_op_resolver target)
+    cmake_parse_arguments(_ "" "MODEL;HEADER;NAMESPACE" "" ${ARGN})
+    if(NOT __MODEL OR NOT __HEADER)
+        message(FATAL_ERROR "tflite_micro_generate_op_resolver: MODEL and HEADER are required")
+    endif()
+    if(NOT __NAMESPACE)
+        get_filename_component(__NAMESPACE "${__MODEL}" NAME_WE)
+        string(MAKE_C_IDENTIFIER "${__NAMESPACE}" __NAMESPACE)
+    endif()
+
+    idf_build_get_property(python PYTHON)
+    get_filename_component(model "${__MODEL}" ABSOLUTE)
+    set(gen_dir "${CMAKE_CURRENT_BINARY_DIR}/tflite_micro_op_resolver")
+    set(header "${gen_dir}/${__HEADER}")
+
+    file(MAKE_DIRECTORY "${gen_dir}")
+    add_custom_command(OUTPUT "${header}"
+        COMMAND ${python} "${TFLITE_MICRO_GEN_OP_RESOLVER}"
+                --model "${model}" --output "${header}"
+                --namespace "${__NAMESPACE}"
+        DEPENDS "${model}" "${TFLITE_MICRO_GEN_OP_RESOLVER}"
+        COMMENT "Generating op resolver ${__HEADER}"
+        VERBATIM)
+
+    string(MAKE_C_IDENTIFIER "${target}_${__HEADER}" gen_target)
+    add_custom_target(${gen_target} DEPENDS "${header}")
+    add_dependencies(${target} ${gen_target})
+    target_include_directories(${target} PRIVATE "${gen_dir}")
+endfunction()
+
+# tflite_micro_generate_aot_model(<target>
+#                                 MODEL <model>
+#                                 HEADER <header>
+#                                 [NAMESPACE <namespace>])
+#
+# Generates <header> in the component's build directory with the tables of
+# <model> compiled ahead of time for tflite::AotGraph, and makes it includable
+# from <target>. <model> is a .tflite file or a C/C++ source with the model as
+# a byte array; the same model data has to be passed to AotGraph at run time.
+# The tables are declared in <namespace>, by default the name of the model
+# file without extension followed by "_aot". The header is regenerated when
+# the model changes.
+function(tflite_micro_generate_aot_model target)
+    cmake_parse_arguments(_ "" "MODEL;HEADER;NAMESPACE" "" ${ARGN})
+    if(NOT __MODEL OR NOT __HEADER)
+        message(FATAL_ERROR "tflite_micro_generate_aot_model: MODEL and HEADER are required")
+    endif()
+    if(NOT __NAMESPACE)
+        get_filename_component(__NAMESPACE "${__MODEL}" NAME_WE)
+        string(MAKE_C_IDENTIFIER "${__NAMESPACE}_aot" __NAMESPACE)
+    endif()
+
+    idf_build_get_property(python PYTHON)
+    get_filename_component(model "${__MODEL}" ABSOLUTE)
+    set(gen_dir "${CMAKE_CURRENT_BINARY_DIR}/tflite_micro_aot_model")
+    set(header "${gen_dir}/${__HEADER}")
+
+    file(MAKE_DIRECTORY "${gen_dir}")
+    add_custom_command(OUTPUT "${header}"
+        COMMAND ${python} "${TFLITE_MICRO_GEN_AOT_MODEL}"
+                --model "${model}" --output "${header}"
+                --namespace "${__NAMESPACE}"
+        DEPENDS "${model}" "${TFLITE_MICRO_GEN_AOT_MODEL}"
+                "${TFLITE_MICRO_GEN_OP_RESOLVER}"
+        COMMENT "Generating AOT model ${__HEADER}"
+        VERBATIM)
+
+    string(MAKE_C_IDENTIFIER "${target}_${__HEADER}" gen_target)
+    add_custom_target(${gen_target} DEPENDS "${header}")
+    add_dependencies(${target} ${gen_target})
+    target_include_directories(${target} PRIVATE "${gen_dir}")
+endfunction()
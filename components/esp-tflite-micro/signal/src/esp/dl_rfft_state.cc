@@ -0,0 +1,172 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "signal/src/esp/dl_rfft_state.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+
+// TODO(b/286250473): remove namespace once de-duped libraries
+namespace tflm_signal {
+
+namespace {
+
+// dl_fft allocates its tables 16-byte aligned, and the SIMD variants of the
+// float transform rely on it.
+constexpr size_t kAlignment = 16;
+
+// Shortest transform the dl_fft butterflies and post-processing handle.
+constexpr int32_t kMinFftLength = 8;
+
+size_t AlignSize(size_t size) {
+  return (size + kAlignment - 1) & ~(kAlignment - 1);
+}
+
+uint8_t* AlignPointer(void* memory) {
+  uintptr_t address = reinterpret_cast<uintptr_t>(memory);
+  return reinterpret_cast<uint8_t*>((address + kAlignment - 1) &
+                                    ~(kAlignment - 1));
+}
+
+// Copies `size` bytes of a heap table to `*memory` and advances it.
+template <typename T>
+T* TakeTable(const T* table, size_t size, uint8_t** memory) {
+  T* copy = reinterpret_cast<T*>(*memory);
+  memcpy(copy, table, size);
+  *memory += AlignSize(size);
+  return copy;
+}
+
+// The float transform runs a radix-4 FFT of fft_length / 2 points when
+// log2(fft_length) is odd and a radix-2 one otherwise; see dl_rfft_f32_init.
+bool FloatUsesRadix4(int32_t fft_length) {
+  return dl_power_of_two(fft_length) % 2 == 1;
+}
+
+size_t FloatFftTableSize(int32_t fft_length) {
+  return (FloatUsesRadix4(fft_length) ? 2 * fft_length : fft_length / 2) *
+         sizeof(float);
+}
+
+// Upper bound of the bit reversal table: two entries per swapped pair of the
+// fft_length / 2 complex points.
+size_t FloatBitrevTableSize(int32_t fft_length) {
+  return (fft_length / 2) * sizeof(uint16_t);
+}
+
+}  // namespace
+
+bool DlRfftSupported(int32_t fft_length) {
+  return fft_length >= kMinFftLength && dl_is_power_of_two(fft_length);
+}
+
+size_t DlRfftInt16GetNeededMemory(int32_t fft_length) {
+  if (!DlRfftSupported(fft_length)) {
+    return 0;
+  }
+  return kAlignment - 1 + AlignSize(sizeof(dl_fft_s16_t)) +
+         AlignSize(fft_length * sizeof(int16_t)) +
+         AlignSize(fft_length / 2 * sizeof(int16_t));
+}
+
+dl_fft_s16_t* DlRfftInt16Init(int32_t fft_length, void* memory,
+                              size_t memory_size) {
+  if (!DlRfftSupported(fft_length) ||
+      memory_size < DlRfftInt16GetNeededMemory(fft_length)) {
+    return nullptr;
+  }
+  dl_fft_s16_t* heap_handle = dl_rfft_s16_init(fft_length, MALLOC_CAP_8BIT);
+  if (heap_handle == nullptr) {
+    return nullptr;
+  }
+
+  uint8_t* next = AlignPointer(memory);
+  dl_fft_s16_t* handle = reinterpret_cast<dl_fft_s16_t*>(next);
+  next += AlignSize(sizeof(dl_fft_s16_t));
+  *handle = *heap_handle;
+  handle->rfft_table = TakeTable(heap_handle->rfft_table,
+                                 fft_length * sizeof(int16_t), &next);
+  handle->fft_table = TakeTable(heap_handle->fft_table,
+                                fft_length / 2 * sizeof(int16_t), &next);
+
+  dl_rfft_s16_deinit(heap_handle);
+  return handle;
+}
+
+void DlRfftInt16Rescale(int16_t* data, int32_t length, int exponent,
+                        int target_exponent) {
+  const int shift = exponent - target_exponent;
+  if (shift < 0) {
+    const int32_t round = 1 << (-shift - 1);
+    for (int32_t i = 0; i < length; i++) {
+      data[i] = static_cast<int16_t>((data[i] + round) >> -shift);
+    }
+  } else if (shift > 0) {
+    for (int32_t i = 0; i < length; i++) {
+      const int32_t value = static_cast<int32_t>(data[i]) * (1 << shift);
+      data[i] = static_cast<int16_t>(
+          std::min<int32_t>(INT16_MAX, std::max<int32_t>(INT16_MIN, value)));
+    }
+  }
+}
+
+size_t DlRfftFloatGetNeededMemory(int32_t fft_length) {
+  if (!DlRfftSupported(fft_length)) {
+    return 0;
+  }
+  return kAlignment - 1 + AlignSize(sizeof(dl_fft_f32_t)) +
+         AlignSize(fft_length * sizeof(float)) +
+         AlignSize(FloatFftTableSize(fft_length)) +
+         AlignSize(FloatBitrevTableSize(fft_length));
+}
+
+dl_fft_f32_t* DlRfftFloatInit(int32_t fft_length, void* memory,
+                              size_t memory_size) {
+  if (!DlRfftSupported(fft_length) ||
+      memory_size < DlRfftFloatGetNeededMemory(fft_length)) {
+    return nullptr;
+  }
+  dl_fft_f32_t* heap_handle = dl_rfft_f32_init(fft_length, MALLOC_CAP_8BIT);
+  if (heap_handle == nullptr) {
+    return nullptr;
+  }
+  const size_t bitrev_size =
+      heap_handle->bitrev_size * 2 * sizeof(uint16_t);
+  if (bitrev_size > FloatBitrevTableSize(fft_length)) {
+    dl_rfft_f32_deinit(heap_handle);
+    return nullptr;
+  }
+
+  uint8_t* next = AlignPointer(memory);
+  dl_fft_f32_t* handle = reinterpret_cast<dl_fft_f32_t*>(next);
+  next += AlignSize(sizeof(dl_fft_f32_t));
+  *handle = *heap_handle;
+  handle->rfft_table = TakeTable(heap_handle->rfft_table,
+                                 fft_length * sizeof(float), &next);
+  handle->fft_table = TakeTable(heap_handle->fft_table,
+                                FloatFftTableSize(fft_length), &next);
+  if (heap_handle->bitrev_table != nullptr) {
+    handle->bitrev_table =
+        TakeTable(heap_handle->bitrev_table, bitrev_size, &next);
+  }
+
+  dl_rfft_f32_deinit(heap_handle);
+  return handle;
+}
+
+}  // namespace tflm_signal
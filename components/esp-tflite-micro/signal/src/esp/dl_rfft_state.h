@@ -0,0 +1,59 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef SIGNAL_SRC_ESP_DL_RFFT_STATE_H_
+#define SIGNAL_SRC_ESP_DL_RFFT_STATE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "dl_rfft.h"
+
+// TODO(b/286250473): remove namespace once de-duped libraries
+namespace tflm_signal {
+
+// dl_fft real FFT handles whose tables live in caller-provided memory, such
+// as a TFLM persistent buffer, instead of on the heap. The same handle serves
+// the forward and the inverse transform.
+
+// Returns true if dl_fft can transform `fft_length` points. Other lengths
+// have to fall back to kissfft.
+bool DlRfftSupported(int32_t fft_length);
+
+// Returns the size of the memory DlRfftInt16Init needs for `fft_length`, or 0
+// if the length is not supported.
+size_t DlRfftInt16GetNeededMemory(int32_t fft_length);
+
+// Builds the handle and its tables in `memory`. dl_fft generates the tables
+// on the heap; they are copied and the heap copies released right away.
+// Returns nullptr if the length is not supported, `memory_size` is too small
+// or the heap allocation failed.
+dl_fft_s16_t* DlRfftInt16Init(int32_t fft_length, void* memory,
+                              size_t memory_size);
+
+// Scales `length` values with exponent `exponent`, as returned by the
+// dl_fft int16 transforms, to exponent `target_exponent`. Right shifts round
+// to nearest, left shifts saturate.
+void DlRfftInt16Rescale(int16_t* data, int32_t length, int exponent,
+                        int target_exponent);
+
+// Same for the float transform.
+size_t DlRfftFloatGetNeededMemory(int32_t fft_length);
+dl_fft_f32_t* DlRfftFloatInit(int32_t fft_length, void* memory,
+                              size_t memory_size);
+
+}  // namespace tflm_signal
+
+#endif  // SIGNAL_SRC_ESP_DL_RFFT_STATE_H_
@@ -0,0 +1,96 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "signal/src/complex.h"
+#include "signal/src/esp/dl_rfft_state.h"
+#include "signal/src/irfft.h"
+#include "signal/src/kiss_fft_wrappers/kiss_fft_float.h"
+
+// TODO(b/286250473): remove namespace once de-duped libraries
+namespace tflite {
+namespace tflm_signal {
+
+namespace {
+
+// Same layout as the RFFT state, see rfft_int16.cc.
+struct IrfftFloatState {
+  int32_t fft_length;
+  dl_fft_f32_t* dl_fft;
+  kiss_fft_float::kiss_fftr_cfg kiss_cfg;
+};
+
+constexpr size_t kStateSize = (sizeof(IrfftFloatState) + 15) & ~size_t{15};
+
+}  // namespace
+
+size_t IrfftFloatGetNeededMemory(int32_t fft_length) {
+  size_t kiss_size = 0;
+  kiss_fft_float::kiss_fftr_alloc(fft_length, 1, nullptr, &kiss_size);
+  const size_t dl_fft_size =
+      ::tflm_signal::DlRfftFloatGetNeededMemory(fft_length);
+  return kStateSize + std::max(kiss_size, dl_fft_size);
+}
+
+void* IrfftFloatInit(int32_t fft_length, void* state, size_t state_size) {
+  IrfftFloatState* irfft_state = static_cast<IrfftFloatState*>(state);
+  void* memory = static_cast<uint8_t*>(state) + kStateSize;
+  size_t memory_size = state_size - kStateSize;
+  irfft_state->fft_length = fft_length;
+  irfft_state->kiss_cfg = nullptr;
+  irfft_state->dl_fft =
+      ::tflm_signal::DlRfftFloatInit(fft_length, memory, memory_size);
+  if (irfft_state->dl_fft == nullptr) {
+    irfft_state->kiss_cfg = kiss_fft_float::kiss_fftr_alloc(
+        fft_length, 1, memory, &memory_size);
+    if (irfft_state->kiss_cfg == nullptr) {
+      return nullptr;
+    }
+  }
+  return state;
+}
+
+void IrfftFloatApply(void* state, const Complex<float>* input, float* output) {
+  IrfftFloatState* irfft_state = static_cast<IrfftFloatState*>(state);
+  if (irfft_state->dl_fft == nullptr) {
+    kiss_fft_float::kiss_fftri(
+        irfft_state->kiss_cfg,
+        reinterpret_cast<const kiss_fft_float::kiss_fft_cpx*>(input),
+        reinterpret_cast<kiss_fft_scalar*>(output));
+    // KissFFT scales the IRFFT output by the FFT length. Compensate.
+    for (int i = 0; i < irfft_state->fft_length; i++) {
+      output[i] /= irfft_state->fft_length;
+    }
+    return;
+  }
+
+  // Pack the fft_length / 2 + 1 bins the way dl_fft expects them, with the
+  // real Nyquist bin in the imaginary part of the DC bin, and transform in
+  // place in the output.
+  const int32_t fft_length = irfft_state->fft_length;
+  output[0] = input[0].real;
+  output[1] = input[fft_length / 2].real;
+  memcpy(&output[2], &input[1], (fft_length - 2) * sizeof(float));
+  // Unlike kissfft, dl_fft already normalizes the result.
+  dl_irfft_f32_run(irfft_state->dl_fft, output);
+}
+
+}  // namespace tflm_signal
+}  // namespace tflite
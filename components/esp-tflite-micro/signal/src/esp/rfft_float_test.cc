@@ -0,0 +1,134 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Compares the float RFFT and IRFFT of signal/src/esp, which run dl_fft,
+// with kissfft, which the portable signal/src sources run. The butterflies
+// are ordered differently, so the results differ by float rounding.
+//
+// Host build, from the component directory, with stand-ins for the IDF
+// headers dl_fft includes (esp_attr.h, esp_err.h, esp_heap_caps.h, esp_log.h)
+// in $STUBS and DL_FFT=../../managed_components/espressif__dl_fft:
+//   g++ -std=c++17 -I$STUBS -I. -Ithird_party/kissfft \
+//     -I$DL_FFT -I$DL_FFT/base -I$DL_FFT/base/isa \
+//     signal/src/esp/rfft_float_test.cc \
+//     signal/src/esp/{dl_rfft_state,rfft_float,irfft_float}.cc \
+//     signal/src/kiss_fft_wrappers/kiss_fft_float.cc \
+//     tensorflow/lite/micro/{micro_log,debug_log,system_setup}.cc \
+//     -x c $DL_FFT/{dl_fft_f32,dl_fft_s16}.c \
+//     $DL_FFT/{dl_rfft_f32,dl_rfft_s16}.c \
+//     $DL_FFT/base/{dl_fft_base,dl_fft{2r_fc32,4r_fc32,2r_sc16}_ansi}.c \
+//     -lm -o rfft_float_test
+
+#include <math.h>
+#include <stdint.h>
+
+#include <algorithm>
+
+#include "signal/src/complex.h"
+#include "signal/src/irfft.h"
+#include "signal/src/kiss_fft_wrappers/kiss_fft_float.h"
+#include "signal/src/rfft.h"
+#include "tensorflow/lite/micro/testing/micro_test.h"
+
+namespace {
+
+constexpr int kMaxFftLength = 1024;
+constexpr int kNumRuns = 20;
+// Largest difference to kissfft, per point of the FFT length, for inputs in
+// [-1, 1).
+constexpr float kTolerancePerPoint = 2e-7f;
+
+uint32_t random_state = 1;
+float RandomFloat() {
+  random_state = random_state * 1664525u + 1013904223u;
+  return static_cast<int32_t>(random_state) / 2147483648.f;
+}
+
+alignas(16) uint8_t rfft_state[16 * 1024];
+alignas(16) uint8_t irfft_state[16 * 1024];
+alignas(16) uint8_t kiss_state[16 * 1024];
+alignas(16) uint8_t kiss_inverse_state[16 * 1024];
+float signal_data[kMaxFftLength];
+float expected_signal[kMaxFftLength];
+Complex<float> spectrum[kMaxFftLength / 2 + 1];
+Complex<float> expected_spectrum[kMaxFftLength / 2 + 1];
+
+float MaxDiff(const float* a, const float* b, int length) {
+  float max_diff = 0;
+  for (int i = 0; i < length; i++) {
+    max_diff = std::max(max_diff, fabsf(a[i] - b[i]));
+  }
+  return max_diff;
+}
+
+void TestFloat(int fft_length) {
+  void* rfft = tflm_signal::RfftFloatInit(fft_length, rfft_state,
+                                          sizeof(rfft_state));
+  void* irfft = tflite::tflm_signal::IrfftFloatInit(fft_length, irfft_state,
+                                                    sizeof(irfft_state));
+  size_t kiss_size = sizeof(kiss_state);
+  kiss_fft_float::kiss_fftr_cfg kiss_cfg =
+      kiss_fft_float::kiss_fftr_alloc(fft_length, 0, kiss_state, &kiss_size);
+  kiss_size = sizeof(kiss_inverse_state);
+  kiss_fft_float::kiss_fftr_cfg kiss_inverse_cfg =
+      kiss_fft_float::kiss_fftr_alloc(fft_length, 1, kiss_inverse_state,
+                                      &kiss_size);
+  TF_LITE_MICRO_EXPECT(rfft != nullptr);
+  TF_LITE_MICRO_EXPECT(irfft != nullptr);
+  TF_LITE_MICRO_EXPECT(kiss_cfg != nullptr);
+  TF_LITE_MICRO_EXPECT(kiss_inverse_cfg != nullptr);
+
+  const int num_values = (fft_length / 2 + 1) * 2;
+  const float tolerance = kTolerancePerPoint * fft_length;
+  for (int run = 0; run < kNumRuns; run++) {
+    for (int i = 0; i < fft_length; i++) {
+      signal_data[i] = RandomFloat();
+    }
+    tflm_signal::RfftFloatApply(rfft, signal_data, spectrum);
+    kiss_fft_float::kiss_fftr(
+        kiss_cfg, signal_data,
+        reinterpret_cast<kiss_fft_float::kiss_fft_cpx*>(expected_spectrum));
+    TF_LITE_MICRO_EXPECT_LE(
+        MaxDiff(reinterpret_cast<float*>(spectrum),
+                reinterpret_cast<float*>(expected_spectrum), num_values),
+        tolerance);
+
+    tflite::tflm_signal::IrfftFloatApply(irfft, expected_spectrum,
+                                         signal_data);
+    kiss_fft_float::kiss_fftri(
+        kiss_inverse_cfg,
+        reinterpret_cast<const kiss_fft_float::kiss_fft_cpx*>(
+            expected_spectrum),
+        expected_signal);
+    // kissfft does not normalize the inverse transform, dl_fft does.
+    for (int i = 0; i < fft_length; i++) {
+      expected_signal[i] /= fft_length;
+    }
+    TF_LITE_MICRO_EXPECT_LE(MaxDiff(signal_data, expected_signal, fft_length),
+                            tolerance);
+  }
+}
+
+}  // namespace
+
+TF_LITE_MICRO_TESTS_BEGIN
+
+TF_LITE_MICRO_TEST(RfftIrfftFloatMatchKissFft) {
+  for (int fft_length = 8; fft_length <= kMaxFftLength; fft_length *= 2) {
+    TestFloat(fft_length);
+  }
+}
+
+TF_LITE_MICRO_TESTS_END
@@ -0,0 +1,97 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "signal/src/complex.h"
+#include "signal/src/esp/dl_rfft_state.h"
+#include "signal/src/kiss_fft_wrappers/kiss_fft_int16.h"
+#include "signal/src/rfft.h"
+
+// TODO(b/286250473): remove namespace once de-duped libraries
+namespace tflm_signal {
+
+namespace {
+
+// dl_fft handle, or kissfft config for the lengths dl_fft does not support
+// or if building the dl_fft tables failed. The handle or config follows the
+// state in the same memory.
+struct RfftInt16State {
+  int32_t fft_length;
+  dl_fft_s16_t* dl_fft;
+  kiss_fft_fixed16::kiss_fftr_cfg kiss_cfg;
+};
+
+constexpr size_t kStateSize = (sizeof(RfftInt16State) + 15) & ~size_t{15};
+
+}  // namespace
+
+size_t RfftInt16GetNeededMemory(int32_t fft_length) {
+  size_t kiss_size = 0;
+  kiss_fft_fixed16::kiss_fftr_alloc(fft_length, 0, nullptr, &kiss_size);
+  const size_t dl_fft_size = DlRfftInt16GetNeededMemory(fft_length);
+  return kStateSize + std::max(kiss_size, dl_fft_size);
+}
+
+void* RfftInt16Init(int32_t fft_length, void* state, size_t state_size) {
+  RfftInt16State* rfft_state = static_cast<RfftInt16State*>(state);
+  void* memory = static_cast<uint8_t*>(state) + kStateSize;
+  size_t memory_size = state_size - kStateSize;
+  rfft_state->fft_length = fft_length;
+  rfft_state->kiss_cfg = nullptr;
+  rfft_state->dl_fft = DlRfftInt16Init(fft_length, memory, memory_size);
+  if (rfft_state->dl_fft == nullptr) {
+    rfft_state->kiss_cfg = kiss_fft_fixed16::kiss_fftr_alloc(
+        fft_length, 0, memory, &memory_size);
+    if (rfft_state->kiss_cfg == nullptr) {
+      return nullptr;
+    }
+  }
+  return state;
+}
+
+void RfftInt16Apply(void* state, const int16_t* input,
+                    Complex<int16_t>* output) {
+  RfftInt16State* rfft_state = static_cast<RfftInt16State*>(state);
+  if (rfft_state->dl_fft == nullptr) {
+    kiss_fft_fixed16::kiss_fftr(
+        rfft_state->kiss_cfg, reinterpret_cast<const kiss_fft_scalar*>(input),
+        reinterpret_cast<kiss_fft_fixed16::kiss_fft_cpx*>(output));
+    return;
+  }
+
+  // The output holds fft_length / 2 + 1 bins, so the transform runs in place
+  // in it.
+  const int32_t fft_length = rfft_state->fft_length;
+  int16_t* data = reinterpret_cast<int16_t*>(output);
+  memcpy(data, input, fft_length * sizeof(int16_t));
+  // The high precision transform scales each butterfly stage only as far as
+  // needed to avoid overflow and reports the total as exponent. Bring the
+  // result to the fixed 1 / fft_length scale of kissfft, which the shift
+  // applied by FftAutoScale and the ops after the RFFT expect.
+  int exponent;
+  dl_rfft_s16_hp_run(rfft_state->dl_fft, data, 0, &exponent);
+  DlRfftInt16Rescale(data, fft_length, exponent, rfft_state->dl_fft->log2n);
+  // dl_fft packs the real Nyquist bin into the imaginary part of the DC bin.
+  output[fft_length / 2].real = output[0].imag;
+  output[fft_length / 2].imag = 0;
+  output[0].imag = 0;
+}
+
+}  // namespace tflm_signal
@@ -0,0 +1,163 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Compares the int16 RFFT and IRFFT of signal/src/esp, which run dl_fft,
+// with kissfft, which the portable signal/src sources run. dl_fft is not
+// bit-exact with kissfft: its high precision transforms scale each stage only
+// as far as needed and then rescale to the fixed 1 / fft_length of kissfft,
+// so they round differently.
+//
+// Host build, from the component directory, with stand-ins for the IDF
+// headers dl_fft includes (esp_attr.h, esp_err.h, esp_heap_caps.h, esp_log.h)
+// in $STUBS and DL_FFT=../../managed_components/espressif__dl_fft:
+//   g++ -std=c++17 -I$STUBS -I. -Ithird_party/kissfft \
+//     -I$DL_FFT -I$DL_FFT/base -I$DL_FFT/base/isa \
+//     signal/src/esp/rfft_int16_test.cc \
+//     signal/src/esp/{dl_rfft_state,rfft_int16,irfft_int16}.cc \
+//     signal/src/kiss_fft_wrappers/kiss_fft_int16.cc \
+//     tensorflow/lite/micro/{micro_log,debug_log,system_setup}.cc \
+//     -x c $DL_FFT/{dl_fft_f32,dl_fft_s16}.c \
+//     $DL_FFT/{dl_rfft_f32,dl_rfft_s16}.c \
+//     $DL_FFT/base/{dl_fft_base,dl_fft{2r_fc32,4r_fc32,2r_sc16}_ansi}.c \
+//     -lm -o rfft_int16_test
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <algorithm>
+
+#include "signal/src/complex.h"
+#include "signal/src/irfft.h"
+#include "signal/src/kiss_fft_wrappers/kiss_fft_int16.h"
+#include "signal/src/rfft.h"
+#include "tensorflow/lite/micro/testing/micro_test.h"
+
+namespace {
+
+constexpr int kMaxFftLength = 1024;
+constexpr int kNumRuns = 20;
+// Largest difference to kissfft in LSB.
+constexpr int kRfftTolerance = 4;
+constexpr int kIrfftTolerance = 5;
+
+// Deterministic inputs, full scale or small values that exercise the rounding
+// of the scaled stages.
+uint32_t random_state = 1;
+int16_t RandomInt16(int amplitude) {
+  random_state = random_state * 1664525u + 1013904223u;
+  return static_cast<int16_t>(static_cast<int32_t>(random_state >> 16) %
+                                  (2 * amplitude + 1) -
+                              amplitude);
+}
+
+alignas(16) uint8_t esp_state[16 * 1024];
+alignas(16) uint8_t kiss_state[16 * 1024];
+int16_t signal_data[kMaxFftLength];
+int16_t expected_signal[kMaxFftLength];
+Complex<int16_t> spectrum[kMaxFftLength / 2 + 1];
+Complex<int16_t> expected_spectrum[kMaxFftLength / 2 + 1];
+
+int MaxDiff(const int16_t* a, const int16_t* b, int length) {
+  int max_diff = 0;
+  for (int i = 0; i < length; i++) {
+    max_diff = std::max(max_diff, abs(a[i] - b[i]));
+  }
+  return max_diff;
+}
+
+void TestRfft(int fft_length, int amplitude, int tolerance) {
+  TF_LITE_MICRO_EXPECT_LE(tflm_signal::RfftInt16GetNeededMemory(fft_length),
+                          sizeof(esp_state));
+  void* state =
+      tflm_signal::RfftInt16Init(fft_length, esp_state, sizeof(esp_state));
+  size_t kiss_size = sizeof(kiss_state);
+  kiss_fft_fixed16::kiss_fftr_cfg kiss_cfg = kiss_fft_fixed16::kiss_fftr_alloc(
+      fft_length, 0, kiss_state, &kiss_size);
+  TF_LITE_MICRO_EXPECT(state != nullptr);
+  TF_LITE_MICRO_EXPECT(kiss_cfg != nullptr);
+
+  const int num_values = (fft_length / 2 + 1) * 2;
+  for (int run = 0; run < kNumRuns; run++) {
+    for (int i = 0; i < fft_length; i++) {
+      signal_data[i] = RandomInt16(amplitude);
+    }
+    tflm_signal::RfftInt16Apply(state, signal_data, spectrum);
+    kiss_fft_fixed16::kiss_fftr(
+        kiss_cfg, signal_data,
+        reinterpret_cast<kiss_fft_fixed16::kiss_fft_cpx*>(expected_spectrum));
+    TF_LITE_MICRO_EXPECT_LE(
+        MaxDiff(reinterpret_cast<int16_t*>(spectrum),
+                reinterpret_cast<int16_t*>(expected_spectrum), num_values),
+        tolerance);
+  }
+}
+
+void TestIrfft(int fft_length, int amplitude, int tolerance) {
+  TF_LITE_MICRO_EXPECT_LE(
+      tflite::tflm_signal::IrfftInt16GetNeededMemory(fft_length),
+      sizeof(esp_state));
+  void* state = tflite::tflm_signal::IrfftInt16Init(fft_length, esp_state,
+                                                    sizeof(esp_state));
+  size_t kiss_size = sizeof(kiss_state);
+  kiss_fft_fixed16::kiss_fftr_cfg kiss_cfg = kiss_fft_fixed16::kiss_fftr_alloc(
+      fft_length, 1, kiss_state, &kiss_size);
+  TF_LITE_MICRO_EXPECT(state != nullptr);
+  TF_LITE_MICRO_EXPECT(kiss_cfg != nullptr);
+
+  for (int run = 0; run < kNumRuns; run++) {
+    // Spectrum of a real signal: real DC and Nyquist bins. Full scale bins
+    // overflow the first stage of both kissfft and dl_fft, so half scale is
+    // the largest amplitude compared.
+    for (int i = 0; i <= fft_length / 2; i++) {
+      spectrum[i].real = RandomInt16(amplitude);
+      spectrum[i].imag = RandomInt16(amplitude);
+    }
+    spectrum[0].imag = 0;
+    spectrum[fft_length / 2].imag = 0;
+    tflite::tflm_signal::IrfftInt16Apply(state, spectrum, signal_data);
+    kiss_fft_fixed16::kiss_fftri(
+        kiss_cfg,
+        reinterpret_cast<const kiss_fft_fixed16::kiss_fft_cpx*>(spectrum),
+        expected_signal);
+    TF_LITE_MICRO_EXPECT_LE(MaxDiff(signal_data, expected_signal, fft_length),
+                            tolerance);
+  }
+}
+
+}  // namespace
+
+TF_LITE_MICRO_TESTS_BEGIN
+
+TF_LITE_MICRO_TEST(RfftInt16MatchesKissFft) {
+  for (int fft_length = 8; fft_length <= kMaxFftLength; fft_length *= 2) {
+    TestRfft(fft_length, 32767, kRfftTolerance);
+    TestRfft(fft_length, 64, kRfftTolerance);
+  }
+}
+
+TF_LITE_MICRO_TEST(IrfftInt16MatchesKissFft) {
+  for (int fft_length = 8; fft_length <= kMaxFftLength; fft_length *= 2) {
+    TestIrfft(fft_length, 16383, kIrfftTolerance);
+    TestIrfft(fft_length, 64, kIrfftTolerance);
+  }
+}
+
+TF_LITE_MICRO_TEST(OtherLengthsRunKissFft) {
+  // dl_fft only takes powers of two, other lengths give the kissfft result.
+  TestRfft(12, 32767, 0);
+  TestIrfft(12, 16383, 0);
+}
+
+TF_LITE_MICRO_TESTS_END
@@ -24,7 +24,8 @@ NonPersistentArenaBufferAllocator::NonPersistentArenaBufferAllocator(
     : buffer_head_(buffer),
       buffer_tail_(buffer + buffer_size),
       head_temp_(buffer),
-      next_temp_(buffer) {}
+      next_temp_(buffer),
+      max_next_temp_(buffer) {}
 
 NonPersistentArenaBufferAllocator::~NonPersistentArenaBufferAllocator() {}
 
@@ -41,6 +42,9 @@ uint8_t* NonPersistentArenaBufferAllocator::AllocateTemp(size_t size,
     return nullptr;
   }
   next_temp_ = aligned_result + size;
+  if (max_next_temp_ < next_temp_) {
+    max_next_temp_ = next_temp_;
+  }
   temp_buffer_ptr_check_sum_ ^= reinterpret_cast<intptr_t>(aligned_result);
   temp_buffer_count_++;
   return aligned_result;
@@ -122,6 +126,9 @@ TfLiteStatus NonPersistentArenaBufferAllocator::ResizeBuffer(
   }
   head_temp_ = expect_resizable_buf + size;
   next_temp_ = head_temp_;
+  if (max_next_temp_ < next_temp_) {
+    max_next_temp_ = next_temp_;
+  }
 
   return kTfLiteOk;
 }
@@ -153,9 +160,10 @@ NonPersistentArenaBufferAllocator::ReserveNonPersistentOverlayMemory(
   return ResizeBuffer(expect_resizable_buf, size, alignment);
 }
 
-// Returns the size of non-persistent buffer in use.
+// Returns the size of non-persistent buffer in use. This is the high-water
+// mark, as the arena has to hold the temp buffers of the allocation stage too.
 size_t NonPersistentArenaBufferAllocator::GetNonPersistentUsedBytes() const {
-  return (next_temp_ - buffer_head_);
+  return (max_next_temp_ - buffer_head_);
 }
 
 // Returns the number of bytes available with a given alignment. This number
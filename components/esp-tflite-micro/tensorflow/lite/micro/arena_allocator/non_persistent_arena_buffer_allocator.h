@@ -67,7 +67,8 @@ class NonPersistentArenaBufferAllocator : public INonPersistentBufferAllocator {
   TfLiteStatus ReserveNonPersistentOverlayMemory(size_t size,
                                                  size_t alignment) override;
 
-  // Returns the size of non-persistent buffer in use.
+  // Returns the size of non-persistent buffer in use, as a high-water mark
+  // that includes the temp buffers of the allocation stage.
   size_t GetNonPersistentUsedBytes() const override;
 
   // Returns the number of bytes available with a given alignment. This number
@@ -90,6 +91,9 @@ class NonPersistentArenaBufferAllocator : public INonPersistentBufferAllocator {
   // its range is between head_temp_ and buffer_tail_
   uint8_t* next_temp_;
 
+  // Highest value next_temp_ had so far.
+  uint8_t* max_next_temp_;
+
   // XOR Check sum for outstanding temp buffers.
   // If all temp buffers are deallocated OR no temp buffers are allocated,
   // temp_buffer_ptr_check_sum_ == nullptr.
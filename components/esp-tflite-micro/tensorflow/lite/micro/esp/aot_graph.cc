@@ -0,0 +1,543 @@
+/* Copyright 2025 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/lite/micro/esp/aot_graph.h"
+
+#include <string.h>
+
+#include "tensorflow/lite/micro/memory_helpers.h"
+#include "tensorflow/lite/micro/micro_arena_constants.h"
+#include "tensorflow/lite/micro/micro_log.h"
+
+namespace tflite {
+
+namespace {
+
+// Same limit as MicroAllocator.
+constexpr int kMaxScratchBuffersPerOp = 12;
+
+class AotBuiltinDataAllocator : public TfLiteBridgeBuiltinDataAllocator {
+ public:
+  explicit AotBuiltinDataAllocator(IPersistentBufferAllocator* allocator)
+      : allocator_(allocator) {}
+
+  void* Allocate(size_t size, size_t alignment_hint) override {
+    return allocator_->AllocatePersistentBuffer(size, alignment_hint);
+  }
+  // Builtin data lives as long as the graph.
+  void Deallocate(void* data) override {}
+
+ private:
+  IPersistentBufferAllocator* allocator_;
+
+  TF_LITE_REMOVE_VIRTUAL_DELETE
+};
+
+const char* OpName(const TFLMRegistration* registration) {
+  if (registration->builtin_code == BuiltinOperator_CUSTOM) {
+    return registration->custom_name;
+  }
+  return EnumNameBuiltinOperator(
+      static_cast<BuiltinOperator>(registration->builtin_code));
+}
+
+}  // namespace
+
+void* AotContext::AllocatePersistentBuffer(size_t bytes) {
+  return graph_->allocator_.AllocatePersistentBuffer(
+      bytes, MicroArenaBufferAlignment());
+}
+
+TfLiteStatus AotContext::RequestScratchBufferInArena(size_t bytes,
+                                                     int* buffer_idx) {
+  if (!graph_->preparing_) {
+    MicroPrintf("Scratch buffers can only be requested in Prepare()");
+    return kTfLiteError;
+  }
+  if (graph_->op_scratch_buffer_count_ >= kMaxScratchBuffersPerOp) {
+    MicroPrintf("Scratch buffer request exeeds limit per operator (%d)",
+                kMaxScratchBuffersPerOp);
+    return kTfLiteError;
+  }
+  // The buffers of one op are laid out back to back; all ops share the same
+  // region, so it only has to hold the largest set.
+  int32_t* offsets = reinterpret_cast<int32_t*>(
+      graph_->head_ + graph_->aot_model_.activation_size);
+  offsets[graph_->scratch_buffer_count_] =
+      static_cast<int32_t>(graph_->op_scratch_size_);
+  graph_->op_scratch_size_ +=
+      AlignSizeUp(bytes, MicroArenaBufferAlignment());
+  if (graph_->op_scratch_size_ > graph_->scratch_size_) {
+    graph_->scratch_size_ = graph_->op_scratch_size_;
+  }
+  *buffer_idx = graph_->scratch_buffer_count_++;
+  ++graph_->op_scratch_buffer_count_;
+  return kTfLiteOk;
+}
+
+void* AotContext::GetScratchBuffer(int buffer_idx) {
+  if (graph_->scratch_buffers_ == nullptr || buffer_idx < 0 ||
+      buffer_idx >= graph_->scratch_buffer_count_) {
+    return nullptr;
+  }
+  return graph_->scratch_buffers_[buffer_idx];
+}
+
+TfLiteTensor* AotContext::AllocateTempTfLiteTensor(int tensor_idx) {
+  TfLiteTensor* tensor = nullptr;
+  if (graph_->InitTfLiteTensor(tensor_idx, /*allocate_temp=*/true, &tensor) !=
+      kTfLiteOk) {
+    return nullptr;
+  }
+  return tensor;
+}
+
+void AotContext::DeallocateTempTfLiteTensor(TfLiteTensor* tensor) {
+  // The quantization parameters share the allocation of the tensor.
+  graph_->allocator_.DeallocateTemp(reinterpret_cast<uint8_t*>(tensor));
+}
+
+uint8_t* AotContext::AllocateTempBuffer(size_t size, size_t alignment) {
+  return graph_->allocator_.AllocateTemp(size, alignment);
+}
+
+void AotContext::DeallocateTempBuffer(uint8_t* buffer) {
+  graph_->allocator_.DeallocateTemp(buffer);
+}
+
+TfLiteEvalTensor* AotContext::GetEvalTensor(int tensor_idx) {
+  return &graph_->eval_tensors_[tensor_idx];
+}
+
+TfLiteStatus AotContext::set_external_context(void* external_context_payload) {
+  if (external_context_payload == nullptr ||
+      external_context_payload_ != nullptr) {
+    MicroPrintf(
+        "Attempting to set external context to %x but it was %x already",
+        external_context_payload, external_context_payload_);
+    return kTfLiteError;
+  }
+  external_context_payload_ = external_context_payload;
+  return kTfLiteOk;
+}
+
+MicroGraph& AotContext::graph() { return *graph_; }
+
+AotGraph::AotGraph(const AotModel& aot_model, const Model* model,
+                   uint8_t* tensor_arena, size_t arena_size)
+    : aot_model_(aot_model),
+      model_(model),
+      allocator_(tensor_arena, arena_size),
+      context_impl_(this) {
+  context_.impl_ = static_cast<void*>(&context_impl_);
+  context_.ReportError = MicroContextReportOpError;
+  context_.GetTensor = MicroContextGetTensor;
+  context_.GetEvalTensor = MicroContextGetEvalTensor;
+  context_.RequestScratchBufferInArena =
+      MicroContextRequestScratchBufferInArena;
+  context_.GetExternalContext = MicroContextGetExternalContext;
+  context_.AllocatePersistentBuffer = MicroContextAllocatePersistentBuffer;
+  context_.GetScratchBuffer = MicroContextGetScratchBuffer;
+}
+
+AotGraph::~AotGraph() {
+  if (nodes_ == nullptr) {
+    return;
+  }
+  for (int i = 0; i < aot_model_.op_count; ++i) {
+    const TFLMRegistration* registration = nodes_[i].registration;
+    if (registration != nullptr && registration->free != nullptr) {
+      registration->free(&context_, nodes_[i].node.user_data);
+    }
+  }
+}
+
+const TfLiteIntArray* AotGraph::IntArray(int32_t index) const {
+  return reinterpret_cast<const TfLiteIntArray*>(aot_model_.ints + index);
+}
+
+uint8_t* AotGraph::TensorData(const AotTensor& tensor) const {
+  switch (tensor.kind) {
+    case AotTensorKind::kConstant:
+      return const_cast<uint8_t*>(reinterpret_cast<const uint8_t*>(model_)) +
+             tensor.offset;
+    case AotTensorKind::kActivation:
+    case AotTensorKind::kVariable:
+      return head_ + tensor.offset;
+    default:
+      return nullptr;
+  }
+}
+
+TfLiteStatus AotGraph::InitTfLiteTensor(int tensor_idx, bool allocate_temp,
+                                        TfLiteTensor** result) {
+  const AotTensor& src = aot_model_.tensors[tensor_idx];
+  const bool quantized = src.zero_points >= 0;
+
+  // The tensor and its TfLiteAffineQuantization are allocated together, so a
+  // temp tensor is released with a single DeallocateTemp().
+  const size_t bytes =
+      sizeof(TfLiteTensor) +
+      (quantized ? sizeof(TfLiteAffineQuantization) : 0);
+  uint8_t* buffer =
+      allocate_temp
+          ? allocator_.AllocateTemp(bytes, alignof(TfLiteTensor))
+          : allocator_.AllocatePersistentBuffer(bytes, alignof(TfLiteTensor));
+  if (buffer == nullptr) {
+    MicroPrintf("Failed to allocate tensor %d", tensor_idx);
+    return kTfLiteError;
+  }
+
+  TfLiteTensor* tensor = reinterpret_cast<TfLiteTensor*>(buffer);
+  *tensor = {};
+  tensor->type = src.type;
+  tensor->is_variable = src.kind == AotTensorKind::kVariable;
+  tensor->data.data = TensorData(src);
+  tensor->allocation_type = src.kind == AotTensorKind::kConstant
+                                ? kTfLiteMmapRo
+                                : kTfLiteArenaRw;
+  tensor->bytes = src.bytes;
+  tensor->dims = const_cast<TfLiteIntArray*>(IntArray(src.dims));
+
+  if (quantized) {
+    const TfLiteIntArray* zero_points = IntArray(src.zero_points);
+    const TfLiteFloatArray* scales = reinterpret_cast<const TfLiteFloatArray*>(
+        reinterpret_cast<const uint8_t*>(model_) + src.scales);
+    tensor->params.scale = scales->data[0];
+    tensor->params.zero_point = zero_points->data[0];
+
+    TfLiteAffineQuantization* quantization =
+        reinterpret_cast<TfLiteAffineQuantization*>(buffer +
+                                                    sizeof(TfLiteTensor));
+    quantization->scale = const_cast<TfLiteFloatArray*>(scales);
+    quantization->zero_point = const_cast<TfLiteIntArray*>(zero_points);
+    quantization->quantized_dimension = src.quantized_dimension;
+    tensor->quantization = {kTfLiteAffineQuantization, quantization};
+  }
+  *result = tensor;
+  return kTfLiteOk;
+}
+
+TfLiteStatus AotGraph::InitEvalTensors() {
+  const auto* subgraphs = model_->subgraphs();
+  if (subgraphs == nullptr || subgraphs->size() != 1) {
+    MicroPrintf("AOT graphs support a single subgraph");
+    return kTfLiteError;
+  }
+  const SubGraph* subgraph = subgraphs->Get(0);
+  if (subgraph->tensors() == nullptr || subgraph->operators() == nullptr ||
+      static_cast<int32_t>(subgraph->tensors()->size()) !=
+          aot_model_.tensor_count ||
+      static_cast<int32_t>(subgraph->operators()->size()) !=
+          aot_model_.op_count) {
+    MicroPrintf("Model does not match its AOT tables");
+    return kTfLiteError;
+  }
+
+  eval_tensors_ =
+      reinterpret_cast<TfLiteEvalTensor*>(allocator_.AllocatePersistentBuffer(
+          sizeof(TfLiteEvalTensor) * aot_model_.tensor_count,
+          alignof(TfLiteEvalTensor)));
+  if (eval_tensors_ == nullptr) {
+    MicroPrintf("Failed to allocate %d eval tensors", aot_model_.tensor_count);
+    return kTfLiteError;
+  }
+
+  const auto* buffers = model_->buffers();
+  for (int32_t i = 0; i < aot_model_.tensor_count; ++i) {
+    const AotTensor& src = aot_model_.tensors[i];
+    TfLiteEvalTensor* tensor = &eval_tensors_[i];
+    tensor->data.data = TensorData(src);
+    tensor->dims = const_cast<TfLiteIntArray*>(IntArray(src.dims));
+    tensor->type = src.type;
+
+    // The baked offsets of the constants double as a check that this is the
+    // model the tables were generated from.
+    if (src.kind == AotTensorKind::kConstant) {
+      const uint32_t buffer_index = subgraph->tensors()->Get(i)->buffer();
+      const Buffer* buffer = buffers != nullptr && buffer_index < buffers->size()
+                                 ? buffers->Get(buffer_index)
+                                 : nullptr;
+      const void* data = buffer != nullptr && buffer->data() != nullptr
+                             ? buffer->data()->data()
+                             : nullptr;
+      if (data != tensor->data.data) {
+        MicroPrintf("Model does not match its AOT tables (tensor %d)", i);
+        return kTfLiteError;
+      }
+    }
+  }
+  return kTfLiteOk;
+}
+
+TfLiteStatus AotGraph::InitNodes() {
+  registrations_ =
+      reinterpret_cast<TFLMRegistration*>(allocator_.AllocatePersistentBuffer(
+          sizeof(TFLMRegistration) * aot_model_.opcode_count,
+          alignof(TFLMRegistration)));
+  nodes_ = reinterpret_cast<NodeAndRegistration*>(
+      allocator_.AllocatePersistentBuffer(
+          sizeof(NodeAndRegistration) * aot_model_.op_count,
+          alignof(NodeAndRegistration)));
+  if (registrations_ == nullptr || nodes_ == nullptr) {
+    MicroPrintf("Failed to allocate %d nodes", aot_model_.op_count);
+    return kTfLiteError;
+  }
+
+  aot_model_.get_registrations(registrations_);
+  for (int32_t i = 0; i < aot_model_.opcode_count; ++i) {
+    registrations_[i].builtin_code = aot_model_.opcodes[i].builtin_code;
+    registrations_[i].custom_name = aot_model_.opcodes[i].custom_name;
+  }
+
+  AotBuiltinDataAllocator builtin_data_allocator(&allocator_);
+  const auto* operators = model_->subgraphs()->Get(0)->operators();
+  for (int32_t i = 0; i < aot_model_.op_count; ++i) {
+    const AotOp& op = aot_model_.ops[i];
+    const AotOpCode& opcode = aot_model_.opcodes[op.opcode];
+    const Operator* flatbuffer_op = operators->Get(i);
+
+    TfLiteNode* node = &nodes_[i].node;
+    *node = {};
+    node->inputs = const_cast<TfLiteIntArray*>(IntArray(op.inputs));
+    node->outputs = const_cast<TfLiteIntArray*>(IntArray(op.outputs));
+    if (op.intermediates >= 0) {
+      node->intermediates =
+          const_cast<TfLiteIntArray*>(IntArray(op.intermediates));
+    }
+    nodes_[i].registration = &registrations_[op.opcode];
+
+    if (opcode.parser == nullptr) {
+      if (flatbuffer_op->custom_options() != nullptr) {
+        node->custom_initial_data = flatbuffer_op->custom_options()->data();
+        node->custom_initial_data_size =
+            flatbuffer_op->custom_options()->size();
+      }
+    } else {
+      void* builtin_data = nullptr;
+      TF_LITE_ENSURE_STATUS(CallBuiltinParseFunction(
+          opcode.parser, flatbuffer_op, &builtin_data_allocator,
+          &builtin_data));
+      node->builtin_data = builtin_data;
+    }
+  }
+
+  for (int32_t i = 0; i < aot_model_.op_count; ++i) {
+    const TFLMRegistration* registration = nodes_[i].registration;
+    TfLiteNode* node = &nodes_[i].node;
+    if (registration->init != nullptr) {
+      const bool custom = registration->builtin_code == BuiltinOperator_CUSTOM;
+      node->user_data = registration->init(
+          &context_,
+          custom ? reinterpret_cast<const char*>(node->custom_initial_data)
+                 : reinterpret_cast<const char*>(node->builtin_data),
+          custom ? node->custom_initial_data_size : 0);
+    }
+  }
+  return kTfLiteOk;
+}
+
+TfLiteStatus AotGraph::PrepareNodes() {
+  preparing_ = true;
+  for (int32_t i = 0; i < aot_model_.op_count; ++i) {
+    const TFLMRegistration* registration = nodes_[i].registration;
+    op_scratch_buffer_count_ = 0;
+    op_scratch_size_ = 0;
+    if (registration->prepare != nullptr &&
+        registration->prepare(&context_, &nodes_[i].node) != kTfLiteOk) {
+      MicroPrintf("Node %s (number %d) failed to prepare", OpName(registration),
+                  i);
+      preparing_ = false;
+      return kTfLiteError;
+    }
+    TF_LITE_ENSURE_STATUS(allocator_.ResetTempAllocations());
+    // Leave room after the offsets recorded so far for the next op.
+    TF_LITE_ENSURE_STATUS(allocator_.ResizeBuffer(
+        head_,
+        aot_model_.activation_size +
+            sizeof(int32_t) * (scratch_buffer_count_ + kMaxScratchBuffersPerOp),
+        MicroArenaBufferAlignment()));
+  }
+  preparing_ = false;
+  return kTfLiteOk;
+}
+
+TfLiteStatus AotGraph::CommitScratchBuffers() {
+  if (scratch_buffer_count_ > 0) {
+    scratch_buffers_ =
+        reinterpret_cast<uint8_t**>(allocator_.AllocatePersistentBuffer(
+            sizeof(uint8_t*) * scratch_buffer_count_, alignof(uint8_t*)));
+    if (scratch_buffers_ == nullptr) {
+      MicroPrintf("Failed to allocate %d scratch buffer handles",
+                  scratch_buffer_count_);
+      return kTfLiteError;
+    }
+    // The offsets are read before the head grows over them.
+    uint8_t* scratch = head_ + aot_model_.activation_size;
+    const int32_t* offsets = reinterpret_cast<const int32_t*>(scratch);
+    for (int i = 0; i < scratch_buffer_count_; ++i) {
+      scratch_buffers_[i] = scratch + offsets[i];
+    }
+  }
+  return allocator_.ResizeBuffer(head_,
+                                 aot_model_.activation_size + scratch_size_,
+                                 MicroArenaBufferAlignment());
+}
+
+TfLiteStatus AotGraph::AllocateTensors() {
+  if (tensors_allocated_) {
+    return kTfLiteOk;
+  }
+  head_ = allocator_.AllocateResizableBuffer(
+      aot_model_.activation_size + sizeof(int32_t) * kMaxScratchBuffersPerOp,
+      MicroArenaBufferAlignment());
+  if (head_ == nullptr) {
+    MicroPrintf("Arena too small for %d bytes of activations",
+                aot_model_.activation_size);
+    return kTfLiteError;
+  }
+
+  TF_LITE_ENSURE_STATUS(InitEvalTensors());
+  TF_LITE_ENSURE_STATUS(InitNodes());
+  TF_LITE_ENSURE_STATUS(PrepareNodes());
+  TF_LITE_ENSURE_STATUS(CommitScratchBuffers());
+
+  const TfLiteIntArray* inputs = IntArray(aot_model_.inputs);
+  const TfLiteIntArray* outputs = IntArray(aot_model_.outputs);
+  input_tensors_ =
+      reinterpret_cast<TfLiteTensor**>(allocator_.AllocatePersistentBuffer(
+          sizeof(TfLiteTensor*) * inputs->size, alignof(TfLiteTensor*)));
+  output_tensors_ =
+      reinterpret_cast<TfLiteTensor**>(allocator_.AllocatePersistentBuffer(
+          sizeof(TfLiteTensor*) * outputs->size, alignof(TfLiteTensor*)));
+  if (input_tensors_ == nullptr || output_tensors_ == nullptr) {
+    MicroPrintf("Failed to allocate the input and output tensors");
+    return kTfLiteError;
+  }
+  for (int i = 0; i < inputs->size; ++i) {
+    TF_LITE_ENSURE_STATUS(InitTfLiteTensor(
+        inputs->data[i], /*allocate_temp=*/false, &input_tensors_[i]));
+  }
+  for (int i = 0; i < outputs->size; ++i) {
+    TF_LITE_ENSURE_STATUS(InitTfLiteTensor(
+        outputs->data[i], /*allocate_temp=*/false, &output_tensors_[i]));
+  }
+
+  tensors_allocated_ = true;
+  return Reset();
+}
+
+TfLiteStatus AotGraph::Invoke() {
+  if (!tensors_allocated_) {
+    TF_LITE_ENSURE_STATUS(AllocateTensors());
+  }
+  const int32_t op_count = aot_model_.op_count;
+  NodeAndRegistration* nodes = nodes_;
+  for (int32_t i = 0; i < op_count; ++i) {
+    const TfLiteStatus status =
+        nodes[i].registration->invoke(&context_, &nodes[i].node);
+    if (status != kTfLiteOk) {
+      if (status != kTfLiteAbort) {
+        MicroPrintf("Node %s (number %d) failed to invoke with status %d",
+                    OpName(nodes[i].registration), i, status);
+      }
+      allocator_.ResetTempAllocations();
+      return status;
+    }
+  }
+  // Kernels rarely allocate temp memory in Eval(); release it once per
+  // Invoke() rather than after every op.
+  return allocator_.ResetTempAllocations();
+}
+
+TfLiteStatus AotGraph::Reset() {
+  if (!tensors_allocated_) {
+    return kTfLiteError;
+  }
+  for (int32_t i = 0; i < aot_model_.op_count; ++i) {
+    const TFLMRegistration* registration = nodes_[i].registration;
+    if (registration->reset != nullptr) {
+      registration->reset(&context_, nodes_[i].node.user_data);
+    }
+  }
+  for (int32_t i = 0; i < aot_model_.tensor_count; ++i) {
+    const AotTensor& tensor = aot_model_.tensors[i];
+    if (tensor.kind != AotTensorKind::kVariable) {
+      continue;
+    }
+    int value = 0;
+    if (tensor.type == kTfLiteInt8 && tensor.zero_points >= 0) {
+      value = IntArray(tensor.zero_points)->data[0];
+    }
+    memset(head_ + tensor.offset, value, tensor.bytes);
+  }
+  return kTfLiteOk;
+}
+
+TfLiteTensor* AotGraph::input(size_t index) {
+  if (input_tensors_ == nullptr || index >= inputs_size()) {
+    MicroPrintf("Input index %d out of range (length is %d)", index,
+                inputs_size());
+    return nullptr;
+  }
+  return input_tensors_[index];
+}
+
+TfLiteTensor* AotGraph::output(size_t index) {
+  if (output_tensors_ == nullptr || index >= outputs_size()) {
+    MicroPrintf("Output index %d out of range (length is %d)", index,
+                outputs_size());
+    return nullptr;
+  }
+  return output_tensors_[index];
+}
+
+size_t AotGraph::inputs_size() const {
+  return IntArray(aot_model_.inputs)->size;
+}
+
+size_t AotGraph::outputs_size() const {
+  return IntArray(aot_model_.outputs)->size;
+}
+
+size_t AotGraph::arena_used_bytes() const {
+  return allocator_.GetUsedBytes();
+}
+
+TfLiteStatus AotGraph::InvokeSubgraph(int subgraph_idx) {
+  if (subgraph_idx != 0) {
+    MicroPrintf("Accessing subgraph %d but only 1 subgraph found",
+                subgraph_idx);
+    return kTfLiteError;
+  }
+  return Invoke();
+}
+
+size_t AotGraph::NumSubgraphInputs(int subgraph_idx) { return inputs_size(); }
+
+TfLiteEvalTensor* AotGraph::GetSubgraphInput(int subgraph_idx, int input_idx) {
+  return &eval_tensors_[IntArray(aot_model_.inputs)->data[input_idx]];
+}
+
+size_t AotGraph::NumSubgraphOutputs(int subgraph_idx) {
+  return outputs_size();
+}
+
+TfLiteEvalTensor* AotGraph::GetSubgraphOutput(int subgraph_idx,
+                                              int output_idx) {
+  return &eval_tensors_[IntArray(aot_model_.outputs)->data[output_idx]];
+}
+
+}  // namespace tflite
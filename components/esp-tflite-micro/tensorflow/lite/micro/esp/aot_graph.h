@@ -0,0 +1,241 @@
+/* Copyright 2025 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_MICRO_ESP_AOT_GRAPH_H_
+#define TENSORFLOW_LITE_MICRO_ESP_AOT_GRAPH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "tensorflow/lite/c/common.h"
+#include "tensorflow/lite/micro/arena_allocator/single_arena_buffer_allocator.h"
+#include "tensorflow/lite/micro/compatibility.h"
+#include "tensorflow/lite/micro/micro_allocator.h"
+#include "tensorflow/lite/micro/micro_common.h"
+#include "tensorflow/lite/micro/micro_context.h"
+#include "tensorflow/lite/micro/micro_graph.h"
+#include "tensorflow/lite/micro/tflite_bridge/flatbuffer_conversions_bridge.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+
+namespace tflite {
+
+// Where the data of an AotTensor lives.
+enum class AotTensorKind : uint8_t {
+  // Not used by any operator nor as graph input or output.
+  kUnused,
+  // Read-only data in the model flatbuffer.
+  kConstant,
+  // Activation in the tensor arena, shared with tensors of disjoint lifetime.
+  kActivation,
+  // Variable tensor in the tensor arena, never shared.
+  kVariable,
+};
+
+// Tensor of an ahead-of-time compiled model.
+struct AotTensor {
+  // kConstant: byte offset of the data from the root table of the model.
+  // kActivation, kVariable: byte offset from the start of the tensor arena.
+  int32_t offset;
+  int32_t bytes;
+  // Shape, laid out as a TfLiteIntArray in AotModel::ints.
+  int32_t dims;
+  // Zero points, laid out as a TfLiteIntArray in AotModel::ints, or -1 if the
+  // tensor is not quantized.
+  int32_t zero_points;
+  // Byte offset from the root table of the model of the scales. As in
+  // MicroAllocator, the flatbuffer vector is used as a TfLiteFloatArray.
+  int32_t scales;
+  int32_t quantized_dimension;
+  TfLiteType type;
+  AotTensorKind kind;
+};
+
+// Operator code of an ahead-of-time compiled model.
+struct AotOpCode {
+  int32_t builtin_code;
+  // Name of a custom op, nullptr for builtin ops.
+  const char* custom_name;
+  // Parser of the builtin options, nullptr for custom ops.
+  TfLiteBridgeBuiltinParseFunction parser;
+};
+
+// Operator of an ahead-of-time compiled model, in execution order. The tensor
+// lists are TfLiteIntArrays in AotModel::ints; `intermediates` is -1 if the
+// operator has none.
+struct AotOp {
+  int32_t opcode;
+  int32_t inputs;
+  int32_t outputs;
+  int32_t intermediates;
+};
+
+// Model compiled ahead of time by tools/gen_aot_model.py. All fields are
+// constant, so the generated tables stay in flash.
+struct AotModel {
+  int32_t tensor_count;
+  const AotTensor* tensors;
+  int32_t op_count;
+  const AotOp* ops;
+  int32_t opcode_count;
+  const AotOpCode* opcodes;
+  // Stores the registration of each operator code into `registrations`.
+  void (*get_registrations)(TFLMRegistration* registrations);
+  const int32_t* ints;
+  // Graph inputs and outputs, as TfLiteIntArrays in `ints`.
+  int32_t inputs;
+  int32_t outputs;
+  // Bytes at the start of the tensor arena holding the activation and
+  // variable tensors. A multiple of MicroArenaBufferAlignment().
+  int32_t activation_size;
+};
+
+class AotGraph;
+
+// MicroContext of an AotGraph. Kernels reach it through
+// GetMicroContext(context) exactly as with MicroInterpreter.
+class AotContext : public MicroContext {
+ public:
+  explicit AotContext(AotGraph* graph) : graph_(graph) {}
+
+  void* AllocatePersistentBuffer(size_t bytes) override;
+  TfLiteStatus RequestScratchBufferInArena(size_t bytes,
+                                           int* buffer_idx) override;
+  void* GetScratchBuffer(int buffer_idx) override;
+  TfLiteTensor* AllocateTempTfLiteTensor(int tensor_idx) override;
+  void DeallocateTempTfLiteTensor(TfLiteTensor* tensor) override;
+  uint8_t* AllocateTempBuffer(size_t size, size_t alignment) override;
+  void DeallocateTempBuffer(uint8_t* buffer) override;
+  TfLiteEvalTensor* GetEvalTensor(int tensor_idx) override;
+  TfLiteStatus set_external_context(void* external_context_payload) override;
+  void* external_context() override { return external_context_payload_; }
+  MicroGraph& graph() override;
+
+#ifdef USE_TFLM_COMPRESSION
+  // Compressed models are rejected by the generator.
+  bool IsTensorCompressed(const TfLiteNode* node, int tensor_idx) override {
+    return false;
+  }
+  int AllocateDecompressionScratchBuffer(const TfLiteNode* node,
+                                         int tensor_idx) override {
+    return -1;
+  }
+  const CompressionTensorData* GetTensorCompressionData(
+      const TfLiteNode* node, int tensor_idx) override {
+    return nullptr;
+  }
+#endif  // USE_TFLM_COMPRESSION
+
+ private:
+  AotGraph* graph_;
+  void* external_context_payload_ = nullptr;
+
+  TF_LITE_REMOVE_VIRTUAL_DELETE
+};
+
+// Runs a model compiled ahead of time by tools/gen_aot_model.py, in place of
+// MicroInterpreter.
+//
+// The generator bakes the tensor shapes, types, quantization parameters and
+// the arena offsets of the activations into constant tables, so neither the
+// flatbuffer walk nor the memory planner of MicroAllocator runs on the
+// target. AllocateTensors() still runs Init() and Prepare() of every kernel
+// once, since the op data depends on the kernels and Kconfig options the
+// image is built with. Invoke() is then a plain loop over the prepared nodes:
+// no profiler scopes, no per-op bookkeeping and no temp resets between ops.
+//
+// The model flatbuffer must be the one the tables were generated from; it
+// still provides the weights and the builtin options. Only models with a
+// single subgraph and no resource variables are supported.
+class AotGraph : public MicroGraph {
+ public:
+  AotGraph(const AotModel& aot_model, const Model* model,
+           uint8_t* tensor_arena, size_t arena_size);
+  ~AotGraph();
+
+  // Prepares all kernels and lays out their scratch buffers after the
+  // activations. Returns an error if `model` is not the one the tables were
+  // generated from or the arena is too small.
+  TfLiteStatus AllocateTensors();
+
+  // Runs all operators in order.
+  TfLiteStatus Invoke();
+
+  // Resets the kernel states and the variable tensors.
+  TfLiteStatus Reset();
+
+  TfLiteTensor* input(size_t index);
+  TfLiteTensor* output(size_t index);
+  size_t inputs_size() const;
+  size_t outputs_size() const;
+
+  // Bytes of the tensor arena in use, including the alignment of the arena
+  // pointer. Valid after AllocateTensors().
+  size_t arena_used_bytes() const;
+
+  TfLiteStatus SetMicroExternalContext(void* external_context_payload) {
+    return context_impl_.set_external_context(external_context_payload);
+  }
+
+  // MicroGraph. Only subgraph 0 exists.
+  TfLiteStatus InvokeSubgraph(int subgraph_idx) override;
+  size_t NumSubgraphInputs(int subgraph_idx) override;
+  TfLiteEvalTensor* GetSubgraphInput(int subgraph_idx, int input_idx) override;
+  size_t NumSubgraphOutputs(int subgraph_idx) override;
+  TfLiteEvalTensor* GetSubgraphOutput(int subgraph_idx,
+                                      int output_idx) override;
+  int NumSubgraphs() override { return 1; }
+  MicroResourceVariables* GetResourceVariables() override { return nullptr; }
+
+ private:
+  friend class AotContext;
+
+  const TfLiteIntArray* IntArray(int32_t index) const;
+  uint8_t* TensorData(const AotTensor& tensor) const;
+  TfLiteStatus InitTfLiteTensor(int tensor_idx, bool allocate_temp,
+                                TfLiteTensor** result);
+  TfLiteStatus InitEvalTensors();
+  TfLiteStatus InitNodes();
+  TfLiteStatus PrepareNodes();
+  TfLiteStatus CommitScratchBuffers();
+
+  const AotModel& aot_model_;
+  const Model* model_;
+  SingleArenaBufferAllocator allocator_;
+  AotContext context_impl_;
+  TfLiteContext context_ = {};
+
+  // Start of the head of the arena: the activations, then the scratch
+  // buffers. Between Prepare() calls the scratch buffer offsets requested so
+  // far are stored after the activations.
+  uint8_t* head_ = nullptr;
+  TFLMRegistration* registrations_ = nullptr;
+  NodeAndRegistration* nodes_ = nullptr;
+  TfLiteEvalTensor* eval_tensors_ = nullptr;
+  TfLiteTensor** input_tensors_ = nullptr;
+  TfLiteTensor** output_tensors_ = nullptr;
+  uint8_t** scratch_buffers_ = nullptr;
+  int scratch_buffer_count_ = 0;
+  int op_scratch_buffer_count_ = 0;
+  size_t op_scratch_size_ = 0;
+  size_t scratch_size_ = 0;
+  bool preparing_ = false;
+  bool tensors_allocated_ = false;
+
+  TF_LITE_REMOVE_VIRTUAL_DELETE
+};
+
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_MICRO_ESP_AOT_GRAPH_H_
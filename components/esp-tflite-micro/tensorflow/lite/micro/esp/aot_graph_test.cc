@@ -0,0 +1,176 @@
+/* Copyright 2025 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Runs the hello_world and micro_speech example models through AotGraph and
+// MicroInterpreter with the same inputs and checks that the outputs are
+// bit-identical. Both run the same kernels, so any difference comes from the
+// generated tables: a tensor at the wrong arena offset, a wrong shape or
+// quantization parameter, or operators out of order.
+//
+// Host build, from the component directory, with the tables generated into
+// $AOT:
+//   python3 tools/gen_aot_model.py --namespace hello_world_aot \
+//     --model examples/hello_world/main/model.cc \
+//     --output $AOT/hello_world_aot_model.h
+//   python3 tools/gen_aot_model.py --namespace micro_speech_aot \
+//     --model examples/micro_speech/main/model.cc \
+//     --output $AOT/micro_speech_aot_model.h
+//   g++ -std=c++17 -fno-exceptions -fno-rtti -DTF_LITE_STATIC_MEMORY \
+//     -I$AOT -I. -Ithird_party/flatbuffers/include -Ithird_party/gemmlowp \
+//     -Ithird_party/ruy tensorflow/lite/micro/esp/aot_graph_test.cc \
+//     tensorflow/lite/micro/esp/aot_graph.cc \
+//     $(ls tensorflow/lite/micro/*.cc | grep -v _test.cc) \
+//     tensorflow/lite/micro/{arena_allocator,memory_planner}/*.cc \
+//     tensorflow/lite/micro/{kernels,tflite_bridge}/*.cc \
+//     tensorflow/lite/core/api/*.cc tensorflow/lite/core/c/common.cc \
+//     tensorflow/lite/kernels/internal/{,reference/}*.cc \
+//     tensorflow/lite/kernels/kernel_util.cc \
+//     tensorflow/compiler/mlir/lite/schema/schema_utils.cc \
+//     tensorflow/compiler/mlir/lite/core/api/error_reporter.cc \
+//     -o aot_graph_test
+
+#include "tensorflow/lite/micro/esp/aot_graph.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include "hello_world_aot_model.h"
+#include "micro_speech_aot_model.h"
+#include "tensorflow/lite/micro/micro_interpreter.h"
+#include "tensorflow/lite/micro/micro_mutable_op_resolver.h"
+#include "tensorflow/lite/micro/testing/micro_test.h"
+
+// Both examples name their model g_model.
+namespace hello_world_model {
+#include "examples/hello_world/main/model.cc"
+}  // namespace hello_world_model
+namespace micro_speech_model {
+#include "examples/micro_speech/main/model.cc"
+}  // namespace micro_speech_model
+
+namespace {
+
+constexpr size_t kArenaSize = 32 * 1024;
+constexpr int kNumRuns = 10;
+
+alignas(16) uint8_t interpreter_arena[kArenaSize];
+alignas(16) uint8_t aot_arena[kArenaSize];
+
+uint32_t random_state = 1;
+uint32_t RandomUint32() {
+  random_state = random_state * 1664525u + 1013904223u;
+  return random_state;
+}
+
+// Fills a tensor with deterministic values over its whole range; float
+// tensors get values in [-1, 1) so that no NaN reaches the kernels.
+void FillRandom(TfLiteTensor* tensor) {
+  if (tensor->type == kTfLiteFloat32) {
+    float* data = tflite::GetTensorData<float>(tensor);
+    for (size_t i = 0; i < tensor->bytes / sizeof(float); i++) {
+      data[i] = static_cast<int32_t>(RandomUint32()) / 2147483648.f;
+    }
+    return;
+  }
+  for (size_t i = 0; i < tensor->bytes; i++) {
+    tensor->data.uint8[i] = static_cast<uint8_t>(RandomUint32() >> 24);
+  }
+}
+
+void ExpectSameTensor(const TfLiteTensor* expected,
+                      const TfLiteTensor* actual) {
+  TF_LITE_MICRO_EXPECT(expected != nullptr);
+  TF_LITE_MICRO_EXPECT(actual != nullptr);
+  TF_LITE_MICRO_EXPECT_EQ(expected->type, actual->type);
+  TF_LITE_MICRO_EXPECT_EQ(expected->bytes, actual->bytes);
+  TF_LITE_MICRO_EXPECT(TfLiteIntArrayEqual(expected->dims, actual->dims));
+  TF_LITE_MICRO_EXPECT_EQ(expected->params.scale, actual->params.scale);
+  TF_LITE_MICRO_EXPECT_EQ(expected->params.zero_point,
+                          actual->params.zero_point);
+}
+
+template <unsigned int tOpCount>
+void TestMatchesInterpreter(
+    const unsigned char* model_data, const tflite::AotModel& aot_model,
+    tflite::MicroMutableOpResolver<tOpCount>& resolver) {
+  const tflite::Model* model = tflite::GetModel(model_data);
+  tflite::MicroInterpreter interpreter(model, resolver, interpreter_arena,
+                                       kArenaSize);
+  tflite::AotGraph graph(aot_model, model, aot_arena, kArenaSize);
+  TF_LITE_MICRO_EXPECT_EQ(interpreter.AllocateTensors(), kTfLiteOk);
+  TF_LITE_MICRO_EXPECT_EQ(graph.AllocateTensors(), kTfLiteOk);
+  // The AOT graph keeps no allocation info or planner state in the arena.
+  TF_LITE_MICRO_EXPECT_LE(graph.arena_used_bytes(),
+                          interpreter.arena_used_bytes());
+
+  TF_LITE_MICRO_EXPECT_EQ(graph.inputs_size(), interpreter.inputs_size());
+  TF_LITE_MICRO_EXPECT_EQ(graph.outputs_size(), interpreter.outputs_size());
+  for (size_t i = 0; i < graph.inputs_size(); i++) {
+    ExpectSameTensor(interpreter.input(i), graph.input(i));
+  }
+  for (size_t i = 0; i < graph.outputs_size(); i++) {
+    ExpectSameTensor(interpreter.output(i), graph.output(i));
+  }
+  if (micro_test::did_test_fail) {
+    return;
+  }
+
+  for (int run = 0; run < kNumRuns; run++) {
+    for (size_t i = 0; i < graph.inputs_size(); i++) {
+      TfLiteTensor* input = interpreter.input(i);
+      FillRandom(input);
+      memcpy(graph.input(i)->data.raw, input->data.raw, input->bytes);
+    }
+    TF_LITE_MICRO_EXPECT_EQ(interpreter.Invoke(), kTfLiteOk);
+    TF_LITE_MICRO_EXPECT_EQ(graph.Invoke(), kTfLiteOk);
+    for (size_t i = 0; i < graph.outputs_size(); i++) {
+      const TfLiteTensor* expected = interpreter.output(i);
+      TF_LITE_MICRO_EXPECT_EQ(
+          memcmp(expected->data.raw, graph.output(i)->data.raw,
+                 expected->bytes),
+          0);
+    }
+  }
+}
+
+}  // namespace
+
+TF_LITE_MICRO_TESTS_BEGIN
+
+TF_LITE_MICRO_TEST(HelloWorldMatchesInterpreter) {
+  tflite::MicroMutableOpResolver<1> resolver;
+  resolver.AddFullyConnected();
+  TestMatchesInterpreter(hello_world_model::g_model, hello_world_aot::kModel,
+                         resolver);
+}
+
+TF_LITE_MICRO_TEST(MicroSpeechMatchesInterpreter) {
+  tflite::MicroMutableOpResolver<4> resolver;
+  resolver.AddReshape();
+  resolver.AddDepthwiseConv2D();
+  resolver.AddFullyConnected();
+  resolver.AddSoftmax();
+  TestMatchesInterpreter(micro_speech_model::g_model,
+                         micro_speech_aot::kModel, resolver);
+}
+
+TF_LITE_MICRO_TEST(OtherModelIsRejected) {
+  tflite::AotGraph graph(hello_world_aot::kModel,
+                         tflite::GetModel(micro_speech_model::g_model),
+                         aot_arena, kArenaSize);
+  TF_LITE_MICRO_EXPECT_EQ(graph.AllocateTensors(), kTfLiteError);
+}
+
+TF_LITE_MICRO_TESTS_END
@@ -0,0 +1,364 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/lite/micro/esp/arena_plan.h"
+
+#include <new>
+
+#include "tensorflow/lite/micro/arena_allocator/single_arena_buffer_allocator.h"
+#include "tensorflow/lite/micro/compatibility.h"
+#include "tensorflow/lite/micro/memory_helpers.h"
+#include "tensorflow/lite/micro/memory_planner/greedy_memory_planner.h"
+#include "tensorflow/lite/micro/micro_arena_constants.h"
+#include "tensorflow/lite/micro/micro_interpreter.h"
+#include "tensorflow/lite/micro/micro_log.h"
+
+namespace tflite {
+
+namespace {
+
+constexpr uint32_t kArenaPlanMagic = 0x50414654;  // "TFAP"
+
+// Runs the greedy planner and copies the buffers it lays out into a plan.
+class ArenaPlanRecorder : public MicroMemoryPlanner {
+ public:
+  ArenaPlanRecorder(ArenaPlan* plan, int32_t capacity)
+      : plan_(plan), capacity_(capacity) {}
+
+  TfLiteStatus Init(unsigned char* scratch_buffer,
+                    int scratch_buffer_size) override {
+    return greedy_.Init(scratch_buffer, scratch_buffer_size);
+  }
+
+  size_t GetScratchBufferSize(int buffer_count) override {
+    return greedy_.GetScratchBufferSize(buffer_count);
+  }
+
+  TfLiteStatus AddBuffer(int size, int first_time_used,
+                         int last_time_used) override {
+    RecordSize(size);
+    return greedy_.AddBuffer(size, first_time_used, last_time_used);
+  }
+
+  TfLiteStatus AddBuffer(int size, int first_time_used, int last_time_used,
+                         int offline_offset) override {
+    RecordSize(size);
+    return greedy_.AddBuffer(size, first_time_used, last_time_used,
+                             offline_offset);
+  }
+
+  // The allocator asks for this once the offsets are committed, after the
+  // scratch memory of the greedy planner is released, so it is only asked
+  // once and kept.
+  size_t GetMaximumMemorySize() override {
+    maximum_memory_size_ = greedy_.GetMaximumMemorySize();
+    return maximum_memory_size_;
+  }
+
+  int GetBufferCount() override { return greedy_.GetBufferCount(); }
+
+  TfLiteStatus GetOffsetForBuffer(int buffer_index, int* offset) override {
+    TF_LITE_ENSURE_STATUS(greedy_.GetOffsetForBuffer(buffer_index, offset));
+    if (buffer_index < capacity_) {
+      plan_->entries[buffer_index].offset = *offset;
+    }
+    return kTfLiteOk;
+  }
+
+  bool preserves_all_tensors() const override { return false; }
+
+  void PrintMemoryPlan() override { greedy_.PrintMemoryPlan(); }
+
+  int32_t buffer_count() const { return buffer_count_; }
+  size_t maximum_memory_size() const { return maximum_memory_size_; }
+
+ private:
+  void RecordSize(int size) {
+    if (buffer_count_ < capacity_) {
+      plan_->entries[buffer_count_].size = size;
+    }
+    buffer_count_++;
+  }
+
+  GreedyMemoryPlanner greedy_;
+  ArenaPlan* plan_;
+  int32_t capacity_;
+  int32_t buffer_count_ = 0;
+  size_t maximum_memory_size_ = 0;
+
+  TF_LITE_REMOVE_VIRTUAL_DELETE
+};
+
+// Hands out the offsets of a recorded plan, after checking that the
+// allocator asks for the same buffers.
+class ArenaPlanReplayer : public MicroMemoryPlanner {
+ public:
+  explicit ArenaPlanReplayer(const ArenaPlan* plan) : plan_(plan) {}
+
+  TfLiteStatus AddBuffer(int size, int first_time_used,
+                         int last_time_used) override {
+    if (buffer_count_ >= plan_->buffer_count ||
+        size > plan_->entries[buffer_count_].size) {
+      MicroPrintf("Buffer %d of %d bytes does not match the arena plan.",
+                  buffer_count_, size);
+      return kTfLiteError;
+    }
+    buffer_count_++;
+    return kTfLiteOk;
+  }
+
+  // Offline planned offsets were already followed when the plan was
+  // recorded.
+  TfLiteStatus AddBuffer(int size, int first_time_used, int last_time_used,
+                         int offline_offset) override {
+    return AddBuffer(size, first_time_used, last_time_used);
+  }
+
+  size_t GetMaximumMemorySize() override { return plan_->non_persistent_size; }
+
+  size_t GetScratchBufferSize(int buffer_count) override { return 0; }
+
+  int GetBufferCount() override { return buffer_count_; }
+
+  TfLiteStatus GetOffsetForBuffer(int buffer_index, int* offset) override {
+    if (buffer_index < 0 || buffer_index >= buffer_count_) {
+      MicroPrintf("Buffer %d is not in the arena plan.", buffer_index);
+      return kTfLiteError;
+    }
+    *offset = plan_->entries[buffer_index].offset;
+    return kTfLiteOk;
+  }
+
+  bool preserves_all_tensors() const override { return false; }
+
+ private:
+  const ArenaPlan* plan_;
+  int32_t buffer_count_ = 0;
+
+  TF_LITE_REMOVE_VIRTUAL_DELETE
+};
+
+uint32_t HashValue(uint32_t hash, int32_t value) {
+  // FNV-1a over the bytes of the value.
+  for (int i = 0; i < 4; i++) {
+    hash ^= static_cast<uint32_t>(value >> (8 * i)) & 0xff;
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+uint32_t HashVector(uint32_t hash,
+                    const flatbuffers::Vector<int32_t>* vector) {
+  if (vector == nullptr) {
+    return HashValue(hash, -1);
+  }
+  hash = HashValue(hash, vector->size());
+  for (int32_t value : *vector) {
+    hash = HashValue(hash, value);
+  }
+  return hash;
+}
+
+// Hashes what the memory plan depends on: the tensors and how the operators
+// connect them.
+uint32_t HashModel(const Model* model) {
+  uint32_t hash = 2166136261u;
+  if (model->subgraphs() == nullptr) {
+    return hash;
+  }
+  for (const SubGraph* subgraph : *model->subgraphs()) {
+    if (subgraph->tensors() != nullptr) {
+      hash = HashValue(hash, subgraph->tensors()->size());
+      for (const Tensor* tensor : *subgraph->tensors()) {
+        hash = HashValue(hash, tensor->type());
+        hash = HashValue(hash, tensor->is_variable());
+        hash = HashVector(hash, tensor->shape());
+      }
+    }
+    if (subgraph->operators() != nullptr) {
+      hash = HashValue(hash, subgraph->operators()->size());
+      for (const Operator* op : *subgraph->operators()) {
+        hash = HashValue(hash, op->opcode_index());
+        hash = HashVector(hash, op->inputs());
+        hash = HashVector(hash, op->outputs());
+      }
+    }
+  }
+  return hash;
+}
+
+// Creates a MicroAllocator on the arena the way MicroAllocator::Create()
+// does, with a memory planner of type Planner placed in the arena tail.
+template <typename Planner, typename... Args>
+MicroAllocator* CreateAllocator(uint8_t* arena, size_t arena_size,
+                                SingleArenaBufferAllocator** memory_allocator,
+                                Planner** planner, Args... args) {
+  uint8_t* aligned_arena = AlignPointerUp(arena, MicroArenaBufferAlignment());
+  size_t aligned_arena_size = arena + arena_size - aligned_arena;
+  *memory_allocator =
+      SingleArenaBufferAllocator::Create(aligned_arena, aligned_arena_size);
+  uint8_t* planner_buffer = (*memory_allocator)->AllocatePersistentBuffer(
+      sizeof(Planner), alignof(Planner));
+  if (planner_buffer == nullptr) {
+    return nullptr;
+  }
+  *planner = new (planner_buffer) Planner(args...);
+  return MicroAllocator::Create(*memory_allocator, *planner);
+}
+
+// Allocates the model in the first `arena_size` bytes of `arena`, with the
+// greedy planner or the given plan, and reports the arena usage if it fits.
+bool Fits(const Model* model, const MicroOpResolver& op_resolver,
+          uint8_t* arena, size_t arena_size, const ArenaPlan* plan,
+          ArenaRequirements* usage) {
+  SingleArenaBufferAllocator* memory_allocator = nullptr;
+  MicroAllocator* allocator;
+  if (plan != nullptr) {
+    ArenaPlanReplayer* planner;
+    allocator = CreateAllocator(arena, arena_size, &memory_allocator, &planner,
+                                plan);
+  } else {
+    GreedyMemoryPlanner* planner;
+    allocator =
+        CreateAllocator(arena, arena_size, &memory_allocator, &planner);
+  }
+  if (allocator == nullptr) {
+    return false;
+  }
+  MicroInterpreter interpreter(model, op_resolver, allocator);
+  if (interpreter.AllocateTensors() != kTfLiteOk) {
+    return false;
+  }
+  if (usage != nullptr) {
+    usage->persistent_bytes = memory_allocator->GetPersistentUsedBytes();
+    usage->non_persistent_bytes = memory_allocator->GetNonPersistentUsedBytes();
+  }
+  return true;
+}
+
+// Smallest multiple of the arena alignment in [low, high] the model fits in.
+// The model is known to fit in `high` bytes.
+size_t SmallestFit(const Model* model, const MicroOpResolver& op_resolver,
+                   uint8_t* arena, size_t low, size_t high,
+                   const ArenaPlan* plan) {
+  const size_t alignment = MicroArenaBufferAlignment();
+  low = AlignSizeUp(low, alignment);
+  while (low < high) {
+    const size_t mid = low + (high - low) / 2 / alignment * alignment;
+    if (Fits(model, op_resolver, arena, mid, plan, nullptr)) {
+      high = mid;
+    } else {
+      low = mid + alignment;
+    }
+  }
+  return high;
+}
+
+}  // namespace
+
+TfLiteStatus MeasureArena(const Model* model,
+                          const MicroOpResolver& op_resolver,
+                          uint8_t* probe_arena, size_t probe_arena_size,
+                          ArenaRequirements* requirements, ArenaPlan* plan,
+                          size_t plan_size) {
+  TFLITE_DCHECK(requirements != nullptr);
+  *requirements = {};
+
+  // Searching from an aligned arena makes the result independent of where
+  // the probe arena is; the alignment slack is added at the end.
+  const size_t alignment = MicroArenaBufferAlignment();
+  uint8_t* arena = AlignPointerUp(probe_arena, alignment);
+  if (arena >= probe_arena + probe_arena_size) {
+    return kTfLiteError;
+  }
+  const size_t arena_size = probe_arena + probe_arena_size - arena;
+
+  int32_t capacity = 0;
+  if (plan != nullptr && plan_size >= sizeof(ArenaPlan)) {
+    capacity = 1 + (plan_size - sizeof(ArenaPlan)) / sizeof(ArenaPlanEntry);
+  }
+
+  int32_t buffer_count;
+  size_t non_persistent_size;
+  size_t recorded_used_bytes;
+  {
+    SingleArenaBufferAllocator* memory_allocator;
+    ArenaPlanRecorder* recorder;
+    MicroAllocator* allocator =
+        CreateAllocator(arena, arena_size, &memory_allocator, &recorder, plan,
+                        capacity);
+    if (allocator == nullptr) {
+      return kTfLiteError;
+    }
+    MicroInterpreter interpreter(model, op_resolver, allocator);
+    if (interpreter.AllocateTensors() != kTfLiteOk) {
+      MicroPrintf("Model does not fit the probe arena of %u bytes.",
+                  static_cast<unsigned>(probe_arena_size));
+      return kTfLiteError;
+    }
+    buffer_count = recorder->buffer_count();
+    non_persistent_size = recorder->maximum_memory_size();
+    recorded_used_bytes = interpreter.arena_used_bytes();
+  }
+
+  // The recording run only differs from a plain one in the size of its
+  // planner, so no smaller arena can hold the model.
+  const size_t lower_bound = recorded_used_bytes - sizeof(ArenaPlanRecorder);
+  const size_t greedy_size =
+      SmallestFit(model, op_resolver, arena, lower_bound, arena_size, nullptr);
+  if (!Fits(model, op_resolver, arena, greedy_size, nullptr, requirements)) {
+    return kTfLiteError;
+  }
+  requirements->arena_size = greedy_size + alignment - 1;
+  requirements->plan_size = SizeOfArenaPlan(buffer_count);
+
+  if (plan == nullptr) {
+    return kTfLiteOk;
+  }
+  if (buffer_count > capacity) {
+    MicroPrintf("The arena plan needs %u bytes, got %u.",
+                static_cast<unsigned>(requirements->plan_size),
+                static_cast<unsigned>(plan_size));
+    return kTfLiteError;
+  }
+  plan->magic = kArenaPlanMagic;
+  plan->model_hash = HashModel(model);
+  plan->non_persistent_size = non_persistent_size;
+  plan->buffer_count = buffer_count;
+
+  // Without the greedy planner's scratch memory the planned arena can be
+  // smaller.
+  requirements->planned_arena_size =
+      SmallestFit(model, op_resolver, arena, lower_bound, greedy_size, plan) +
+      alignment - 1;
+  return kTfLiteOk;
+}
+
+MicroAllocator* CreatePlannedMicroAllocator(const Model* model,
+                                            const ArenaPlan* plan,
+                                            uint8_t* tensor_arena,
+                                            size_t arena_size) {
+  if (plan == nullptr || plan->magic != kArenaPlanMagic ||
+      plan->model_hash != HashModel(model)) {
+    MicroPrintf("The arena plan was not recorded for this model.");
+    return nullptr;
+  }
+  SingleArenaBufferAllocator* memory_allocator;
+  ArenaPlanReplayer* planner;
+  return CreateAllocator(tensor_arena, arena_size, &memory_allocator, &planner,
+                         plan);
+}
+
+}  // namespace tflite
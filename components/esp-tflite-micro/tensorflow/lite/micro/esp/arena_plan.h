@@ -0,0 +1,105 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_MICRO_ESP_ARENA_PLAN_H_
+#define TENSORFLOW_LITE_MICRO_ESP_ARENA_PLAN_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "tensorflow/lite/c/common.h"
+#include "tensorflow/lite/micro/micro_allocator.h"
+#include "tensorflow/lite/micro/micro_op_resolver.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+
+namespace tflite {
+
+// Tensor arena a model needs, as measured by MeasureArena().
+struct ArenaRequirements {
+  // Smallest tensor_arena_size the interpreter allocates the model in with
+  // the default greedy memory planner. Includes the slack for aligning an
+  // arbitrary arena pointer.
+  size_t arena_size;
+  // Same, for an interpreter whose allocator comes from
+  // CreatePlannedMicroAllocator(). 0 if no plan was requested.
+  size_t planned_arena_size;
+  // Bytes at the tail of the arena that stay allocated for the lifetime of
+  // the interpreter: allocator state, eval tensors, node and op data.
+  size_t persistent_bytes;
+  // Bytes at the head of the arena shared by the activation tensors and the
+  // kernel scratch buffers, as laid out by the memory plan.
+  size_t non_persistent_bytes;
+  // Size of the ArenaPlan of the model, see SizeOfArenaPlan().
+  size_t plan_size;
+};
+
+// Offset and size of one buffer of an ArenaPlan, in the order the allocator
+// adds buffers to its memory planner: activation tensors first, then kernel
+// scratch buffers in the order the kernels request them.
+struct ArenaPlanEntry {
+  int32_t offset;
+  int32_t size;
+};
+
+// Memory plan of a model, as recorded by MeasureArena(). It only has
+// primitive fields, so it can be written to flash or dumped as a C array and
+// given to CreatePlannedMicroAllocator() on later boots, which then skips the
+// greedy planning in AllocateTensors().
+//
+// The plan is only valid for the model and the kernels it was recorded with.
+// The model is checked through `model_hash`; the buffer sizes are checked
+// when the plan is applied, so a plan recorded before a kernel or Kconfig
+// change that alters scratch sizes is rejected.
+struct ArenaPlan {
+  uint32_t magic;
+  uint32_t model_hash;
+  int32_t non_persistent_size;
+  int32_t buffer_count;
+  // Flexible array member, see the same caveat in BufferPlan.
+  ArenaPlanEntry entries[1];
+};
+
+// Size of an ArenaPlan holding `buffer_count` buffers.
+constexpr size_t SizeOfArenaPlan(int32_t buffer_count) {
+  return sizeof(ArenaPlan) +
+         sizeof(ArenaPlanEntry) * (buffer_count > 1 ? buffer_count - 1 : 0);
+}
+
+// Allocates the model in `probe_arena` and reports the smallest arena it
+// needs. The probe arena has to be large enough for the model; it is only
+// used during the call. The interpreter is allocated several times to find
+// the smallest arena, and the attempts that do not fit log allocation errors.
+//
+// If `plan` is not null and `plan_size` bytes are enough for the plan of the
+// model (requirements->plan_size), also records the memory plan into it.
+// Returns an error if the plan does not fit.
+TfLiteStatus MeasureArena(const Model* model,
+                          const MicroOpResolver& op_resolver,
+                          uint8_t* probe_arena, size_t probe_arena_size,
+                          ArenaRequirements* requirements,
+                          ArenaPlan* plan = nullptr, size_t plan_size = 0);
+
+// Creates a MicroAllocator on `tensor_arena` that lays out the activation
+// tensors and scratch buffers as recorded in `plan` instead of running the
+// greedy memory planner. `plan` must outlive the allocator. Returns nullptr
+// if `plan` was not recorded for `model`.
+MicroAllocator* CreatePlannedMicroAllocator(const Model* model,
+                                            const ArenaPlan* plan,
+                                            uint8_t* tensor_arena,
+                                            size_t arena_size);
+
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_MICRO_ESP_ARENA_PLAN_H_
@@ -56,12 +56,23 @@ TfLiteStatus EvalAdd(TfLiteContext* context, TfLiteNode* node,
             tflite::micro::GetTensorShape(output),
             tflite::micro::GetTensorData<float>(output));
       } else {
+#if ESP_NN
+        esp_nn_add_elementwise_f32(tflite::micro::GetTensorData<float>(input1),
+                                   tflite::micro::GetTensorData<float>(input2),
+                                   tflite::micro::GetTensorData<float>(output),
+                                   data->output_activation_min_f32,
+                                   data->output_activation_max_f32,
+                                   MatchingElementsSize(tflite::micro::GetTensorShape(input1),
+                                                        tflite::micro::GetTensorShape(input2),
+                                                        tflite::micro::GetTensorShape(output)));
+#else
         reference_ops::Add(op_params, tflite::micro::GetTensorShape(input1),
                            tflite::micro::GetTensorData<float>(input1),
                            tflite::micro::GetTensorShape(input2),
                            tflite::micro::GetTensorData<float>(input2),
                            tflite::micro::GetTensorShape(output),
                            tflite::micro::GetTensorData<float>(output));
+#endif
       }
     } break;
     case kTfLiteInt32: {
@@ -173,6 +184,31 @@ TfLiteStatus EvalAddQuantized(TfLiteContext* context, TfLiteNode* node,
             tflite::micro::GetTensorShape(output),
             tflite::micro::GetTensorData<int16_t>(output));
       } else {
+#if ESP_NN
+        const int16_t *input1_data = tflite::micro::GetTensorData<int16_t>(input1);
+        const int16_t *input2_data = tflite::micro::GetTensorData<int16_t>(input2);
+        int16_t *out_data = tflite::micro::GetTensorData<int16_t>(output);
+
+        esp_nn_add_elementwise_s16(input1_data,
+                                   input2_data,
+                                   data->input1_offset,
+                                   data->input2_offset,
+                                   data->input1_multiplier,
+                                   data->input2_multiplier,
+                                   data->input1_shift,
+                                   data->input2_shift,
+                                   data->left_shift,
+                                   out_data,
+                                   data->output_offset,
+                                   data->output_multiplier,
+                                   data->output_shift,
+                                   data->output_activation_min,
+                                   data->output_activation_max,
+                                   MatchingElementsSize(tflite::micro::GetTensorShape(input1),
+                                                        tflite::micro::GetTensorShape(input2),
+                                                        tflite::micro::GetTensorShape(output))
+                                   );
+#else
         reference_ops::Add(op_params, tflite::micro::GetTensorShape(input1),
                            tflite::micro::GetTensorData<int16_t>(input1),
                            tflite::micro::GetTensorShape(input2),
@@ -180,6 +216,7 @@ TfLiteStatus EvalAddQuantized(TfLiteContext* context, TfLiteNode* node,
                            tflite::micro::GetTensorShape(output),
                            tflite::micro::GetTensorData<int16_t>(output),
                            false);
+#endif
       }
       break;
     }
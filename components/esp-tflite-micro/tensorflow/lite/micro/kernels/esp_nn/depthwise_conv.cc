@@ -21,9 +21,13 @@ limitations under the License.
 #include "tensorflow/lite/kernels/internal/reference/integer_ops/depthwise_conv.h"
 #include "tensorflow/lite/kernels/internal/tensor_ctypes.h"
 #include "tensorflow/lite/kernels/kernel_util.h"
+#include "tensorflow/lite/micro/kernels/esp_nn/int4_filter.h"
+#include "tensorflow/lite/micro/kernels/esp_nn/parallel.h"
 #include "tensorflow/lite/micro/kernels/kernel_util.h"
 #include "tensorflow/lite/micro/micro_log.h"
 
+#include <algorithm>
+
 #include <esp_timer.h>
 
 #if ESP_NN
@@ -37,8 +41,15 @@ namespace {
 
 struct NodeData {
   OpDataConv op_data;
+  // int4 filter unpacked at Prepare, nullptr to unpack at every Eval.
+  const int8_t* unpacked_filter;
 #if ESP_NN
   int buffer_idx;
+  // Set at Prepare for int8 depthwise convs split by output rows across both
+  // cores, see conv.cc.
+  bool parallel;
+  int worker_buffer_idx;
+  int padded_input_idx;
 #endif
 };
 
@@ -49,11 +60,125 @@ void* Init(TfLiteContext* context, const char* buffer,
 }
 
 #if ESP_NN
+// One image of an int8 depthwise convolution split by output rows, over an
+// input that is already padded.
+struct DepthwiseConvRowsJob {
+  const int8_t* input;
+  int input_height;
+  int input_width;
+  int input_depth;
+  const int8_t* filter;
+  int filter_height;
+  int filter_width;
+  const int32_t* bias;
+  int8_t* output;
+  int output_width;
+  int output_depth;
+  dw_conv_params_t conv_params;
+  quant_data_t quant_data;
+  void* scratch[2];  // esp-nn scratch buffer of each worker
+};
+
+void DepthwiseConvRows(void* arg, int worker, int begin, int end) {
+  const DepthwiseConvRowsJob& job =
+      *static_cast<const DepthwiseConvRowsJob*>(arg);
+  const int first_row = begin * job.conv_params.stride.height;
+  int last_row = (end - 1) * job.conv_params.stride.height + job.filter_height;
+  if (last_row > job.input_height) {
+    last_row = job.input_height;
+  }
+
+  data_dims_t input_dims =  {
+                              .width = job.input_width,
+                              .height = last_row - first_row,
+                              .channels = job.input_depth, .extra = 1
+                            };
+  data_dims_t output_dims = {
+                              .width = job.output_width, .height = end - begin,
+                              .channels = job.output_depth, .extra = 1
+                            };
+  data_dims_t filter_dims = {
+                              .width = job.filter_width,
+                              .height = job.filter_height,
+                              .channels = 0, .extra = 0
+                            };
+  esp_nn_set_depthwise_conv_scratch_buf(job.scratch[worker]);
+  esp_nn_depthwise_conv_s8(
+      &input_dims, job.input + first_row * job.input_width * job.input_depth,
+      &filter_dims, job.filter, job.bias, &output_dims,
+      job.output + begin * job.output_width * job.output_depth,
+      &job.conv_params, &job.quant_data);
+}
+
+// Runs the int8 depthwise convolution of every image on both cores.
+void EvalQuantizedPerChannelParallel(
+    TfLiteContext* context, const NodeData& data, const int8_t* input_data,
+    const data_dims_t& input_dims, const int8_t* filter_data,
+    const data_dims_t& filter_dims, const int32_t* bias_data,
+    int8_t* output_data, const data_dims_t& output_dims, int batch_size,
+    const dw_conv_params_t& conv_params, const quant_data_t& quant_data) {
+  DepthwiseConvRowsJob job;
+  job.input_height = input_dims.height;
+  job.input_width = input_dims.width;
+  job.input_depth = input_dims.channels;
+  job.filter = filter_data;
+  job.filter_height = filter_dims.height;
+  job.filter_width = filter_dims.width;
+  job.bias = bias_data;
+  job.output_width = output_dims.width;
+  job.output_depth = output_dims.channels;
+  job.conv_params = conv_params;
+  job.quant_data = quant_data;
+  job.scratch[0] = data.buffer_idx > -1
+                       ? context->GetScratchBuffer(context, data.buffer_idx)
+                       : nullptr;
+  job.scratch[1] =
+      data.worker_buffer_idx > -1
+          ? context->GetScratchBuffer(context, data.worker_buffer_idx)
+          : nullptr;
+
+  int8_t* padded_input = nullptr;
+  if (data.padded_input_idx > -1) {
+    padded_input = static_cast<int8_t*>(
+        context->GetScratchBuffer(context, data.padded_input_idx));
+    job.input_height = (output_dims.height - 1) * conv_params.stride.height +
+                       filter_dims.height;
+    job.input_width = (output_dims.width - 1) * conv_params.stride.width +
+                      filter_dims.width;
+    job.conv_params.padding = {0, 0};
+  }
+
+  const int input_size =
+      input_dims.width * input_dims.height * input_dims.channels;
+  const int output_size =
+      output_dims.width * output_dims.height * output_dims.channels;
+  const int split_unit = std::max(
+      EspNnAlignedUnit(conv_params.stride.height * job.input_width *
+                       job.input_depth),
+      EspNnAlignedUnit(job.output_width * job.output_depth));
+  const int split = EspNnSplitPoint(output_dims.height, split_unit);
+
+  for (int i_batch = 0; i_batch < batch_size; i_batch++) {
+    job.input = input_data + i_batch * input_size;
+    if (padded_input != nullptr) {
+      EspNnPadInput(job.input, input_dims.height, input_dims.width,
+                    input_dims.channels, conv_params.padding.height,
+                    conv_params.padding.width, job.input_height,
+                    job.input_width,
+                    static_cast<int8_t>(-conv_params.in_offset), padded_input);
+      job.input = padded_input;
+    }
+    job.output = output_data + i_batch * output_size;
+    EspNnParallelFor(DepthwiseConvRows, &job, split, output_dims.height);
+  }
+}
+
 inline void EvalQuantizedPerChannel(TfLiteContext* context, TfLiteNode* node,
                                     const TfLiteDepthwiseConvParams& params,
                                     const NodeData& data,
                                     const TfLiteEvalTensor* input,
                                     const TfLiteEvalTensor* filter,
+                                    const int8_t* filter_data,
                                     const TfLiteEvalTensor* bias,
                                     TfLiteEvalTensor* output) {
   const int dilation_width_factor = params.dilation_width_factor;
@@ -105,12 +230,6 @@ inline void EvalQuantizedPerChannel(TfLiteContext* context, TfLiteNode* node,
 
     const int input_size = input_width * input_height * input_depth;
     const int output_size = output_width * output_height * output_depth;
-    void *scratch_buf = NULL;
-    if (data.buffer_idx > -1) {
-      scratch_buf = context->GetScratchBuffer(context, data.buffer_idx);
-    }
-
-    esp_nn_set_depthwise_conv_scratch_buf(scratch_buf);
 
     data_dims_t input_dims =  {
                                 .width = input_width, .height = input_height,
@@ -136,9 +255,23 @@ inline void EvalQuantizedPerChannel(TfLiteContext* context, TfLiteNode* node,
                                 .mult = data.op_data.per_channel_output_multiplier
                               };
 
+    if (data.parallel) {
+      EvalQuantizedPerChannelParallel(
+          context, data, input_data, input_dims, filter_data, filter_dims,
+          tflite::micro::GetTensorData<int32_t>(bias), output_data,
+          output_dims, batch_size, conv_params, quant_data);
+      return;
+    }
+
+    void *scratch_buf = NULL;
+    if (data.buffer_idx > -1) {
+      scratch_buf = context->GetScratchBuffer(context, data.buffer_idx);
+    }
+    esp_nn_set_depthwise_conv_scratch_buf(scratch_buf);
+
     for (int i_batch = 0; i_batch < batch_size; i_batch++) {
       esp_nn_depthwise_conv_s8(&input_dims, input_data + i_batch * input_size,
-                               &filter_dims, tflite::micro::GetTensorData<int8_t>(filter),
+                               &filter_dims, filter_data,
                                tflite::micro::GetTensorData<int32_t>(bias),
                                &output_dims, output_data + i_batch * output_size,
                                &conv_params, &quant_data);
@@ -150,14 +283,136 @@ inline void EvalQuantizedPerChannel(TfLiteContext* context, TfLiteNode* node,
         data.op_data.per_channel_output_shift,
         tflite::micro::GetTensorShape(input),
         tflite::micro::GetTensorData<int8_t>(input),
-        tflite::micro::GetTensorShape(filter),
-        tflite::micro::GetTensorData<int8_t>(filter),
+        tflite::micro::GetTensorShape(filter), filter_data,
         tflite::micro::GetTensorShape(bias),
         tflite::micro::GetTensorData<int32_t>(bias),
         tflite::micro::GetTensorShape(output),
         tflite::micro::GetTensorData<int8_t>(output));
   }
 }
+
+inline bool EvalQuantizedPerChannel16x8(
+    const TfLiteDepthwiseConvParams& params, const NodeData& data,
+    const TfLiteEvalTensor* input, const TfLiteEvalTensor* filter,
+    const TfLiteEvalTensor* bias, TfLiteEvalTensor* output) {
+  if (params.dilation_width_factor != 1 || params.dilation_height_factor != 1) {
+    return false;
+  }
+  const RuntimeShape input_shape = tflite::micro::GetTensorShape(input);
+  const RuntimeShape filter_shape = tflite::micro::GetTensorShape(filter);
+  const RuntimeShape output_shape = tflite::micro::GetTensorShape(output);
+
+  const int batch_size = MatchingDim(input_shape, 0, output_shape, 0);
+  const int input_height = input_shape.Dims(1);
+  const int input_width = input_shape.Dims(2);
+  const int input_depth = input_shape.Dims(3);
+  const int output_height = output_shape.Dims(1);
+  const int output_width = output_shape.Dims(2);
+  const int output_depth = MatchingDim(filter_shape, 3, output_shape, 3);
+
+  data_dims_t input_dims =  {
+                              .width = input_width, .height = input_height,
+                              .channels = input_depth, .extra = 1
+                            };
+  data_dims_t output_dims = {
+                              .width = output_width, .height = output_height,
+                              .channels = output_depth, .extra = 1
+                            };
+  data_dims_t filter_dims = {
+                              .width = filter_shape.Dims(2),
+                              .height = filter_shape.Dims(1),
+                              .channels = 0, .extra = 0
+                            };
+  dw_conv_params_t conv_params =  {
+                                    .in_offset = 0, .out_offset = 0,
+                                    .ch_mult = params.depth_multiplier,
+                                    .stride = {params.stride_width, params.stride_height},
+                                    .padding = {data.op_data.padding.width,
+                                                data.op_data.padding.height},
+                                    .dilation = {0, 0},
+                                    .activation = {data.op_data.output_activation_min,
+                                                   data.op_data.output_activation_max}
+                                  };
+  quant_data_t quant_data = {
+                              .shift = data.op_data.per_channel_output_shift,
+                              .mult = data.op_data.per_channel_output_multiplier
+                            };
+
+  const int16_t* input_data = tflite::micro::GetTensorData<int16_t>(input);
+  int16_t* output_data = tflite::micro::GetTensorData<int16_t>(output);
+  const int input_size = input_width * input_height * input_depth;
+  const int output_size = output_width * output_height * output_depth;
+
+  for (int i_batch = 0; i_batch < batch_size; i_batch++) {
+    esp_nn_depthwise_conv_s16(&input_dims, input_data + i_batch * input_size,
+                              &filter_dims,
+                              tflite::micro::GetTensorData<int8_t>(filter),
+                              tflite::micro::GetOptionalTensorData<int64_t>(bias),
+                              &output_dims, output_data + i_batch * output_size,
+                              &conv_params, &quant_data);
+  }
+  return true;
+}
+
+inline bool EvalFloat(const TfLiteDepthwiseConvParams& params,
+                      const NodeData& data, const TfLiteEvalTensor* input,
+                      const TfLiteEvalTensor* filter,
+                      const TfLiteEvalTensor* bias, TfLiteEvalTensor* output) {
+  if (params.dilation_width_factor != 1 || params.dilation_height_factor != 1) {
+    return false;
+  }
+  const RuntimeShape input_shape = tflite::micro::GetTensorShape(input);
+  const RuntimeShape filter_shape = tflite::micro::GetTensorShape(filter);
+  const RuntimeShape output_shape = tflite::micro::GetTensorShape(output);
+
+  const int batch_size = MatchingDim(input_shape, 0, output_shape, 0);
+  const int input_height = input_shape.Dims(1);
+  const int input_width = input_shape.Dims(2);
+  const int input_depth = input_shape.Dims(3);
+  const int output_height = output_shape.Dims(1);
+  const int output_width = output_shape.Dims(2);
+  const int output_depth = MatchingDim(filter_shape, 3, output_shape, 3);
+
+  float activation_min, activation_max;
+  CalculateActivationRange(params.activation, &activation_min, &activation_max);
+
+  data_dims_t input_dims =  {
+                              .width = input_width, .height = input_height,
+                              .channels = input_depth, .extra = 1
+                            };
+  data_dims_t output_dims = {
+                              .width = output_width, .height = output_height,
+                              .channels = output_depth, .extra = 1
+                            };
+  data_dims_t filter_dims = {
+                              .width = filter_shape.Dims(2),
+                              .height = filter_shape.Dims(1),
+                              .channels = 0, .extra = 0
+                            };
+  dw_conv_params_f32_t conv_params =  {
+                                        .ch_mult = params.depth_multiplier,
+                                        .stride = {params.stride_width, params.stride_height},
+                                        .padding = {data.op_data.padding.width,
+                                                    data.op_data.padding.height},
+                                        .dilation = {0, 0},
+                                        .activation = {activation_min, activation_max}
+                                      };
+
+  const float* input_data = tflite::micro::GetTensorData<float>(input);
+  float* output_data = tflite::micro::GetTensorData<float>(output);
+  const int input_size = input_width * input_height * input_depth;
+  const int output_size = output_width * output_height * output_depth;
+
+  for (int i_batch = 0; i_batch < batch_size; i_batch++) {
+    esp_nn_depthwise_conv_f32(&input_dims, input_data + i_batch * input_size,
+                              &filter_dims,
+                              tflite::micro::GetTensorData<float>(filter),
+                              tflite::micro::GetOptionalTensorData<float>(bias),
+                              &output_dims, output_data + i_batch * output_size,
+                              &conv_params);
+  }
+  return true;
+}
 #endif
 
 TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
@@ -240,7 +495,8 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
           (input->type == kTfLiteInt16 && filter->type == kTfLiteInt8),
       "Hybrid models are not supported on TFLite Micro.");
 
-  if (filter->type == kTfLiteInt4) {
+  data->unpacked_filter = UnpackInt4FilterAtPrepare(context, filter);
+  if (filter->type == kTfLiteInt4 && data->unpacked_filter == nullptr) {
     int filter_size =
         RuntimeShape(filter->dims->size,
                      reinterpret_cast<const int32_t*>(filter->dims->data))
@@ -277,6 +533,39 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
 
     int scratch_buf_size = esp_nn_get_depthwise_conv_scratch_size(
         &input_dims, &filter_dims, &output_dims, &conv_params);
+
+    data->parallel = params.dilation_width_factor == 1 &&
+                     params.dilation_height_factor == 1 &&
+                     EspNnShouldSplit(static_cast<int64_t>(output_height) *
+                                      output_width * output->dims->data[3] *
+                                      filter_height * filter_width);
+    data->worker_buffer_idx = -1;
+    data->padded_input_idx = -1;
+    if (data->parallel) {
+      // The slices run on the padded input, which may need a larger scratch.
+      data_dims_t padded_dims = {
+          .width = (output_width - 1) * params.stride_width + filter_width,
+          .height = (output_height - 1) * params.stride_height + filter_height,
+          .channels = num_input_channels, .extra = 1};
+      conv_params.padding = {0, 0};
+      const int padded_scratch_size = esp_nn_get_depthwise_conv_scratch_size(
+          &padded_dims, &filter_dims, &output_dims, &conv_params);
+      if (padded_scratch_size > scratch_buf_size) {
+        scratch_buf_size = padded_scratch_size;
+      }
+      if (scratch_buf_size > 0) {
+        TF_LITE_ENSURE_STATUS(context->RequestScratchBufferInArena(
+            context, scratch_buf_size, &data->worker_buffer_idx));
+      }
+      if (data->op_data.padding.width != 0 ||
+          data->op_data.padding.height != 0) {
+        TF_LITE_ENSURE_STATUS(context->RequestScratchBufferInArena(
+            context,
+            padded_dims.width * padded_dims.height * padded_dims.channels,
+            &data->padded_input_idx));
+      }
+    }
+
     if (scratch_buf_size > 0) {
       TF_LITE_ENSURE_STATUS(context->RequestScratchBufferInArena(
         context, scratch_buf_size, &data->buffer_idx));
@@ -315,6 +604,11 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
   long long start_time = esp_timer_get_time();
   switch (input->type) {  // Already know in/out types are same.
     case kTfLiteFloat32: {
+#if ESP_NN
+      if (EvalFloat(params, data, input, filter, bias, output)) {
+        break;
+      }
+#endif
       tflite::reference_ops::DepthwiseConv(
           DepthwiseConvParamsFloat(params, data.op_data),
           tflite::micro::GetTensorShape(input),
@@ -330,12 +624,13 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
     case kTfLiteInt8: {
       switch (filter->type) {
         case kTfLiteInt4: {
-          int8_t* unpacked_filter_data = static_cast<int8_t*>(
-              context->GetScratchBuffer(context, data.op_data.filter_buffer_index));
-          tflite::tensor_utils::UnpackDenseInt4IntoInt8(
-              tflite::micro::GetTensorData<int8_t>(filter),
-              tflite::micro::GetTensorShape(filter).FlatSize(),
-              unpacked_filter_data);
+          const int8_t* unpacked_filter_data = GetUnpackedInt4Filter(
+              context, filter, data.unpacked_filter,
+              data.op_data.filter_buffer_index);
+#if ESP_NN
+          EvalQuantizedPerChannel(context, node, params, data, input, filter,
+                                  unpacked_filter_data, bias, output);
+#else
           reference_integer_ops::DepthwiseConvPerChannel(
               DepthwiseConvParamsQuantized(params, data.op_data),
               data.op_data.per_channel_output_multiplier,
@@ -347,12 +642,14 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
               tflite::micro::GetOptionalTensorData<int32_t>(bias),
               tflite::micro::GetTensorShape(output),
               tflite::micro::GetTensorData<int8_t>(output));
+#endif
           break;
         }
         case kTfLiteInt8: {
 #if ESP_NN
-          EvalQuantizedPerChannel(context, node, params, data, input, filter, bias,
-                                  output);
+          EvalQuantizedPerChannel(context, node, params, data, input, filter,
+                                  tflite::micro::GetTensorData<int8_t>(filter),
+                                  bias, output);
 #else
           reference_integer_ops::DepthwiseConvPerChannel(
               DepthwiseConvParamsQuantized(params, data.op_data),
@@ -380,6 +677,12 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
     case kTfLiteInt16: {
       switch (filter->type) {
         case kTfLiteInt8: {
+#if ESP_NN
+          if (EvalQuantizedPerChannel16x8(params, data, input, filter, bias,
+                                          output)) {
+            break;
+          }
+#endif
           reference_integer_ops::DepthwiseConvPerChannel(
               DepthwiseConvParamsQuantized(params, data.op_data),
               data.op_data.per_channel_output_multiplier,
@@ -0,0 +1,110 @@
+/* Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/lite/kernels/internal/reference/hard_swish.h"
+
+#include "tensorflow/lite/c/builtin_op_data.h"
+#include "tensorflow/lite/c/common.h"
+#include "tensorflow/lite/kernels/internal/common.h"
+#include "tensorflow/lite/kernels/internal/quantization_util.h"
+#include "tensorflow/lite/kernels/internal/tensor_ctypes.h"
+#include "tensorflow/lite/kernels/internal/types.h"
+#include "tensorflow/lite/kernels/kernel_util.h"
+#include "tensorflow/lite/kernels/op_macros.h"
+#include "tensorflow/lite/micro/kernels/esp_nn/lut.h"
+#include "tensorflow/lite/micro/kernels/hard_swish.h"
+#include "tensorflow/lite/micro/kernels/kernel_util.h"
+#include "tensorflow/lite/micro/micro_log.h"
+#include "tensorflow/lite/micro/micro_utils.h"
+
+#include <esp_timer.h>
+
+long long hard_swish_total_time = 0;
+
+namespace tflite {
+namespace {
+// HardSwishPrepare fills `params` through node->user_data, so it must stay
+// the first member.
+struct NodeData {
+  HardSwishParams params;
+  // int8 only: the whole op as a table, built at Prepare.
+  int8_t* lut;
+};
+
+void* HardSwishInit(TfLiteContext* context, const char* buffer, size_t length) {
+  TFLITE_DCHECK(context->AllocatePersistentBuffer != nullptr);
+  return context->AllocatePersistentBuffer(context, sizeof(NodeData));
+}
+
+TfLiteStatus HardSwishPrepareEsp(TfLiteContext* context, TfLiteNode* node) {
+  TF_LITE_ENSURE_OK(context, HardSwishPrepare(context, node));
+  NodeData* data = static_cast<NodeData*>(node->user_data);
+
+  data->lut = nullptr;
+  MicroContext* micro_context = GetMicroContext(context);
+  TfLiteTensor* input =
+      micro_context->AllocateTempInputTensor(node, kHardSwishInputTensor);
+  TF_LITE_ENSURE(context, input != nullptr);
+  if (input->type == kTfLiteInt8) {
+    data->lut = static_cast<int8_t*>(
+        context->AllocatePersistentBuffer(context, kInt8LutSize));
+    TF_LITE_ENSURE(context, data->lut != nullptr);
+    const HardSwishParams& params = data->params;
+    PopulateInt8Lut(data->lut, [&params](const int8_t* in, int8_t* out,
+                                         int size) {
+      const RuntimeShape shape(1, size);
+      tflite::reference_ops::HardSwish<int8_t>(params, shape, in, shape, out);
+    });
+  }
+  micro_context->DeallocateTempTfLiteTensor(input);
+  return kTfLiteOk;
+}
+
+TfLiteStatus HardSwishEval(TfLiteContext* context, TfLiteNode* node) {
+  const TfLiteEvalTensor* input =
+      tflite::micro::GetEvalInput(context, node, kHardSwishInputTensor);
+  TfLiteEvalTensor* output =
+      tflite::micro::GetEvalOutput(context, node, kHardSwishOutputTensor);
+  const NodeData* data = static_cast<const NodeData*>(node->user_data);
+
+  switch (input->type) {
+    case kTfLiteFloat32: {
+      tflite::reference_ops::HardSwish<float>(
+          tflite::micro::GetTensorShape(input),
+          tflite::micro::GetTensorData<float>(input),
+          tflite::micro::GetTensorShape(output),
+          tflite::micro::GetTensorData<float>(output));
+    } break;
+    case kTfLiteInt8: {
+      long long start_time = esp_timer_get_time();
+      EvalInt8Lut(data->lut, input, output);
+      hard_swish_total_time += esp_timer_get_time() - start_time;
+    } break;
+    default: {
+      MicroPrintf("Unsupported type %s", TfLiteTypeGetName(input->type));
+      return kTfLiteError;
+    }
+  }
+  return kTfLiteOk;
+}
+
+}  // namespace
+
+TFLMRegistration Register_HARD_SWISH() {
+  return tflite::micro::RegisterOp(HardSwishInit, HardSwishPrepareEsp,
+                                   HardSwishEval);
+}
+
+}  // namespace tflite
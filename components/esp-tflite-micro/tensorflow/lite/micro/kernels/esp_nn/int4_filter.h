@@ -0,0 +1,71 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_MICRO_KERNELS_ESP_NN_INT4_FILTER_H_
+#define TENSORFLOW_LITE_MICRO_KERNELS_ESP_NN_INT4_FILTER_H_
+
+#include "tensorflow/lite/c/common.h"
+#include "tensorflow/lite/kernels/internal/portable_tensor_utils.h"
+#include "tensorflow/lite/kernels/internal/tensor_ctypes.h"
+#include "tensorflow/lite/kernels/kernel_util.h"
+#include "tensorflow/lite/micro/kernels/kernel_util.h"
+
+namespace tflite {
+
+// Unpacks a constant int4 filter once into the persistent arena, so that Eval
+// can hand int8 weights to the esp-nn kernels without unpacking them on every
+// Invoke. Returns nullptr if the filter is not constant, the persistent arena
+// is exhausted or ESP_NN_INT4_UNPACK_AT_PREPARE is not set; the caller then
+// requests a scratch buffer and unpacks into it at Eval.
+inline const int8_t* UnpackInt4FilterAtPrepare(TfLiteContext* context,
+                                               const TfLiteTensor* filter) {
+#ifdef ESP_NN_INT4_UNPACK_AT_PREPARE
+  if (filter->type != kTfLiteInt4 || !IsConstantTensor(filter)) {
+    return nullptr;
+  }
+  const int filter_size = NumElements(filter);
+  int8_t* unpacked_filter = static_cast<int8_t*>(
+      context->AllocatePersistentBuffer(context, filter_size));
+  if (unpacked_filter == nullptr) {
+    return nullptr;
+  }
+  tensor_utils::UnpackDenseInt4IntoInt8(GetTensorData<int8_t>(filter),
+                                        filter_size, unpacked_filter);
+  return unpacked_filter;
+#else
+  return nullptr;
+#endif
+}
+
+// Returns the int8 weights of an int4 filter for this Invoke, either unpacked
+// at Prepare or unpacked now into the scratch buffer at `buffer_index`.
+inline const int8_t* GetUnpackedInt4Filter(TfLiteContext* context,
+                                           const TfLiteEvalTensor* filter,
+                                           const int8_t* unpacked_filter,
+                                           int buffer_index) {
+  if (unpacked_filter != nullptr) {
+    return unpacked_filter;
+  }
+  int8_t* scratch = static_cast<int8_t*>(
+      context->GetScratchBuffer(context, buffer_index));
+  tensor_utils::UnpackDenseInt4IntoInt8(
+      tflite::micro::GetTensorData<int8_t>(filter),
+      tflite::micro::GetTensorShape(filter).FlatSize(), scratch);
+  return scratch;
+}
+
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_MICRO_KERNELS_ESP_NN_INT4_FILTER_H_
@@ -0,0 +1,64 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_MICRO_KERNELS_ESP_NN_LUT_H_
+#define TENSORFLOW_LITE_MICRO_KERNELS_ESP_NN_LUT_H_
+
+#include <cstdint>
+
+#include "tensorflow/lite/c/common.h"
+#include "tensorflow/lite/kernels/internal/types.h"
+#include "tensorflow/lite/micro/kernels/kernel_util.h"
+
+#if ESP_NN
+#include <esp_nn.h>
+#endif
+
+namespace tflite {
+
+// An int8 -> int8 activation with fixed quantization has only 256 possible
+// outputs. The table follows the esp_nn_lut_s8 layout: lut[i] is the output
+// for input i - 128.
+constexpr int kInt8LutSize = 256;
+
+// Fills `lut` by running `eval(input, output, size)`, the op's own int8
+// kernel, once over every int8 value, so table lookups are bit-exact with it.
+template <typename EvalFn>
+void PopulateInt8Lut(int8_t* lut, EvalFn eval) {
+  int8_t input[kInt8LutSize];
+  for (int i = 0; i < kInt8LutSize; ++i) {
+    input[i] = static_cast<int8_t>(i - 128);
+  }
+  eval(input, lut, kInt8LutSize);
+}
+
+inline void EvalInt8Lut(const int8_t* lut, const TfLiteEvalTensor* input,
+                        TfLiteEvalTensor* output) {
+  const int size = MatchingFlatSize(tflite::micro::GetTensorShape(input),
+                                    tflite::micro::GetTensorShape(output));
+  const int8_t* input_data = tflite::micro::GetTensorData<int8_t>(input);
+  int8_t* output_data = tflite::micro::GetTensorData<int8_t>(output);
+#if ESP_NN
+  esp_nn_lut_s8(input_data, output_data, lut, size);
+#else
+  for (int i = 0; i < size; ++i) {
+    output_data[i] = lut[input_data[i] + 128];
+  }
+#endif
+}
+
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_MICRO_KERNELS_ESP_NN_LUT_H_
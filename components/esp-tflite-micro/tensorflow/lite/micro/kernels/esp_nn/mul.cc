@@ -55,13 +55,19 @@ void MulEvalQuantized(TfLiteContext* context, TfLiteNode* node,
       tflite::micro::GetTensorShape(input2), &op_params);
 
   if (need_broadcast) {
-    reference_integer_ops::BroadcastMul4DSlow(
-        op_params, tflite::micro::GetTensorShape(input1),
-        tflite::micro::GetTensorData<int8_t>(input1),
-        tflite::micro::GetTensorShape(input2),
-        tflite::micro::GetTensorData<int8_t>(input2),
-        tflite::micro::GetTensorShape(output),
-        tflite::micro::GetTensorData<int8_t>(output));
+    EvalMulQuantizedReference(context, node, data, input1, input2, output);
+  } else if (input1->type == kTfLiteInt16) {
+    const int16_t *input1_data = tflite::micro::GetTensorData<int16_t>(input1);
+    const int16_t *input2_data = tflite::micro::GetTensorData<int16_t>(input2);
+    int16_t *out_data = tflite::micro::GetTensorData<int16_t>(output);
+
+    esp_nn_mul_elementwise_s16(input1_data, input2_data, op_params.input1_offset,
+                               op_params.input2_offset, out_data, op_params.output_offset,
+                               op_params.output_multiplier, op_params.output_shift,
+                               op_params.quantized_activation_min, op_params.quantized_activation_max,
+                               MatchingElementsSize(tflite::micro::GetTensorShape(input1),
+                                                     tflite::micro::GetTensorShape(input2),
+                                                     tflite::micro::GetTensorShape(output)));
   } else {
     const int8_t *input1_data = tflite::micro::GetTensorData<int8_t>(input1);
     const int8_t *input2_data = tflite::micro::GetTensorData<int8_t>(input2);
@@ -76,6 +82,29 @@ void MulEvalQuantized(TfLiteContext* context, TfLiteNode* node,
                                                     tflite::micro::GetTensorShape(output)));
   }
 }
+
+void MulEvalFloat(TfLiteContext* context, TfLiteNode* node,
+                  TfLiteMulParams* params, const OpDataMul* data,
+                  const TfLiteEvalTensor* input1,
+                  const TfLiteEvalTensor* input2, TfLiteEvalTensor* output) {
+  tflite::ArithmeticParams op_params = {};
+  bool need_broadcast = reference_ops::ProcessBroadcastShapes(
+      tflite::micro::GetTensorShape(input1),
+      tflite::micro::GetTensorShape(input2), &op_params);
+
+  if (need_broadcast) {
+    EvalMulFloatReference(context, node, params, data, input1, input2, output);
+  } else {
+    esp_nn_mul_elementwise_f32(tflite::micro::GetTensorData<float>(input1),
+                               tflite::micro::GetTensorData<float>(input2),
+                               tflite::micro::GetTensorData<float>(output),
+                               data->output_activation_min_f32,
+                               data->output_activation_max_f32,
+                               MatchingElementsSize(tflite::micro::GetTensorShape(input1),
+                                                    tflite::micro::GetTensorShape(input2),
+                                                    tflite::micro::GetTensorShape(output)));
+  }
+}
 #endif
 
 TfLiteStatus MulEval(TfLiteContext* context, TfLiteNode* node) {
@@ -95,19 +124,23 @@ TfLiteStatus MulEval(TfLiteContext* context, TfLiteNode* node) {
   long long start_time = esp_timer_get_time();
   switch (input1->type) {
     case kTfLiteInt8:
+    case kTfLiteInt16:
 #if ESP_NN
       MulEvalQuantized(context, node, data, input1, input2, output);
 #else
       EvalMulQuantizedReference(context, node, data, input1, input2, output);
 #endif
       break;
-    case kTfLiteInt16:
     case kTfLiteInt32:
       EvalMulQuantizedReference(context, node, data, input1, input2, output);
       break;
     case kTfLiteFloat32:
+#if ESP_NN
+      MulEvalFloat(context, node, params, data, input1, input2, output);
+#else
       EvalMulFloatReference(context, node, params, data, input1, input2,
                             output);
+#endif
       break;
     default:
       MicroPrintf("Type %s (%d) not supported.",
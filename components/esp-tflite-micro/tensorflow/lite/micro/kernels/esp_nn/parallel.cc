@@ -0,0 +1,158 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/lite/micro/kernels/esp_nn/parallel.h"
+
+#include <cstring>
+
+#include "tensorflow/lite/micro/micro_log.h"
+
+#ifdef ESP_NN_DUAL_CORE
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#endif
+
+namespace tflite {
+
+#ifdef ESP_NN_DUAL_CORE
+namespace {
+
+constexpr uint32_t kWorkerStackSize = 4096;
+
+struct WorkerJob {
+  EspNnWorkFn fn;
+  void* arg;
+  int begin;
+  int end;
+};
+
+enum WorkerState {
+  kWorkerNotStarted,
+  kWorkerStarting,
+  kWorkerRunning,
+  kWorkerFailed,
+};
+
+// Guards worker_state, so that interpreters on different tasks reaching their
+// first split op at the same time start only one worker.
+portMUX_TYPE worker_state_lock = portMUX_INITIALIZER_UNLOCKED;
+WorkerState worker_state = kWorkerNotStarted;
+TaskHandle_t worker_task = nullptr;
+// Held by the interpreter whose op is running on the worker.
+SemaphoreHandle_t worker_lock = nullptr;
+StaticSemaphore_t worker_lock_buffer;
+SemaphoreHandle_t job_done = nullptr;
+StaticSemaphore_t job_done_buffer;
+// Written by the caller before the worker is notified, read by the worker
+// after it wakes up; the notification orders the accesses.
+WorkerJob job;
+
+void WorkerLoop(void* unused) {
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    job.fn(job.arg, 1, job.begin, job.end);
+    xSemaphoreGive(job_done);
+  }
+}
+
+// Starts the worker on the core the first caller is not running on, with the
+// caller's priority. Inference should run from a task pinned to one core,
+// otherwise both halves may end up on the same core. Callers that come in
+// while another task is starting the worker run on one core this time.
+bool StartWorker() {
+  taskENTER_CRITICAL(&worker_state_lock);
+  const WorkerState state = worker_state;
+  if (state == kWorkerNotStarted) {
+    worker_state = kWorkerStarting;
+  }
+  taskEXIT_CRITICAL(&worker_state_lock);
+  if (state != kWorkerNotStarted) {
+    return state == kWorkerRunning;
+  }
+
+  worker_lock = xSemaphoreCreateMutexStatic(&worker_lock_buffer);
+  job_done = xSemaphoreCreateBinaryStatic(&job_done_buffer);
+  const BaseType_t worker_core = xPortGetCoreID() == 0 ? 1 : 0;
+  const bool started =
+      xTaskCreatePinnedToCore(WorkerLoop, "esp_nn_worker", kWorkerStackSize,
+                              nullptr, uxTaskPriorityGet(nullptr),
+                              &worker_task, worker_core) == pdPASS;
+  if (!started) {
+    MicroPrintf("Could not start the esp-nn worker, running on one core.");
+  }
+  taskENTER_CRITICAL(&worker_state_lock);
+  worker_state = started ? kWorkerRunning : kWorkerFailed;
+  taskEXIT_CRITICAL(&worker_state_lock);
+  return started;
+}
+
+}  // namespace
+#endif
+
+int EspNnSplitPoint(int count, int unit) {
+  int split = ((count / 2 + unit / 2) / unit) * unit;
+  if (split <= 0) {
+    split = unit;
+  }
+  if (split >= count) {
+    split -= unit;
+  }
+  return split > 0 ? split : 0;
+}
+
+void EspNnParallelFor(EspNnWorkFn fn, void* arg, int split, int count) {
+#ifdef ESP_NN_DUAL_CORE
+  if (split > 0 && split < count && StartWorker() &&
+      xSemaphoreTake(worker_lock, 0) == pdTRUE) {
+    job = {fn, arg, split, count};
+    xTaskNotifyGive(worker_task);
+    fn(arg, 0, 0, split);
+    xSemaphoreTake(job_done, portMAX_DELAY);
+    xSemaphoreGive(worker_lock);
+    return;
+  }
+#endif
+  fn(arg, 0, 0, count);
+}
+
+void EspNnPadInput(const int8_t* input, int input_height, int input_width,
+                   int channels, int pad_top, int pad_left, int padded_height,
+                   int padded_width, int8_t pad_value, int8_t* padded) {
+  const int padded_row_size = padded_width * channels;
+  const int copy_begin = pad_left < 0 ? -pad_left : 0;
+  int copy_end = padded_width - pad_left;
+  if (copy_end > input_width) {
+    copy_end = input_width;
+  }
+  const int left_size = (pad_left + copy_begin) * channels;
+  const int copy_size = (copy_end - copy_begin) * channels;
+
+  for (int y = 0; y < padded_height; y++) {
+    const int in_y = y - pad_top;
+    if (in_y < 0 || in_y >= input_height || copy_size <= 0) {
+      memset(padded, pad_value, padded_row_size);
+    } else {
+      memset(padded, pad_value, left_size);
+      memcpy(padded + left_size,
+             input + (in_y * input_width + copy_begin) * channels, copy_size);
+      memset(padded + left_size + copy_size, pad_value,
+             padded_row_size - left_size - copy_size);
+    }
+    padded += padded_row_size;
+  }
+}
+
+}  // namespace tflite
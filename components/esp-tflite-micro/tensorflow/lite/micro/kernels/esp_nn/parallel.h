@@ -0,0 +1,78 @@
+/* Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_MICRO_KERNELS_ESP_NN_PARALLEL_H_
+#define TENSORFLOW_LITE_MICRO_KERNELS_ESP_NN_PARALLEL_H_
+
+#include <cstdint>
+
+namespace tflite {
+
+// Number of workers an esp-nn kernel splits its output across. Worker 0 is
+// the task calling Invoke, worker 1 a persistent task on the other core.
+// Each worker needs its own esp-nn scratch buffer.
+#ifdef ESP_NN_DUAL_CORE
+constexpr int kEspNnNumWorkers = 2;
+#else
+constexpr int kEspNnNumWorkers = 1;
+#endif
+
+// Ops with less work than this (in multiply-accumulates, or input reads for
+// pooling) stay on the calling core: the hand-off to the other core costs a
+// few microseconds.
+constexpr int64_t kEspNnMinSplitWork = 64 * 1024;
+
+// True if an op doing `work` is split across both cores. Kernels decide this
+// at Prepare, so that the extra scratch buffers are only requested by the
+// ops that use them.
+inline bool EspNnShouldSplit(int64_t work) {
+  return kEspNnNumWorkers > 1 && work >= kEspNnMinSplitWork;
+}
+
+// Smallest number of rows (or channels) of `bytes` each that starts on a
+// 16-byte boundary again. Splitting on multiples of it keeps the data of the
+// second worker as aligned as the tensor itself.
+inline int EspNnAlignedUnit(int bytes) {
+  int unit = 1;
+  while (unit < 16 && (unit * bytes) % 16 != 0) {
+    unit *= 2;
+  }
+  return unit;
+}
+
+// Multiple of `unit` closest to count / 2, or 0 if there is none inside
+// (0, count).
+int EspNnSplitPoint(int count, int unit);
+
+// Computes the part [begin, end) of an op on the given worker.
+typedef void (*EspNnWorkFn)(void* arg, int worker, int begin, int end);
+
+// Runs fn(arg, 0, 0, split) on the calling core and fn(arg, 1, split, count)
+// on the other core, and returns once both are done. Everything runs on the
+// calling core with worker 0 if `split` is not inside (0, count), dual core
+// mode is off, or the worker is busy with another interpreter.
+void EspNnParallelFor(EspNnWorkFn fn, void* arg, int split, int count);
+
+// Copies one NHWC int8 image into a padded_height x padded_width image whose
+// first row and column are at -pad_top and -pad_left of the input, filling
+// everything outside the input with `pad_value`. A VALID window over the
+// result then reads the same values as the padded window over the input.
+void EspNnPadInput(const int8_t* input, int input_height, int input_width,
+                   int channels, int pad_top, int pad_left, int padded_height,
+                   int padded_width, int8_t pad_value, int8_t* padded);
+
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_MICRO_KERNELS_ESP_NN_PARALLEL_H_
@@ -16,6 +16,7 @@ limitations under the License.
 
 #include "tensorflow/lite/c/builtin_op_data.h"
 #include "tensorflow/lite/kernels/kernel_util.h"
+#include "tensorflow/lite/micro/kernels/esp_nn/parallel.h"
 #include "tensorflow/lite/micro/kernels/kernel_util.h"
 #include "tensorflow/lite/micro/kernels/pooling.h"
 #include "tensorflow/lite/micro/micro_log.h"
@@ -32,6 +33,105 @@ namespace tflite {
 
 namespace {
 #if ESP_NN
+typedef void (*PoolS8Fn)(const int8_t*, const uint16_t, const uint16_t,
+                         int8_t*, const uint16_t, const uint16_t,
+                         const uint16_t, const uint16_t, const uint16_t,
+                         const uint16_t, const uint16_t, const uint16_t,
+                         const int32_t, const int32_t, const uint16_t);
+
+// One image of an int8 pool split by output rows.
+struct PoolRowsJob {
+  PoolS8Fn pool_fn;
+  const TfLitePoolParams* params;
+  const OpDataPooling* data;
+  const int8_t* input;
+  int input_height;
+  int input_width;
+  int8_t* output;
+  int output_width;
+  int depth;
+};
+
+// The esp-nn pools clip the window at the input border instead of reading
+// padding, so a slice starts at its first input row with only the top
+// padding it still needs, and runs to the end of the input.
+inline int PoolFirstInputRow(const PoolRowsJob& job, int output_row) {
+  const int row =
+      output_row * job.params->stride_height - job.data->padding.height;
+  return row > 0 ? row : 0;
+}
+
+void PoolRows(void* arg, int worker, int begin, int end) {
+  const PoolRowsJob& job = *static_cast<const PoolRowsJob*>(arg);
+  const int first_row = PoolFirstInputRow(job, begin);
+  const int pad_height = first_row + job.data->padding.height -
+                         begin * job.params->stride_height;
+  job.pool_fn(job.input + first_row * job.input_width * job.depth,
+              job.input_width, job.input_height - first_row,
+              job.output + begin * job.output_width * job.depth,
+              job.output_width, end - begin,
+              job.params->stride_width, job.params->stride_height,
+              job.params->filter_width, job.params->filter_height,
+              job.data->padding.width, pad_height,
+              job.data->activation_min, job.data->activation_max, job.depth);
+}
+
+// Output row near the middle at which both the input and the output rows of
+// the second slice start 16-byte aligned, 0 if there is none.
+int PoolSplitPoint(const PoolRowsJob& job, int output_height) {
+  const int unit = EspNnAlignedUnit(job.output_width * job.depth);
+  const int middle = EspNnSplitPoint(output_height, unit);
+  for (int step = 0; step <= middle || middle + step < output_height;
+       step += unit) {
+    const int candidates[2] = {middle + step, middle - step};
+    for (const int split : candidates) {
+      if (split > 0 && split < output_height &&
+          (PoolFirstInputRow(job, split) * job.input_width * job.depth) % 16 ==
+              0) {
+        return split;
+      }
+    }
+  }
+  return 0;
+}
+
+// Runs an int8 pool on both cores if it is large enough, returns false if the
+// caller should run it on this core.
+bool PoolEvalQuantizedParallel(PoolS8Fn pool_fn,
+                               const TfLitePoolParams* params,
+                               const OpDataPooling* data,
+                               const TfLiteEvalTensor* input,
+                               TfLiteEvalTensor* output) {
+  const RuntimeShape& input_shape = tflite::micro::GetTensorShape(input);
+  const RuntimeShape& output_shape = tflite::micro::GetTensorShape(output);
+  const int batches = MatchingDim(input_shape, 0, output_shape, 0);
+  const int depth = MatchingDim(input_shape, 3, output_shape, 3);
+  const int output_height = output_shape.Dims(1);
+  const int output_width = output_shape.Dims(2);
+  if (!EspNnShouldSplit(static_cast<int64_t>(output_height) * output_width *
+                        depth * params->filter_height * params->filter_width)) {
+    return false;
+  }
+
+  PoolRowsJob job = {pool_fn, params, data,
+                     tflite::micro::GetTensorData<int8_t>(input),
+                     input_shape.Dims(1), input_shape.Dims(2),
+                     tflite::micro::GetTensorData<int8_t>(output),
+                     output_width, depth};
+  const int split = PoolSplitPoint(job, output_height);
+  if (split == 0) {
+    return false;
+  }
+  const int input_size = job.input_height * job.input_width * depth;
+  const int output_size = output_height * output_width * depth;
+  for (int batch = 0; batch < batches; ++batch) {
+    EspNnParallelFor(PoolRows, &job, split, output_height);
+    job.input += input_size;
+    job.output += output_size;
+  }
+  return true;
+}
+
 void AverageEvalQuantized(TfLiteContext* context, const TfLiteNode* node,
                           const TfLitePoolParams* params, const OpDataPooling* data,
                           const TfLiteEvalTensor* input,
@@ -64,6 +164,12 @@ void AverageEvalQuantized(TfLiteContext* context, const TfLiteNode* node,
   const int input_size = input_width * input_height * depth;
   const int output_size = output_width * output_height * depth;
 
+  if (PoolEvalQuantizedParallel(
+          depth % 4 == 0 ? esp_nn_avg_pool_s8 : esp_nn_avg_pool_s8_ansi,
+          params, data, input, output)) {
+    return;
+  }
+
   if (depth % 4 == 0) { // S3 version only supports channels multiple of 4
     for (int batch = 0; batch < batches; ++batch) {
       esp_nn_avg_pool_s8(input_data, input_width, input_height,
@@ -119,6 +225,13 @@ void MaxEvalQuantized(TfLiteContext* context, TfLiteNode* node,
 
   const int input_size = input_width * input_height * depth;
   const int output_size = output_width * output_height * depth;
+
+  if (PoolEvalQuantizedParallel(
+          depth % 4 == 0 ? esp_nn_max_pool_s8 : esp_nn_max_pool_s8_ansi,
+          params, data, input, output)) {
+    return;
+  }
+
   if (depth % 4 == 0) { // S3 version only supports channels multiple of 4
     for (int batch = 0; batch < batches; ++batch) {
       esp_nn_max_pool_s8(input_data, input_width, input_height,
@@ -143,6 +256,43 @@ void MaxEvalQuantized(TfLiteContext* context, TfLiteNode* node,
     }
   }
 }
+
+typedef void (*PoolFloatFn)(const float*, const uint16_t, const uint16_t,
+                            float*, const uint16_t, const uint16_t,
+                            const uint16_t, const uint16_t, const uint16_t,
+                            const uint16_t, const uint16_t, const uint16_t,
+                            const float, const float, const uint16_t);
+
+void PoolEvalFloat(PoolFloatFn pool_fn, const TfLitePoolParams* params,
+                   const OpDataPooling* data, const TfLiteEvalTensor* input,
+                   TfLiteEvalTensor* output) {
+  const RuntimeShape& input_shape = tflite::micro::GetTensorShape(input);
+  const RuntimeShape& output_shape = tflite::micro::GetTensorShape(output);
+  TFLITE_DCHECK_EQ(input_shape.DimensionsCount(), 4);
+  TFLITE_DCHECK_EQ(output_shape.DimensionsCount(), 4);
+  const int batches = MatchingDim(input_shape, 0, output_shape, 0);
+  const int depth = MatchingDim(input_shape, 3, output_shape, 3);
+  const int input_height = input_shape.Dims(1);
+  const int input_width = input_shape.Dims(2);
+  const int output_height = output_shape.Dims(1);
+  const int output_width = output_shape.Dims(2);
+
+  const float *input_data = tflite::micro::GetTensorData<float>(input);
+  float *output_data = tflite::micro::GetTensorData<float>(output);
+
+  const int input_size = input_width * input_height * depth;
+  const int output_size = output_width * output_height * depth;
+  for (int batch = 0; batch < batches; ++batch) {
+    pool_fn(input_data, input_width, input_height,
+            output_data, output_width, output_height,
+            params->stride_width, params->stride_height,
+            params->filter_width, params->filter_height,
+            data->padding.width, data->padding.height,
+            data->activation_min_f32, data->activation_max_f32, depth);
+    input_data += input_size;
+    output_data += output_size;
+  }
+}
 #endif
 
 TfLiteStatus AverageEval(TfLiteContext* context, TfLiteNode* node) {
@@ -162,7 +312,11 @@ TfLiteStatus AverageEval(TfLiteContext* context, TfLiteNode* node) {
   // Inputs and outputs share the same type, guaranteed by the converter.
   switch (input->type) {
     case kTfLiteFloat32:
+#if ESP_NN
+      PoolEvalFloat(esp_nn_avg_pool_f32, params, data, input, output);
+#else
       AveragePoolingEvalFloat(context, node, params, data, input, output);
+#endif
       break;
     case kTfLiteInt8:
 #if ESP_NN
@@ -201,7 +355,11 @@ TfLiteStatus MaxEval(TfLiteContext* context, TfLiteNode* node) {
   long long start_time = esp_timer_get_time();
   switch (input->type) {
     case kTfLiteFloat32:
+#if ESP_NN
+      PoolEvalFloat(esp_nn_max_pool_f32, params, data, input, output);
+#else
       MaxPoolingEvalFloat(context, node, params, data, input, output);
+#endif
       break;
     case kTfLiteInt8:
 #if ESP_NN
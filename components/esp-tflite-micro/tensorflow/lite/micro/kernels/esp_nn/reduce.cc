@@ -0,0 +1,263 @@
+/* Copyright 2025 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/lite/kernels/internal/reference/reduce.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+#include "tensorflow/lite/c/builtin_op_data.h"
+#include "tensorflow/lite/c/common.h"
+#include "tensorflow/lite/kernels/internal/common.h"
+#include "tensorflow/lite/kernels/internal/quantization_util.h"
+#include "tensorflow/lite/kernels/internal/reference/integer_ops/mean.h"
+#include "tensorflow/lite/kernels/internal/tensor_ctypes.h"
+#include "tensorflow/lite/kernels/internal/types.h"
+#include "tensorflow/lite/kernels/kernel_util.h"
+#include "tensorflow/lite/micro/kernels/kernel_util.h"
+#include "tensorflow/lite/micro/kernels/reduce.h"
+#include "tensorflow/lite/micro/micro_utils.h"
+
+#if ESP_NN
+#include <esp_nn.h>
+#endif
+
+#include <esp_timer.h>
+
+long long reduce_total_time = 0;
+
+namespace tflite {
+
+namespace {
+
+struct NodeData {
+  OpDataReduce op_data;
+  // The int8 input seen as [outer_size, reduce_size, inner_size], the reduced
+  // axes collapsed in the middle. reduce_size is 0, and the reference kernel
+  // runs, when that is not possible.
+  int32_t outer_size;
+  int32_t reduce_size;
+  int32_t inner_size;
+  // Output rescale of MEAN and SUM, 1 / reduce_size folded in for MEAN.
+  int32_t multiplier;
+  int shift;
+};
+
+void* InitReduce(TfLiteContext* context, const char* buffer, size_t length) {
+  void* node_data = context->AllocatePersistentBuffer(context, sizeof(NodeData));
+  return new (node_data) NodeData();
+}
+
+#if ESP_NN
+// The axes must be constant and, once the dimensions of size 1 are left out,
+// contiguous. That covers the global pooling of NHWC data (axes 1 and 2) and
+// reductions over the last axis.
+void PrepareCollapsedShape(TfLiteContext* context, TfLiteNode* node,
+                           NodeData* data) {
+  data->reduce_size = 0;
+  MicroContext* micro_context = GetMicroContext(context);
+  TfLiteTensor* input = micro_context->AllocateTempInputTensor(node, 0);
+  TfLiteTensor* axis = micro_context->AllocateTempInputTensor(node, 1);
+  TfLiteTensor* output = micro_context->AllocateTempOutputTensor(node, 0);
+  const int num_dims = NumDimensions(input);
+
+  uint32_t reduced = 0;
+  bool collapsible = input->type == kTfLiteInt8 &&
+                     output->type == kTfLiteInt8 && IsConstantTensor(axis) &&
+                     num_dims <= kMaxNumberOfAxis;
+  const int32_t* axis_data = GetTensorData<int32_t>(axis);
+  for (int i = 0; collapsible && i < NumElements(axis); ++i) {
+    const int current = axis_data[i] < 0 ? axis_data[i] + num_dims
+                                         : axis_data[i];
+    collapsible = current >= 0 && current < num_dims;
+    if (collapsible) {
+      reduced |= 1u << current;
+    }
+  }
+
+  int first = num_dims;
+  int last = -1;
+  for (int d = 0; collapsible && d < num_dims; ++d) {
+    collapsible = input->dims->data[d] > 0;
+    if ((reduced & (1u << d)) && input->dims->data[d] != 1) {
+      first = std::min(first, d);
+      last = d;
+    }
+  }
+  for (int d = first + 1; collapsible && d < last; ++d) {
+    collapsible = (reduced & (1u << d)) || input->dims->data[d] == 1;
+  }
+
+  if (collapsible) {
+    data->outer_size = 1;
+    data->reduce_size = 1;
+    data->inner_size = 1;
+    for (int d = 0; d < num_dims; ++d) {
+      const int32_t size = input->dims->data[d];
+      if (d < first) {
+        data->outer_size *= size;
+      } else if (d <= last) {
+        data->reduce_size *= size;
+      } else {
+        data->inner_size *= size;
+      }
+    }
+  }
+
+  micro_context->DeallocateTempTfLiteTensor(input);
+  micro_context->DeallocateTempTfLiteTensor(axis);
+  micro_context->DeallocateTempTfLiteTensor(output);
+}
+
+// The reference temp_sum buffer holds one int32_t per output element, which
+// is at least the inner_size accumulators the esp-nn kernel needs.
+void EvalSumEspNn(TfLiteContext* context, TfLiteNode* node,
+                  const NodeData& data) {
+  const TfLiteEvalTensor* input = tflite::micro::GetEvalInput(context, node, 0);
+  TfLiteEvalTensor* output = tflite::micro::GetEvalOutput(context, node, 0);
+  esp_nn_set_reduce_scratch_buf(
+      context->GetScratchBuffer(context, data.op_data.temp_buffer_idx));
+  esp_nn_reduce_sum_s8(tflite::micro::GetTensorData<int8_t>(input),
+                       data.outer_size, data.reduce_size, data.inner_size,
+                       -data.op_data.input_zp,
+                       tflite::micro::GetTensorData<int8_t>(output),
+                       data.op_data.output_zp, data.multiplier, data.shift,
+                       std::numeric_limits<int8_t>::min(),
+                       std::numeric_limits<int8_t>::max());
+}
+#endif
+
+TfLiteStatus PrepareMinMax(TfLiteContext* context, TfLiteNode* node) {
+  NodeData* data = static_cast<NodeData*>(node->user_data);
+  TF_LITE_ENSURE_OK(context,
+                    PrepareMinMaxHelper(context, node, &data->op_data));
+#if ESP_NN
+  PrepareCollapsedShape(context, node, data);
+  // Requantizing max is left to the reference kernel, which rejects it.
+  if (data->op_data.input_scale != data->op_data.output_scale ||
+      data->op_data.input_zp != data->op_data.output_zp) {
+    data->reduce_size = 0;
+  }
+#endif
+  return kTfLiteOk;
+}
+
+TfLiteStatus PrepareMeanOrSum(TfLiteContext* context, TfLiteNode* node,
+                              bool compute_sum) {
+  NodeData* data = static_cast<NodeData*>(node->user_data);
+  TF_LITE_ENSURE_OK(context,
+                    PrepareMeanOrSumHelper(context, node, &data->op_data));
+#if ESP_NN
+  PrepareCollapsedShape(context, node, data);
+  data->multiplier = data->op_data.multiplier;
+  data->shift = data->op_data.shift;
+  if (!compute_sum && data->reduce_size > 0) {
+    // Same 1 / reduce_size folding as reference_ops::QuantizedMeanOrSum.
+    int shift = 63 - CountLeadingZeros(static_cast<uint64_t>(data->reduce_size));
+    shift = std::min(shift, 32);
+    shift = std::min(shift, 31 + data->op_data.shift);
+    data->multiplier = static_cast<int32_t>(
+        (static_cast<int64_t>(data->op_data.multiplier) << shift) /
+        data->reduce_size);
+    data->shift = data->op_data.shift - shift;
+  }
+#endif
+  return kTfLiteOk;
+}
+
+TfLiteStatus PrepareMean(TfLiteContext* context, TfLiteNode* node) {
+  return PrepareMeanOrSum(context, node, /*compute_sum=*/false);
+}
+
+TfLiteStatus PrepareSum(TfLiteContext* context, TfLiteNode* node) {
+  return PrepareMeanOrSum(context, node, /*compute_sum=*/true);
+}
+
+TfLiteStatus EvalMean(TfLiteContext* context, TfLiteNode* node) {
+  NodeData* data = static_cast<NodeData*>(node->user_data);
+  long long start_time = esp_timer_get_time();
+#if ESP_NN
+  if (data->reduce_size > 0) {
+    EvalSumEspNn(context, node, *data);
+    reduce_total_time += esp_timer_get_time() - start_time;
+    return kTfLiteOk;
+  }
+#endif
+  TfLiteStatus status = EvalMeanHelper(context, node, &data->op_data);
+  reduce_total_time += esp_timer_get_time() - start_time;
+  return status;
+}
+
+TfLiteStatus EvalMax(TfLiteContext* context, TfLiteNode* node) {
+  NodeData* data = static_cast<NodeData*>(node->user_data);
+  long long start_time = esp_timer_get_time();
+#if ESP_NN
+  if (data->reduce_size > 0) {
+    const TfLiteEvalTensor* input =
+        tflite::micro::GetEvalInput(context, node, 0);
+    TfLiteEvalTensor* output = tflite::micro::GetEvalOutput(context, node, 0);
+    esp_nn_reduce_max_s8(tflite::micro::GetTensorData<int8_t>(input),
+                         data->outer_size, data->reduce_size,
+                         data->inner_size,
+                         tflite::micro::GetTensorData<int8_t>(output));
+    reduce_total_time += esp_timer_get_time() - start_time;
+    return kTfLiteOk;
+  }
+#endif
+  TfLiteStatus status = EvalMaxHelper(context, node, &data->op_data);
+  reduce_total_time += esp_timer_get_time() - start_time;
+  return status;
+}
+
+TfLiteStatus EvalMin(TfLiteContext* context, TfLiteNode* node) {
+  NodeData* data = static_cast<NodeData*>(node->user_data);
+  return EvalMinHelper(context, node, &data->op_data);
+}
+
+TfLiteStatus EvalSum(TfLiteContext* context, TfLiteNode* node) {
+  NodeData* data = static_cast<NodeData*>(node->user_data);
+  long long start_time = esp_timer_get_time();
+#if ESP_NN
+  if (data->reduce_size > 0) {
+    EvalSumEspNn(context, node, *data);
+    reduce_total_time += esp_timer_get_time() - start_time;
+    return kTfLiteOk;
+  }
+#endif
+  TfLiteStatus status = EvalSumHelper(context, node, &data->op_data);
+  reduce_total_time += esp_timer_get_time() - start_time;
+  return status;
+}
+
+}  // namespace
+
+TFLMRegistration Register_MEAN() {
+  return tflite::micro::RegisterOp(InitReduce, PrepareMean, EvalMean);
+}
+
+TFLMRegistration Register_REDUCE_MAX() {
+  return tflite::micro::RegisterOp(InitReduce, PrepareMinMax, EvalMax);
+}
+
+TFLMRegistration Register_REDUCE_MIN() {
+  return tflite::micro::RegisterOp(InitReduce, PrepareMinMax, EvalMin);
+}
+
+TFLMRegistration Register_SUM() {
+  return tflite::micro::RegisterOp(InitReduce, PrepareSum, EvalSum);
+}
+
+}  // namespace tflite
@@ -0,0 +1,271 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/lite/micro/kernels/svdf.h"
+
+#include <math.h>
+
+#include "tensorflow/lite/c/builtin_op_data.h"
+#include "tensorflow/lite/c/common.h"
+#include "tensorflow/lite/kernels/internal/common.h"
+#include "tensorflow/lite/kernels/internal/quantization_util.h"
+#include "tensorflow/lite/kernels/internal/tensor_ctypes.h"
+#include "tensorflow/lite/kernels/kernel_util.h"
+#include "tensorflow/lite/kernels/op_macros.h"
+#include "tensorflow/lite/micro/kernels/activation_utils.h"
+#include "tensorflow/lite/micro/kernels/kernel_util.h"
+#include "tensorflow/lite/micro/micro_log.h"
+#include "tensorflow/lite/micro/micro_utils.h"
+
+#if ESP_NN
+#include <esp_nn.h>
+#endif
+
+#include <esp_timer.h>
+
+#include <cstring>
+#include <limits>
+
+long long svdf_total_time = 0;
+
+namespace tflite {
+namespace {
+
+struct NodeData {
+  OpDataSvdf op_data;
+  // Feature weight row sums times -input_zero_point, so that the feature
+  // matmul runs on the raw int8 input. nullptr runs the reference kernel.
+  int32_t* feature_bias;
+};
+
+void* InitSvdf(TfLiteContext* context, const char* buffer, size_t length) {
+  TFLITE_DCHECK(context->AllocatePersistentBuffer != nullptr);
+  return context->AllocatePersistentBuffer(context, sizeof(NodeData));
+}
+
+TfLiteStatus PrepareEspNnSvdf(TfLiteContext* context, TfLiteNode* node) {
+  TF_LITE_ENSURE_OK(context, PrepareSvdf(context, node));
+
+  NodeData* data = static_cast<NodeData*>(node->user_data);
+  data->feature_bias = nullptr;
+#if ESP_NN
+  MicroContext* micro_context = GetMicroContext(context);
+  TfLiteTensor* input =
+      micro_context->AllocateTempInputTensor(node, kSvdfInputTensor);
+  TfLiteTensor* weights_feature =
+      micro_context->AllocateTempInputTensor(node, kSvdfWeightsFeatureTensor);
+  TF_LITE_ENSURE(context, input != nullptr);
+  TF_LITE_ENSURE(context, weights_feature != nullptr);
+
+  if (input->type == kTfLiteInt8 && IsConstantTensor(weights_feature)) {
+    const int n_filter = weights_feature->dims->data[0];
+    const int n_input = weights_feature->dims->data[1];
+    data->feature_bias = static_cast<int32_t*>(
+        context->AllocatePersistentBuffer(context, n_filter * sizeof(int32_t)));
+    if (data->feature_bias != nullptr) {
+      const int8_t* weights = GetTensorData<int8_t>(weights_feature);
+      for (int r = 0; r < n_filter; r++) {
+        int32_t sum = 0;
+        for (int c = 0; c < n_input; c++) {
+          sum += weights[r * n_input + c];
+        }
+        data->feature_bias[r] = -data->op_data.input_zero_point * sum;
+      }
+    }
+  }
+
+  micro_context->DeallocateTempTfLiteTensor(input);
+  micro_context->DeallocateTempTfLiteTensor(weights_feature);
+#endif
+  return kTfLiteOk;
+}
+
+#if ESP_NN
+// EvalIntegerSvdfReference with the feature matmul on esp-nn. The scratch
+// tensor holds n_filter int32 per batch, and is free until the time stage, so
+// one batch of int16 feature outputs goes there before being scattered into
+// the newest column of the state.
+template <typename T>
+void EvalIntegerSvdfEspNn(TfLiteContext* context,
+                          const TfLiteEvalTensor* input_tensor,
+                          const TfLiteEvalTensor* weights_feature_tensor,
+                          const TfLiteEvalTensor* weights_time_tensor,
+                          const TfLiteEvalTensor* bias_tensor,
+                          const TfLiteSVDFParams* params,
+                          TfLiteEvalTensor* activation_state_tensor,
+                          TfLiteEvalTensor* output_tensor,
+                          const NodeData& node_data) {
+  const OpDataSvdf& data = node_data.op_data;
+  const int n_rank = params->rank;
+  const int n_batch = input_tensor->dims->data[0];
+  const int n_input = input_tensor->dims->data[1];
+  const int n_filter = weights_feature_tensor->dims->data[0];
+  const int n_unit = n_filter / n_rank;
+  const int n_memory = weights_time_tensor->dims->data[1];
+
+  int32_t* scratch_tensor = static_cast<int32_t*>(
+      context->GetScratchBuffer(context, data.scratch_tensor_index));
+
+  // Left shift the activation_state.
+  T* const state_ptr = tflite::micro::GetTensorData<T>(activation_state_tensor);
+  std::memmove(state_ptr, state_ptr + 1,
+               (n_batch * n_filter * n_memory - 1) * sizeof(T));
+
+  // Feature matmul.
+  {
+    const int8_t* input = tflite::micro::GetTensorData<int8_t>(input_tensor);
+    const int8_t* weight_feature =
+        tflite::micro::GetTensorData<int8_t>(weights_feature_tensor);
+    int16_t* feature_out = reinterpret_cast<int16_t*>(scratch_tensor);
+    T* result_in_batch = state_ptr + (n_memory - 1);
+    for (int b = 0; b < n_batch; b++) {
+      esp_nn_fully_connected_s8_s16(input + b * n_input, n_input,
+                                    weight_feature, node_data.feature_bias,
+                                    feature_out, n_filter,
+                                    data.effective_scale_1_b,
+                                    data.effective_scale_1_a,
+                                    std::numeric_limits<T>::min(),
+                                    std::numeric_limits<T>::max());
+      for (int r = 0; r < n_filter; r++) {
+        *result_in_batch = data.activation_state_zero_point + feature_out[r];
+        result_in_batch += n_memory;
+      }
+    }
+  }
+
+  // Time.
+  for (int b = 0; b < n_batch; ++b) {
+    int32_t* scratch_ptr_batch = scratch_tensor + b * n_filter;
+    const T* vector1_ptr = tflite::micro::GetTensorData<T>(weights_time_tensor);
+    const T* vector2_ptr = state_ptr + b * n_memory * n_filter;
+    for (int i = 0; i < n_filter; i++) {
+      int32_t acc = 0;
+      for (int j = 0; j < n_memory; j++) {
+        acc += *vector1_ptr++ *
+               (*vector2_ptr++ - data.activation_state_zero_point);
+      }
+      *scratch_ptr_batch++ = acc;
+    }
+  }
+
+  // Add bias, reduce, rescale, activation.
+  const int32_t* bias_data =
+      bias_tensor ? tflite::micro::GetTensorData<int32_t>(bias_tensor)
+                  : nullptr;
+  int8_t* output = tflite::micro::GetTensorData<int8_t>(output_tensor);
+  const int32_t* scratch_ptr = scratch_tensor;
+  for (int b = 0; b < n_batch; ++b) {
+    for (int i = 0; i < n_unit; ++i) {
+      int32_t acc = bias_data ? bias_data[i] : 0;
+      for (int j = 0; j < n_rank; ++j) {
+        acc += *scratch_ptr++;
+      }
+      acc = MultiplyByQuantizedMultiplier(acc, data.effective_scale_2_a,
+                                          data.effective_scale_2_b);
+      acc += data.output_zero_point;
+      acc = std::min(std::max(acc, static_cast<int32_t>(
+                                       std::numeric_limits<int8_t>::min())),
+                     static_cast<int32_t>(std::numeric_limits<int8_t>::max()));
+      output[b * n_unit + i] = static_cast<int8_t>(acc);
+    }
+  }
+}
+#endif
+
+TfLiteStatus EvalSvdf(TfLiteContext* context, TfLiteNode* node) {
+  auto* params = reinterpret_cast<TfLiteSVDFParams*>(node->builtin_data);
+  TFLITE_DCHECK(node->user_data != nullptr);
+  const NodeData& node_data = *(static_cast<const NodeData*>(node->user_data));
+  const OpDataSvdf& data = node_data.op_data;
+
+  const TfLiteEvalTensor* input =
+      tflite::micro::GetEvalInput(context, node, kSvdfInputTensor);
+  const TfLiteEvalTensor* weights_feature =
+      tflite::micro::GetEvalInput(context, node, kSvdfWeightsFeatureTensor);
+  const TfLiteEvalTensor* weights_time =
+      tflite::micro::GetEvalInput(context, node, kSvdfWeightsTimeTensor);
+  // TODO(#1751): account for optional bias tensor
+  const TfLiteEvalTensor* bias =
+      (NumInputs(node) == 5)
+          ? tflite::micro::GetEvalInput(context, node, kSvdfBiasTensor)
+          : nullptr;
+  TfLiteEvalTensor* activation_state = tflite::micro::GetMutableEvalInput(
+      context, node, kSvdfInputActivationStateTensor);
+  TfLiteEvalTensor* output =
+      tflite::micro::GetEvalOutput(context, node, kSvdfOutputTensor);
+
+  long long start_time = esp_timer_get_time();
+  switch (weights_feature->type) {
+    case kTfLiteFloat32: {
+      EvalFloatSvdfReference(
+          context, node, input, weights_feature, weights_time, bias, params,
+          data.scratch_tensor_index, activation_state, output);
+      break;
+    }
+
+    case kTfLiteInt8: {
+      switch (weights_time->type) {
+        case kTfLiteInt16: {
+#if ESP_NN
+          if (node_data.feature_bias != nullptr) {
+            EvalIntegerSvdfEspNn<int16_t>(
+                context, input, weights_feature, weights_time, bias, params,
+                activation_state, output, node_data);
+            break;
+          }
+#endif
+          EvalInt16SvdfReference(context, node, input, weights_feature,
+                                 weights_time, bias, params, activation_state,
+                                 output, data);
+          break;
+        }
+        case kTfLiteInt8: {
+#if ESP_NN
+          if (node_data.feature_bias != nullptr) {
+            EvalIntegerSvdfEspNn<int8_t>(
+                context, input, weights_feature, weights_time, bias, params,
+                activation_state, output, node_data);
+            break;
+          }
+#endif
+          EvalInt8SvdfReference(context, node, input, weights_feature,
+                                weights_time, bias, params, activation_state,
+                                output, data);
+          break;
+        }
+        default:
+          MicroPrintf("Type %s not currently supported.",
+                      TfLiteTypeGetName(weights_time->type));
+          return kTfLiteError;
+      }
+      break;
+    }
+
+    default:
+      MicroPrintf("Type %s not currently supported.",
+                  TfLiteTypeGetName(weights_feature->type));
+      return kTfLiteError;
+  }
+  svdf_total_time += esp_timer_get_time() - start_time;
+  return kTfLiteOk;
+}
+
+}  // namespace
+
+TFLMRegistration Register_SVDF() {
+  return tflite::micro::RegisterOp(InitSvdf, PrepareEspNnSvdf, EvalSvdf);
+}
+
+}  // namespace tflite
@@ -0,0 +1,426 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Integer version of unidirectional sequence lstm. Only the standard LSTM
+// (defined in the keras LSTM layer, e.g., no peephole etc.) is supported here.
+// Currently used by the 16 bits activation case only
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "tensorflow/lite/kernels/internal/quantization_util.h"
+#include "tensorflow/lite/kernels/internal/tensor_ctypes.h"
+#include "tensorflow/lite/kernels/kernel_util.h"
+#include "tensorflow/lite/micro/kernels/fully_connected.h"
+#include "tensorflow/lite/micro/kernels/kernel_util.h"
+#include "tensorflow/lite/micro/kernels/lstm_eval.h"
+#include "tensorflow/lite/micro/kernels/lstm_shared.h"
+
+#if ESP_NN
+#include <esp_nn.h>
+#endif
+
+#include <esp_timer.h>
+
+long long lstm_total_time = 0;
+
+namespace tflite {
+
+namespace {
+
+constexpr int kLstmGates = 4;
+
+struct NodeData {
+  OpDataLSTM op_data;
+  // Gate weights packed at Prepare for esp_nn_lstm_gates_s8, gates in the
+  // order input, forget, cell, output. Row c of a gate holds the input
+  // weights of cell c followed by its recurrent weights. nullptr runs the
+  // reference kernel.
+  const int8_t* gate_weights;
+  // Gate biases with the input and hidden state zero points folded in.
+  const int32_t* input_bias;
+  const int32_t* recurrent_bias;
+  int32_t input_mult[kLstmGates];
+  int32_t input_shift[kLstmGates];
+  int32_t recurrent_mult[kLstmGates];
+  int32_t recurrent_shift[kLstmGates];
+  // Gate outputs, a temporary and the cell and hidden state of all batches.
+  int state_buffer_index;
+};
+
+/*Helper Functions*/
+
+#if ESP_NN
+#ifdef ESP_NN_LSTM_PACK_WEIGHTS
+const GateParameters& GetGateParameters(const OpDataLSTM& op_data, int gate) {
+  switch (gate) {
+    case 0:
+      return op_data.input_gate_parameters;
+    case 1:
+      return op_data.forget_gate_parameters;
+    case 2:
+      return op_data.cell_gate_parameters;
+    default:
+      return op_data.output_gate_parameters;
+  }
+}
+
+bool IsInt16Range(const FullyConnectedParams& params) {
+  return params.quantized_activation_min ==
+             std::numeric_limits<int16_t>::min() &&
+         params.quantized_activation_max == std::numeric_limits<int16_t>::max();
+}
+#endif
+
+// Packs the eight gate weight tensors of an int8x8_16 LSTM into the persistent
+// arena and folds the zero points into the biases. gate_weights stays nullptr,
+// and the reference kernel runs, for other LSTMs, for non-constant or
+// asymmetric weights, when the persistent arena is exhausted or
+// ESP_NN_LSTM_PACK_WEIGHTS is not set.
+void PackGateWeights(TfLiteContext* context, const LstmTensors& lstm_tensors,
+                     NodeData* data) {
+  data->gate_weights = nullptr;
+#ifdef ESP_NN_LSTM_PACK_WEIGHTS
+  const OpDataLSTM& op_data = data->op_data;
+  if (lstm_tensors.GetInternalTensor(kLstmInputTensor)->type != kTfLiteInt8 ||
+      lstm_tensors.GetInternalTensor(kLstmInputToInputWeightsTensor)->type !=
+          kTfLiteInt8 ||
+      lstm_tensors.CellStateTensor()->type != kTfLiteInt16 ||
+      (op_data.cell_gate_nonlinear_type != kTfLiteActTanh &&
+       op_data.cell_gate_nonlinear_type != kTfLiteActSigmoid)) {
+    return;
+  }
+  for (int gate = 0; gate < kLstmGates; ++gate) {
+    const GateParameters& params = GetGateParameters(op_data, gate);
+    if (!IsConstantTensor(lstm_tensors.GetInternalTensor(
+            kLstmInputToInputWeightsTensor + gate)) ||
+        !IsConstantTensor(lstm_tensors.GetInternalTensor(
+            kLstmRecurrentToInputWeightsTensor + gate)) ||
+        params.input_fc_params.weights_offset != 0 ||
+        params.recurrent_fc_params.weights_offset != 0 ||
+        params.input_fc_params.output_offset != 0 ||
+        params.recurrent_fc_params.output_offset != 0 ||
+        !IsInt16Range(params.input_fc_params) ||
+        !IsInt16Range(params.recurrent_fc_params)) {
+      return;
+    }
+  }
+
+  const int n_input = op_data.size_info.input_dimension;
+  const int n_cell = op_data.size_info.state_dimension;
+  const int row_len = n_input + n_cell;
+  int8_t* weights = static_cast<int8_t*>(context->AllocatePersistentBuffer(
+      context, kLstmGates * n_cell * row_len));
+  int32_t* biases = static_cast<int32_t*>(context->AllocatePersistentBuffer(
+      context, 2 * kLstmGates * n_cell * sizeof(int32_t)));
+  if (weights == nullptr || biases == nullptr) {
+    return;
+  }
+  int32_t* input_bias = biases;
+  int32_t* recurrent_bias = biases + kLstmGates * n_cell;
+
+  for (int gate = 0; gate < kLstmGates; ++gate) {
+    const GateParameters& params = GetGateParameters(op_data, gate);
+    const int8_t* input_weights = GetTensorData<int8_t>(
+        lstm_tensors.GetInternalTensor(kLstmInputToInputWeightsTensor + gate));
+    const int8_t* recurrent_weights =
+        GetTensorData<int8_t>(lstm_tensors.GetInternalTensor(
+            kLstmRecurrentToInputWeightsTensor + gate));
+    const int32_t* bias = GetTensorData<int32_t>(
+        lstm_tensors.GetInternalTensor(kLstmInputGateBiasTensor + gate));
+    for (int cell = 0; cell < n_cell; ++cell) {
+      const int row = gate * n_cell + cell;
+      const int8_t* input_row = input_weights + cell * n_input;
+      const int8_t* recurrent_row = recurrent_weights + cell * n_cell;
+      std::memcpy(weights + row * row_len, input_row, n_input);
+      std::memcpy(weights + row * row_len + n_input, recurrent_row, n_cell);
+
+      int32_t input_sum = 0;
+      for (int i = 0; i < n_input; ++i) {
+        input_sum += input_row[i];
+      }
+      int32_t recurrent_sum = 0;
+      for (int i = 0; i < n_cell; ++i) {
+        recurrent_sum += recurrent_row[i];
+      }
+      input_bias[row] =
+          bias[cell] + params.input_fc_params.input_offset * input_sum;
+      recurrent_bias[row] =
+          params.recurrent_fc_params.input_offset * recurrent_sum;
+    }
+    data->input_mult[gate] = params.input_fc_params.output_multiplier;
+    data->input_shift[gate] = params.input_fc_params.output_shift;
+    data->recurrent_mult[gate] = params.recurrent_fc_params.output_multiplier;
+    data->recurrent_shift[gate] = params.recurrent_fc_params.output_shift;
+  }
+  data->gate_weights = weights;
+  data->input_bias = input_bias;
+  data->recurrent_bias = recurrent_bias;
+#endif
+}
+
+// One time step of one batch, bit-exact with lstm_internal::LstmStep. All four
+// gates come out of a single esp_nn_lstm_gates_s8 call; the int16 sigmoid and
+// tanh are the same lookup tables as in the reference kernel.
+void LstmStepEspNn(const NodeData& data, const int8_t* input,
+                   int16_t* cell_state, int8_t* hidden_state, int16_t* gates,
+                   int16_t* buffer) {
+  const OpDataLSTM& op_data = data.op_data;
+  const int n_input = op_data.size_info.input_dimension;
+  const int n_cell = op_data.size_info.state_dimension;
+  quant_data_t input_quant = {const_cast<int32_t*>(data.input_shift),
+                              const_cast<int32_t*>(data.input_mult)};
+  quant_data_t recurrent_quant = {const_cast<int32_t*>(data.recurrent_shift),
+                                  const_cast<int32_t*>(data.recurrent_mult)};
+  esp_nn_lstm_gates_s8(input, n_input, hidden_state, n_cell, data.gate_weights,
+                       data.input_bias, data.recurrent_bias, gates, kLstmGates,
+                       n_cell, &input_quant, &recurrent_quant);
+
+  const int32_t dims[1] = {n_cell};
+  const RuntimeShape shape(1, dims);
+  int16_t* input_gate = gates;
+  int16_t* forget_gate = gates + n_cell;
+  int16_t* cell_gate = gates + 2 * n_cell;
+  int16_t* output_gate = gates + 3 * n_cell;
+  lstm_internal::Sigmoid(shape, input_gate);
+  lstm_internal::Sigmoid(shape, forget_gate);
+  if (op_data.cell_gate_nonlinear_type == kTfLiteActSigmoid) {
+    lstm_internal::Sigmoid(shape, cell_gate);
+  } else {
+    lstm_internal::Tanh(/*cell_state_scale_power=*/-12, shape, cell_gate,
+                        shape, cell_gate);
+  }
+  lstm_internal::Sigmoid(shape, output_gate);
+
+  const InterGateParameters& inter_gate_params = op_data.inter_gate_parameters;
+  lstm_internal::Mul(shape, inter_gate_params.forget_cell_mul_params,
+                     forget_gate, cell_state, cell_state);
+  lstm_internal::Mul(shape, inter_gate_params.input_mul_params, input_gate,
+                     cell_gate, buffer);
+  lstm_internal::AddElementWise(cell_state, buffer, /*n_batch=*/1, n_cell,
+                                cell_state);
+  if (op_data.cell_state_info.cell_clip > 0) {
+    lstm_internal::Clipping(n_cell, op_data.cell_state_info, cell_state);
+  }
+
+  lstm_internal::Tanh(op_data.cell_state_info.cell_state_scale_power, shape,
+                      cell_state, shape, buffer);
+  lstm_internal::Mul(shape, inter_gate_params.output_mul_params, buffer,
+                     output_gate, hidden_state);
+}
+
+// The batches of an LSTM are independent, so every batch runs all its time
+// steps in turn. The states are copied into the scratch buffer for the whole
+// Invoke, which a tiered MicroAllocator places in the fast arena, while the
+// variable tensors stay in the persistent one.
+void EvalLstmEspNn(TfLiteContext* context, const NodeData& data,
+                   LSTMKernelContents& kernel_content) {
+  const LstmSizeInfo& size_info = data.op_data.size_info;
+  const int n_batch = size_info.batch_size;
+  const int n_time = size_info.time_steps;
+  const int n_input = size_info.input_dimension;
+  const int n_cell = size_info.state_dimension;
+  const int state_size = n_batch * n_cell;
+
+  int16_t* gates = static_cast<int16_t*>(
+      context->GetScratchBuffer(context, data.state_buffer_index));
+  int16_t* buffer = gates + kLstmGates * n_cell;
+  int16_t* cell_state = buffer + n_cell;
+  int8_t* hidden_state = reinterpret_cast<int8_t*>(cell_state + state_size);
+
+  int16_t* cell_state_tensor =
+      tflite::micro::GetTensorData<int16_t>(kernel_content.CellStateTensor());
+  int8_t* hidden_state_tensor =
+      tflite::micro::GetTensorData<int8_t>(kernel_content.HiddenStateTensor());
+  std::memcpy(cell_state, cell_state_tensor, state_size * sizeof(int16_t));
+  std::memcpy(hidden_state, hidden_state_tensor, state_size);
+
+  const int8_t* input = tflite::micro::GetTensorData<int8_t>(
+      kernel_content.GetInternalTensor(kLstmInputTensor));
+  int8_t* output =
+      tflite::micro::GetTensorData<int8_t>(kernel_content.output_tensor);
+  for (int b = 0; b < n_batch; ++b) {
+    for (int t = 0; t < n_time; ++t) {
+      const int step = size_info.time_major ? t * n_batch + b : b * n_time + t;
+      LstmStepEspNn(data, input + step * n_input, cell_state + b * n_cell,
+                    hidden_state + b * n_cell, gates, buffer);
+      std::memcpy(output + step * n_cell, hidden_state + b * n_cell, n_cell);
+    }
+  }
+
+  std::memcpy(cell_state_tensor, cell_state, state_size * sizeof(int16_t));
+  std::memcpy(hidden_state_tensor, hidden_state, state_size);
+}
+#endif
+
+/*Kernel functions*/
+
+void* UnidirectionalSequenceLstmInit(TfLiteContext* context, const char* buffer,
+                                     size_t length) {
+  TFLITE_DCHECK(context->AllocatePersistentBuffer != nullptr);
+  return context->AllocatePersistentBuffer(context, sizeof(NodeData));
+}
+
+TfLiteStatus UnidirectionalSequenceLstmPrepare(TfLiteContext* context,
+                                               TfLiteNode* node) {
+  TF_LITE_ENSURE_EQ(context, node->outputs->size, 1);
+  TF_LITE_ENSURE_EQ(context, node->inputs->size, 24);
+
+  TFLITE_DCHECK(node->builtin_data != nullptr);
+  TFLITE_DCHECK(node->user_data != nullptr);
+
+  NodeData* data = static_cast<NodeData*>(node->user_data);
+  OpDataLSTM* op_data = &data->op_data;
+  const auto* builtin_data =
+      static_cast<TfLiteUnidirectionalSequenceLSTMParams*>(node->builtin_data);
+  // All TempTfLiteTensors will be deallocated through the destructor.
+  LstmTensors lstm_tensors(context, node);
+  TF_LITE_ENSURE_OK(context, lstm_tensors.ValidateTensorStatus(context));
+
+  op_data->cell_gate_nonlinear_type = builtin_data->activation;
+  op_data->size_info =
+      CreateLstmSizeInfo(builtin_data->time_major,
+                         lstm_tensors.GetInternalTensor(kLstmInputTensor)->dims,
+                         lstm_tensors.HiddenStateTensor()->dims);
+  TF_LITE_ENSURE_OK(
+      context, ValidateTensorSize(context, lstm_tensors, op_data->size_info));
+
+  // Create cell state information and gate parameters (Fully Connected and Mul)
+  auto cell_state_type =
+      lstm_tensors.GetInternalTensor(kLstmCellStateTensor)->type;
+  if (cell_state_type == kTfLiteFloat32) {
+    op_data->cell_state_info =
+        CreateLstmCellStateInfoFloat(builtin_data->cell_clip);
+    TF_LITE_ENSURE_OK(
+        context, PrepareGateParametersFloat(context, lstm_tensors, op_data));
+  } else if (cell_state_type == kTfLiteInt16) {
+    op_data->cell_state_info = CreateLstmCellStateInfo(
+        lstm_tensors.CellStateTensor()->params.scale, builtin_data->cell_clip);
+    TF_LITE_ENSURE_OK(
+        context, PrepareGateParametersInteger(context, lstm_tensors, op_data));
+  } else {
+    MicroPrintf(
+        "Cell state type %s (%d) not supported. The quantized Unidirectional "
+        "Sequence LSTM Op only support int16 cell state",
+        TfLiteTypeGetName(cell_state_type), cell_state_type);
+    return kTfLiteError;
+  }
+
+#if ESP_NN
+  PackGateWeights(context, lstm_tensors, data);
+  if (data->gate_weights != nullptr) {
+    const int n_cell = op_data->size_info.state_dimension;
+    const int state_size = op_data->size_info.batch_size * n_cell;
+    return context->RequestScratchBufferInArena(
+        context,
+        (kLstmGates * n_cell + n_cell + state_size) * sizeof(int16_t) +
+            state_size,
+        &data->state_buffer_index);
+  }
+#endif
+
+  // request buffers (four buffers)
+  for (size_t i = 0; i < 4; i++) {
+    TF_LITE_ENSURE_OK(context, context->RequestScratchBufferInArena(
+                                   context,
+                                   op_data->size_info.batch_size *
+                                       op_data->size_info.state_dimension *
+                                       TfLiteTypeGetSize(cell_state_type),
+                                   &(op_data->buffer_indices[i])));
+  }
+  return kTfLiteOk;
+}
+
+TfLiteStatus UnidirectionalSequenceLstmEval(TfLiteContext* context,
+                                            TfLiteNode* node) {
+  TFLITE_DCHECK(node->user_data != nullptr);
+  const NodeData& data = *static_cast<const NodeData*>(node->user_data);
+  const OpDataLSTM& op_data = data.op_data;
+  auto kernel_content = CreateLSTMKernelContent(context, node);
+
+  const auto activation_type =
+      kernel_content.internal_tensors[kLstmInputTensor]->type;
+  const auto weight_type =
+      kernel_content.internal_tensors[kLstmInputToInputWeightsTensor]->type;
+
+  long long start_time = esp_timer_get_time();
+  switch (activation_type) {
+    case kTfLiteFloat32: {
+      LSTMBuffers<float> buffers =
+          CreateLSTMBuffers<float>(context, op_data.buffer_indices);
+      EvalLstm<float, float, float, float>(op_data, kernel_content, buffers);
+      break;
+    }
+    case kTfLiteInt8: {
+      switch (weight_type) {
+        case kTfLiteInt8: {
+#if ESP_NN
+          if (data.gate_weights != nullptr) {
+            EvalLstmEspNn(context, data, kernel_content);
+            break;
+          }
+#endif
+          // 8(activation)x8(weight)->16(cell) LSTM with 32 bits bias
+          LSTMBuffers<int16_t> buffers =
+              CreateLSTMBuffers<int16_t>(context, op_data.buffer_indices);
+          EvalLstm<int8_t, int8_t, int16_t, int32_t>(op_data, kernel_content,
+                                                     buffers);
+          break;
+        }
+        default: {
+          MicroPrintf("Filter type %s (%d) not supported.",
+                      TfLiteTypeGetName(weight_type), activation_type);
+          return kTfLiteError;
+        }
+      }
+      break;
+    }
+    case kTfLiteInt16: {
+      switch (weight_type) {
+        case kTfLiteInt8: {
+          // 16(activation)x8(weight)->16(cell) LSTM with 64 bits bias
+          LSTMBuffers<int16_t> buffers =
+              CreateLSTMBuffers<int16_t>(context, op_data.buffer_indices);
+          EvalLstm<int16_t, int8_t, int16_t, int64_t>(op_data, kernel_content,
+                                                      buffers);
+          break;
+        }
+        default: {
+          MicroPrintf("Filter type %s (%d) not supported.",
+                      TfLiteTypeGetName(weight_type), weight_type);
+          return kTfLiteError;
+        }
+      }
+      break;
+    }
+    default: {
+      MicroPrintf("Input type %s (%d) not supported.",
+                  TfLiteTypeGetName(activation_type), activation_type);
+      return kTfLiteError;
+    }
+  }
+  lstm_total_time += esp_timer_get_time() - start_time;
+  return kTfLiteOk;
+}
+
+}  // namespace
+
+TFLMRegistration Register_UNIDIRECTIONAL_SEQUENCE_LSTM() {
+  return tflite::micro::RegisterOp(UnidirectionalSequenceLstmInit,
+                                   UnidirectionalSequenceLstmPrepare,
+                                   UnidirectionalSequenceLstmEval);
+}
+}  // namespace tflite
@@ -61,6 +61,10 @@ class GreedyMemoryPlanner : public MicroMemoryPlanner {
   TfLiteStatus Init(unsigned char* scratch_buffer,
                     int scratch_buffer_size) override;
 
+  size_t GetScratchBufferSize(int buffer_count) override {
+    return per_buffer_size() * buffer_count;
+  }
+
   // Record details of a buffer we want to place.
   TfLiteStatus AddBuffer(int size, int first_time_used,
                          int last_time_used) override;
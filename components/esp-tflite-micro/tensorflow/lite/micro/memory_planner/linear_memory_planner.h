@@ -35,6 +35,9 @@ class LinearMemoryPlanner : public MicroMemoryPlanner {
   int GetBufferCount() override;
   TfLiteStatus GetOffsetForBuffer(int buffer_index, int* offset) override;
 
+  // The offsets are kept in the planner itself.
+  size_t GetScratchBufferSize(int buffer_count) override { return 0; }
+
   // Returns True because the LinearMemoryPlanner preserves all tensors after
   // invocation.
   bool preserves_all_tensors() const override { return true; }
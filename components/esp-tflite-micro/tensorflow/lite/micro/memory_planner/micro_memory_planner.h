@@ -16,6 +16,9 @@ limitations under the License.
 #ifndef TENSORFLOW_LITE_MICRO_MICRO_MEMORY_PLANNER_MEMORY_PLANNER_H_
 #define TENSORFLOW_LITE_MICRO_MICRO_MEMORY_PLANNER_MEMORY_PLANNER_H_
 
+#include <cstddef>
+#include <cstdint>
+
 #include "tensorflow/lite/c/common.h"
 
 namespace tflite {
@@ -81,6 +84,11 @@ class MicroMemoryPlanner {
     return kTfLiteOk;
   }
 
+  // Returns the size of the scratch buffer Init() needs to plan
+  // `buffer_count` buffers. By default the planner is given all the memory
+  // that is free in the arena.
+  virtual size_t GetScratchBufferSize(int buffer_count) { return SIZE_MAX; }
+
   // Method will return True if the MicroMemoryPlanner preserves all tensors
   // after invocation, and False if it doesn't.
   virtual bool preserves_all_tensors() const = 0;
@@ -199,6 +199,8 @@ TfLiteStatus AllocationInfoBuilder::InitializeAllocationInfo(
 
       current->first_created = kUninitializedLifetime;
       current->last_used = kUninitializedLifetime;
+      current->uses = 0;
+      current->in_fast_arena = false;
       current->needs_allocating =
           (eval_tensors[i].data.data == nullptr) &&
           (!subgraph->tensors()->Get(i)->is_variable()) &&
@@ -224,6 +226,8 @@ TfLiteStatus AllocationInfoBuilder::InitializeAllocationInfo(
     AllocationInfo* current = &scratch_allocation_info[i];
     current->first_created = kUninitializedLifetime;
     current->last_used = kUninitializedLifetime;
+    current->uses = kScratchBufferUses;
+    current->in_fast_arena = false;
     current->needs_allocating = true;
     current->offline_offset = kOnlinePlannedBuffer;
   }
@@ -286,6 +290,7 @@ TfLiteStatus AllocationInfoBuilder::MarkAllocationLifetimes(
         // or producer op, or it is not part of the memory plan (weight, bias
         // tensor).
         UpdateLastUsed(current, allocation_scope_count_);
+        current->uses++;
       }
     }
     for (size_t n = 0; op->outputs() != nullptr && n < op->outputs()->size();
@@ -293,6 +298,7 @@ TfLiteStatus AllocationInfoBuilder::MarkAllocationLifetimes(
       const int tensor_index = op->outputs()->Get(n);
       AllocationInfo* current = &subgraph_allocation_info[tensor_index];
       UpdateLastUsed(current, allocation_scope_count_);
+      current->uses++;
     }
 
     // Mark thse lifetime of scratch buffers belonging to the current node. This
@@ -23,6 +23,11 @@ limitations under the License.
 
 namespace tflite {
 
+// Scratch buffers back the inner loops of a kernel (im2col, padded input,
+// accumulators) and are read many times per invocation. They count as this
+// many uses when buffers are ranked for the fast arena.
+constexpr int kScratchBufferUses = 8;
+
 // Used to hold information used during allocation calculations.
 struct AllocationInfo {
   size_t bytes;
@@ -30,7 +35,13 @@ struct AllocationInfo {
   int first_created;
   int last_used;
   int32_t offline_offset;
+  // Number of times operators read or write the buffer, as an estimate of
+  // how often it is accessed.
+  int uses;
   bool needs_allocating;
+  // Planned in the fast arena of a tiered MicroAllocator instead of the head
+  // of the tensor arena.
+  bool in_fast_arena;
 };
 
 // Used to hold the allocation info list and related metadata for the entire
@@ -103,13 +103,17 @@ MicroMemoryPlanner* CreateMemoryPlanner(
   return memory_planner;
 }
 
+// Plans the buffers of the tensor arena, or of the fast arena if
+// `in_fast_arena` is set.
 TfLiteStatus CreatePlan(MicroMemoryPlanner* planner,
                         const AllocationInfo* allocation_info,
-                        size_t allocation_info_size) {
+                        size_t allocation_info_size,
+                        bool in_fast_arena = false) {
   // Add the tensors to our allocation plan.
   for (size_t i = 0; i < allocation_info_size; ++i) {
     const AllocationInfo* current = &allocation_info[i];
-    if (current->needs_allocating) {
+    if (current->needs_allocating &&
+        current->in_fast_arena == in_fast_arena) {
       size_t aligned_bytes_required =
           AlignSizeUp(current->bytes, MicroArenaBufferAlignment());
       if (current->offline_offset == kOnlinePlannedBuffer) {
@@ -128,12 +132,14 @@ TfLiteStatus CreatePlan(MicroMemoryPlanner* planner,
 
 TfLiteStatus CommitPlan(MicroMemoryPlanner* planner, uint8_t* starting_point,
                         const AllocationInfo* allocation_info,
-                        size_t allocation_info_size) {
+                        size_t allocation_info_size,
+                        bool in_fast_arena = false) {
   // Figure out the actual memory addresses for each buffer, based on the plan.
   int planner_index = 0;
   for (size_t i = 0; i < allocation_info_size; ++i) {
     const AllocationInfo* current = &allocation_info[i];
-    if (current->needs_allocating) {
+    if (current->needs_allocating &&
+        current->in_fast_arena == in_fast_arena) {
       int offset = -1;
       TF_LITE_ENSURE_STATUS(
           planner->GetOffsetForBuffer(planner_index, &offset));
@@ -566,6 +572,23 @@ MicroAllocator* MicroAllocator::Create(uint8_t* tensor_arena, size_t arena_size,
   return Create(memory_allocator, memory_planner);
 }
 
+MicroAllocator* MicroAllocator::CreateTiered(uint8_t* tensor_arena,
+                                             size_t arena_size,
+                                             uint8_t* fast_arena,
+                                             size_t fast_arena_size) {
+  TFLITE_DCHECK(fast_arena != nullptr);
+  MicroAllocator* allocator =
+      Create(tensor_arena, arena_size, MemoryPlannerType::kGreedy);
+  uint8_t* aligned_fast_arena =
+      AlignPointerUp(fast_arena, MicroArenaBufferAlignment());
+  if (aligned_fast_arena < fast_arena + fast_arena_size) {
+    allocator->fast_arena_ = aligned_fast_arena;
+    allocator->fast_arena_size_ =
+        fast_arena + fast_arena_size - aligned_fast_arena;
+  }
+  return allocator;
+}
+
 MicroAllocator* MicroAllocator::Create(
     SingleArenaBufferAllocator* memory_allocator,
     MicroMemoryPlanner* memory_planner) {
@@ -764,8 +787,15 @@ TfLiteStatus MicroAllocator::FinishPrepareNodeAllocations(int node_id) {
 }
 
 size_t MicroAllocator::used_bytes() const {
-  return non_persistent_buffer_allocator_->GetNonPersistentUsedBytes() +
-         persistent_buffer_allocator_->GetPersistentUsedBytes();
+  return non_persistent_used_bytes() + persistent_used_bytes();
+}
+
+size_t MicroAllocator::persistent_used_bytes() const {
+  return persistent_buffer_allocator_->GetPersistentUsedBytes();
+}
+
+size_t MicroAllocator::non_persistent_used_bytes() const {
+  return non_persistent_buffer_allocator_->GetNonPersistentUsedBytes();
 }
 
 TfLiteStatus MicroAllocator::AllocateNodeAndRegistrations(
@@ -1158,10 +1188,22 @@ TfLiteStatus MicroAllocator::CommitStaticMemoryPlan(
   int allocation_info_count = builder.AllocationCount();
   AllocationInfo* allocation_info = builder.Finish();
 
-  // Remaining arena size that memory planner can use for calculating offsets.
+  if (fast_arena_ != nullptr) {
+    TF_LITE_ENSURE_STATUS(
+        CommitFastArenaPlan(allocation_info, allocation_info_count));
+  }
+
+  // Arena size that memory planner can use for calculating offsets. Only
+  // what the planner needs is taken, so that the high-water mark of the
+  // non-persistent arena is the size it really needs.
   size_t remaining_arena_size =
       non_persistent_buffer_allocator_->GetAvailableMemory(
           MicroArenaBufferAlignment());
+  size_t planner_arena_size =
+      memory_planner_->GetScratchBufferSize(allocation_info_count);
+  if (remaining_arena_size > planner_arena_size) {
+    remaining_arena_size = planner_arena_size;
+  }
   uint8_t* planner_arena = non_persistent_buffer_allocator_->AllocateTemp(
       remaining_arena_size, MicroArenaBufferAlignment());
 
@@ -1211,6 +1253,87 @@ TfLiteStatus MicroAllocator::CommitStaticMemoryPlan(
   return kTfLiteOk;
 }
 
+TfLiteStatus MicroAllocator::CommitFastArenaPlan(
+    AllocationInfo* allocation_info, size_t allocation_info_size) {
+  // Rank the buffers the fast arena can hold by uses per byte, most first.
+  // Offline planned buffers keep their place in the tensor arena.
+  int* ranking = reinterpret_cast<int*>(non_persistent_buffer_allocator_
+      ->AllocateTemp(sizeof(int) * allocation_info_size, alignof(int)));
+  if (ranking == nullptr) {
+    return kTfLiteError;
+  }
+  int candidate_count = 0;
+  for (size_t i = 0; i < allocation_info_size; ++i) {
+    const AllocationInfo* current = &allocation_info[i];
+    if (!current->needs_allocating ||
+        current->offline_offset != kOnlinePlannedBuffer ||
+        AlignSizeUp(current->bytes, MicroArenaBufferAlignment()) >
+            fast_arena_size_) {
+      continue;
+    }
+    int position = candidate_count++;
+    for (; position > 0; --position) {
+      const AllocationInfo* other = &allocation_info[ranking[position - 1]];
+      const uint64_t current_density =
+          static_cast<uint64_t>(current->uses) * other->bytes;
+      const uint64_t other_density =
+          static_cast<uint64_t>(other->uses) * current->bytes;
+      if (current_density < other_density ||
+          (current_density == other_density &&
+           current->bytes >= other->bytes)) {
+        break;
+      }
+      ranking[position] = ranking[position - 1];
+    }
+    ranking[position] = static_cast<int>(i);
+  }
+
+  const int planner_scratch_size =
+      GreedyMemoryPlanner::per_buffer_size() * candidate_count;
+  uint8_t* planner_scratch = non_persistent_buffer_allocator_->AllocateTemp(
+      planner_scratch_size, MicroArenaBufferAlignment());
+  if (planner_scratch == nullptr) {
+    non_persistent_buffer_allocator_->DeallocateTemp(
+        reinterpret_cast<uint8_t*>(ranking));
+    return kTfLiteError;
+  }
+
+  // Take the buffers in order as long as the plan still fits. Buffers whose
+  // sizes add up to at most the fast arena fit without planning.
+  GreedyMemoryPlanner planner;
+  size_t total_bytes = 0;
+  for (int i = 0; i < candidate_count; ++i) {
+    AllocationInfo* current = &allocation_info[ranking[i]];
+    const size_t bytes =
+        AlignSizeUp(current->bytes, MicroArenaBufferAlignment());
+    current->in_fast_arena = true;
+    if (total_bytes + bytes > fast_arena_size_) {
+      planner.Init(planner_scratch, planner_scratch_size);
+      TF_LITE_ENSURE_STATUS(CreatePlan(&planner, allocation_info,
+                                       allocation_info_size, true));
+      if (planner.GetMaximumMemorySize() > fast_arena_size_) {
+        current->in_fast_arena = false;
+        continue;
+      }
+    }
+    total_bytes += bytes;
+  }
+
+  planner.Init(planner_scratch, planner_scratch_size);
+  TF_LITE_ENSURE_STATUS(
+      CreatePlan(&planner, allocation_info, allocation_info_size, true));
+  TF_LITE_ENSURE_STATUS(CommitPlan(&planner, fast_arena_, allocation_info,
+                                   allocation_info_size, true));
+  if (fast_arena_used_bytes_ < planner.GetMaximumMemorySize()) {
+    fast_arena_used_bytes_ = planner.GetMaximumMemorySize();
+  }
+
+  non_persistent_buffer_allocator_->DeallocateTemp(planner_scratch);
+  non_persistent_buffer_allocator_->DeallocateTemp(
+      reinterpret_cast<uint8_t*>(ranking));
+  return kTfLiteOk;
+}
+
 TfLiteStatus MicroAllocator::AllocateScratchBufferHandles(
     ScratchBufferHandle** scratch_buffer_handles, size_t handle_count) {
   TFLITE_DCHECK(scratch_buffer_handles != nullptr);
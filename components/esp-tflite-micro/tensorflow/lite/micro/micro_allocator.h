@@ -92,6 +92,10 @@ struct ScratchBufferHandle {
   uint8_t* data;
 };
 
+// Lifetime and placement of a buffer during memory planning, see
+// micro_allocation_info.h.
+struct AllocationInfo;
+
 // Stores all per-subgraph allocations. This includes the node and registration
 // array, and tensor list for each subgraph.
 struct SubgraphAllocations {
@@ -151,15 +155,29 @@ class MicroAllocator {
   static MicroAllocator* Create(SingleArenaBufferAllocator* memory_allocator,
                                 MicroMemoryPlanner* memory_planner);
 
-  // Creates a MicroAllocator instance using the provided
-  // SingleArenaBufferAllocator instance and the MemoryPlanner. This allocator
-  // instance will use the SingleArenaBufferAllocator instance to manage
-  // allocations internally.
+  // Creates a MicroAllocator instance with separate arenas for the persistent
+  // buffers (allocator and interpreter state, eval tensors, op data) and for
+  // the non-persistent ones (activation tensors and scratch buffers).
+  //
+  // Interpreters that never run concurrently can share one non-persistent
+  // arena, each with its own persistent arena. Every Invoke() then overwrites
+  // the activations of the others, so inputs have to be written right before
+  // Invoke() and outputs read before another interpreter runs. The shared
+  // arena needs the largest non_persistent_used_bytes() of the allocators.
   static MicroAllocator* Create(
       uint8_t* persistent_tensor_arena, size_t persistent_arena_size,
       uint8_t* non_persistent_tensor_arena, size_t non_persistent_arena_size,
       MemoryPlannerType memory_planner_type = MemoryPlannerType::kGreedy);
 
+  // Creates a MicroAllocator instance like Create(tensor_arena, arena_size)
+  // that places the most frequently accessed non-persistent buffers in
+  // `fast_arena` instead of the tensor arena, e.g. internal RAM when the
+  // tensor arena is in PSRAM. Kernel scratch buffers and small tensors that
+  // many operators read come first; the rest stays in the tensor arena.
+  static MicroAllocator* CreateTiered(uint8_t* tensor_arena, size_t arena_size,
+                                      uint8_t* fast_arena,
+                                      size_t fast_arena_size);
+
   // Returns the fixed amount of memory overhead of MicroAllocator.
   static size_t GetDefaultTailUsage(bool is_memory_planner_given);
 
@@ -257,6 +275,14 @@ class MicroAllocator {
   // `FinishModelAllocation`. Otherwise, it will return 0.
   size_t used_bytes() const;
 
+  // Returns the persistent and the non-persistent part of used_bytes(), only
+  // available after `FinishModelAllocation`.
+  size_t persistent_used_bytes() const;
+  size_t non_persistent_used_bytes() const;
+
+  // Returns the bytes of the fast arena in use, 0 if there is none.
+  size_t fast_arena_used_bytes() const { return fast_arena_used_bytes_; }
+
   TfLiteBridgeBuiltinDataAllocator* GetBuiltinDataAllocator();
 
  protected:
@@ -335,6 +361,11 @@ class MicroAllocator {
   // the head section.
   internal::ScratchBufferRequest* GetScratchBufferRequests();
 
+  // Moves the buffers with the most uses per byte that fit into the fast
+  // arena, plans them there and sets their pointers.
+  TfLiteStatus CommitFastArenaPlan(AllocationInfo* allocation_info,
+                                   size_t allocation_info_size);
+
   // A simple memory allocator that always allocate from the arena tail or head.
   INonPersistentBufferAllocator* non_persistent_buffer_allocator_;
   IPersistentBufferAllocator* persistent_buffer_allocator_;
@@ -360,6 +391,11 @@ class MicroAllocator {
   // to ensure that multi-tenant allocations can share the head for buffers.
   size_t max_head_buffer_usage_ = 0;
 
+  // Optional second arena for the most frequently accessed buffers.
+  uint8_t* fast_arena_ = nullptr;
+  size_t fast_arena_size_ = 0;
+  size_t fast_arena_used_bytes_ = 0;
+
   TF_LITE_REMOVE_VIRTUAL_DELETE
 };
 
@@ -143,6 +143,8 @@ class MicroInterpreter {
   // Note that normally `tensor_arena` requires 16 bytes alignment to fully
   // utilize the space. If it's not the case, the optimial arena size would be
   // arena_used_bytes() + 16.
+  // For an allocator with separate persistent and non-persistent arenas, this
+  // is the sum of both; MicroAllocator reports them separately.
   size_t arena_used_bytes() const { return allocator_.used_bytes(); }
 
   // Returns True if all Tensors are being preserves
@@ -0,0 +1,470 @@
+#!/usr/bin/env python3
+# Copyright 2025 The TensorFlow Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ==============================================================================
+"""Compiles a model ahead of time into tables for tflite::AotGraph.
+
+The model is either a .tflite flatbuffer or a C/C++ source with the model as
+a byte array (as written by `xxd -i`). The generated header defines
+
+  namespace <namespace> {
+  constexpr int32_t kActivationSize = N;
+  constexpr tflite::AotModel kModel = {...};
+  }
+
+with the shapes, types and quantization parameters of all tensors, the arena
+offsets of the activations, the input and output tensors of every operator
+and the kernel and builtin options parser of every operator code, all as
+constant data. tflite::AotGraph runs the model from these tables instead of
+walking the flatbuffer and planning the arena on the target:
+
+  tflite::AotGraph graph(<namespace>::kModel, tflite::GetModel(model_data),
+                         tensor_arena, kTensorArenaSize);
+  graph.AllocateTensors();
+  graph.Invoke();
+
+Only the kernels the model runs are referenced, so the linker leaves out all
+others, as with gen_op_resolver.py. Models with more than one subgraph,
+control flow or resource variable ops are rejected.
+
+Only the Python standard library is used, so the script can run from the
+ESP-IDF build without extra packages.
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+from gen_op_resolver import BUILTIN_CUSTOM
+from gen_op_resolver import FlatBuffer
+from gen_op_resolver import RESOLVER_HEADER
+from gen_op_resolver import builtin_names
+from gen_op_resolver import read_model
+
+# Matches MicroArenaBufferAlignment().
+ALIGNMENT = 16
+
+# TensorType of the schema: (TfLiteType, element size).
+TENSOR_TYPES = {
+    0: ('kTfLiteFloat32', 4),
+    1: ('kTfLiteFloat16', 2),
+    2: ('kTfLiteInt32', 4),
+    3: ('kTfLiteUInt8', 1),
+    4: ('kTfLiteInt64', 8),
+    6: ('kTfLiteBool', 1),
+    7: ('kTfLiteInt16', 2),
+    8: ('kTfLiteComplex64', 8),
+    9: ('kTfLiteInt8', 1),
+    10: ('kTfLiteFloat64', 8),
+    12: ('kTfLiteUInt64', 8),
+    15: ('kTfLiteUInt32', 4),
+    16: ('kTfLiteUInt16', 2),
+    18: ('kTfLiteBFloat16', 2),
+}
+
+# Ops that need the interpreter: other subgraphs or resource variables.
+UNSUPPORTED_OPS = ('CALL_ONCE', 'IF', 'WHILE', 'VAR_HANDLE', 'READ_VARIABLE',
+                   'ASSIGN_VARIABLE')
+
+
+def kernel_functions():
+  """Maps op names to (registration expression, parser) of the resolver.
+
+  Builtin ops are keyed by their BuiltinOperator name, custom ops by their
+  custom code. Registrations of custom ops are pointers.
+  """
+  with open(RESOLVER_HEADER) as f:
+    text = f.read()
+  functions = {}
+  for args, body in re.findall(
+      r'TfLiteStatus Add\w+\(([^{]*)\)\s*\{(.*?)\n  \}', text, re.S):
+    default = re.search(r'registration\s*=\s*([\w:]+\(\))', args)
+    builtin = re.search(
+        r'AddBuiltin\(BuiltinOperator_(\w+),\s*([\w:]+\(\)|registration),'
+        r'\s*(\w+)\)', body)
+    custom = re.search(r'AddCustom\(\s*"(\w+)",\s*([\w:]+\(\)|registration)\)',
+                       body)
+    if builtin:
+      reg = builtin.group(2)
+      if reg == 'registration':
+        reg = default.group(1) if default else None
+      if reg:
+        functions.setdefault(builtin.group(1), (reg, builtin.group(3)))
+    elif custom:
+      reg = custom.group(2)
+      if reg == 'registration':
+        reg = default.group(1) if default else None
+      if reg:
+        functions.setdefault(custom.group(1), (reg, None))
+  return functions
+
+
+class Model(object):
+  """Tensors and operators of the single subgraph of a model."""
+
+  def __init__(self, data, path):
+    fb = FlatBuffer(data)
+    self.fb = fb
+    self.path = path
+    root = fb.u32(0)
+    self.root = root
+    # Model: 1 operator_codes, 2 subgraphs, 4 buffers.
+    subgraphs = fb.tables(root, 2)
+    if len(subgraphs) != 1:
+      self.fail('%d subgraphs, AOT graphs support one' % len(subgraphs))
+    subgraph = subgraphs[0]
+    self.buffers = fb.tables(root, 4)
+    self.op_codes = fb.tables(root, 1)
+    # SubGraph: 0 tensors, 1 inputs, 2 outputs, 3 operators.
+    self.tensors = fb.tables(subgraph, 0)
+    self.inputs = self.ints(subgraph, 1)
+    self.outputs = self.ints(subgraph, 2)
+    self.operators = fb.tables(subgraph, 3)
+
+  def fail(self, message):
+    sys.exit('%s: %s' % (self.path, message))
+
+  def ints(self, table, index):
+    start, length = self.fb.vector(table, index)
+    return [self.fb.i32(start + 4 * i) for i in range(length)]
+
+  def int64s(self, table, index):
+    start, length = self.fb.vector(table, index)
+    return list(struct.unpack_from('<%dq' % length, self.fb.data, start))
+
+  def op_code(self, index):
+    """Returns (builtin code, custom code) of an OperatorCode."""
+    fb = self.fb
+    op_code = self.op_codes[index]
+    # OperatorCode: 0 deprecated_builtin_code (int8), 1 custom_code,
+    # 3 builtin_code (int32). The larger of the two codes is the real one.
+    pos = fb.field(op_code, 0)
+    code = fb.i8(pos) if pos is not None else 0
+    pos = fb.field(op_code, 3)
+    if pos is not None:
+      code = max(code, fb.i32(pos))
+    custom = fb.string(op_code, 1) if code == BUILTIN_CUSTOM else None
+    return code, custom
+
+  def tensor(self, index):
+    """Returns a dict describing tensor `index`."""
+    fb = self.fb
+    table = self.tensors[index]
+    # Tensor: 0 shape, 1 type, 2 buffer, 4 quantization, 5 is_variable,
+    # 6 sparsity.
+    pos = fb.field(table, 1)
+    tensor_type = fb.i8(pos) if pos is not None else 0
+    if tensor_type not in TENSOR_TYPES:
+      self.fail('tensor %d has unsupported type %d' % (index, tensor_type))
+    if fb.field(table, 6) is not None:
+      self.fail('tensor %d is sparse' % index)
+    type_name, type_size = TENSOR_TYPES[tensor_type]
+    shape = self.ints(table, 0)
+    elements = 1
+    for dim in shape:
+      if dim < 0:
+        self.fail('tensor %d has a dynamic shape' % index)
+      elements *= dim
+    pos = fb.field(table, 5)
+    is_variable = pos is not None and fb.data[pos] != 0
+
+    data_offset = None
+    pos = fb.field(table, 2)
+    buffer_index = fb.u32(pos) if pos is not None else 0
+    if buffer_index < len(self.buffers):
+      buffer = self.buffers[buffer_index]
+      # Buffer: 0 data, 1 offset. Data outside the flatbuffer is not
+      # supported, the interpreter cannot load such models either.
+      start, length = fb.vector(buffer, 0)
+      pos = fb.field(buffer, 1)
+      if pos is not None and struct.unpack_from('<Q', fb.data, pos)[0] > 1:
+        self.fail('tensor %d has its data outside the flatbuffer' % index)
+      if length:
+        data_offset = start - self.root
+
+    quantization = None
+    pos = fb.field(table, 4)
+    if pos is not None:
+      params = pos + fb.u32(pos)
+      # QuantizationParameters: 2 scale, 3 zero_point, 6 quantized_dimension.
+      scales, channels = fb.vector(params, 2)
+      zero_points = self.int64s(params, 3)
+      if channels and zero_points:
+        # As in MicroAllocator, a single zero point applies to all channels.
+        if len(zero_points) != channels:
+          zero_points = [zero_points[0]] * channels
+        pos = fb.field(params, 6)
+        quantized_dimension = fb.i32(pos) if pos is not None else 0
+        # The scales are used in place, from their length prefix on.
+        quantization = (scales - 4 - self.root, zero_points,
+                        quantized_dimension)
+
+    return {
+        'type': type_name,
+        'bytes': elements * type_size,
+        'shape': shape,
+        'variable': is_variable,
+        'data_offset': data_offset,
+        'quantization': quantization,
+    }
+
+  def operator(self, index):
+    """Returns (opcode index, inputs, outputs, intermediates, custom_options)."""
+    fb = self.fb
+    op = self.operators[index]
+    # Operator: 0 opcode_index, 1 inputs, 2 outputs, 5 custom_options,
+    # 8 intermediates.
+    pos = fb.field(op, 0)
+    opcode = fb.u32(pos) if pos is not None else 0
+    return (opcode, self.ints(op, 1), self.ints(op, 2), self.ints(op, 8),
+            fb.field(op, 5) is not None)
+
+
+def plan_activations(model, tensors):
+  """Assigns arena offsets to the activation and variable tensors.
+
+  Same greedy scheme as GreedyMemoryPlanner: the largest buffers are placed
+  first, each at the lowest offset that does not overlap a buffer alive at
+  the same time. Variable tensors are alive for the whole graph.
+  """
+  last_op = max(len(model.operators) - 1, 0)
+  first_use = {}
+  last_use = {}
+
+  def use(index, op):
+    if index < 0 or tensors[index]['kind'] != 'kActivation':
+      return
+    first_use[index] = min(first_use.get(index, op), op)
+    last_use[index] = max(last_use.get(index, op), op)
+
+  for index in model.inputs:
+    use(index, 0)
+  for op_index in range(len(model.operators)):
+    _, inputs, outputs, intermediates, _ = model.operator(op_index)
+    for index in inputs + outputs + intermediates:
+      use(index, op_index)
+  for index in model.outputs:
+    use(index, last_op)
+  for index, tensor in enumerate(tensors):
+    if tensor['kind'] == 'kVariable':
+      first_use[index] = 0
+      last_use[index] = last_op
+  for index, tensor in enumerate(tensors):
+    if tensor['kind'] == 'kActivation' and index not in first_use:
+      tensor['kind'] = 'kUnused'
+
+  def aligned(size):
+    return (size + ALIGNMENT - 1) // ALIGNMENT * ALIGNMENT
+
+  order = sorted(first_use, key=lambda i: (-tensors[i]['bytes'], first_use[i],
+                                           i))
+  placed = []
+  size = 0
+  for index in order:
+    bytes_ = aligned(tensors[index]['bytes'])
+    offset = 0
+    for other_offset, other_bytes, other in sorted(placed):
+      if (last_use[other] < first_use[index] or
+          last_use[index] < first_use[other]):
+        continue
+      if offset + bytes_ <= other_offset:
+        break
+      offset = max(offset, other_offset + other_bytes)
+    tensors[index]['offset'] = offset
+    placed.append((offset, bytes_, index))
+    size = max(size, offset + bytes_)
+  return size
+
+
+class IntTable(object):
+  """Deduplicated TfLiteIntArrays laid out back to back."""
+
+  def __init__(self):
+    self.values = []
+    self.index = {}
+
+  def add(self, values):
+    key = tuple(values)
+    if key not in self.index:
+      self.index[key] = len(self.values)
+      self.values += [len(values)] + list(values)
+    return self.index[key]
+
+
+def wrap(items, indent='    ', width=80):
+  lines = []
+  line = indent
+  for item in items:
+    item += ','
+    if len(line) + len(item) + 1 > width and line.strip():
+      lines.append(line.rstrip())
+      line = indent
+    line += item + ' '
+  if line.strip():
+    lines.append(line.rstrip())
+  return lines
+
+
+def generate(model_path, namespace):
+  model = Model(read_model(model_path), model_path)
+  names = builtin_names()
+  functions = kernel_functions()
+
+  opcodes = []
+  for index in range(len(model.op_codes)):
+    code, custom = model.op_code(index)
+    if custom is not None:
+      name = custom
+    else:
+      name = names.get(code, str(code))
+      if name in UNSUPPORTED_OPS:
+        model.fail('op %s is not supported by AOT graphs' % name)
+    opcodes.append((code, custom, name))
+
+  ints = IntTable()
+
+  tensors = []
+  for index in range(len(model.tensors)):
+    tensor = model.tensor(index)
+    if tensor['data_offset'] is not None:
+      tensor['kind'] = 'kConstant'
+      tensor['offset'] = tensor['data_offset']
+    elif tensor['variable']:
+      tensor['kind'] = 'kVariable'
+    else:
+      tensor['kind'] = 'kActivation'
+    tensors.append(tensor)
+  activation_size = plan_activations(model, tensors)
+
+  used_opcodes = []
+  ops = []
+  for op_index in range(len(model.operators)):
+    opcode, inputs, outputs, intermediates, has_custom_options = (
+        model.operator(op_index))
+    if opcode >= len(opcodes):
+      model.fail('op %d has an invalid opcode index' % op_index)
+    _, custom, name = opcodes[opcode]
+    if custom is None and has_custom_options:
+      model.fail('builtin op %s has custom options' % name)
+    if opcode not in used_opcodes:
+      used_opcodes.append(opcode)
+    ops.append((used_opcodes.index(opcode), ints.add(inputs),
+                ints.add(outputs),
+                ints.add(intermediates) if intermediates else -1, name))
+  model_inputs = ints.add(model.inputs)
+  model_outputs = ints.add(model.outputs)
+
+  registrations = []
+  opcode_rows = []
+  for opcode in used_opcodes:
+    code, custom, name = opcodes[opcode]
+    if name not in functions:
+      model.fail('op %s has no kernel in TFLM' % name)
+    reg, parser = functions[name]
+    if not reg.startswith('tflite::'):
+      reg = 'tflite::' + reg
+    if custom is None:
+      registrations.append(reg)
+      opcode_rows.append('{%d, nullptr, tflite::%s},  // %s' %
+                         (code, parser, name))
+    else:
+      registrations.append('*' + reg)
+      opcode_rows.append('{%d, "%s", nullptr},' % (code, custom))
+
+  tensor_rows = []
+  for index, tensor in enumerate(tensors):
+    dims = ints.add(tensor['shape'])
+    zero_points = scales = -1
+    quantized_dimension = 0
+    if tensor['quantization']:
+      scales, tensor_zero_points, quantized_dimension = tensor['quantization']
+      zero_points = ints.add(tensor_zero_points)
+    tensor_rows.append(
+        '{%d, %d, %d, %d, %d, %d, %s, tflite::AotTensorKind::%s},  // %d' %
+        (tensor.get('offset', -1), tensor['bytes'], dims, zero_points,
+         scales, quantized_dimension, tensor['type'], tensor['kind'],
+         index))
+
+  guard = re.sub(r'\W', '_', namespace).upper() + '_AOT_MODEL_H_'
+  lines = [
+      '// Generated by gen_aot_model.py from %s. Do not edit.' %
+      os.path.basename(model_path),
+      '',
+      '#ifndef %s' % guard,
+      '#define %s' % guard,
+      '',
+      '#include "tensorflow/lite/micro/esp/aot_graph.h"',
+      '// Declares the registration and parser of every kernel.',
+      '#include "tensorflow/lite/micro/micro_mutable_op_resolver.h"',
+      '',
+      'namespace %s {' % namespace,
+      '',
+      '// Arena bytes of the activations. The scratch buffers of the kernels',
+      '// and the persistent allocations come on top, see',
+      '// tflite::AotGraph::arena_used_bytes().',
+      'constexpr int32_t kActivationSize = %d;' % activation_size,
+      '',
+      'constexpr int32_t kInts[] = {',
+  ]
+  lines += wrap(['%d' % v for v in ints.values] or ['0'])
+  lines += ['};', '', 'constexpr tflite::AotTensor kTensors[] = {']
+  lines += ['    ' + row for row in tensor_rows]
+  lines += ['};', '', 'constexpr tflite::AotOpCode kOpCodes[] = {']
+  lines += ['    ' + row for row in opcode_rows]
+  lines += ['};', '', 'constexpr tflite::AotOp kOps[] = {']
+  for opcode, inputs, outputs, intermediates, name in ops:
+    lines.append('    {%d, %d, %d, %d},  // %s' %
+                 (opcode, inputs, outputs, intermediates, name))
+  lines += [
+      '};',
+      '',
+      'inline void GetRegistrations(TFLMRegistration* registrations) {',
+  ]
+  for index, reg in enumerate(registrations):
+    lines.append('  registrations[%d] = %s;' % (index, reg))
+  lines += [
+      '}',
+      '',
+      'constexpr tflite::AotModel kModel = {',
+      '    %d, kTensors, %d, kOps, %d, kOpCodes, GetRegistrations, kInts,' %
+      (len(tensors), len(ops), len(used_opcodes)),
+      '    %d, %d, kActivationSize,' % (model_inputs, model_outputs),
+      '};',
+      '',
+      '}  // namespace %s' % namespace,
+      '',
+      '#endif  // %s' % guard,
+      '',
+  ]
+  return '\n'.join(lines)
+
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+  parser.add_argument('--model', required=True,
+                      help='.tflite file or C/C++ source with a byte array')
+  parser.add_argument('--output', required=True, help='header to write')
+  parser.add_argument('--namespace', default='model_aot',
+                      help='namespace of the generated tables')
+  args = parser.parse_args()
+
+  header = generate(args.model, args.namespace)
+  with open(args.output, 'w') as f:
+    f.write(header)
+
+
+if __name__ == '__main__':
+  main()
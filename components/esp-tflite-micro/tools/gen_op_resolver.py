@@ -0,0 +1,233 @@
+#!/usr/bin/env python3
+# Copyright 2024 The TensorFlow Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ==============================================================================
+"""Generates a MicroMutableOpResolver holding exactly the ops of a model.
+
+The model is either a .tflite flatbuffer or a C/C++ source with the model as
+a byte array (as written by `xxd -i`). The generated header defines
+
+  namespace <namespace> {
+  constexpr int kNumberOperators = N;
+  using OpResolver = tflite::MicroMutableOpResolver<kNumberOperators>;
+  TfLiteStatus RegisterOps(OpResolver& resolver);
+  }
+
+so that only the kernels the model runs are referenced, and the linker leaves
+out all the others. Custom ops are counted in N but have to be added by the
+caller with AddCustom().
+
+Only the Python standard library is used, so the script can run from the
+ESP-IDF build without extra packages.
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+COMPONENT_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+RESOLVER_HEADER = os.path.join(COMPONENT_DIR, 'tensorflow', 'lite', 'micro',
+                               'micro_mutable_op_resolver.h')
+SCHEMA_HEADER = os.path.join(COMPONENT_DIR, 'tensorflow', 'lite', 'schema',
+                             'schema_generated.h')
+
+BUILTIN_CUSTOM = 32
+
+
+class FlatBuffer(object):
+  """Minimal reader for the tables of the TFLite schema used here."""
+
+  def __init__(self, data):
+    self.data = data
+
+  def i8(self, pos):
+    return struct.unpack_from('<b', self.data, pos)[0]
+
+  def i32(self, pos):
+    return struct.unpack_from('<i', self.data, pos)[0]
+
+  def u32(self, pos):
+    return struct.unpack_from('<I', self.data, pos)[0]
+
+  def field(self, table, index):
+    """Returns the position of field `index` of `table`, or None."""
+    vtable = table - self.i32(table)
+    vtable_size = struct.unpack_from('<H', self.data, vtable)[0]
+    entry = 4 + 2 * index
+    if entry >= vtable_size:
+      return None
+    offset = struct.unpack_from('<H', self.data, vtable + entry)[0]
+    return table + offset if offset else None
+
+  def vector(self, table, index):
+    """Returns (start, length) of a vector field, or (0, 0)."""
+    pos = self.field(table, index)
+    if pos is None:
+      return 0, 0
+    vec = pos + self.u32(pos)
+    return vec + 4, self.u32(vec)
+
+  def tables(self, table, index):
+    start, length = self.vector(table, index)
+    return [start + 4 * i + self.u32(start + 4 * i) for i in range(length)]
+
+  def string(self, table, index):
+    start, length = self.vector(table, index)
+    return self.data[start:start + length].decode('utf-8')
+
+
+def read_model(path):
+  """Returns the flatbuffer bytes of a .tflite file or a C array source."""
+  with open(path, 'rb') as f:
+    data = f.read()
+  if data[4:8] == b'TFL3':
+    return data
+  text = data.decode('utf-8', errors='replace')
+  # Strip comments, then take the first brace initializer of a byte array.
+  text = re.sub(r'/\*.*?\*/|//[^\n]*', '', text, flags=re.S)
+  match = re.search(r'\[[^\]]*\]\s*(?:[A-Za-z_][\w()\s,]*)?=\s*\{([^}]*)\}',
+                    text)
+  if not match:
+    sys.exit('%s: neither a .tflite file nor a C byte array' % path)
+  values = [int(v, 0) for v in re.findall(r'0[xX][0-9a-fA-F]+|\d+',
+                                          match.group(1))]
+  data = bytes(v & 0xff for v in values)
+  if data[4:8] != b'TFL3':
+    sys.exit('%s: the byte array is not a TFLite flatbuffer' % path)
+  return data
+
+
+def used_operators(data):
+  """Returns the builtin codes and custom names the model's subgraphs run."""
+  fb = FlatBuffer(data)
+  model = fb.u32(0)
+  # Model: 1 operator_codes, 2 subgraphs.
+  op_codes = fb.tables(model, 1)
+  used = set()
+  for subgraph in fb.tables(model, 2):
+    # SubGraph: 3 operators. Operator: 0 opcode_index.
+    for op in fb.tables(subgraph, 3):
+      pos = fb.field(op, 0)
+      used.add(fb.u32(pos) if pos is not None else 0)
+
+  builtins = set()
+  customs = set()
+  for index in sorted(used):
+    op_code = op_codes[index]
+    # OperatorCode: 0 deprecated_builtin_code (int8), 1 custom_code,
+    # 3 builtin_code (int32). The larger of the two codes is the real one.
+    pos = fb.field(op_code, 0)
+    code = fb.i8(pos) if pos is not None else 0
+    pos = fb.field(op_code, 3)
+    if pos is not None:
+      code = max(code, fb.i32(pos))
+    if code == BUILTIN_CUSTOM:
+      customs.add(fb.string(op_code, 1))
+    else:
+      builtins.add(code)
+  return builtins, customs
+
+
+def builtin_names():
+  """Maps BuiltinOperator values to their names, from the schema header."""
+  with open(SCHEMA_HEADER) as f:
+    text = f.read()
+  body = re.search(r'enum BuiltinOperator\b[^{]*\{(.*?)\};', text, re.S)
+  names = {}
+  for name, value in re.findall(r'BuiltinOperator_(\w+)\s*=\s*(-?\d+)',
+                                body.group(1)):
+    if name not in ('MIN', 'MAX'):
+      names[int(value)] = name
+  return names
+
+
+def resolver_methods():
+  """Maps builtin operator names to the resolver method registering them."""
+  with open(RESOLVER_HEADER) as f:
+    text = f.read()
+  methods = {}
+  for method, body in re.findall(
+      r'TfLiteStatus (Add\w+)\([^{]*\)\s*\{(.*?)\n  \}', text, re.S):
+    op = re.search(r'BuiltinOperator_(\w+)', body)
+    if op and method not in ('AddBuiltin', 'AddCustom'):
+      methods.setdefault(op.group(1), method)
+  return methods
+
+
+def generate(model_path, namespace):
+  builtins, customs = used_operators(read_model(model_path))
+  names = builtin_names()
+  methods = resolver_methods()
+
+  calls = []
+  for code in builtins:
+    name = names.get(code, str(code))
+    if name not in methods:
+      sys.exit('%s: op %s has no kernel in TFLM' % (model_path, name))
+    calls.append(methods[name])
+  calls.sort()
+
+  guard = re.sub(r'\W', '_', namespace).upper() + '_OP_RESOLVER_H_'
+  lines = [
+      '// Generated by gen_op_resolver.py from %s. Do not edit.' %
+      os.path.basename(model_path),
+      '',
+      '#ifndef %s' % guard,
+      '#define %s' % guard,
+      '',
+      '#include "tensorflow/lite/micro/micro_mutable_op_resolver.h"',
+      '',
+      'namespace %s {' % namespace,
+      '',
+      'constexpr int kNumberOperators = %d;' % (len(calls) + len(customs)),
+      '',
+      'using OpResolver = tflite::MicroMutableOpResolver<kNumberOperators>;',
+      '',
+  ]
+  if customs:
+    lines.append('// The caller has to add the custom ops %s with AddCustom().'
+                 % ', '.join('"%s"' % c for c in sorted(customs)))
+  lines.append('inline TfLiteStatus RegisterOps(OpResolver& resolver) {')
+  for call in calls:
+    lines.append('  TF_LITE_ENSURE_STATUS(resolver.%s());' % call)
+  lines += [
+      '  return kTfLiteOk;',
+      '}',
+      '',
+      '}  // namespace %s' % namespace,
+      '',
+      '#endif  // %s' % guard,
+      '',
+  ]
+  return '\n'.join(lines)
+
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+  parser.add_argument('--model', required=True,
+                      help='.tflite file or C/C++ source with a byte array')
+  parser.add_argument('--output', required=True, help='header to write')
+  parser.add_argument('--namespace', default='model_ops',
+                      help='namespace of the generated resolver')
+  args = parser.parse_args()
+
+  header = generate(args.model, args.namespace)
+  with open(args.output, 'w') as f:
+    f.write(header)
+
+
+if __name__ == '__main__':
+  main()
@@ -12,18 +12,26 @@
 #include "tensorflow/lite/core/api/error_reporter.h"
 #include "tensorflow/lite/core/api/model.h"
 #include "tensorflow/lite/kernels/internal/tensor_ctypes.h"
-#include "tensorflow/lite/micro/all_ops_resolver.h"
+#include "tensorflow/lite/micro/esp/arena_plan.h"
 #include "tensorflow/lite/micro/micro_mutable_op_resolver.h"
 #include "tensorflow/lite/micro/micro_op_resolver.h"
 #include "tensorflow/lite/micro/micro_interpreter.h"
 #include "tensorflow/lite/micro/system_setup.h"
 #include "tensorflow/lite/schema/schema_generated.h"
+#include "simple_model_op_resolver.h"  // Generated from simple_model.h
 #else
 #define TFLM_AVAILABLE 0
 #endif
 
 static const char *TAG = "TFLM_MODEL_TEST";
 
+#if TFLM_AVAILABLE
+// Tensor arena for simple_model, as reported by tflite::MeasureArena() with
+// CONFIG_TFLM_MEASURE_ARENA (959 bytes), rounded up. Measure again when the
+// model, the kernels or their Kconfig options change.
+static const int kTensorArenaSize = 1024;
+#endif
+
 void app_main() {
     ESP_LOGI(TAG, "Starting TensorFlow Lite Micro model test...");
     ESP_LOGI(TAG, "Model size: %d bytes", simple_model_tflite_len);
@@ -44,11 +52,38 @@ void app_main() {
     }
     ESP_LOGI(TAG, "Model version check passed");
     
-    // Allocate memory for operations
-    static tflite::AllOpsResolver resolver;
+    // Register only the ops the model uses
+    static simple_model::OpResolver resolver;
+    if (simple_model::RegisterOps(resolver) != kTfLiteOk) {
+        ESP_LOGE(TAG, "Failed to register the model's ops");
+        return;
+    }
     
-    // Set up tensor arena (increased size for better stability)
-    const int tensor_arena_size = 8 * 1024; // 8KB
+#if CONFIG_TFLM_MEASURE_ARENA
+    // Development step: measure the arena the model needs in a generous probe
+    // buffer and print it, to update kTensorArenaSize. The probe attempts
+    // that do not fit log allocation errors.
+    const int probe_arena_size = 32 * 1024;
+    uint8_t *probe_arena = (uint8_t*)malloc(probe_arena_size);
+    if (probe_arena == NULL) {
+        ESP_LOGE(TAG, "Failed to allocate probe arena!");
+        return;
+    }
+    tflite::ArenaRequirements requirements;
+    TfLiteStatus measure_status = tflite::MeasureArena(
+        model, resolver, probe_arena, probe_arena_size, &requirements);
+    free(probe_arena);
+    if (measure_status != kTfLiteOk) {
+        ESP_LOGE(TAG, "Model does not fit in %d bytes", probe_arena_size);
+        return;
+    }
+    ESP_LOGI(TAG, "Arena needed: %d bytes (persistent %d, non-persistent %d)",
+             (int)requirements.arena_size, (int)requirements.persistent_bytes,
+             (int)requirements.non_persistent_bytes);
+#endif
+
+    // Set up tensor arena
+    const int tensor_arena_size = kTensorArenaSize;
     uint8_t *tensor_arena = (uint8_t*)malloc(tensor_arena_size);
     if (tensor_arena == NULL) {
         ESP_LOGE(TAG, "Failed to allocate tensor arena!");
@@ -65,6 +100,7 @@ void app_main() {
     TfLiteStatus allocate_status = interpreter->AllocateTensors();
     if (allocate_status != kTfLiteOk) {
         ESP_LOGE(TAG, "AllocateTensors() failed with status: %d", allocate_status);
+        ESP_LOGE(TAG, "Enable CONFIG_TFLM_MEASURE_ARENA to measure the arena size");
         free(tensor_arena);
         return;
     }